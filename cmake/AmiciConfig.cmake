@@ -2,6 +2,13 @@
 
 include(CMakeFindDependencyMacro)
 
+find_dependency(Threads)
+if(@ENABLE_MPI@)
+    find_dependency(MPI COMPONENTS CXX)
+endif()
+if(@ENABLE_MPI@ OR @BUILD_AMICI_SERVE@)
+    find_dependency(Boost COMPONENTS serialization)
+endif()
 find_package(SUNDIALS REQUIRED PATHS "@CMAKE_SOURCE_DIR@/ThirdParty/sundials/build/lib/cmake/sundials/")
 
 include("${CMAKE_CURRENT_LIST_DIR}/AmiciTargets.cmake")
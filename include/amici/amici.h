@@ -6,9 +6,18 @@
 #include "amici/edata.h"
 #include "amici/exception.h"
 #include "amici/model.h"
+#include "amici/profiling.h"
 #include "amici/rdata.h"
 #include "amici/solver.h"
 #include "amici/symbolic_functions.h"
+#include "amici/trace.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
 
 namespace amici {
 
@@ -75,6 +84,24 @@ class AmiciApplication {
                         const std::vector<ExpData *> &edatas,
                         Model const &model, bool failfast, int num_threads);
 
+    /**
+     * @brief Same as runAmiciSimulation, but for multiple ExpData instances.
+     * Results are handed over to the consumer as soon as they are available.
+     * Exceptions thrown by the consumer do not interrupt the other
+     * simulations, they are reported as one AmiException afterwards.
+     *
+     * @param solver Solver instance
+     * @param edatas experimental data objects
+     * @param model model specification object
+     * @param consumer receives the return data objects
+     * @param failfast flag to allow early termination
+     * @param num_threads number of threads for parallel execution
+     */
+    void runAmiciSimulations(Solver const &solver,
+                             const std::vector<ExpData *> &edatas,
+                             Model const &model, ReturnDataConsumer &consumer,
+                             bool failfast, int num_threads);
+
     /** Function to process warnings */
     outputFunctionType warning = printWarnMsgIdAndTxt;
 
@@ -127,6 +154,10 @@ std::unique_ptr<ReturnData> runAmiciSimulation(Solver &solver,
  * @brief Same as runAmiciSimulation, but for multiple ExpData instances. When
  * compiled with OpenMP support, this function runs multi-threaded.
  *
+ * If the solver has a CancellationToken, cancelling it interrupts running
+ * simulations and skips the remaining conditions, which then report
+ * AMICI_CANCELLED.
+ *
  * @param solver Solver instance
  * @param edatas experimental data objects
  * @param model model specification object
@@ -138,6 +169,147 @@ std::vector<std::unique_ptr<ReturnData>>
 runAmiciSimulations(Solver const &solver, const std::vector<ExpData *> &edatas,
                     Model const &model, bool failfast, int num_threads);
 
+/**
+ * @brief Same as runAmiciSimulations, but hands over each result to the
+ * consumer as soon as it is available. When compiled with OpenMP support,
+ * this function runs multi-threaded. Exceptions thrown by the consumer do
+ * not interrupt the other simulations, they are reported as one AmiException
+ * after all simulations have finished.
+ *
+ * @param solver Solver instance
+ * @param edatas experimental data objects
+ * @param model model specification object
+ * @param consumer receives the return data objects
+ * @param failfast flag to allow early termination
+ * @param num_threads number of threads for parallel execution
+ */
+void runAmiciSimulations(Solver const &solver,
+                         const std::vector<ExpData *> &edatas,
+                         Model const &model, ReturnDataConsumer &consumer,
+                         bool failfast, int num_threads);
+
+/**
+ * @brief Persistent pool of worker threads for asynchronous simulations.
+ *
+ * Simulations are started in the order of submission, but may complete in
+ * any order. Solver, Model and ExpData are copied on submission, so they can
+ * be modified or destroyed right after submitting.
+ */
+class SimulationWorkerPool {
+  public:
+    /**
+     * @brief Start the worker threads
+     * @param num_threads number of worker threads, `0` for the number of
+     * hardware threads
+     */
+    explicit SimulationWorkerPool(int num_threads = 0);
+
+    /**
+     * @brief Cancels all simulations that have not been started yet, waits
+     * for the running ones and stops the worker threads.
+     *
+     * Futures of cancelled simulations throw std::future_error
+     * (std::future_errc::broken_promise).
+     */
+    ~SimulationWorkerPool();
+
+    SimulationWorkerPool(SimulationWorkerPool const &) = delete;
+
+    SimulationWorkerPool &operator=(SimulationWorkerPool const &) = delete;
+
+    /**
+     * @brief Submit a simulation (see amici::runAmiciSimulation)
+     * @param solver Solver instance
+     * @param edata pointer to experimental data object, may be `nullptr`
+     * @param model model specification object
+     * @param on_completion called from the worker thread once the future is
+     * ready, i.e. after the simulation finished or was cancelled
+     * @return future for the simulation result
+     */
+    std::future<std::unique_ptr<ReturnData>>
+    submit(Solver const &solver, ExpData const *edata, Model const &model,
+           std::function<void()> on_completion = nullptr);
+
+    /**
+     * @brief Submit one simulation per experimental data object
+     * @param solver Solver instance
+     * @param edatas experimental data objects
+     * @param model model specification object
+     * @return futures for the simulation results, in the order of `edatas`
+     */
+    std::vector<std::future<std::unique_ptr<ReturnData>>>
+    submit(Solver const &solver, std::vector<ExpData *> const &edatas,
+           Model const &model);
+
+    /**
+     * @brief Number of worker threads
+     * @return number of worker threads
+     */
+    int numThreads() const { return static_cast<int>(workers_.size()); }
+
+  private:
+    /** @brief Runs submitted simulations until the pool is stopped. */
+    void work();
+
+    /** worker threads */
+    std::vector<std::thread> workers_;
+
+    /** @brief A submitted simulation */
+    struct Job {
+        /** simulation */
+        std::packaged_task<std::unique_ptr<ReturnData>()> task;
+
+        /** called once the future of `task` is ready, may be empty */
+        std::function<void()> on_completion;
+    };
+
+    /** submitted, but not yet started simulations */
+    std::deque<Job> queue_;
+
+    /** guards queue_ and stop_ */
+    std::mutex mutex_;
+
+    /** signals new jobs or stop to the workers */
+    std::condition_variable cv_;
+
+    /** set on destruction to stop the workers */
+    bool stop_ {false};
+};
+
+/**
+ * @brief Pool used by amici::submitSimulation and amici::submitSimulations,
+ * with one worker per hardware thread. Started on first use, simulations
+ * that have not been started at program exit are cancelled.
+ * @return default pool
+ */
+SimulationWorkerPool &defaultSimulationWorkerPool();
+
+/**
+ * @brief Asynchronous version of amici::runAmiciSimulation, running on
+ * amici::defaultSimulationWorkerPool.
+ *
+ * @param solver Solver instance
+ * @param edata pointer to experimental data object, may be `nullptr`
+ * @param model model specification object
+ * @return future for the simulation result
+ */
+std::future<std::unique_ptr<ReturnData>>
+submitSimulation(Solver const &solver, ExpData const *edata,
+                 Model const &model);
+
+/**
+ * @brief Asynchronous version of amici::runAmiciSimulations, running on
+ * amici::defaultSimulationWorkerPool.
+ *
+ * @param solver Solver instance
+ * @param edatas experimental data objects
+ * @param model model specification object
+ * @return futures for the simulation results, in the order of `edatas`
+ */
+std::vector<std::future<std::unique_ptr<ReturnData>>>
+submitSimulations(Solver const &solver, std::vector<ExpData *> const &edatas,
+                  Model const &model);
+
 } // namespace amici
 
 #endif /* amici_h */
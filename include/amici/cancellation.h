@@ -0,0 +1,137 @@
+#ifndef AMICI_CANCELLATION_H
+#define AMICI_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+
+namespace amici {
+
+/**
+ * @brief Cooperative cancellation of simulations.
+ *
+ * A token is attached to a Solver via Solver::setCancellationToken and is
+ * shared by all clones of that solver, e.g. by all conditions of a
+ * runAmiciSimulations batch. Simulations using the token stop at the next
+ * integrator step boundary once the token was cancelled, its deadline has
+ * passed, or one of its work budgets is exhausted. Interrupted simulations
+ * report AMICI_CANCELLED, or AMICI_MAX_TIME_EXCEEDED if the deadline passed.
+ * Conditions that have not started yet are not simulated at all.
+ *
+ * All member functions are thread-safe, in particular cancel() may be called
+ * from any thread while simulations are running. Budgets are shared across
+ * all simulations using the token.
+ */
+class CancellationToken {
+  public:
+    /** Why the token was cancelled */
+    enum class Reason {
+        /** not cancelled */
+        none,
+        /** cancel() was called */
+        requested,
+        /** deadline passed */
+        deadline,
+        /** budget of right-hand side evaluations exhausted */
+        rhsEvaluations,
+        /** budget of integration steps exhausted */
+        steps,
+    };
+
+    CancellationToken() = default;
+    CancellationToken(CancellationToken const &) = delete;
+    CancellationToken &operator=(CancellationToken const &) = delete;
+
+    /**
+     * @brief Request cancellation of all simulations using this token.
+     * @param reason reason for cancellation
+     */
+    void cancel(Reason reason = Reason::requested);
+
+    /**
+     * @brief Check whether the token was cancelled. Only reads a flag, does
+     * not check deadline and budgets.
+     * @return cancellation status
+     */
+    bool isCancelled() const {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the reason for cancellation.
+     * @return reason, Reason::none if not cancelled
+     */
+    Reason getReason() const;
+
+    /**
+     * @brief Get the simulation status corresponding to the current reason
+     * for cancellation.
+     * @return AMICI_SUCCESS, AMICI_CANCELLED or AMICI_MAX_TIME_EXCEEDED
+     */
+    int getStatus() const;
+
+    /**
+     * @brief Cancel once the given amount of wall time, counted from now,
+     * has passed.
+     * @param seconds time in seconds
+     */
+    void setTimeout(double seconds);
+
+    /**
+     * @brief Cancel after the given total number of right-hand side
+     * evaluations (forward and backward) of all simulations using this token.
+     * @param max_evaluations number of evaluations, negative for no limit
+     */
+    void setMaxRHSEvaluations(long int max_evaluations);
+
+    /**
+     * @brief Cancel after the given total number of forward integration
+     * steps of all simulations using this token.
+     * @param max_steps number of steps, negative for no limit
+     */
+    void setMaxSteps(long int max_steps);
+
+    /**
+     * @brief Number of right-hand side evaluations charged so far
+     * @return evaluations
+     */
+    long int getNumRHSEvaluations() const;
+
+    /**
+     * @brief Number of integration steps charged so far
+     * @return steps
+     */
+    long int getNumSteps() const;
+
+    /**
+     * @brief Un-cancel the token and reset the work counters. Deadline and
+     * budgets are kept.
+     */
+    void reset();
+
+    /**
+     * @brief Add work to the counters and check deadline and budgets.
+     * @param rhs_evaluations number of right-hand side evaluations since the
+     * last call
+     * @param steps number of integration steps since the last call
+     * @return whether the token is cancelled
+     */
+    bool charge(long int rhs_evaluations, long int steps);
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    std::atomic<bool> cancelled_ {false};
+    std::atomic<int> reason_ {static_cast<int>(Reason::none)};
+
+    /** deadline as clock ticks since epoch, max if unset */
+    std::atomic<clock::rep> deadline_ {clock::duration::max().count()};
+
+    std::atomic<long int> max_rhs_evaluations_ {-1};
+    std::atomic<long int> max_steps_ {-1};
+    std::atomic<long int> rhs_evaluations_ {0};
+    std::atomic<long int> steps_ {0};
+};
+
+} // namespace amici
+
+#endif // AMICI_CANCELLATION_H
@@ -59,6 +59,31 @@ void amici_dgemm(BLASLayout layout, BLASTranspose TransA,
                  int lda, const double *B, int ldb,
                  double beta, double *C, int ldc);
 
+/**
+ * @brief CBLAS symmetric rank-k update (dsyrk)
+ *
+ * This routines computes \f$ C = alpha*A*A^T + beta*C \f$ (noTrans) or
+ * \f$ C = alpha*A^T*A + beta*C \f$ (trans) with C: [NxN] and
+ * A: [NxK] (noTrans) or [KxN] (trans). Only the triangle of C selected by
+ * `uplo` is referenced and updated.
+ *
+ * @param layout    memory layout.
+ * @param uplo      flag indicating whether the upper or lower triangle of C
+ * is updated
+ * @param Trans     flag indicating whether A should be transposed
+ * @param N         order of C
+ * @param K         number of columns in A (noTrans) or rows in A (trans)
+ * @param alpha     coefficient alpha
+ * @param A         matrix A
+ * @param lda       leading dimension of A
+ * @param beta      coefficient beta
+ * @param C         matrix C
+ * @param ldc       leading dimension of C (>=N)
+ */
+void amici_dsyrk(BLASLayout layout, BLASUplo uplo, BLASTranspose Trans,
+                 int N, int K, double alpha, const double *A, int lda,
+                 double beta, double *C, int ldc);
+
 /**
  * @brief Compute y = a*x + y
  * @param n         number of elements in y
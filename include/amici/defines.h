@@ -76,6 +76,7 @@ constexpr int AMICI_DAMPING_FACTOR_ERROR=    -86;
 constexpr int AMICI_SINGULAR_JACOBIAN=      -809;
 constexpr int AMICI_NOT_IMPLEMENTED=        -999;
 constexpr int AMICI_MAX_TIME_EXCEEDED  =   -1000;
+constexpr int AMICI_CANCELLED          =   -1001;
 constexpr int AMICI_SUCCESS=                   0;
 constexpr int AMICI_DATA_RETURN=               1;
 constexpr int AMICI_ROOT_RETURN=               2;
@@ -102,6 +103,12 @@ enum class BLASTranspose {
     conjTrans = 113
 };
 
+/** BLAS triangle selection, affects dsyrk calls */
+enum class BLASUplo {
+    upper = 121,
+    lower = 122
+};
+
 /** modes for parameter transformations */
 enum class ParameterScaling {
     none,
@@ -221,6 +228,47 @@ enum class RDataReporting {
     likelihood,
 };
 
+/**
+ * ReturnData fields that can be deselected in addition to the
+ * RDataReporting mode, values are bit flags that can be combined to a mask
+ */
+enum class RDataField {
+    none = 0,
+    x = 1 << 0,
+    sx = 1 << 1,
+    w = 1 << 2,
+    y = 1 << 3,
+    sy = 1 << 4,
+    sigmay = 1 << 5,
+    ssigmay = 1 << 6,
+    res = 1 << 7,
+    sres = 1 << 8,
+    FIM = 1 << 9,
+    all = (1 << 10) - 1,
+};
+
+#ifndef SWIG
+/**
+ * @brief Combines two ReturnData fields to a mask
+ * @param a field
+ * @param b field
+ * @return mask
+ */
+constexpr int operator|(RDataField a, RDataField b) {
+    return static_cast<int>(a) | static_cast<int>(b);
+}
+
+/**
+ * @brief Adds a ReturnData field to a mask
+ * @param mask mask
+ * @param field field
+ * @return mask
+ */
+constexpr int operator|(int mask, RDataField field) {
+    return mask | static_cast<int>(field);
+}
+#endif
+
 /**
  * Type for function to process warnings or error messages.
  */
@@ -12,6 +12,19 @@ namespace amici {
 
 class Model;
 class ReturnData;
+class ExpData;
+
+} // namespace amici
+
+// for serialization friend in amici::ExpData
+namespace boost {
+namespace serialization {
+template <class Archive>
+void serialize(Archive &ar, amici::ExpData &e, unsigned int version);
+}
+} // namespace boost
+
+namespace amici {
 
 /**
  * @brief ExpData carries all information about experimental or
@@ -196,19 +209,128 @@ class ExpData : public SimulationParameters {
     /**
      * @brief get function that copies data from ExpData::observedData to output
      *
+     * Only available for dense storage, see getObservedDataDense for sparse
+     * storage.
+     *
      * @return observed data (dimension: nt x nytrue, row-major)
      */
     std::vector<realtype> const &getObservedData() const;
 
+    /**
+     * @brief get function that assembles the dense observed data for dense
+     * and sparse storage
+     *
+     * @return observed data (dimension: nt x nytrue, row-major), unset data
+     * points are NaN
+     */
+    std::vector<realtype> getObservedDataDense() const;
+
     /**
      * @brief get function that returns a pointer to observed data at index
      *
      * @param it timepoint index
      *
-     * @return pointer to observed data at index (dimension: nytrue)
+     * @return pointer to observed data at index (dimension: nytrue), nullptr
+     * if no data was set or for sparse storage
      */
     const realtype *getObservedDataPtr(int it) const;
 
+    /**
+     * @brief get function that returns a pointer to observed data at index
+     * for dense and sparse storage
+     *
+     * @param it timepoint index
+     * @param buffer storage for the data at timepoint `it` in case of sparse
+     * storage, unset data points are NaN
+     *
+     * @return pointer to observed data at index (dimension: nytrue)
+     */
+    const realtype *getObservedDataPtr(int it,
+                                       std::vector<realtype> &buffer) const;
+
+    /**
+     * @brief set function that copies observed data and standard deviations
+     * given in coordinate format, all other data points are unset
+     *
+     * @param it timepoint indices of the data points (dimension: ndata)
+     * @param iy observable indices of the data points (dimension: ndata)
+     * @param observedData observed data (dimension: ndata)
+     * @param observedDataStdDev standard deviation of observed data
+     * (dimension: ndata or empty)
+     */
+    void setObservedDataSparse(std::vector<int> const &it,
+                               std::vector<int> const &iy,
+                               std::vector<realtype> const &observedData,
+                               std::vector<realtype> const &observedDataStdDev);
+
+    /**
+     * @brief whether observed data and standard deviations are stored only
+     * for the data points that have been set, as after
+     * setObservedDataSparse. Any other setter for observed data or their
+     * standard deviations switches back to dense storage.
+     *
+     * @return true for sparse storage
+     */
+    bool isObservedDataSparse() const;
+
+    /**
+     * @brief get function that returns the values of the data points that
+     * have been set at the given timepoint, in the order of
+     * getObservedDataIndices(it)
+     *
+     * @param it timepoint index
+     *
+     * @return observed data, empty unless stored sparse
+     */
+    gsl::span<const realtype> getObservedDataValues(int it) const;
+
+    /**
+     * @brief get function that returns the standard deviations of the data
+     * points that have been set at the given timepoint, in the order of
+     * getObservedDataIndices(it)
+     *
+     * @param it timepoint index
+     *
+     * @return standard deviations, NaN if not set, empty unless stored sparse
+     * with standard deviations
+     */
+    gsl::span<const realtype> getObservedDataStdDevValues(int it) const;
+
+    /**
+     * @brief number of data points that have been set
+     *
+     * @return number of data points that have been set
+     */
+    int nObservedData() const;
+
+    /**
+     * @brief get function that returns the row pointers of the compressed
+     * sparse row index of data points that have been set. The observable
+     * indices of the data points at timepoint `it` are
+     * `getObservedDataIndices()[indptr[it]:indptr[it + 1]]`.
+     *
+     * @return row pointers (dimension: nt + 1)
+     */
+    std::vector<int> const &getObservedDataIndptr() const;
+
+    /**
+     * @brief get function that returns the observable indices of all data
+     * points that have been set, ordered by timepoint
+     *
+     * @return observable indices (dimension: nObservedData)
+     */
+    std::vector<int> const &getObservedDataIndices() const;
+
+    /**
+     * @brief get function that returns the observable indices of the data
+     * points that have been set at the given timepoint
+     *
+     * @param it timepoint index
+     *
+     * @return observable indices in ascending order
+     */
+    gsl::span<const int> getObservedDataIndices(int it) const;
+
     /**
      * @brief set function that copies data from input to
      * ExpData::observedDataStdDev
@@ -260,16 +382,29 @@ class ExpData : public SimulationParameters {
      * @brief get function that copies data from ExpData::observedDataStdDev to
      * output
      *
+     * Only available for dense storage, see getObservedDataStdDevDense for
+     * sparse storage.
+     *
      * @return standard deviation of observed data
      */
     std::vector<realtype> const &getObservedDataStdDev() const;
 
+    /**
+     * @brief get function that assembles the dense standard deviation of
+     * observed data for dense and sparse storage
+     *
+     * @return standard deviation of observed data (dimension: nt x nytrue,
+     * row-major), unset data points are NaN
+     */
+    std::vector<realtype> getObservedDataStdDevDense() const;
+
     /**
      * @brief get function that returns a pointer to standard deviation of
      * observed data at index
      *
      * @param it timepoint index
-     * @return pointer to standard deviation of observed data at index
+     * @return pointer to standard deviation of observed data at index,
+     * nullptr if not set or for sparse storage
      */
     const realtype *getObservedDataStdDevPtr(int it) const;
 
@@ -390,6 +525,16 @@ class ExpData : public SimulationParameters {
      */
     std::string id;
 
+    /**
+     * @brief Serialize ExpData (see boost::serialization::serialize)
+     * @param ar Archive to serialize to
+     * @param e Data to serialize
+     * @param version Version number
+     */
+    template <class Archive>
+    friend void boost::serialization::serialize(Archive &ar, ExpData &e,
+                                                unsigned int version);
+
   protected:
     /**
      * @brief resizes observedData, observedDataStdDev, observedEvents and
@@ -407,6 +552,12 @@ class ExpData : public SimulationParameters {
      */
     void applyEventDimension();
 
+    /**
+     * @brief rebuilds the index of data points that have been set from
+     * observedData
+     */
+    void updateObservedDataIndex();
+
     /**
      * @brief checker for dimensions of input observedData or observedDataStdDev
      *
@@ -435,15 +586,64 @@ class ExpData : public SimulationParameters {
     /** @brief maximal number of event occurrences */
     int nmaxevent_{0};
 
-    /** @brief observed data (dimension: nt x nytrue, row-major) */
+    /**
+     * @brief convert sparse storage of observed data and standard
+     * deviations to dense storage
+     */
+    void densifyObservedData();
+
+    /**
+     * @brief position of a data point in the sparse index
+     *
+     * @param it time index
+     * @param iy observable index
+     * @return position in observed_data_indices_, -1 if not set
+     */
+    int findObservedData(int it, int iy) const;
+
+    /**
+     * @brief check that the sparse index and values are consistent with
+     * the dimensions
+     */
+    void checkObservedDataIndex() const;
+
+    /** @brief observed data (dimension: nt x nytrue, row-major, empty for
+     * sparse storage) */
     std::vector<realtype> observed_data_;
 
     /**
      * @brief standard deviation of observed data (dimension: nt x nytrue,
-     * row-major)
+     * row-major, empty for sparse storage)
      */
     std::vector<realtype> observed_data_std_dev_;
 
+    /** @brief whether only set data points are stored */
+    bool observed_data_sparse_{false};
+
+    /**
+     * @brief observed data of the set data points in the order of
+     * observed_data_indices_ (sparse storage only)
+     */
+    std::vector<realtype> observed_data_values_;
+
+    /**
+     * @brief standard deviations of the set data points in the order of
+     * observed_data_indices_ (sparse storage only, may be empty)
+     */
+    std::vector<realtype> observed_data_std_dev_values_;
+
+    /**
+     * @brief row pointers of the compressed sparse row index of data points
+     * that have been set (dimension: nt + 1)
+     */
+    std::vector<int> observed_data_indptr_;
+
+    /**
+     * @brief observable indices of data points that have been set
+     * (dimension: number of set data points)
+     */
+    std::vector<int> observed_data_indices_;
+
     /**
      * @brief observed events (dimension: nmaxevents x nztrue, row-major)
      */
@@ -1,8 +1,17 @@
 #ifndef AMICI_HDF5_H
 #define AMICI_HDF5_H
 
+#include "amici/rdata.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <H5Cpp.h>
@@ -152,10 +161,49 @@ std::unique_ptr<ExpData> readSimulationExpData(const std::string &hdf5Filename,
  * @param edata The experimental data which is to be written
  * @param file Name of HDF5 file
  * @param hdf5Location Path inside the HDF5 file to object having ExpData
+ * @param sparse If true, only data points that have been set are written, as
+ * compressed sparse rows (`Y_indptr`, `Y_indices`, `Y_data`, `Sigma_Y_data`)
+ * instead of the dense `Y` and `Sigma_Y`
  */
 
 void writeSimulationExpData(const ExpData &edata, H5::H5File const &file,
-                            const std::string &hdf5Location);
+                            const std::string &hdf5Location,
+                            bool sparse = false);
+
+/**
+ * @brief Read AMICI ExpData for multiple conditions from stacked datasets in
+ * a single HDF5 group.
+ *
+ * Expects `Y` and `Sigma_Y` (shape `ncond` x `nt` x `nytrue`) and optionally
+ * `Z` and `Sigma_Z` (`ncond` x `nmaxevent` x `nztrue`), `ts` (`ncond` x `nt`,
+ * model timepoints are used if missing), `t_presim` (`ncond`) and
+ * `condition`, `conditionPreequilibration` and `conditionPresimulation`
+ * (`ncond` x `nk`, rows of NaN denote no parameters), `ids` (`ncond`
+ * strings), `reinitializeFixedParameterInitialStates` (`ncond`) and the
+ * reinitialized states `reinitialization_state_idxs_sim` with row pointers
+ * `reinitialization_state_idxs_sim_indptr` (`ncond + 1`). Every dataset is
+ * read at once. Settings that are missing are taken from the model, as for
+ * readSimulationExpData.
+ * @param hdf5Filename Name of HDF5 file
+ * @param hdf5Root Path inside the HDF5 file to the group with the datasets
+ * @param model The model for which data is to be read
+ * @return ExpData instances, one per condition
+ */
+std::vector<std::unique_ptr<ExpData>>
+readSimulationExpDatas(const std::string &hdf5Filename,
+                       const std::string &hdf5Root, const Model &model);
+
+/**
+ * @brief Write AMICI ExpData for multiple conditions to stacked datasets in a
+ * single HDF5 group, see readSimulationExpDatas for the layout.
+ * @param edatas The experimental data which is to be written, all instances
+ * need to have the same dimensions
+ * @param file HDF5 file
+ * @param hdf5Location Path inside the HDF5 file to the group to write to
+ */
+void writeSimulationExpDatas(std::vector<ExpData *> const &edatas,
+                             H5::H5File const &file,
+                             const std::string &hdf5Location);
 
 /**
  * @brief Check whether an attribute with the given name exists
@@ -339,6 +387,137 @@ bool locationExists(std::string const &filename, std::string const &location);
 
 bool locationExists(H5::H5File const &file, std::string const &location);
 
+/**
+ * @brief Writes the results of many simulations to stacked, chunked datasets
+ * (e.g. `y` with shape `nsim` x `nt` x `ny`, `llh` with shape `nsim`)
+ * instead of one group per simulation.
+ *
+ * Results are handed over via a bounded queue to a dedicated I/O thread, so
+ * simulation threads only block if the queue is full. Pass an instance to
+ * amici::runAmiciSimulations to write results as they become available.
+ * All results must have the same dimensions. Rows of simulations that have
+ * not been written are filled with NaN, `status` with AMICI_ERROR and other
+ * integer fields with 0.
+ *
+ * HDF5 is only accessed from the I/O thread while the writer is open, other
+ * HDF5 calls on the same file must not be made concurrently.
+ */
+class ReturnDataBatchWriter : public ReturnDataConsumer {
+  public:
+    /**
+     * @brief Opens the file and starts the I/O thread
+     * @param hdf5Filename HDF5 file to write to, created if it does not exist
+     * @param hdf5Location group in which the datasets are created
+     * @param compression deflate compression level (0-9), 0 to disable
+     * @param shuffle whether to apply the shuffle filter
+     * @param chunkSize maximum number of simulations per chunk, chunks are
+     * further limited to 1 MiB
+     * @param queueCapacity maximum number of results waiting to be written
+     */
+    ReturnDataBatchWriter(std::string const &hdf5Filename,
+                          std::string const &hdf5Location,
+                          int compression = 0, bool shuffle = false,
+                          int chunkSize = 64, int queueCapacity = 64);
+
+    ReturnDataBatchWriter(ReturnDataBatchWriter const &) = delete;
+    ReturnDataBatchWriter &operator=(ReturnDataBatchWriter const &) = delete;
+
+    /**
+     * @brief Writes all queued results and closes the file, errors are
+     * discarded, call close() to handle them
+     */
+    ~ReturnDataBatchWriter() override;
+
+    /**
+     * @brief Queues a result for writing, blocks while the queue is full.
+     * Throws if the writer was closed, which runAmiciSimulations reports
+     * after all simulations have finished.
+     * @param index index of the simulation, determines the row
+     * @param rdata simulation result
+     */
+    void consume(int index, std::unique_ptr<ReturnData> rdata) override;
+
+    /**
+     * @brief Queues a copy of a result for writing, blocks while the queue
+     * is full
+     * @param index index of the simulation, determines the row
+     * @param rdata simulation result
+     */
+    void append(int index, ReturnData const &rdata);
+
+    /**
+     * @brief Writes all queued results, stops the I/O thread and closes the
+     * file. Rethrows the first error that occurred during writing.
+     */
+    void close();
+
+  private:
+    /** I/O thread main loop */
+    void run();
+
+    /**
+     * @brief Writes a single result
+     * @param index row
+     * @param rdata simulation result
+     */
+    void write(int index, ReturnData const &rdata);
+
+    /**
+     * @brief Writes one field of a single result to row `index` of the
+     * respective stacked dataset, which is created or extended as needed
+     * @param name dataset name
+     * @param type HDF5 memory and file type
+     * @param buffer data of a single simulation
+     * @param dims shape of the data of a single simulation
+     * @param index row
+     */
+    void writeField(std::string const &name, H5::PredType const &type,
+                    void const *buffer, std::vector<hsize_t> const &dims,
+                    int index);
+
+    /** HDF5 file */
+    H5::H5File file_;
+
+    /** group in which the datasets are created */
+    std::string location_;
+
+    /** deflate level */
+    int compression_;
+
+    /** apply shuffle filter */
+    bool shuffle_;
+
+    /** maximum number of simulations per chunk */
+    int chunk_size_;
+
+    /** maximum size of a chunk in bytes */
+    static constexpr hsize_t max_chunk_bytes = 1024 * 1024;
+
+    /** maximum queue length */
+    std::size_t queue_capacity_;
+
+    /** open datasets by name */
+    std::map<std::string, H5::DataSet> datasets_;
+
+    /** results waiting to be written */
+    std::deque<std::pair<int, std::unique_ptr<ReturnData>>> queue_;
+
+    /** protects queue_, closing_ and error_ */
+    std::mutex mutex_;
+
+    /** signals changes of queue_ or closing_ */
+    std::condition_variable cv_;
+
+    /** set once close() was called */
+    bool closing_ {false};
+
+    /** first error on the I/O thread */
+    std::exception_ptr error_;
+
+    /** I/O thread */
+    std::thread thread_;
+};
+
 } // namespace hdf5
 } // namespace amici
 
@@ -66,6 +66,11 @@ void amici_dgemm(BLASLayout layout, BLASTranspose TransA,
                  const int lda, const double *B, const int ldb,
                  const double beta, double *C, const int ldc);
 
+void amici_dsyrk(BLASLayout layout, BLASUplo uplo, BLASTranspose Trans,
+                 const int N, const int K, const double alpha,
+                 const double *A, const int lda, const double beta, double *C,
+                 const int ldc);
+
 } // namespace amici
 
 #endif
@@ -7,6 +7,7 @@
 #include <sunmatrix/sunmatrix_sparse.h> // SUNMatrixContent_Sparse
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <regex>
@@ -187,6 +188,45 @@ class ContextManager{
     ContextManager(ContextManager &&other) = delete;
 };
 
+/**
+ * @brief Measures CPU time of the calling thread and monotonic wall time.
+ *
+ * Unlike `clock()`, which measures CPU time of the whole process, the CPU time
+ * is not affected by other threads, e.g. when simulating multiple conditions
+ * in parallel. Where per-thread CPU time is not available, process CPU time is
+ * used.
+ */
+class CpuTimer {
+  public:
+    /** Start the timer */
+    CpuTimer() { reset(); }
+
+    /** Restart the timer */
+    void reset();
+
+    /**
+     * @brief CPU time of the calling thread since start
+     * @return CPU time [ms]
+     */
+    double elapsedMilliseconds() const;
+
+    /**
+     * @brief Wall time since start
+     * @return wall time [ms]
+     */
+    double elapsedWallMilliseconds() const;
+
+    /**
+     * @brief CPU time consumed by the calling thread
+     * @return CPU time [ms]
+     */
+    static double threadCpuTime();
+
+  private:
+    double start_cpu_ {0.0};
+    std::chrono::steady_clock::time_point start_wall_;
+};
+
 } // namespace amici
 
 #endif // AMICI_MISC_H
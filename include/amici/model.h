@@ -34,6 +34,31 @@ void serialize(Archive &ar, amici::Model &m, unsigned int version);
 
 namespace amici {
 
+/**
+ * @brief Model properties that are fixed at construction.
+ *
+ * Shared read-only between a model and its clones. Names, ids and sparsity
+ * patterns are provided by the generated model code and are not duplicated
+ * per instance either.
+ */
+struct ModelDefinition {
+    /** Flag array for DAE equations (dimension: `nx_solver`) */
+    std::vector<realtype> idlist;
+
+    /** Index indicating to which event an event output belongs
+     * (dimension: `nz`) */
+    std::vector<int> z2event;
+
+    /** Number of nonzero elements in `dxdotdp_explicit` */
+    int ndxdotdp_explicit {0};
+
+    /** Number of nonzero elements in `dxdotdx_explicit` */
+    int ndxdotdx_explicit {0};
+
+    /** Recursion depth of fw */
+    int w_recursion_depth {0};
+};
+
 /**
  * @brief The Model class represents an AMICI ODE/DAE model.
  *
@@ -68,6 +93,15 @@ class Model : public AbstractModel, public ModelDimensions {
     /** Destructor. */
     ~Model() override = default;
 
+    /**
+     * @brief Copy constructor.
+     *
+     * Copies settings and ModelState, shares the ModelDefinition and sets up
+     * a new, empty workspace.
+     * @param other Object to copy from
+     */
+    Model(Model const &other);
+
     /**
      * @brief Copy assignment is disabled until const members are removed.
      * @param other Object to copy from
@@ -1303,17 +1337,30 @@ class Model : public AbstractModel, public ModelDimensions {
     bool pythonGenerated;
 
     /**
-     * @brief getter for dxdotdp (matlab generated)
+     * @brief getter for dxdotdp (matlab generated), as computed by the last
+     * call of fdxdotdp
      * @return dxdotdp
      */
     const AmiVectorArray &get_dxdotdp() const;
 
     /**
-     * @brief getter for dxdotdp (python generated)
+     * @brief getter for dxdotdp (python generated), as computed by the last
+     * call of fdxdotdp
      * @return dxdotdp
      */
     const SUNMatrixWrapper &get_dxdotdp_full() const;
 
+    /**
+     * @brief Get the memory currently allocated for the model workspace.
+     *
+     * Workspaces for sensitivity analysis, adjoint simulations and DAEs are
+     * allocated on first use, so this reflects the requirements of the
+     * simulations performed so far. Each thread in `runAmiciSimulations`
+     * works on its own copy of the model and workspace.
+     * @return Size in bytes
+     */
+    std::size_t getWorkspaceMemoryUsage() const;
+
     /**
      * Flag indicating whether for
      * `amici::Solver::sensi_` == `amici::SensitivityOrder::second`
@@ -1321,8 +1368,13 @@ class Model : public AbstractModel, public ModelDimensions {
      */
     SecondOrderMode o2mode{SecondOrderMode::none};
 
-    /** Flag array for DAE equations */
-    std::vector<realtype> idlist;
+    /**
+     * @brief Get flag array for DAE equations
+     * @return Flags indicating differential (1) or algebraic (0) states
+     */
+    std::vector<realtype> const &getIdList() const {
+        return definition_->idlist;
+    }
 
     /** AMICI application context */
     AmiciApplication *app = &defaultContext;
@@ -1791,8 +1843,9 @@ class Model : public AbstractModel, public ModelDimensions {
      */
     ModelStateDerived derived_state_;
 
-    /** index indicating to which event an event output belongs */
-    std::vector<int> z2event_;
+    /** Fixed model properties, shared with clones */
+    std::shared_ptr<ModelDefinition const> definition_ {
+        std::make_shared<ModelDefinition>()};
 
     /** state initialization (size nx_solver) */
     std::vector<realtype> x0data_;
@@ -1828,18 +1881,30 @@ class Model : public AbstractModel, public ModelDimensions {
     /** offset to ensure positivity of sigma residuals, only has an effect when `sigma_res_` is `true`  */
     realtype min_sigma_ {50.0};
 
-  private:
-    /** Sparse dwdp implicit temporary storage (shape `ndwdp`) */
-    mutable std::vector<SUNMatrixWrapper> dwdp_hierarchical_;
+    /**
+     * @brief Allocate the workspaces for the parameter derivative of `w`
+     * if not yet allocated.
+     */
+    void allocateDwdp();
 
-    /** Sparse dwdw temporary storage (shape `ndwdw`) */
-    mutable SUNMatrixWrapper dwdw_;
+    /**
+     * @brief Allocate the workspaces for the parameter derivative of `xdot`
+     * if not yet allocated or the parameter list changed.
+     */
+    void allocateDxdotdp();
 
-    /** Sparse dwdx implicit temporary storage (shape `ndwdx`) */
-    mutable std::vector<SUNMatrixWrapper> dwdx_hierarchical_;
+    /**
+     * @brief Allocate the workspace for the backward Jacobian if not yet
+     * allocated.
+     */
+    void allocateJB();
 
-    /** Recursion */
-    int w_recursion_depth_ {0};
+  private:
+    /**
+     * @brief Allocate the parts of derived_state_ that are required for any
+     * simulation.
+     */
+    void initializeWorkspace();
 
     /** Simulation parameters, initial state, etc. */
     SimulationParameters simulation_parameters_;
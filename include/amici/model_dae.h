@@ -47,9 +47,7 @@ class Model_DAE : public Model {
               const int ndxdotdp_explicit=0)
         : Model(model_dimensions, simulation_parameters,
                 o2mode, idlist, z2event, pythonGenerated,
-                ndxdotdp_explicit) {
-        derived_state_.M_ = SUNMatrixWrapper(nx_solver, nx_solver);
-    }
+                ndxdotdp_explicit) {}
 
     void fJ(realtype t, realtype cj, const AmiVector &x, const AmiVector &dx,
             const AmiVector &xdot, SUNMatrix J) override;
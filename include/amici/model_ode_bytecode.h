@@ -0,0 +1,498 @@
+#ifndef AMICI_MODEL_ODE_BYTECODE_H
+#define AMICI_MODEL_ODE_BYTECODE_H
+
+#include "amici/model_ode.h"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace amici {
+
+namespace bytecode {
+
+/** Operations of the bytecode interpreter */
+enum class Opcode : std::uint8_t {
+    /** `r[dst] = constants[a]` */
+    constant,
+    /** `r[dst] = slot_a[b]` */
+    load,
+    /** `out[a] = r[b]` */
+    store,
+    /** `out[a] = r[b]` if `a` is in the reinitialization state indices */
+    store_reinit,
+    /** `out[a] = 0` if `a` is in the reinitialization state indices */
+    zero_reinit,
+    // binary operations `r[dst] = op(r[a], r[b])`
+    add, sub, mul, div, pow, pos_pow, max, min, fmod, atan2, heaviside,
+    lt, le, gt, ge, eq, ne, logical_and, logical_or,
+    // unary operations `r[dst] = op(r[a])`
+    neg, sqrt, cbrt, exp, log, sin, cos, tan, asin, acos, atan, sinh, cosh,
+    tanh, asinh, acosh, atanh, fabs, floor, ceil, erf, sign, dirac,
+    logical_not,
+    /** `r[dst] = r[a] ? r[b] : r[c]` */
+    select,
+};
+
+/** Arrays that instructions can read from, named as the arguments of the
+ * generated model functions */
+enum class Slot : std::uint8_t {
+    out, t, x, p, k, h, w, tcl, dtcldp, dwdx, y, sigmay, my, sx, stau, xdot,
+    xdot_old, x0, x_rdata,
+};
+
+/** Number of entries of amici::bytecode::Slot */
+constexpr int num_slots = static_cast<int>(Slot::x_rdata) + 1;
+
+/** A single instruction with up to three operands */
+struct Instruction {
+    /** operation */
+    Opcode op;
+    /** destination register */
+    int dst;
+    /** first operand, see amici::bytecode::Opcode */
+    int a;
+    /** second operand */
+    int b;
+    /** third operand */
+    int c;
+};
+
+/** Inputs and output of a program evaluation */
+struct Arguments {
+    /** input arrays, indexed by amici::bytecode::Slot */
+    std::array<const realtype *, num_slots> arrays{};
+    /** output array */
+    realtype *out{nullptr};
+    /** value of `t` */
+    realtype t{0.0};
+    /** state indices for `store_reinit` and `zero_reinit` */
+    gsl::span<const int> reinitialization_state_idxs;
+};
+
+/**
+ * @brief Straight-line program computing the nonzero entries of one model
+ * function for one case, e.g. one parameter index.
+ */
+struct Program {
+    /** constants referenced by `constant` instructions */
+    std::vector<realtype> constants;
+    /** instructions, executed in order */
+    std::vector<Instruction> instructions;
+    /** number of registers */
+    int n_registers{0};
+
+    /**
+     * @brief Execute the program
+     * @param args inputs and output
+     * @param registers scratch space of at least `n_registers` entries
+     */
+    void evaluate(Arguments const &args, realtype *registers) const;
+};
+
+/** Model functions provided by a bytecode model, in the order of
+ * amici::bytecode::function_names */
+enum class Function {
+    Jy, dJydsigma, dJydy, root, dwdp, dwdx, dwdw, dxdotdw, dxdotdx_explicit,
+    dxdotdp_explicit, dydx, dydp, dsigmaydy, dsigmaydp, sigmay, stau, deltax,
+    deltasx, w, x0, x0_fixedParameters, sx0, sx0_fixedParameters, xdot, y,
+    x_rdata, x_solver, total_cl, dtotal_cldp, dtotal_cldx_rdata,
+    dx_rdatadx_solver, dx_rdatadp, dx_rdatadtcl,
+};
+
+/** Number of entries of amici::bytecode::Function */
+constexpr int num_functions = static_cast<int>(Function::dx_rdatadtcl) + 1;
+
+/** Sparsity pattern of a sparse model function */
+struct SparsityPattern {
+    /** column pointers */
+    std::vector<sunindextype> colptrs;
+    /** row indices */
+    std::vector<sunindextype> rowvals;
+};
+
+} // namespace bytecode
+
+/**
+ * @brief Everything a bytecode model consists of, as read by
+ * amici::readBytecodeModel. Shared read-only between model instances.
+ */
+struct BytecodeModelDefinition {
+    /** model name */
+    std::string name;
+    /** AMICI version used for model import */
+    std::string amici_version;
+    /** AMICI commit used for model import */
+    std::string amici_commit;
+    /** model dimensions */
+    ModelDimensions dimensions;
+    /** number of nonzero elements in `dxdotdp_explicit` */
+    int ndxdotdp_explicit{0};
+    /** number of nonzero elements in `dxdotdx_explicit` */
+    int ndxdotdx_explicit{0};
+    /** recursion depth of `fw` */
+    int w_recursion_depth{0};
+    /** whether states depending on fixed parameters may be reinitialized */
+    bool reinit_fixpar_initcond{false};
+    /** whether all observables have a gaussian noise model */
+    bool quadratic_llh{false};
+    /** default parameters */
+    std::vector<realtype> parameters;
+    /** default fixed parameters */
+    std::vector<realtype> fixed_parameters;
+    /** parameter names */
+    std::vector<std::string> parameter_names;
+    /** fixed parameter names */
+    std::vector<std::string> fixed_parameter_names;
+    /** state names */
+    std::vector<std::string> state_names;
+    /** observable names */
+    std::vector<std::string> observable_names;
+    /** expression names */
+    std::vector<std::string> expression_names;
+    /** parameter ids */
+    std::vector<std::string> parameter_ids;
+    /** fixed parameter ids */
+    std::vector<std::string> fixed_parameter_ids;
+    /** state ids */
+    std::vector<std::string> state_ids;
+    /** observable ids */
+    std::vector<std::string> observable_ids;
+    /** expression ids */
+    std::vector<std::string> expression_ids;
+    /** indices of the solver states in the full state vector */
+    std::vector<int> state_idxs_solver;
+    /** observable scalings */
+    std::vector<ObservableScaling> observable_scalings;
+    /** programs per function, indexed by the function specific case, i.e.
+     * observable, parameter and/or event index. Empty if not provided. */
+    std::array<std::vector<bytecode::Program>, bytecode::num_functions>
+        programs;
+    /** sparsity patterns of the sparse functions, per observable for
+     * `dJydy` */
+    std::array<std::vector<bytecode::SparsityPattern>, bytecode::num_functions>
+        sparsity;
+    /** maximum number of registers of all programs */
+    int n_registers{0};
+};
+
+/**
+ * @brief ODE model evaluated by a bytecode interpreter.
+ *
+ * Provides the same model functions as a model generated by
+ * amici.ode_export, but evaluates them from the bytecode written by
+ * amici.bytecode at model import, so no C++ compilation is required. This
+ * trades simulation speed for import speed, which is useful during model
+ * development.
+ */
+class Model_ODE_Bytecode : public Model_ODE {
+  public:
+    /**
+     * @brief Constructor
+     * @param definition bytecode model
+     */
+    explicit Model_ODE_Bytecode(
+        std::shared_ptr<const BytecodeModelDefinition> definition);
+
+    Model *clone() const override { return new Model_ODE_Bytecode(*this); }
+
+    void fJy(realtype *Jy, int iy, const realtype *p, const realtype *k,
+             const realtype *y, const realtype *sigmay,
+             const realtype *my) override;
+
+    void fdJydsigma(realtype *dJydsigma, int iy, const realtype *p,
+                    const realtype *k, const realtype *y,
+                    const realtype *sigmay, const realtype *my) override;
+
+    void fdJydy(realtype *dJydy, int iy, const realtype *p, const realtype *k,
+                const realtype *y, const realtype *sigmay,
+                const realtype *my) override;
+    void fdJydy_colptrs(SUNMatrixWrapper &dJydy, int index) override;
+    void fdJydy_rowvals(SUNMatrixWrapper &dJydy, int index) override;
+
+    void froot(realtype *root, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *tcl) override;
+
+    void fdwdp(realtype *dwdp, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *w, const realtype *tcl,
+               const realtype *stcl) override;
+    void fdwdp_colptrs(SUNMatrixWrapper &dwdp) override;
+    void fdwdp_rowvals(SUNMatrixWrapper &dwdp) override;
+
+    void fdwdx(realtype *dwdx, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *w, const realtype *tcl) override;
+    void fdwdx_colptrs(SUNMatrixWrapper &dwdx) override;
+    void fdwdx_rowvals(SUNMatrixWrapper &dwdx) override;
+
+    void fdwdw(realtype *dwdw, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *w, const realtype *tcl) override;
+    void fdwdw_colptrs(SUNMatrixWrapper &dwdw) override;
+    void fdwdw_rowvals(SUNMatrixWrapper &dwdw) override;
+
+    void fdxdotdw(realtype *dxdotdw, realtype t, const realtype *x,
+                  const realtype *p, const realtype *k, const realtype *h,
+                  const realtype *w) override;
+    void fdxdotdw_colptrs(SUNMatrixWrapper &dxdotdw) override;
+    void fdxdotdw_rowvals(SUNMatrixWrapper &dxdotdw) override;
+
+    void fdxdotdx_explicit(realtype *dxdotdx_explicit, realtype t,
+                           const realtype *x, const realtype *p,
+                           const realtype *k, const realtype *h,
+                           const realtype *w) override;
+    void fdxdotdx_explicit_colptrs(SUNMatrixWrapper &dxdotdx) override;
+    void fdxdotdx_explicit_rowvals(SUNMatrixWrapper &dxdotdx) override;
+
+    void fdxdotdp_explicit(realtype *dxdotdp_explicit, realtype t,
+                           const realtype *x, const realtype *p,
+                           const realtype *k, const realtype *h,
+                           const realtype *w) override;
+    void fdxdotdp_explicit_colptrs(SUNMatrixWrapper &dxdotdp) override;
+    void fdxdotdp_explicit_rowvals(SUNMatrixWrapper &dxdotdp) override;
+
+    void fdydx(realtype *dydx, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *w, const realtype *dwdx) override;
+
+    void fdydp(realtype *dydp, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               int ip, const realtype *w, const realtype *tcl,
+               const realtype *dtcldp) override;
+
+    void fdsigmaydy(realtype *dsigmaydy, realtype t, const realtype *p,
+                    const realtype *k, const realtype *y) override;
+
+    void fdsigmaydp(realtype *dsigmaydp, realtype t, const realtype *p,
+                    const realtype *k, const realtype *y, int ip) override;
+
+    void fsigmay(realtype *sigmay, realtype t, const realtype *p,
+                 const realtype *k, const realtype *y) override;
+
+    void fstau(realtype *stau, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *tcl, const realtype *sx, int ip,
+               int ie) override;
+
+    void fdeltax(realtype *deltax, realtype t, const realtype *x,
+                 const realtype *p, const realtype *k, const realtype *h,
+                 int ie, const realtype *xdot,
+                 const realtype *xdot_old) override;
+
+    void fdeltasx(realtype *deltasx, realtype t, const realtype *x,
+                  const realtype *p, const realtype *k, const realtype *h,
+                  const realtype *w, int ip, int ie, const realtype *xdot,
+                  const realtype *xdot_old, const realtype *sx,
+                  const realtype *stau, const realtype *tcl) override;
+
+    void fw(realtype *w, realtype t, const realtype *x, const realtype *p,
+            const realtype *k, const realtype *h,
+            const realtype *tcl) override;
+
+    void fx0(realtype *x0, realtype t, const realtype *p,
+             const realtype *k) override;
+
+    void fx0_fixedParameters(
+        realtype *x0_fixedParameters, realtype t, const realtype *p,
+        const realtype *k,
+        gsl::span<const int> reinitialization_state_idxs) override;
+
+    void fsx0(realtype *sx0, realtype t, const realtype *x,
+              const realtype *p, const realtype *k, int ip) override;
+
+    void fsx0_fixedParameters(
+        realtype *sx0_fixedParameters, realtype t, const realtype *x0,
+        const realtype *p, const realtype *k, int ip,
+        gsl::span<const int> reinitialization_state_idxs) override;
+
+    void fxdot(realtype *xdot, realtype t, const realtype *x,
+               const realtype *p, const realtype *k, const realtype *h,
+               const realtype *w) override;
+
+    void fy(realtype *y, realtype t, const realtype *x, const realtype *p,
+            const realtype *k, const realtype *h,
+            const realtype *w) override;
+
+    void fx_rdata(realtype *x_rdata, const realtype *x, const realtype *tcl,
+                  const realtype *p, const realtype *k) override;
+
+    void fx_solver(realtype *x_solver, const realtype *x_rdata) override;
+
+    void ftotal_cl(realtype *total_cl, const realtype *x_rdata,
+                   const realtype *p, const realtype *k) override;
+
+    void fdtotal_cldp(realtype *dtotal_cldp, const realtype *x_rdata,
+                      const realtype *p, const realtype *k,
+                      int ip) override;
+
+    void fdtotal_cldx_rdata(realtype *dtotal_cldx_rdata,
+                            const realtype *x_rdata, const realtype *p,
+                            const realtype *k, const realtype *tcl) override;
+    void fdtotal_cldx_rdata_colptrs(
+        SUNMatrixWrapper &dtotal_cldx_rdata) override;
+    void fdtotal_cldx_rdata_rowvals(
+        SUNMatrixWrapper &dtotal_cldx_rdata) override;
+
+    void fdx_rdatadx_solver(realtype *dx_rdatadx_solver, const realtype *x,
+                            const realtype *tcl, const realtype *p,
+                            const realtype *k) override;
+    void fdx_rdatadx_solver_colptrs(
+        SUNMatrixWrapper &dxrdatadxsolver) override;
+    void fdx_rdatadx_solver_rowvals(
+        SUNMatrixWrapper &dxrdatadxsolver) override;
+
+    void fdx_rdatadp(realtype *dx_rdatadp, const realtype *x,
+                     const realtype *tcl, const realtype *p,
+                     const realtype *k, int ip) override;
+
+    void fdx_rdatadtcl(realtype *dx_rdatadtcl, const realtype *x,
+                       const realtype *tcl, const realtype *p,
+                       const realtype *k) override;
+    void fdx_rdatadtcl_colptrs(SUNMatrixWrapper &dx_rdatadtcl) override;
+    void fdx_rdatadtcl_rowvals(SUNMatrixWrapper &dx_rdatadtcl) override;
+
+    // event outputs are not supported by python-generated models
+    void fJrz(realtype * /*nllh*/, int /*iz*/, const realtype * /*p*/,
+              const realtype * /*k*/, const realtype * /*rz*/,
+              const realtype * /*sigmaz*/) override {}
+    void fJz(realtype * /*nllh*/, int /*iz*/, const realtype * /*p*/,
+             const realtype * /*k*/, const realtype * /*z*/,
+             const realtype * /*sigmaz*/, const realtype * /*mz*/) override {}
+    void fdJrzdsigma(realtype * /*dJrzdsigma*/, int /*iz*/,
+                     const realtype * /*p*/, const realtype * /*k*/,
+                     const realtype * /*rz*/,
+                     const realtype * /*sigmaz*/) override {}
+    void fdJrzdz(realtype * /*dJrzdz*/, int /*iz*/, const realtype * /*p*/,
+                 const realtype * /*k*/, const realtype * /*rz*/,
+                 const realtype * /*sigmaz*/) override {}
+    void fdJzdsigma(realtype * /*dJzdsigma*/, int /*iz*/,
+                    const realtype * /*p*/, const realtype * /*k*/,
+                    const realtype * /*z*/, const realtype * /*sigmaz*/,
+                    const realtype * /*mz*/) override {}
+    void fdJzdz(realtype * /*dJzdz*/, int /*iz*/, const realtype * /*p*/,
+                const realtype * /*k*/, const realtype * /*z*/,
+                const realtype * /*sigmaz*/,
+                const realtype * /*mz*/) override {}
+    void fdeltaqB(realtype * /*deltaqB*/, realtype /*t*/,
+                  const realtype * /*x*/, const realtype * /*p*/,
+                  const realtype * /*k*/, const realtype * /*h*/,
+                  int /*ip*/, int /*ie*/, const realtype * /*xdot*/,
+                  const realtype * /*xdot_old*/,
+                  const realtype * /*xB*/) override {}
+    void fdeltaxB(realtype * /*deltaxB*/, realtype /*t*/,
+                  const realtype * /*x*/, const realtype * /*p*/,
+                  const realtype * /*k*/, const realtype * /*h*/,
+                  int /*ie*/, const realtype * /*xdot*/,
+                  const realtype * /*xdot_old*/,
+                  const realtype * /*xB*/) override {}
+    void fdrzdp(realtype * /*drzdp*/, int /*ie*/, realtype /*t*/,
+                const realtype * /*x*/, const realtype * /*p*/,
+                const realtype * /*k*/, const realtype * /*h*/,
+                int /*ip*/) override {}
+    void fdrzdx(realtype * /*drzdx*/, int /*ie*/, realtype /*t*/,
+                const realtype * /*x*/, const realtype * /*p*/,
+                const realtype * /*k*/, const realtype * /*h*/) override {}
+    void fdsigmazdp(realtype * /*dsigmazdp*/, realtype /*t*/,
+                    const realtype * /*p*/, const realtype * /*k*/,
+                    int /*ip*/) override {}
+    void fdzdp(realtype * /*dzdp*/, int /*ie*/, realtype /*t*/,
+               const realtype * /*x*/, const realtype * /*p*/,
+               const realtype * /*k*/, const realtype * /*h*/,
+               int /*ip*/) override {}
+    void fdzdx(realtype * /*dzdx*/, int /*ie*/, realtype /*t*/,
+               const realtype * /*x*/, const realtype * /*p*/,
+               const realtype * /*k*/, const realtype * /*h*/) override {}
+    void frz(realtype * /*rz*/, int /*ie*/, realtype /*t*/,
+             const realtype * /*x*/, const realtype * /*p*/,
+             const realtype * /*k*/, const realtype * /*h*/) override {}
+    void fsigmaz(realtype * /*sigmaz*/, realtype /*t*/,
+                 const realtype * /*p*/, const realtype * /*k*/) override {}
+    void fsrz(realtype * /*srz*/, int /*ie*/, realtype /*t*/,
+              const realtype * /*x*/, const realtype * /*p*/,
+              const realtype * /*k*/, const realtype * /*h*/,
+              const realtype * /*sx*/, int /*ip*/) override {}
+    void fsz(realtype * /*sz*/, int /*ie*/, realtype /*t*/,
+             const realtype * /*x*/, const realtype * /*p*/,
+             const realtype * /*k*/, const realtype * /*h*/,
+             const realtype * /*sx*/, int /*ip*/) override {}
+    void fz(realtype * /*z*/, int /*ie*/, realtype /*t*/,
+            const realtype * /*x*/, const realtype * /*p*/,
+            const realtype * /*k*/, const realtype * /*h*/) override {}
+
+    std::string getName() const override;
+    std::vector<std::string> getParameterNames() const override;
+    std::vector<std::string> getStateNames() const override;
+    std::vector<std::string> getStateNamesSolver() const override;
+    std::vector<std::string> getFixedParameterNames() const override;
+    std::vector<std::string> getObservableNames() const override;
+    std::vector<std::string> getExpressionNames() const override;
+    std::vector<std::string> getParameterIds() const override;
+    std::vector<std::string> getStateIds() const override;
+    std::vector<std::string> getStateIdsSolver() const override;
+    std::vector<std::string> getFixedParameterIds() const override;
+    std::vector<std::string> getObservableIds() const override;
+    std::vector<std::string> getExpressionIds() const override;
+    bool isFixedParameterStateReinitializationAllowed() const override;
+    std::string getAmiciVersion() const override;
+    std::string getAmiciCommit() const override;
+    bool hasQuadraticLLH() const override;
+    ObservableScaling getObservableScaling(int iy) const override;
+
+  private:
+    /**
+     * @brief Evaluate the program of a function, if any
+     * @param function model function
+     * @param index function specific case index
+     * @param args inputs and output
+     */
+    void evaluate(bytecode::Function function, int index,
+                  bytecode::Arguments const &args);
+
+    /**
+     * @brief Set column pointers of a sparse function, if any
+     * @param function model function
+     * @param index observable index for `dJydy`, otherwise 0
+     * @param matrix matrix to set the column pointers of
+     */
+    void setColptrs(bytecode::Function function, int index,
+                    SUNMatrixWrapper &matrix) const;
+
+    /**
+     * @brief Set row indices of a sparse function, if any
+     * @param function model function
+     * @param index observable index for `dJydy`, otherwise 0
+     * @param matrix matrix to set the row indices of
+     */
+    void setRowvals(bytecode::Function function, int index,
+                    SUNMatrixWrapper &matrix) const;
+
+    /** bytecode model, shared with clones */
+    std::shared_ptr<const BytecodeModelDefinition> definition_;
+
+    /** interpreter registers */
+    std::vector<realtype> registers_;
+};
+
+/**
+ * @brief Read a bytecode model as written by amici.bytecode
+ * @param stream input
+ * @return bytecode model
+ */
+std::shared_ptr<const BytecodeModelDefinition>
+readBytecodeModel(std::istream &stream);
+
+/**
+ * @brief Load a bytecode model from file
+ * @param filename bytecode file, usually `<model_name>.amici_bytecode`
+ * @return model instance
+ */
+std::unique_ptr<Model> loadBytecodeModel(std::string const &filename);
+
+} // namespace amici
+
+#endif // AMICI_MODEL_ODE_BYTECODE_H
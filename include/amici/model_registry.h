@@ -0,0 +1,246 @@
+#ifndef AMICI_MODEL_REGISTRY_H
+#define AMICI_MODEL_REGISTRY_H
+
+#include "amici/model.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#define AMICI_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define AMICI_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/**
+ * @brief Define the entry point of a model plugin library.
+ *
+ * Must be used exactly once per plugin library, see
+ * amici::ModelRegistry. Model libraries generated by AMICI are built as
+ * plugins with the CMake option `BUILD_MODEL_PLUGIN`.
+ *
+ * @param NAME model name (string literal)
+ * @param VERSION model version (string literal, may be empty)
+ * @param FACTORY function returning a `std::unique_ptr<amici::Model>`, e.g.
+ * `amici::generic_model::getModel`
+ */
+#define AMICI_MODEL_PLUGIN(NAME, VERSION, FACTORY)                            \
+    extern "C" AMICI_PLUGIN_EXPORT amici::ModelPluginInfo const *              \
+    amici_model_plugin() {                                                     \
+        static amici::ModelPluginInfo const info{                              \
+            amici::model_plugin_api_version, NAME, VERSION,                    \
+            []() -> amici::Model * { return FACTORY().release(); }};           \
+        return &info;                                                          \
+    }
+
+namespace amici {
+
+/** Version of ModelPluginInfo, incremented on incompatible changes */
+constexpr int model_plugin_api_version = 1;
+
+/** Name of the entry point function defined by AMICI_MODEL_PLUGIN */
+constexpr char const *model_plugin_symbol = "amici_model_plugin";
+
+/**
+ * @brief Description of a model plugin, returned by the entry point of the
+ * plugin library.
+ */
+struct ModelPluginInfo {
+    /** model_plugin_api_version the plugin was built with */
+    int api_version;
+    /** model name */
+    char const *name;
+    /** model version, may be empty */
+    char const *version;
+    /** create a new model instance, owned by the caller */
+    Model *(*create)();
+};
+
+/**
+ * @brief A loaded model plugin library.
+ *
+ * The library is unloaded when the ModelPlugin is destroyed. Model
+ * instances created by the plugin, and anything obtained from them such as
+ * clones or solvers, must be destroyed before.
+ */
+class ModelPlugin {
+  public:
+    /**
+     * @brief Load a plugin library.
+     * @param path path of the shared library
+     */
+    explicit ModelPlugin(std::string path);
+
+    ~ModelPlugin();
+
+    ModelPlugin(ModelPlugin const &) = delete;
+    ModelPlugin &operator=(ModelPlugin const &) = delete;
+
+    /**
+     * @brief Get the model name.
+     * @return name
+     */
+    std::string getName() const { return info_->name; }
+
+    /**
+     * @brief Get the model version.
+     * @return version, empty if the plugin is not versioned
+     */
+    std::string getVersion() const { return info_->version; }
+
+    /**
+     * @brief Get the path of the plugin library.
+     * @return path
+     */
+    std::string const &getPath() const { return path_; }
+
+    /**
+     * @brief Create a new model instance.
+     * @return model, which must not outlive this plugin
+     */
+    std::unique_ptr<Model> create() const;
+
+  private:
+    /** path of the library */
+    std::string path_;
+
+    /** handle returned by dlopen */
+    void *handle_{nullptr};
+
+    /** plugin description, owned by the library */
+    ModelPluginInfo const *info_{nullptr};
+};
+
+/**
+ * @brief Registry of model plugin libraries that are loaded on demand.
+ *
+ * Plugins are looked up by model name and version in a list of search
+ * directories. For each directory `dir`, the library of a versioned model is
+ * expected at `dir/<name>/<version>/lib<name>.so`, and of an unversioned
+ * model (empty version) at `dir/lib<name>.so` (`.dll` and no `lib` prefix on
+ * Windows). The name and version reported by the plugin have to match.
+ *
+ * Loaded plugins stay loaded until they are explicitly unloaded, which is
+ * only possible while no model instances created by them exist.
+ *
+ * Plugins built against a static libamici do not contain AMICI itself, but
+ * use the AMICI symbols of the application, which therefore has to contain
+ * all of libamici and export its symbols (see
+ * `amici_provide_symbols_to_plugins` in AMICI's CMakeLists.txt). With a
+ * shared libamici, plugins link against the same library as the
+ * application.
+ *
+ * All member functions are thread-safe.
+ */
+class ModelRegistry {
+  public:
+    /**
+     * @brief Constructor.
+     * @param search_paths directories to search for plugin libraries, in
+     * order
+     */
+    explicit ModelRegistry(std::vector<std::string> search_paths = {});
+
+    /**
+     * @brief Append a directory to the search paths.
+     * @param path directory
+     */
+    void addSearchPath(std::string const &path);
+
+    /**
+     * @brief Load a plugin from the search paths, unless already loaded.
+     * @param name model name
+     * @param version model version, empty for unversioned models
+     * @return plugin
+     */
+    std::shared_ptr<ModelPlugin const> load(std::string const &name,
+                                            std::string const &version = "");
+
+    /**
+     * @brief Load a plugin library from an explicit path and register it
+     * under the name and version it reports.
+     *
+     * Fails if a different library with the same name and version is already
+     * loaded.
+     *
+     * @param path path of the shared library
+     * @return plugin
+     */
+    std::shared_ptr<ModelPlugin const> loadLibrary(std::string const &path);
+
+    /**
+     * @brief Create a model instance, loading the plugin if necessary.
+     *
+     * The returned model keeps the plugin loaded until it is destroyed.
+     * Clones and solvers obtained from it must be destroyed before the
+     * model.
+     *
+     * @param name model name
+     * @param version model version, empty for unversioned models
+     * @return model
+     */
+    std::shared_ptr<Model> createModel(std::string const &name,
+                                       std::string const &version = "");
+
+    /**
+     * @brief Check whether a plugin is loaded.
+     * @param name model name
+     * @param version model version
+     * @return true if loaded
+     */
+    bool isLoaded(std::string const &name,
+                  std::string const &version = "") const;
+
+    /**
+     * @brief Get name and version of all loaded plugins.
+     * @return name and version pairs, sorted
+     */
+    std::vector<std::pair<std::string, std::string>> getLoadedModels() const;
+
+    /**
+     * @brief Unload a plugin if it is not in use, i.e. if there are no model
+     * instances created by it and no other references to it.
+     * @param name model name
+     * @param version model version
+     * @return true if the plugin was unloaded, false if it is in use or was
+     * not loaded
+     */
+    bool unload(std::string const &name, std::string const &version = "");
+
+    /**
+     * @brief Unload all plugins that are not in use.
+     * @return number of unloaded plugins
+     */
+    int unloadUnused();
+
+    /**
+     * @brief Get the path where a plugin library is expected.
+     * @param directory search directory
+     * @param name model name
+     * @param version model version, empty for unversioned models
+     * @return path
+     */
+    static std::string getLibraryPath(std::string const &directory,
+                                      std::string const &name,
+                                      std::string const &version = "");
+
+  private:
+    /** protects all members */
+    mutable std::mutex mutex_;
+
+    /** directories to search for plugin libraries */
+    std::vector<std::string> search_paths_;
+
+    /** loaded plugins by name and version */
+    std::map<std::pair<std::string, std::string>,
+             std::shared_ptr<ModelPlugin const>>
+        plugins_;
+};
+
+} // namespace amici
+
+#endif // AMICI_MODEL_REGISTRY_H
@@ -51,16 +51,25 @@ struct ModelState {
  * `amici::ModelState` for a specific timepoint.
  *
  * Serves as workspace for a model simulation to avoid repeated reallocation.
+ * Workspaces that are only required for sensitivity analysis, adjoint
+ * simulations or DAEs are allocated by `amici::Model` on first use.
  */
 struct ModelStateDerived {
     ModelStateDerived() = default;
 
     /**
-     * @brief Constructor from model dimensions.
+     * @brief Constructor from model dimensions. Allocates the workspaces
+     * required for any simulation.
      * @param dim Model dimensions
      */
     explicit ModelStateDerived(ModelDimensions const& dim);
 
+    /**
+     * @brief Get the memory currently allocated for all workspaces.
+     * @return Size in bytes
+     */
+    std::size_t getMemoryUsage() const;
+
     /** Sparse Jacobian (dimension: `amici::Model::nnz`) */
     SUNMatrixWrapper J_;
 
@@ -76,6 +85,21 @@ struct ModelStateDerived {
     /** Sparse dwdp temporary storage (dimension: `ndwdp`) */
     SUNMatrixWrapper dwdp_;
 
+    /** Sparse dwdw temporary storage (dimension: `ndwdw`), Python only */
+    SUNMatrixWrapper dwdw_;
+
+    /**
+     * Sparse dwdx implicit temporary storage per recursion level of fw,
+     * Python only (dimension: `ndwdx`)
+     */
+    std::vector<SUNMatrixWrapper> dwdx_hierarchical_;
+
+    /**
+     * Sparse dwdp implicit temporary storage per recursion level of fw,
+     * Python only (dimension: `ndwdp`)
+     */
+    std::vector<SUNMatrixWrapper> dwdp_hierarchical_;
+
     /** Dense Mass matrix (dimension: `nx_solver` x `nx_solver`) */
     SUNMatrixWrapper M_;
 
@@ -247,6 +271,10 @@ struct ModelStateDerived {
     /** data standard deviation for current timepoint (dimension: ny) */
     std::vector<realtype> sigmay_;
 
+    /** observed data for current timepoint, only used for sparse ExpData
+     * (dimension: nytrue) */
+    std::vector<realtype> my_;
+
     /** temporary storage for parameter derivative of data standard deviation,
      * (dimension: ny x nplist, row-major)
      */
@@ -0,0 +1,93 @@
+#ifndef AMICI_MPI_H
+#define AMICI_MPI_H
+
+#include "amici/defines.h"
+
+#include <memory>
+#include <vector>
+
+#include <mpi.h>
+
+namespace amici {
+
+class ReturnData;
+class ExpData;
+class Model;
+class Solver;
+
+namespace mpi {
+
+/* Functions for distributing multi-condition simulations over MPI ranks. */
+
+/**
+ * @brief Results of a distributed multi-condition simulation, summed over
+ * all conditions.
+ */
+struct ReducedResults {
+    /** sum of log-likelihoods of all conditions */
+    realtype llh {0.0};
+
+    /** sum of chi2 values of all conditions */
+    realtype chi2 {0.0};
+
+    /**
+     * sum of log-likelihood gradients (dimension: nplist), empty if no
+     * sensitivities were computed
+     */
+    std::vector<realtype> sllh;
+
+    /**
+     * sum of Fisher information matrices (dimension: nplist x nplist,
+     * row-major), empty if not computed
+     */
+    std::vector<realtype> FIM;
+
+    /** number of simulations that did not finish with AMICI_SUCCESS */
+    int num_failed {0};
+
+    /**
+     * results of all conditions in the order of the input, only set on the
+     * root rank and only if requested
+     */
+    std::vector<std::unique_ptr<ReturnData>> rdatas;
+};
+
+/**
+ * @brief Same as amici::runAmiciSimulations, but distributes the conditions
+ * across all ranks of the given communicator.
+ *
+ * The conditions provided on the root rank are split into contiguous blocks
+ * of (almost) equal size and scattered to all ranks, where they are simulated
+ * with amici::runAmiciSimulations. `llh`, `chi2`, `sllh` and `FIM` are summed
+ * over all conditions and the sums are available on all ranks.
+ *
+ * This is a collective operation: it has to be called on all ranks of `comm`,
+ * with equivalent `solver` and `model` and the same `gather_rdatas` and
+ * `root`. Experimental data is only read on the root rank.
+ *
+ * Requires boost::serialization, which is used for transferring ExpData and
+ * ReturnData between ranks.
+ *
+ * @param solver Solver instance
+ * @param edatas experimental data objects, only significant on `root`
+ * @param model model specification object
+ * @param comm communicator over which to distribute the simulations
+ * @param gather_rdatas whether to gather all ReturnData on `root`
+ * @param failfast flag to allow early termination, only applies to the
+ * conditions of the respective rank
+ * @param num_threads number of threads per rank
+ * @param root rank that provides the experimental data and receives the
+ * ReturnData
+ * @return summed results
+ */
+ReducedResults runAmiciSimulations(Solver const &solver,
+                                   std::vector<ExpData *> const &edatas,
+                                   Model const &model, MPI_Comm comm,
+                                   bool gather_rdatas = false,
+                                   bool failfast = false, int num_threads = 1,
+                                   int root = 0);
+
+} // namespace mpi
+} // namespace amici
+
+#endif // AMICI_MPI_H
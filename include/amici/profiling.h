@@ -0,0 +1,205 @@
+#ifndef AMICI_PROFILING_H
+#define AMICI_PROFILING_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <sundials/sundials_linearsolver.h>
+
+namespace amici {
+
+/**
+ * @brief Model functions and simulation phases with call count and time
+ * instrumentation.
+ *
+ * Times are inclusive, e.g. `fxdot` includes the time spent in `fw` when
+ * called from there, and the phases include all functions called within.
+ */
+enum class ProfiledFunction {
+    // model functions
+    fx0,
+    fsx0,
+    fxdot,
+    fJ,
+    fJSparse,
+    fJv,
+    fJDiag,
+    fJB,
+    fJSparseB,
+    fJvB,
+    froot,
+    fw,
+    fdwdp,
+    fdwdx,
+    fdxdotdw,
+    fdxdotdp,
+    fsxdot,
+    fxBdot,
+    fqBdot,
+    fy,
+    fdydp,
+    fdydx,
+    fsigmay,
+    fdsigmaydp,
+    fdJydy,
+    fdJydsigma,
+    fz,
+    frz,
+    fdzdp,
+    fdzdx,
+    fsigmaz,
+    fdJzdz,
+    fdJrzdz,
+    fdeltax,
+    fdeltasx,
+    fdeltaxB,
+    fdeltaqB,
+    fstau,
+    // simulation phases
+    preequilibration,
+    forward,
+    postequilibration,
+    backward,
+    steadystateBackward,
+    newtonsMethod,
+    steadystateSimulation,
+    events,
+    dataPoints,
+    linearSolverSetup,
+    linearSolverSolve,
+    /** number of entries, not a function */
+    count
+};
+
+/**
+ * @brief Get the name of a profiled function or phase
+ * @param function profiled function
+ * @return name
+ */
+char const *getProfiledFunctionName(ProfiledFunction function);
+
+/**
+ * @brief Get the names of all profiled functions and phases, in the order of
+ * ReturnData::profile_calls and ReturnData::profile_time
+ * @return names
+ */
+std::vector<std::string> getProfiledFunctionNames();
+
+/**
+ * @brief Call counts and accumulated wall time per ProfiledFunction for a
+ * single simulation.
+ */
+class Profile {
+  public:
+    /** clock used for timing */
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Record a call
+     * @param function profiled function
+     * @param duration duration of the call
+     */
+    void add(ProfiledFunction function, clock::duration duration) {
+        auto i = static_cast<int>(function);
+        ++calls_[i];
+        time_[i] += duration;
+    }
+
+    /**
+     * @brief Number of calls per function
+     * @return call counts, indexed by ProfiledFunction
+     */
+    std::vector<int> getCalls() const;
+
+    /**
+     * @brief Accumulated time per function
+     * @return time in milliseconds, indexed by ProfiledFunction
+     */
+    std::vector<double> getTime() const;
+
+  private:
+    static constexpr int n_ = static_cast<int>(ProfiledFunction::count);
+    std::array<int, n_> calls_ {};
+    std::array<clock::duration, n_> time_ {};
+};
+
+/**
+ * @brief Profile that receives the timings of the current thread, nullptr if
+ * profiling is disabled. Set via ProfileContext.
+ * @return profile
+ */
+Profile *getCurrentProfile();
+
+/**
+ * @brief RAII guard that activates a Profile for the current thread and
+ * restores the previous one when going out of scope.
+ */
+class ProfileContext {
+  public:
+    /**
+     * @brief Constructor
+     * @param profile profile to activate, nullptr to disable profiling
+     */
+    explicit ProfileContext(Profile *profile);
+
+    ~ProfileContext();
+
+    ProfileContext(ProfileContext const &) = delete;
+    ProfileContext &operator=(ProfileContext const &) = delete;
+
+  private:
+    Profile *previous_;
+};
+
+/**
+ * @brief RAII timer adding the duration of its scope to the current profile,
+ * use via AMICI_PROFILE_SCOPE.
+ */
+class ProfileScope {
+  public:
+    /**
+     * @brief Start timing if profiling is active on the current thread
+     * @param function profiled function
+     */
+    explicit ProfileScope(ProfiledFunction function)
+        : profile_(getCurrentProfile()), function_(function) {
+        if (profile_)
+            start_ = Profile::clock::now();
+    }
+
+    ~ProfileScope() {
+        if (profile_)
+            profile_->add(function_, Profile::clock::now() - start_);
+    }
+
+    ProfileScope(ProfileScope const &) = delete;
+    ProfileScope &operator=(ProfileScope const &) = delete;
+
+  private:
+    Profile *profile_;
+    ProfiledFunction function_;
+    Profile::clock::time_point start_;
+};
+
+/**
+ * @brief Add timing of setup and solve calls of the given linear solver to
+ * the current profile (if compiled with AMICI_PROFILING) and record setups
+ * in the active TraceRecorder.
+ * @param linsol linear solver
+ */
+void instrumentLinearSolver(SUNLinearSolver linsol);
+
+} // namespace amici
+
+#ifdef AMICI_PROFILING
+/** Time the enclosing scope as amici::ProfiledFunction::`function` */
+#define AMICI_PROFILE_SCOPE(function)                                          \
+    amici::ProfileScope amici_profile_scope_(                                  \
+        amici::ProfiledFunction::function)
+#else
+#define AMICI_PROFILE_SCOPE(function)
+#endif
+
+#endif // AMICI_PROFILING_H
@@ -6,6 +6,10 @@
 #include "amici/model.h"
 #include "amici/misc.h"
 #include "amici/forwardproblem.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace amici {
@@ -55,6 +59,9 @@ class ReturnData: public ModelDimensions {
      * computing res, sres and FIM makes sense
      * @param sigma_res indicates whether additional residuals are to be added for each sigma
      * @param sigma_offset offset to ensure real-valuedness of sigma residuals
+     * @param rdata_fields see amici::Solver::setReturnDataFields
+     * @param trajectory_its see
+     * amici::Solver::setReturnDataTrajectoryTimepoints
      */
     ReturnData(std::vector<realtype> ts,
                ModelDimensions const& model_dimensions,
@@ -63,7 +70,9 @@ class ReturnData: public ModelDimensions {
                std::vector<ParameterScaling> pscale, SecondOrderMode o2mode,
                SensitivityOrder sensi, SensitivityMethod sensi_meth,
                RDataReporting rdrm, bool quadratic_llh, bool sigma_res,
-               realtype sigma_offset);
+               realtype sigma_offset,
+               int rdata_fields = static_cast<int>(RDataField::all),
+               std::vector<int> const &trajectory_its = std::vector<int>());
 
     /**
      * @brief constructor that uses information from model and solver to
@@ -219,15 +228,48 @@ class ReturnData: public ModelDimensions {
     /** employed order forward problem (shape `nt`) */
     std::vector<int> order;
 
-    /** computation time of forward solve [ms] */
+    /**
+     * CPU time of forward solve [ms]. All `cpu_time*` fields measure the CPU
+     * time of the simulating thread, so they are not affected by concurrent
+     * simulations and, together with the corresponding `wall_time*` fields,
+     * can serve as cost estimates when scheduling further simulations.
+     */
     double cpu_time = 0.0;
 
-    /** computation time of backward solve [ms] */
+    /** CPU time of backward solve [ms] */
     double cpu_timeB = 0.0;
 
     /** total CPU time from entering runAmiciSimulation until exiting [ms] */
     double cpu_time_total = 0.0;
 
+    /** wall time of forward solve [ms] */
+    double wall_time = 0.0;
+
+    /** wall time of backward solve [ms] */
+    double wall_timeB = 0.0;
+
+    /** total wall time from entering runAmiciSimulation until exiting [ms] */
+    double wall_time_total = 0.0;
+
+    /**
+     * memory allocated for the model workspace at the end of the simulation
+     * [bytes], see Model::getWorkspaceMemoryUsage
+     */
+    long long model_workspace_bytes = 0;
+
+    /**
+     * number of calls per model function and simulation phase, indexed by
+     * amici::ProfiledFunction, see amici::getProfiledFunctionNames (only set
+     * if Solver::getProfiling and AMICI was built with ENABLE_PROFILING)
+     */
+    std::vector<int> profile_calls;
+
+    /**
+     * wall time per model function and simulation phase [ms], inclusive of
+     * nested calls (shape as `profile_calls`)
+     */
+    std::vector<realtype> profile_time;
+
     /** flags indicating success of steady state solver (preequilibration) */
     std::vector<SteadyStateStatus> preeq_status;
 
@@ -238,6 +280,13 @@ class ReturnData: public ModelDimensions {
      *  (preequilibration) */
     double preeq_cpu_timeB = 0.0;
 
+    /** wall time of the steady state solver [ms] (preequilibration) */
+    double preeq_wall_time = 0.0;
+
+    /** wall time of the steady state solver of the backward problem [ms]
+     *  (preequilibration) */
+    double preeq_wall_timeB = 0.0;
+
     /** flags indicating success of steady state solver  (postequilibration) */
     std::vector<SteadyStateStatus> posteq_status;
 
@@ -248,6 +297,13 @@ class ReturnData: public ModelDimensions {
      *  (postequilibration) */
     double posteq_cpu_timeB = 0.0;
 
+    /** wall time of the steady state solver [ms] (postequilibration) */
+    double posteq_wall_time = 0.0;
+
+    /** wall time of the steady state solver of the backward problem [ms]
+     *  (postequilibration) */
+    double posteq_wall_timeB = 0.0;
+
     /**
      * number of Newton steps for steady state problem (preequilibration)
      * [newton, simulation, newton] (length = 3)
@@ -363,6 +419,26 @@ class ReturnData: public ModelDimensions {
     /** reporting mode */
     RDataReporting rdata_reporting{RDataReporting::full};
 
+    /** mask of reported fields, see amici::RDataField */
+    int rdata_fields{static_cast<int>(RDataField::all)};
+
+    /**
+     * indices of the timepoints at which `x`, `sx` and `w` are reported, in
+     * ascending order, empty if reported at all timepoints (see
+     * amici::Solver::setReturnDataTrajectoryTimepoints)
+     */
+    std::vector<int> trajectory_its;
+
+    /**
+     * @brief number of timepoints at which `x`, `sx` and `w` are reported,
+     * i.e. their leading dimension
+     * @return number of timepoints
+     */
+    int ntTrajectory() const {
+        return trajectory_its.empty() ? nt
+                                      : static_cast<int>(trajectory_its.size());
+    }
+
     /**
      * @brief Serialize ReturnData (see boost::serialization::serialize)
      * @param ar Archive to serialize to
@@ -405,6 +481,60 @@ class ReturnData: public ModelDimensions {
      * (shape `ne`) */
     std::vector<int> nroots_;
 
+    /** observable buffer for a single timepoint (shape `ny`) */
+    std::vector<realtype> y_it_;
+
+    /** observable standard deviation buffer for a single timepoint
+     * (shape `ny`) */
+    std::vector<realtype> sigmay_it_;
+
+    /** observed data buffer for a single timepoint, only used for sparse
+     * ExpData (shape `nytrue`) */
+    std::vector<realtype> my_it_;
+
+    /** observable sensitivity buffer for a single timepoint
+     * (shape `nplist` x `ny`, row-major) */
+    std::vector<realtype> sy_it_;
+
+    /** observable standard deviation sensitivity buffer for a single
+     * timepoint (shape `nplist` x `ny`, row-major) */
+    std::vector<realtype> ssigmay_it_;
+
+    /** residual sensitivity buffer for a single timepoint, only used to
+     * compute the FIM if `sres` is not reported
+     * (shape `nytrue` x `nplist`, twice that if `sigma_res`, row-major) */
+    std::vector<realtype> sres_it_;
+
+    /** row of `x`, `sx` and `w` for each timepoint, -1 if not reported,
+     * empty if reported at all timepoints (dimension: nt) */
+    std::vector<int> trajectory_rows_;
+
+    /**
+     * @brief allocates a field if it was selected in rdata_fields
+     * @param field field
+     * @param vec storage of the field
+     * @param size number of elements
+     * @param value initial value
+     */
+    void allocateField(RDataField field, std::vector<realtype> &vec,
+                       std::size_t size, realtype value);
+
+    /**
+     * @brief restricts state trajectory reporting to the given timepoints
+     * @param trajectory_its timepoint indices, empty for all timepoints
+     */
+    void applyTrajectoryTimepoints(std::vector<int> const &trajectory_its);
+
+    /**
+     * @brief row of the state trajectories for a timepoint
+     * @param it timepoint index
+     * @return row of `x`, `sx` and `w` to be written at `it`, -1 if not
+     * reported
+     */
+    int trajectoryRow(int it) const {
+        return trajectory_rows_.empty() ? it : trajectory_rows_[it];
+    }
+
     /**
      * @brief initializes storage for likelihood reporting mode
      * @param quadratic_llh whether model defines a quadratic nllh and computing res, sres and FIM
@@ -513,7 +643,8 @@ class ReturnData: public ModelDimensions {
     void readSimulationState(SimulationState const &state, Model &model);
 
     /**
-     * @brief Residual function
+     * @brief Residual function, expects that y_it_ and sigmay_it_ were set
+     * for the given timepoint
      * @param it time index
      * @param model model that was used for forward/backward simulation
      * @param edata ExpData instance containing observable data
@@ -528,7 +659,8 @@ class ReturnData: public ModelDimensions {
     void fchi2(int it, const ExpData &edata);
 
     /**
-     * @brief Residual sensitivity function
+     * @brief Residual sensitivity function, expects that y_it_, sigmay_it_,
+     * sy_it_ and ssigmay_it_ were set for the given timepoint
      * @param it time index
      * @param model model that was used for forward/backward simulation
      * @param edata ExpData instance containing observable data
@@ -536,13 +668,37 @@ class ReturnData: public ModelDimensions {
     void fsres(int it, Model &model, const ExpData &edata);
 
     /**
-     * @brief Fisher information matrix function
+     * @brief Evaluates residual sensitivities for a single timepoint from
+     * y_it_, sigmay_it_, sy_it_ and ssigmay_it_
+     * @param it time index
+     * @param model model that was used for forward/backward simulation
+     * @param edata ExpData instance containing observable data
+     * @param sres_it residual sensitivities
+     * (shape `nytrue` x `nplist`, row-major)
+     * @param sres_error_it sigma residual sensitivities
+     * (shape `nytrue` x `nplist`, row-major), only written if `sigma_res`
+     * @param compact if true, the sensitivities of the k-th measured
+     * observable are written to row k instead of the row of the observable
+     */
+    void fsres(int it, Model &model, const ExpData &edata,
+               gsl::span<realtype> sres_it, gsl::span<realtype> sres_error_it,
+               bool compact = false);
+
+    /**
+     * @brief Fisher information matrix function, accumulates the
+     * contribution of the residual sensitivities at the given timepoint to
+     * the upper triangle of `FIM` (see symmetrizeFIM)
      * @param it time index
      * @param model model that was used for forward/backward simulation
      * @param edata ExpData instance containing observable data
      */
     void fFIM(int it, Model &model, const ExpData &edata);
 
+    /**
+     * @brief Fills the lower triangle of `FIM` from its upper triangle
+     */
+    void symmetrizeFIM();
+
     /**
      * @brief Set likelihood, state variables, outputs and respective
      * sensitivities to NaN (typically after integration failure)
@@ -645,6 +801,164 @@ class ReturnData: public ModelDimensions {
                           AmiVector &xB) const;
 };
 
+/**
+ * @brief Receives the results of runAmiciSimulations as soon as the
+ * individual simulations have finished, e.g. to write them to disk without
+ * keeping all of them in memory.
+ */
+class ReturnDataConsumer {
+  public:
+    virtual ~ReturnDataConsumer() = default;
+
+    /**
+     * @brief Takes over the result of a single simulation. Called
+     * concurrently from all simulation threads.
+     * @param index index of the simulation in the list of conditions
+     * @param rdata simulation result
+     */
+    virtual void consume(int index, std::unique_ptr<ReturnData> rdata) = 0;
+};
+
+/**
+ * @brief Stores the results of a batch of simulations in a single
+ * allocation.
+ *
+ * The non-empty array fields of the first result (see getFieldNames()),
+ * together with `llh` and `chi2`, determine the layout of the storage. Each
+ * field is stored contiguously for all simulations, i.e. the values of
+ * field `f` of simulation `i` start at `getFieldOffset(f) + i *
+ * getFieldSize(f)`. All results of a batch must have the same field sizes.
+ * reset() keeps the allocated storage, so that it can be reused for further
+ * batches without allocating again. Storage that is still shared via
+ * getStorage(), e.g. by numpy arrays of a previous batch, is not reused but
+ * left to its other owners.
+ */
+class ReturnDataArena : public ReturnDataConsumer {
+  public:
+    /**
+     * @brief Constructor
+     * @param num_simulations number of simulations of the first batch
+     */
+    explicit ReturnDataArena(int num_simulations = 0);
+
+    /**
+     * @brief Prepares the arena for a new batch of simulations, keeping the
+     * allocated storage unless it is shared
+     * @param num_simulations number of simulations
+     */
+    void reset(int num_simulations);
+
+    /**
+     * @brief Copies the fields of a single result into the arena. Called
+     * concurrently from all simulation threads.
+     * @param index index of the simulation in the batch
+     * @param rdata simulation result
+     */
+    void consume(int index, std::unique_ptr<ReturnData> rdata) override;
+
+    /**
+     * @brief Number of simulations of the current batch
+     * @return number of simulations
+     */
+    int getNumSimulations() const { return num_simulations_; }
+
+    /**
+     * @brief Names of the stored fields, empty before the first result was
+     * consumed
+     * @return field names
+     */
+    std::vector<std::string> getFieldNames() const;
+
+    /**
+     * @brief Offset of a field in the storage
+     * @param field field name
+     * @return offset of the field of the first simulation
+     */
+    int getFieldOffset(std::string const &field) const;
+
+    /**
+     * @brief Number of elements of a field per simulation
+     * @param field field name
+     * @return number of elements
+     */
+    int getFieldSize(std::string const &field) const;
+
+    /**
+     * @brief Row-major shape of a field of a single simulation
+     * @param field field name
+     * @return shape, empty for scalars
+     */
+    std::vector<int> const &getFieldShape(std::string const &field) const;
+
+    /**
+     * @brief Storage of all fields, see getFieldOffset() for the layout
+     * @return storage
+     */
+    std::vector<realtype> &getData() { return *data_; }
+
+    /**
+     * @brief Shared ownership of the storage of the current batch, which
+     * keeps it valid after the arena was reset or destroyed
+     * @return storage
+     */
+    std::shared_ptr<std::vector<realtype>> getStorage() const {
+        return data_;
+    }
+
+    /**
+     * @brief Simulation status of all simulations of the batch
+     * @return status, see ReturnData::status, AMICI_ERROR for simulations
+     * that were not consumed yet
+     */
+    std::vector<int> const &getStatus() const { return status_; }
+
+  private:
+    /** layout of a field */
+    struct Field {
+        /** field name */
+        std::string name;
+        /** ReturnData member, nullptr for scalars */
+        std::vector<realtype> ReturnData::*vector;
+        /** ReturnData member for scalars */
+        realtype ReturnData::*scalar;
+        /** row-major shape of the field of a single simulation */
+        std::vector<int> shape;
+        /** number of elements per simulation */
+        std::size_t size;
+        /** offset of the field of the first simulation */
+        std::size_t offset;
+    };
+
+    /**
+     * @brief Determines the layout of the fields from the first result and
+     * prepares the storage
+     * @param rdata first result of the batch
+     */
+    void initializeLayout(ReturnData const &rdata);
+
+    /**
+     * @brief Looks up a field by name
+     * @param field field name
+     * @return field layout
+     */
+    Field const &getField(std::string const &field) const;
+
+    /** number of simulations of the current batch */
+    int num_simulations_{0};
+
+    /** layout of the stored fields, empty until the first result */
+    std::vector<Field> fields_;
+
+    /** storage of all fields */
+    std::shared_ptr<std::vector<realtype>> data_;
+
+    /** status of all simulations */
+    std::vector<int> status_;
+
+    /** protects the initialization of the layout */
+    std::mutex mutex_;
+};
+
 /**
  * @brief The ModelContext temporarily stores amici::Model::state
  * and restores it when going out of scope
@@ -2,10 +2,12 @@
 #define AMICI_SERIALIZATION_H
 
 #include "amici/rdata.h"
+#include "amici/edata.h"
 #include "amici/model.h"
 #include "amici/solver.h"
 #include "amici/solver_cvodes.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -13,6 +15,7 @@
 
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
@@ -22,6 +25,16 @@
 
 /** @file serialization.h Helper functions and forward declarations for
  * boost::serialization */
+
+// Bump the class version whenever members are added to the respective
+// serialize function below, and only archive the new members for
+// `version >= ` the new class version, so older archives remain readable.
+BOOST_CLASS_VERSION(amici::Solver, 3)
+BOOST_CLASS_VERSION(amici::Model, 1)
+BOOST_CLASS_VERSION(amici::SimulationParameters, 1)
+BOOST_CLASS_VERSION(amici::ExpData, 1)
+BOOST_CLASS_VERSION(amici::ReturnData, 5)
+
 namespace boost {
 namespace serialization {
 
@@ -52,7 +65,7 @@ void archiveVector(Archive &ar, T **p, int size) {
  * @param s Solver instance to serialize
  */
 template <class Archive>
-void serialize(Archive &ar, amici::Solver &s, const unsigned int /*version*/) {
+void serialize(Archive &ar, amici::Solver &s, const unsigned int version) {
     ar &s.sensi_;
     ar &s.atol_;
     ar &s.rtol_;
@@ -87,6 +100,20 @@ void serialize(Archive &ar, amici::Solver &s, const unsigned int /*version*/) {
     ar &s.check_sensi_steadystate_conv_;
     ar &s.rdata_mode_;
     ar &s.maxtime_;
+
+    if (version >= 1) {
+        ar &s.profiling_;
+    }
+
+    if (version >= 2) {
+        ar &s.wall_time_;
+        ar &s.wall_timeB_;
+    }
+
+    if (version >= 3) {
+        ar &s.rdata_fields_;
+        ar &s.rdata_trajectory_its_;
+    }
 }
 
 /**
@@ -122,12 +149,14 @@ void serialize(Archive &ar, amici::CVodeSolver &s, const unsigned int /*version*
  * @param m Model instance to serialize
  */
 template <class Archive>
-void serialize(Archive &ar, amici::Model &m, const unsigned int /*version*/) {
+void serialize(Archive &ar, amici::Model &m, const unsigned int version) {
     ar &dynamic_cast<amici::ModelDimensions&>(m);
     ar &m.simulation_parameters_;
     ar &m.o2mode;
-    ar &m.z2event_;
-    ar &m.idlist;
+    auto z2event = m.definition_->z2event;
+    auto idlist = m.definition_->idlist;
+    ar &z2event;
+    ar &idlist;
     ar &m.state_.h;
     ar &m.state_.unscaledParameters;
     ar &m.state_.fixedParameters;
@@ -139,6 +168,23 @@ void serialize(Archive &ar, amici::Model &m, const unsigned int /*version*/) {
     ar &m.pythonGenerated;
     ar &m.min_sigma_;
     ar &m.sigma_res_;
+
+    if (version >= 1) {
+        ar &m.steadystate_sensitivity_mode_;
+        ar &m.always_check_finite_;
+    }
+
+    if (Archive::is_loading::value) {
+        auto definition = std::make_shared<amici::ModelDefinition>(
+            *m.definition_);
+        definition->z2event = std::move(z2event);
+        definition->idlist = std::move(idlist);
+        m.definition_ = std::move(definition);
+        m.any_state_non_negative_ =
+            std::any_of(m.state_is_non_negative_.begin(),
+                        m.state_is_non_negative_.end(),
+                        [](bool x) { return x; });
+    }
 }
 
 
@@ -148,7 +194,7 @@ void serialize(Archive &ar, amici::Model &m, const unsigned int /*version*/) {
  * @param s amici::SimulationParameters instance to serialize
  */
 template <class Archive>
-void serialize(Archive &ar, amici::SimulationParameters &s, const unsigned int /*version*/) {
+void serialize(Archive &ar, amici::SimulationParameters &s, const unsigned int version) {
     ar &s.fixedParameters;
     ar &s.fixedParametersPreequilibration;
     ar &s.fixedParametersPresimulation;
@@ -161,6 +207,57 @@ void serialize(Archive &ar, amici::SimulationParameters &s, const unsigned int /
     ar &s.tstart_;
     ar &s.t_presim;
     ar &s.reinitializeFixedParameterInitialStates;
+
+    if (version >= 1) {
+        ar &s.reinitialization_state_idxs_presim;
+        ar &s.reinitialization_state_idxs_sim;
+    }
+}
+
+/**
+ * @brief Serialize amici::ExpData to boost archive
+ * @param ar Archive
+ * @param e amici::ExpData instance to serialize
+ */
+template <class Archive>
+void serialize(Archive &ar, amici::ExpData &e, const unsigned int version) {
+    ar &static_cast<amici::SimulationParameters&>(e);
+    ar &e.id;
+    ar &e.nytrue_;
+    ar &e.nztrue_;
+    ar &e.nmaxevent_;
+    ar &e.observed_data_;
+    ar &e.observed_data_std_dev_;
+    ar &e.observed_events_;
+    ar &e.observed_events_std_dev_;
+
+    if (Archive::is_loading::value) {
+        e.checkDataDimension(e.observed_data_, "observedData");
+        e.checkDataDimension(e.observed_data_std_dev_, "observedDataStdDev");
+        e.checkEventsDimension(e.observed_events_, "observedEvents");
+        e.checkEventsDimension(e.observed_events_std_dev_,
+                               "observedEventsStdDev");
+    }
+
+    if (version >= 1) {
+        ar &e.observed_data_sparse_;
+    } else if (Archive::is_loading::value) {
+        e.observed_data_sparse_ = false;
+    }
+
+    if (e.observed_data_sparse_) {
+        ar &e.observed_data_indptr_;
+        ar &e.observed_data_indices_;
+        ar &e.observed_data_values_;
+        ar &e.observed_data_std_dev_values_;
+        if (Archive::is_loading::value)
+            e.checkObservedDataIndex();
+    } else if (Archive::is_loading::value) {
+        // for dense storage, the index of set data points is derived data
+        e.observed_data_values_.clear();
+        e.observed_data_std_dev_values_.clear();
+        e.updateObservedDataIndex();
+    }
 }
 
 /**
@@ -170,7 +267,7 @@ void serialize(Archive &ar, amici::SimulationParameters &s, const unsigned int /
  */
 
 template <class Archive>
-void serialize(Archive &ar, amici::ReturnData &r, const unsigned int /*version*/) {
+void serialize(Archive &ar, amici::ReturnData &r, const unsigned int version) {
     ar &dynamic_cast<amici::ModelDimensions&>(r);
     ar &r.id;
     ar &r.nx;
@@ -229,6 +326,42 @@ void serialize(Archive &ar, amici::ReturnData &r, const unsigned int /*version*/
     ar &r.sllh;
     ar &r.s2llh;
     ar &r.status;
+
+    if (version >= 1) {
+        ar &r.res;
+        ar &r.sres;
+        ar &r.FIM;
+        ar &r.x_ss;
+        ar &r.sx_ss;
+        ar &r.preeq_numstepsB;
+        ar &r.posteq_numstepsB;
+        ar &r.rdata_reporting;
+        ar &r.rdata_fields;
+        ar &r.sigma_res;
+    }
+
+    if (version >= 2) {
+        ar &r.profile_calls;
+        ar &r.profile_time;
+    }
+
+    if (version >= 3) {
+        ar &r.wall_time;
+        ar &r.wall_timeB;
+        ar &r.wall_time_total;
+        ar &r.preeq_wall_time;
+        ar &r.preeq_wall_timeB;
+        ar &r.posteq_wall_time;
+        ar &r.posteq_wall_timeB;
+    }
+
+    if (version >= 4) {
+        ar &r.model_workspace_bytes;
+    }
+
+    if (version >= 5) {
+        ar &r.trajectory_its;
+    }
 }
 
 
@@ -304,23 +437,25 @@ char *serializeToChar(T const& data, int *size) {
 
 /**
  * @brief Deserialize object that has been serialized using serializeToChar
+ * into an existing instance
+ *
+ * Vector members of `data` that already have the serialized size are
+ * overwritten in place, so repeatedly reading objects of the same shape into
+ * the same instance does not allocate.
  *
  * @param buffer serialized object
  * @param size length of buffer
- *
- * @return The deserialized object
+ * @param data object to deserialize into
  */
 
 template <typename T>
-T deserializeFromChar(const char *buffer, int size) {
+void deserializeFromChar(const char *buffer, int size, T &data) {
     namespace ba = ::boost::archive;
     namespace bio = ::boost::iostreams;
 
     bio::basic_array_source<char> device(buffer, size);
     bio::stream<bio::basic_array_source<char>> s(device);
 
-    T data;
-
     try {
         // archive must be destroyed BEFORE returning
         ba::binary_iarchive iar(s);
@@ -328,6 +463,21 @@ T deserializeFromChar(const char *buffer, int size) {
     } catch(ba::archive_exception const& e) {
         throw AmiException("Deserialization from char failed: %s", e.what());
     }
+}
+
+/**
+ * @brief Deserialize object that has been serialized using serializeToChar
+ *
+ * @param buffer serialized object
+ * @param size length of buffer
+ *
+ * @return The deserialized object
+ */
+
+template <typename T>
+T deserializeFromChar(const char *buffer, int size) {
+    T data;
+    deserializeFromChar(buffer, size, data);
     return data;
 }
 
@@ -390,20 +540,19 @@ std::vector<char> serializeToStdVec(T const& data) {
 
 /**
  * @brief Deserialize object that has been serialized using serializeToString
+ * into an existing instance (see amici::deserializeFromChar)
  *
  * @param serialized serialized object
- *
- * @return The deserialized object
+ * @param deserialized object to deserialize into
  */
 
 template <typename T>
-T deserializeFromString(std::string const& serialized) {
+void deserializeFromString(std::string const& serialized, T &deserialized) {
     namespace ba = ::boost::archive;
     namespace bio = ::boost::iostreams;
 
     bio::basic_array_source<char> device(serialized.data(), serialized.size());
     bio::stream<bio::basic_array_source<char>> os(device);
-    T deserialized;
 
     try{
         // archive must be destroyed BEFORE returning
@@ -413,7 +562,20 @@ T deserializeFromString(std::string const& serialized) {
         throw AmiException("Deserialization from std::string failed: %s",
                            e.what());
     }
+}
+
+/**
+ * @brief Deserialize object that has been serialized using serializeToString
+ *
+ * @param serialized serialized object
+ *
+ * @return The deserialized object
+ */
 
+template <typename T>
+T deserializeFromString(std::string const& serialized) {
+    T deserialized;
+    deserializeFromString(serialized, deserialized);
     return deserialized;
 }
 
@@ -0,0 +1,265 @@
+#ifndef AMICI_SERVE_H
+#define AMICI_SERVE_H
+
+#include "amici/defines.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace amici {
+
+class ExpData;
+class Model;
+class ModelRegistry;
+class ReturnData;
+class Solver;
+
+namespace serve {
+
+/* Simulation daemon that keeps models resident and accepts simulation
+ * requests over a Unix domain socket, see amici-serve.
+ *
+ * Every message is a frame consisting of the payload length as 32-bit
+ * little-endian unsigned integer, followed by the payload. Integers in
+ * payloads are little-endian as well, strings and blobs are prefixed with
+ * their length as uint32, vectors of doubles with their number of elements
+ * as uint32. Blobs hold objects serialized with amici::serializeToString.
+ *
+ * Request payload:
+ *   uint32 protocol_version
+ *   string model_name, string model_version
+ *   blob   solver (amici::Solver, empty for the model's default settings)
+ *   double[] parameters (empty for the model's default parameters)
+ *   uint32 number of conditions, followed by one blob (amici::ExpData) per
+ *          condition. Without conditions, the model is simulated once
+ *          without data.
+ *
+ * For every request, the server sends one response frame per condition as
+ * soon as the condition was simulated, in the order of the request, and a
+ * final frame. The first byte of a response payload is its type:
+ *   result: uint32 condition index, blob (amici::ReturnData)
+ *   end:    no further data, all conditions were simulated
+ *   error:  string message, the remaining conditions were skipped
+ *
+ * Blobs are boost serialization archives, which are not hardened against
+ * malicious input: a crafted archive can crash the server or worse. The
+ * socket is therefore only accessible by the user running the server, and
+ * only trusted clients must be given access to it.
+ */
+
+/** Version of the protocol, incremented on incompatible changes */
+constexpr std::uint32_t protocol_version = 1;
+
+/** Type of a response frame */
+enum class ResponseType : std::uint8_t {
+    result = 0,
+    end = 1,
+    error = 2,
+};
+
+/**
+ * @brief A simulation request. Only references the solver and data, which
+ * must stay valid until the request was sent.
+ */
+struct Request {
+    /** model name */
+    std::string model_name;
+
+    /** model version, empty for unversioned models */
+    std::string model_version;
+
+    /** solver settings, nullptr for the default settings of the model */
+    Solver const *solver{nullptr};
+
+    /** model parameters, empty for the default parameters of the model */
+    std::vector<realtype> parameters;
+
+    /** conditions to simulate, empty to simulate once without data */
+    std::vector<ExpData const *> edatas;
+};
+
+/**
+ * @brief Serialize a request into a frame payload.
+ * @param request request
+ * @return payload
+ */
+std::string encodeRequest(Request const &request);
+
+/** Create a model instance by name and version */
+using ModelFactory = std::function<std::shared_ptr<Model>(
+    std::string const &name, std::string const &version)>;
+
+/**
+ * @brief Options for amici::serve::Server
+ */
+struct ServerOptions {
+    /** number of worker threads, i.e. connections served concurrently */
+    int num_threads{1};
+
+    /**
+     * maximum number of models each worker keeps resident, the least
+     * recently used model is released first
+     */
+    int max_models_per_thread{16};
+
+    /** called after a worker released models, e.g. to unload libraries */
+    std::function<void()> on_models_released;
+};
+
+/**
+ * @brief Simulation server listening on a Unix domain socket.
+ *
+ * Each worker thread serves one connection at a time, handling its requests
+ * in order, and keeps a model instance and solver per model it simulated, so
+ * that subsequent requests for that model neither create the model nor
+ * allocate its workspaces again. Parameters and parameter scales are reset
+ * to the request or model defaults for every request.
+ *
+ * The socket file is created with permissions 0600. Requests are decoded
+ * with boost serialization, which does not validate untrusted input, so
+ * clients have to be trusted (see above).
+ */
+class Server {
+  public:
+    /**
+     * @brief Create the socket and start listening. Clients can connect
+     * once the constructor returns, requests are handled once run() was
+     * called.
+     *
+     * A stale socket file at `socket_path` is replaced, if another server is
+     * listening on it, construction fails.
+     *
+     * @param socket_path path of the Unix domain socket
+     * @param model_factory creates model instances by name and version
+     * @param options options
+     */
+    Server(std::string socket_path, ModelFactory model_factory,
+           ServerOptions options = ServerOptions());
+
+    /**
+     * @brief Serve models from a registry. Models are unloaded from the
+     * registry when no longer in use by any worker.
+     * @param socket_path path of the Unix domain socket
+     * @param registry model registry, must outlive the server
+     * @param options options
+     */
+    Server(std::string socket_path, ModelRegistry &registry,
+           ServerOptions options = ServerOptions());
+
+    /**
+     * @brief Stops the server, waits for run() to return if it is running in
+     * another thread, and removes the socket file.
+     *
+     * run() must not be called once destruction has started.
+     */
+    ~Server();
+
+    Server(Server const &) = delete;
+    Server &operator=(Server const &) = delete;
+
+    /**
+     * @brief Accept connections until stop() is called.
+     */
+    void run();
+
+    /**
+     * @brief Stop accepting connections and close open connections after
+     * the current request. May be called from any thread and from signal
+     * handlers.
+     */
+    void stop();
+
+  private:
+    /** Serve connections from the queue until the server stops */
+    void work();
+
+    /** path of the socket */
+    std::string socket_path_;
+
+    /** creates model instances */
+    ModelFactory model_factory_;
+
+    /** options */
+    ServerOptions options_;
+
+    /** listening socket */
+    int listen_fd_{-1};
+
+    /** pipe to wake up run() from stop() */
+    int wake_fds_[2]{-1, -1};
+
+    /** set once the server is stopping */
+    std::atomic<bool> stopping_{false};
+
+    /** protects connections_, active_connections_ and running_ */
+    std::mutex mutex_;
+
+    /** signals new connections and stopping to workers */
+    std::condition_variable cv_;
+
+    /** set while run() is executing */
+    bool running_{false};
+
+    /** signals the end of run() to the destructor */
+    std::condition_variable run_cv_;
+
+    /** accepted connections waiting for a worker */
+    std::deque<int> connections_;
+
+    /** connections currently served by workers */
+    std::vector<int> active_connections_;
+
+    /** worker threads */
+    std::vector<std::thread> workers_;
+};
+
+/**
+ * @brief Client for amici::serve::Server.
+ */
+class Client {
+  public:
+    /**
+     * @brief Connect to a server.
+     * @param socket_path path of the server's socket
+     */
+    explicit Client(std::string const &socket_path);
+
+    ~Client();
+
+    Client(Client const &) = delete;
+    Client &operator=(Client const &) = delete;
+
+    /**
+     * @brief Simulate all conditions of a request.
+     * @param request request
+     * @return results in the order of the conditions
+     */
+    std::vector<std::unique_ptr<ReturnData>> simulate(Request const &request);
+
+    /**
+     * @brief Simulate all conditions of a request and hand over each result
+     * as soon as it was received.
+     * @param request request
+     * @param consumer called with condition index and result
+     */
+    void simulate(
+        Request const &request,
+        std::function<void(int, std::unique_ptr<ReturnData>)> const &consumer);
+
+  private:
+    /** connected socket */
+    int fd_{-1};
+};
+
+} // namespace serve
+} // namespace amici
+
+#endif // AMICI_SERVE_H
@@ -2,6 +2,7 @@
 #define AMICI_SOLVER_H
 
 #include "amici/amici.h"
+#include "amici/cancellation.h"
 #include "amici/defines.h"
 #include "amici/sundials_linsol_wrapper.h"
 #include "amici/symbolic_functions.h"
@@ -513,7 +514,8 @@ class Solver {
     void setMaxTime(double maxtime);
 
     /**
-     * @brief Start timer for tracking integration time
+     * @brief Start timer for tracking integration time and reset CPU and wall
+     * time of forward and backward solves
      */
     void startTimer() const;
 
@@ -524,6 +526,63 @@ class Solver {
      */
     bool timeExceeded() const;
 
+    /**
+     * @brief Enable or disable collection of call counts and timings of
+     * model functions and simulation phases, which are reported in
+     * ReturnData::profile_calls and ReturnData::profile_time.
+     *
+     * Only has an effect if AMICI was built with ENABLE_PROFILING.
+     * @param profiling whether to collect a profile
+     */
+    void setProfiling(bool profiling);
+
+    /**
+     * @brief Whether a profile of model functions and simulation phases is
+     * collected
+     * @return profiling flag
+     */
+    bool getProfiling() const;
+
+    /**
+     * @brief Set the token for cooperative cancellation of simulations
+     * using this solver or any of its clones.
+     *
+     * The token is not owned by the solver and must outlive all simulations
+     * using it.
+     * @param token cancellation token, nullptr to unset
+     */
+    void setCancellationToken(CancellationToken *token);
+
+    /**
+     * @brief Get the cancellation token
+     * @return token, may be nullptr
+     */
+    CancellationToken *getCancellationToken() const;
+
+    /**
+     * @brief Cheap check whether the simulation should be interrupted, meant
+     * to be called from right-hand side callbacks.
+     *
+     * Only reads the cancellation flag. Deadline, budget and maximum time are
+     * checked every `interrupt_poll_interval_` calls and at every call to
+     * run(), step() and runB().
+     * @return true if the simulation should be interrupted
+     */
+    bool interrupted() const {
+        if (cancellation_token_ && cancellation_token_->isCancelled())
+            return true;
+        if (++rhs_evaluations_since_poll_ < interrupt_poll_interval_)
+            return false;
+        return pollInterrupt();
+    }
+
+    /**
+     * @brief Status of an interrupted simulation
+     * @return AMICI_SUCCESS if the simulation was not interrupted,
+     * AMICI_MAX_TIME_EXCEEDED or AMICI_CANCELLED otherwise
+     */
+    int getInterruptStatus() const;
+
     /**
      * @brief returns the maximum number of solver steps for the backward
      * problem
@@ -645,6 +704,37 @@ class Solver {
      */
     void setReturnDataReportingMode(RDataReporting rdrm);
 
+    /**
+     * @brief returns the mask of ReturnData fields that are reported
+     * @return bit mask of amici::RDataField values
+     */
+    int getReturnDataFields() const;
+
+    /**
+     * @brief sets the mask of ReturnData fields that are reported. Fields
+     * that are not selected are neither allocated nor computed, independent
+     * of the reporting mode. Without forward sensitivities, `ssigmay` is only
+     * reported together with `sy`.
+     * @param fields bit mask of amici::RDataField values
+     */
+    void setReturnDataFields(int fields);
+
+    /**
+     * @brief returns the indices of the timepoints at which state
+     * trajectories are reported
+     * @return timepoint indices, empty if reported at all timepoints
+     */
+    std::vector<int> const &getReturnDataTrajectoryTimepoints() const;
+
+    /**
+     * @brief sets the indices of the timepoints at which state trajectories
+     * (`x`, `sx`, `w`) are reported. These fields then only hold the
+     * selected timepoints in ascending order, see
+     * amici::ReturnData::trajectory_its.
+     * @param its timepoint indices, empty to report at all timepoints
+     */
+    void setReturnDataTrajectoryTimepoints(std::vector<int> const &its);
+
     /**
      * @brief write solution from forward simulation
      * @param t time
@@ -771,17 +861,31 @@ class Solver {
     realtype gett() const;
 
     /**
-     * @brief Reads out the CPU time needed for forward solve
-     * @return cpu_time
+     * @brief Reads out the CPU time of the simulating thread needed for
+     * forward solve
+     * @return cpu_time [ms]
      */
     realtype getCpuTime() const;
 
     /**
-     * @brief Reads out the CPU time needed for backward solve
-     * @return cpu_timeB
+     * @brief Reads out the CPU time of the simulating thread needed for
+     * backward solve
+     * @return cpu_timeB [ms]
      */
     realtype getCpuTimeB() const;
 
+    /**
+     * @brief Reads out the wall time needed for forward solve
+     * @return wall_time [ms]
+     */
+    realtype getWallTime() const;
+
+    /**
+     * @brief Reads out the wall time needed for backward solve
+     * @return wall_timeB [ms]
+     */
+    realtype getWallTimeB() const;
+
     /**
      * @brief number of states with which the solver was initialized
      * @return x.getLength()
@@ -1642,7 +1746,22 @@ class Solver {
     std::chrono::duration<double, std::ratio<1>> maxtime_ {std::chrono::duration<double>::max()};
 
     /** Time at which solver timer was started */
-    mutable std::chrono::time_point<std::chrono::system_clock> starttime_;
+    mutable std::chrono::time_point<std::chrono::steady_clock> starttime_;
+
+    /** collect a profile of model functions and simulation phases */
+    bool profiling_ {false};
+
+    /** token for cooperative cancellation, not owned */
+    CancellationToken *cancellation_token_ {nullptr};
+
+    /** number of right-hand side evaluations between full interrupt checks */
+    static constexpr long int interrupt_poll_interval_ {32};
+
+    /** right-hand side evaluations since the last full interrupt check */
+    mutable long int rhs_evaluations_since_poll_ {0};
+
+    /** number of forward steps at the last full interrupt check */
+    mutable long int steps_at_poll_ {0};
 
     /** linear solver for the forward problem */
     mutable std::unique_ptr<SUNLinSolWrapper> linear_solver_;
@@ -1762,6 +1881,20 @@ class Solver {
      */
     void apply_max_num_steps_B() const;
 
+    /**
+     * @brief Charge work to the cancellation token and check deadline,
+     * budgets and maximum time
+     * @return true if the simulation should be interrupted
+     */
+    bool pollInterrupt() const;
+
+    /**
+     * @brief Throws if the simulation should be interrupted, called at step
+     * boundaries
+     * @param backward whether the backward problem is being solved
+     */
+    void checkInterrupt(bool backward) const;
+
 
     /** method for sensitivity computation */
     SensitivityMethod sensi_meth_ {SensitivityMethod::forward};
@@ -1836,6 +1969,12 @@ class Solver {
 
     RDataReporting rdata_mode_ {RDataReporting::full};
 
+    /** mask of amici::RDataField values that are reported */
+    int rdata_fields_ {static_cast<int>(RDataField::all)};
+
+    /** timepoint indices at which state trajectories are reported */
+    std::vector<int> rdata_trajectory_its_;
+
     /** whether newton step should be used for convergence steps */
     bool newton_step_steadystate_conv_ {false};
 
@@ -1848,6 +1987,12 @@ class Solver {
     /** CPU time, backward solve */
     mutable realtype cpu_timeB_ {0.0};
 
+    /** wall time, forward solve */
+    mutable realtype wall_time_ {0.0};
+
+    /** wall time, backward solve */
+    mutable realtype wall_timeB_ {0.0};
+
     /** maximum number of allowed integration steps for backward problem */
     long int maxstepsB_ {0L};
 
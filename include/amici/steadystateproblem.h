@@ -82,17 +82,29 @@ class SteadystateProblem {
     std::vector<realtype> const &getDJydx() const { return dJydx_; }
 
     /**
-     * @brief Accessor for run_time of the forward problem
-     * @return run_time
+     * @brief Accessor for CPU time of the forward problem
+     * @return CPU time of the simulating thread [ms]
      */
     double getCPUTime() const { return cpu_time_; }
 
     /**
-     * @brief Accessor for run_time of the backward problem
-     * @return run_time
+     * @brief Accessor for CPU time of the backward problem
+     * @return CPU time of the simulating thread [ms]
      */
     double getCPUTimeB() const { return cpu_timeB_; }
 
+    /**
+     * @brief Accessor for wall time of the forward problem
+     * @return wall time [ms]
+     */
+    double getWallTime() const { return wall_time_; }
+
+    /**
+     * @brief Accessor for wall time of the backward problem
+     * @return wall time [ms]
+     */
+    double getWallTimeB() const { return wall_timeB_; }
+
     /**
      * @brief Accessor for steady_state_status
      * @return steady_state_status
@@ -414,6 +426,12 @@ class SteadystateProblem {
     /** stores diagnostic information about runtime backward */
     double cpu_timeB_{0.0};
 
+    /** stores diagnostic information about wall time */
+    double wall_time_{0.0};
+
+    /** stores diagnostic information about wall time backward */
+    double wall_timeB_{0.0};
+
     /** flag indicating whether backward mode was run */
     bool hasQuadrature_{false};
 
@@ -0,0 +1,178 @@
+#ifndef AMICI_TRACE_H
+#define AMICI_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace amici {
+
+/**
+ * @brief A completed span of work recorded by a TraceRecorder.
+ */
+struct TraceEvent {
+    /** name of the phase, must be a string literal or otherwise outlive the
+     * recorder */
+    char const *name {nullptr};
+    /** optional argument, e.g. the ExpData::id of the simulated condition */
+    std::string arg;
+    /** start time since creation of the recorder [ns] */
+    std::int64_t start {0};
+    /** duration [ns] */
+    std::int64_t duration {0};
+    /** index of the recording thread, in order of first event */
+    int thread {0};
+};
+
+/**
+ * @brief Records begin and end of simulation phases (simulation of a
+ * condition, preequilibration, forward and backward problem, Newton's method,
+ * event handling, linear solver setup) across all threads and exports them
+ * in the Chrome trace event format, which can be viewed in Perfetto
+ * (https://ui.perfetto.dev) or chrome://tracing.
+ *
+ * Tracing is enabled by activating a recorder via setTraceRecorder. Every
+ * thread records into its own ring buffer of fixed capacity, so recording
+ * takes no locks, and once a buffer is full the oldest events of that thread
+ * are overwritten. While no recorder is active, the cost is a single atomic
+ * load per phase.
+ *
+ * Events may only be retrieved or written while no simulations are running.
+ */
+class TraceRecorder {
+  public:
+    /**
+     * @brief Constructor
+     * @param capacity maximum number of events kept per thread
+     */
+    explicit TraceRecorder(std::size_t capacity = 65536);
+
+    /** Deactivates the recorder, if active */
+    ~TraceRecorder();
+
+    TraceRecorder(TraceRecorder const &) = delete;
+    TraceRecorder &operator=(TraceRecorder const &) = delete;
+
+    /**
+     * @brief Record an event for the current thread
+     * @param name name of the phase
+     * @param start start time
+     * @param end end time
+     * @param arg optional argument
+     */
+    void record(char const *name, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end,
+                std::string const &arg = std::string());
+
+    /**
+     * @brief Get the recorded events of all threads, sorted by start time
+     * @return events
+     */
+    std::vector<TraceEvent> getEvents() const;
+
+    /**
+     * @brief Number of events that were overwritten because a thread's
+     * buffer was full
+     * @return number of dropped events
+     */
+    std::size_t getNumDropped() const;
+
+    /**
+     * @brief Discard all recorded events
+     */
+    void clear();
+
+    /**
+     * @brief Write the recorded events as Chrome trace event JSON
+     * @param os output stream
+     */
+    void writeChromeTrace(std::ostream &os) const;
+
+    /**
+     * @brief Write the recorded events as Chrome trace event JSON
+     * @param filename output file
+     */
+    void writeChromeTrace(std::string const &filename) const;
+
+  private:
+    struct ThreadBuffer;
+
+    ThreadBuffer &getThreadBuffer();
+
+    /** unique id, to detect stale thread-local buffer references */
+    std::uint64_t const id_;
+    std::size_t const capacity_;
+    std::chrono::steady_clock::time_point const epoch_;
+
+    /** guards buffers_ */
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+/**
+ * @brief Activate a recorder for all simulations in this process
+ * @param recorder recorder, which must remain valid while active, or nullptr
+ * to disable tracing
+ */
+void setTraceRecorder(TraceRecorder *recorder);
+
+/**
+ * @brief Get the active recorder
+ * @return recorder, nullptr if tracing is disabled
+ */
+TraceRecorder *getTraceRecorder();
+
+/** active recorder, see setTraceRecorder */
+extern std::atomic<TraceRecorder *> active_trace_recorder;
+
+/**
+ * @brief RAII guard that records its lifetime as a TraceEvent if a recorder
+ * is active.
+ */
+class TraceScope {
+  public:
+    /**
+     * @brief Start a span
+     * @param name name of the phase
+     */
+    explicit TraceScope(char const *name)
+        : recorder_(active_trace_recorder.load(std::memory_order_relaxed)),
+          name_(name) {
+        if (recorder_)
+            start_ = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Start a span with an argument
+     * @param name name of the phase
+     * @param arg argument, e.g. the condition id
+     */
+    TraceScope(char const *name, std::string const &arg) : TraceScope(name) {
+        if (recorder_)
+            arg_ = arg;
+    }
+
+    ~TraceScope() {
+        if (recorder_)
+            recorder_->record(name_, start_, std::chrono::steady_clock::now(),
+                              arg_);
+    }
+
+    TraceScope(TraceScope const &) = delete;
+    TraceScope &operator=(TraceScope const &) = delete;
+
+  private:
+    TraceRecorder *recorder_;
+    char const *name_;
+    std::string arg_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace amici
+
+#endif // AMICI_TRACE_H
@@ -193,12 +193,13 @@ end
 function [objectStrAmici] = compileAmiciBase(amiciRootPath, objectFolder, objectFileSuffix, includesstr, DEBUG, COPT)
     % generate hash for file and append debug string if we have an md5
     % file, check this hash against the contained hash
-    cppsrc = {'amici', 'symbolic_functions','spline', ...
+    cppsrc = {'amici', 'cancellation', 'symbolic_functions','spline', ...
         'edata','rdata', 'exception', ...
         'interface_matlab', 'misc', 'simulation_parameters', ...
         'solver', 'solver_cvodes', 'solver_idas', 'model_state', ...
         'model', 'model_ode', 'model_dae', 'returndata_matlab', ...
         'forwardproblem', 'steadystateproblem', 'backwardproblem', 'newton_solver', ...
+        'profiling', 'trace', ...
         'abstract_model', 'sundials_matrix_wrapper', 'sundials_linsol_wrapper', ...
         'vector'
     };
@@ -108,7 +108,7 @@ if not _imported_from_setup():
         from .swig_wrappers import *
 
         # These modules require the swig interface and other dependencies
-        from .numpy import ReturnDataView, ExpDataView
+        from .numpy import ReturnDataView, ExpDataView, ReturnDataArenaView
         from .pandas import *
 
     # These modules don't require the swig interface
@@ -0,0 +1,661 @@
+"""
+Bytecode model backend
+----------------------
+This module translates the equations of an :class:`amici.ode_export.ODEModel`
+into bytecode for :class:`amici.Model_ODE_Bytecode`, which evaluates the
+model functions with an interpreter instead of compiled C++ code.
+
+Writing the bytecode only takes as long as computing the symbolic
+derivatives, so models can be simulated seconds after import. Simulation is
+slower than with the compiled backend, which remains the choice for
+production runs.
+
+The bytecode file is line-based text. Every model function is a list of
+register-based instructions per observable, parameter and/or event index,
+which read from the arrays passed to the respective model function (see
+``functions`` in :mod:`amici.ode_export`) and write the nonzero entries of the
+output array, in the same way as the generated C++ code.
+"""
+import os
+import re
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple, Union, TYPE_CHECKING
+
+import numpy as np
+import sympy as sp
+
+from . import __commit__, __version__
+from .import_utils import strip_pysb
+from .logging import get_logger, log_execution_time
+
+if TYPE_CHECKING:
+    from .ode_export import ODEExporter
+
+logger = get_logger(__name__)
+
+#: version of the bytecode file format, see ``readBytecodeModel``
+BYTECODE_FORMAT_VERSION = 1
+
+#: file extension of bytecode models
+BYTECODE_SUFFIX = '.amici_bytecode'
+
+#: instructions for sympy functions with a single argument
+_UNARY_FUNCTIONS = {
+    sp.exp: 'exp',
+    sp.log: 'log',
+    sp.sin: 'sin',
+    sp.cos: 'cos',
+    sp.tan: 'tan',
+    sp.asin: 'asin',
+    sp.acos: 'acos',
+    sp.atan: 'atan',
+    sp.sinh: 'sinh',
+    sp.cosh: 'cosh',
+    sp.tanh: 'tanh',
+    sp.asinh: 'asinh',
+    sp.acosh: 'acosh',
+    sp.atanh: 'atanh',
+    sp.Abs: 'fabs',
+    sp.floor: 'floor',
+    sp.ceiling: 'ceil',
+    sp.erf: 'erf',
+    sp.sign: 'sign',
+    sp.DiracDelta: 'dirac',
+    sp.Not: 'not',
+}
+
+#: instructions for sympy relations and functions with two arguments
+_BINARY_FUNCTIONS = {
+    sp.StrictLessThan: 'lt',
+    sp.LessThan: 'le',
+    sp.StrictGreaterThan: 'gt',
+    sp.GreaterThan: 'ge',
+    sp.Equality: 'eq',
+    sp.Unequality: 'ne',
+    sp.Mod: 'fmod',
+    sp.atan2: 'atan2',
+}
+
+#: instructions for associative sympy functions, evaluated as right fold
+_NARY_FUNCTIONS = {
+    sp.Max: 'max',
+    sp.Min: 'min',
+    sp.And: 'and',
+    sp.Or: 'or',
+}
+
+
+class ProgramBuilder:
+    """
+    Translates sympy expressions into the instructions of one program.
+
+    Identical subexpressions are evaluated only once.
+
+    :ivar symbols:
+        array and index that symbols are read from, by symbol name
+
+    :ivar pos_pow:
+        whether to evaluate powers as ``amici::pos_pow``
+
+    :ivar constants:
+        constants of the program
+
+    :ivar instructions:
+        instructions of the program, one string per instruction
+
+    :ivar n_registers:
+        number of registers
+    """
+
+    def __init__(self, symbols: Dict[str, Tuple[str, int]],
+                 pos_pow: bool = False):
+        """
+        Create a new ProgramBuilder instance.
+
+        :param symbols:
+            array and index that symbols are read from, by symbol name.
+            Array ``'out'`` refers to the output array of the function.
+
+        :param pos_pow:
+            whether to evaluate powers as ``amici::pos_pow``
+        """
+        self.symbols = symbols
+        self.pos_pow = pos_pow
+        self.constants: List[float] = []
+        self.instructions: List[str] = []
+        self.n_registers: int = 0
+        self._constant_idx: Dict[float, int] = {}
+        self._registers: Dict[tuple, int] = {}
+        self._expressions: Dict[sp.Basic, int] = {}
+
+    def _emit(self, *operation) -> int:
+        """
+        Emit an instruction computing a new register value, unless the same
+        value has already been computed.
+
+        :param operation:
+            mnemonic and operands except the destination register
+
+        :return:
+            register holding the result
+        """
+        if (register := self._registers.get(operation)) is not None:
+            return register
+        register = self.n_registers
+        self.n_registers += 1
+        self.instructions.append(
+            ' '.join(map(str, (operation[0], register, *operation[1:]))))
+        self._registers[operation] = register
+        return register
+
+    def constant(self, value: float) -> int:
+        """
+        Load a constant.
+
+        :param value:
+            value
+
+        :return:
+            register holding the value
+        """
+        value = float(value)
+        # nan != nan, so it needs a dictionary key of its own
+        key = 'nan' if np.isnan(value) else value
+        if key not in self._constant_idx:
+            self._constant_idx[key] = len(self.constants)
+            self.constants.append(value)
+        return self._emit('const', self._constant_idx[key])
+
+    def store(self, index: int, expr: sp.Expr, reinit: bool = False) -> None:
+        """
+        Compute an expression and write it to the output array.
+
+        :param index:
+            index in the output array
+
+        :param expr:
+            expression
+
+        :param reinit:
+            only write if ``index`` is one of the reinitialized states
+        """
+        register = self.compile(expr)
+        self.instructions.append(
+            f"{'store_reinit' if reinit else 'store'} {index} {register}")
+        load = ('load', 'out', index)
+        if load in self._registers:
+            # the output was read before, drop everything that may depend on
+            # the previous value
+            self._expressions.clear()
+        self._registers[load] = register
+
+    def zero_reinit(self, index: int) -> None:
+        """
+        Set an entry of the output array to zero if ``index`` is one of the
+        reinitialized states.
+
+        :param index:
+            index in the output array
+        """
+        self.instructions.append(f'zero_reinit {index}')
+        self._registers.pop(('load', 'out', index), None)
+        self._expressions.clear()
+
+    def compile(self, expr: sp.Basic) -> int:
+        """
+        Emit the instructions computing an expression.
+
+        :param expr:
+            expression
+
+        :return:
+            register holding the value of the expression
+        """
+        if (register := self._expressions.get(expr)) is not None:
+            return register
+        register = self._compile(expr)
+        self._expressions[expr] = register
+        return register
+
+    def _compile(self, expr: sp.Basic) -> int:
+        if expr.is_Symbol:
+            name = str(expr)
+            if name not in self.symbols:
+                name = str(strip_pysb(expr))
+            if name not in self.symbols:
+                raise ValueError(f'Symbol {expr} is not an argument of this '
+                                 'function.')
+            return self._emit('load', *self.symbols[name])
+
+        if expr.is_Number or expr.is_NumberSymbol \
+                or expr in (sp.oo, -sp.oo, sp.zoo, sp.nan):
+            return self.constant(float(expr) if expr != sp.zoo else np.nan)
+
+        if expr in (sp.true, sp.false):
+            return self.constant(float(bool(expr)))
+
+        if expr.is_Add:
+            terms = list(expr.args)
+            result = self.compile(terms[0])
+            for term in terms[1:]:
+                coeff, _ = term.as_coeff_Mul()
+                if coeff.is_negative:
+                    result = self._emit('sub', result, self.compile(-term))
+                else:
+                    result = self._emit('add', result, self.compile(term))
+            return result
+
+        if expr.is_Mul:
+            coeff, rest = expr.as_coeff_Mul()
+            if coeff == -1:
+                return self._emit('neg', self.compile(rest))
+            numerator = []
+            denominator = []
+            for factor in expr.args:
+                if factor.is_Pow and factor.exp.is_Rational \
+                        and factor.exp.is_negative:
+                    denominator.append(factor.base ** -factor.exp)
+                elif factor.is_Rational and factor.p == 1 and factor.q != 1:
+                    denominator.append(sp.Integer(factor.q))
+                else:
+                    numerator.append(factor)
+            result = self._product(numerator) if numerator \
+                else self.constant(1.0)
+            if denominator:
+                result = self._emit('div', result,
+                                    self._product(denominator))
+            return result
+
+        if expr.is_Pow:
+            base, exponent = expr.args
+            if exponent == -1:
+                return self._emit('div', self.constant(1.0),
+                                  self.compile(base))
+            if exponent == sp.Rational(1, 2):
+                return self._emit('sqrt', self.compile(base))
+            if exponent == sp.Rational(-1, 2):
+                return self._emit('div', self.constant(1.0),
+                                  self._emit('sqrt', self.compile(base)))
+            if exponent == sp.Rational(1, 3):
+                return self._emit('cbrt', self.compile(base))
+            if base == sp.E:
+                return self._emit('exp', self.compile(exponent))
+            return self._emit('pos_pow' if self.pos_pow else 'pow',
+                              self.compile(base), self.compile(exponent))
+
+        if isinstance(expr, sp.Piecewise):
+            result = None
+            for value, condition in reversed(expr.args):
+                if condition == sp.true:
+                    result = self.compile(value)
+                    continue
+                if result is None:
+                    result = self.constant(np.nan)
+                result = self._emit('select', self.compile(condition),
+                                    self.compile(value), result)
+            return result
+
+        if isinstance(expr, sp.Heaviside):
+            x0 = expr.args[1] if len(expr.args) > 1 else sp.Rational(1, 2)
+            return self._emit('heaviside', self.compile(expr.args[0]),
+                              self.compile(x0))
+
+        func = expr.func
+        if func in _UNARY_FUNCTIONS and len(expr.args) == 1:
+            return self._emit(_UNARY_FUNCTIONS[func],
+                              self.compile(expr.args[0]))
+
+        if func in _BINARY_FUNCTIONS and len(expr.args) == 2:
+            return self._emit(_BINARY_FUNCTIONS[func],
+                              *map(self.compile, expr.args))
+
+        if func in _NARY_FUNCTIONS:
+            registers = [self.compile(arg) for arg in expr.args]
+            result = registers[-1]
+            for register in reversed(registers[:-1]):
+                result = self._emit(_NARY_FUNCTIONS[func], register, result)
+            return result
+
+        raise NotImplementedError(
+            f'{func} is not supported by the bytecode backend, use the '
+            'compiled backend for this model.')
+
+    def _product(self, factors: List[sp.Expr]) -> int:
+        """Emit the product of the given factors"""
+        result = self.compile(factors[0])
+        for factor in factors[1:]:
+            result = self._emit('mul', result, self.compile(factor))
+        return result
+
+    def to_lines(self, function: str, index: int) -> List[str]:
+        """
+        Serialize the program.
+
+        :param function:
+            name of the model function
+
+        :param index:
+            observable, parameter and/or event index
+
+        :return:
+            lines of the bytecode file
+        """
+        return [
+            f'function {function} {index} {len(self.instructions)} '
+            f'{self.n_registers}',
+            ' '.join(['constants', str(len(self.constants)),
+                      *map(repr, self.constants)]),
+            *self.instructions
+        ]
+
+
+class _BytecodeWriter:
+    """
+    Writes the bytecode for all model functions of an
+    :class:`amici.ode_export.ODEExporter`.
+    """
+
+    def __init__(self, exporter: 'ODEExporter'):
+        self.exporter = exporter
+        self.model = exporter.model
+
+    def _symbol_arrays(self, name: str) -> List[sp.Symbol]:
+        """
+        Symbols of a symbolic array in the order of the array, see
+        :meth:`amici.ode_export.ODEExporter._write_index_files`
+        """
+        from .ode_export import sparse_functions
+
+        symbols = self.model.sparsesym(name) if name in sparse_functions \
+            else self.model.sym(name).T
+        if isinstance(next(iter(symbols), None), list):
+            symbols = [symbol for obs in symbols for symbol in obs]
+        return symbols
+
+    def _symbols(self, function: str) -> Dict[str, Tuple[str, int]]:
+        """
+        Arrays and indices that the symbols in the equations of ``function``
+        are read from
+        """
+        from .ode_export import non_unique_id_symbols
+
+        arguments = self.exporter.functions[function].arguments
+        arrays = [
+            sym for sym in re.findall(
+                r'const (?:realtype|double) \*([\w]+)[0]*(?:,|$)', arguments)
+            if sym in self.model.sym_names()
+        ]
+        symbols = {}
+        if re.search(r'const realtype t(?:,|$)', arguments):
+            symbols['t'] = ('t', 0)
+        for array in arrays:
+            for index, symbol in enumerate(self._symbol_arrays(array)):
+                if str(symbol) != '0':
+                    symbols[str(strip_pysb(symbol))] = (array, index)
+        if function in self.model.sym_names() \
+                and function not in non_unique_id_symbols:
+            for index, symbol in enumerate(self._symbol_arrays(function)):
+                if str(symbol) != '0':
+                    symbols[str(strip_pysb(symbol))] = ('out', index)
+        return symbols
+
+    def _equations(self, function: str):
+        """Equations of ``function``, see
+        :meth:`amici.ode_export.ODEExporter._write_function_file`"""
+        from .ode_export import sparse_functions
+
+        if function in sparse_functions:
+            return self.model.sparseeq(function)
+        return self.model.eq(function)
+
+    def _programs(self, function: str) -> Dict[int, ProgramBuilder]:
+        """
+        Translate the equations of ``function`` into one program per
+        observable, parameter and/or event index, mirroring
+        :meth:`amici.ode_export.ODEExporter._get_function_body`.
+        """
+        from .ode_export import (
+            event_functions, event_sensi_functions, multiobs_functions,
+            sensi_functions, smart_is_zero_matrix
+        )
+
+        exporter = self.exporter
+        if not exporter.allow_reinit_fixpar_initcond and function in {
+            'sx0_fixedParameters', 'x0_fixedParameters'
+        }:
+            return {}
+
+        equations = self._equations(function)
+        if len(equations) == 0 or (
+                isinstance(equations, (sp.Matrix, sp.ImmutableDenseMatrix))
+                and min(equations.shape) == 0
+        ):
+            return {}
+
+        symbols = self._symbols(function)
+        pos_pow = exporter.assume_pow_positivity \
+            and exporter.functions[function].assume_pow_positivity
+        num_par = self.model.num_par()
+
+        def program(values, indices=None):
+            builder = ProgramBuilder(symbols, pos_pow)
+            if indices is None:
+                indices = range(len(values))
+            for index, value in zip(indices, values):
+                if value not in [0, 0.0]:
+                    builder.store(index, value)
+            return builder
+
+        programs = {}
+        if function == 'sx0_fixedParameters':
+            x0_fixpar_idx = self.model._x0_fixedParameters_idx
+            for ipar in range(num_par):
+                builder = ProgramBuilder(symbols, pos_pow)
+                for index in x0_fixpar_idx:
+                    builder.zero_reinit(index)
+                for index, value in zip(x0_fixpar_idx, equations[:, ipar]):
+                    if not value.is_zero:
+                        builder.store(index, value, reinit=True)
+                programs[ipar] = builder
+        elif function == 'x0_fixedParameters':
+            builder = ProgramBuilder(symbols, pos_pow)
+            for index, value in zip(self.model._x0_fixedParameters_idx,
+                                    equations):
+                builder.store(index, value, reinit=True)
+            programs[0] = builder
+        elif function in event_functions:
+            for ie in range(self.model.num_events()):
+                if not smart_is_zero_matrix(equations[ie]):
+                    programs[ie] = program(equations[ie])
+        elif function in event_sensi_functions:
+            for ie, inner_equations in enumerate(equations):
+                for ipar in range(num_par):
+                    if not smart_is_zero_matrix(inner_equations[:, ipar]):
+                        programs[ie * num_par + ipar] = \
+                            program(inner_equations[:, ipar])
+        elif function in sensi_functions \
+                and equations.shape[1] == num_par:
+            for ipar in range(num_par):
+                if not smart_is_zero_matrix(equations[:, ipar]):
+                    programs[ipar] = program(equations[:, ipar])
+        elif function in multiobs_functions:
+            for iobs in range(self.model.num_obs()):
+                values = equations[iobs] if function == 'dJydy' \
+                    else equations[:, iobs]
+                if not smart_is_zero_matrix(values):
+                    programs[iobs] = program(values)
+        else:
+            programs[0] = program(equations)
+            if function in sensi_functions:
+                # does not depend on the parameter index
+                programs = {ipar: programs[0] for ipar in range(num_par)}
+
+        return {index: builder for index, builder in programs.items()
+                if builder.instructions}
+
+    def _sparsity(self, function: str) -> List[str]:
+        """Sparsity pattern records of a sparse function"""
+        from .ode_export import multiobs_functions
+
+        colptrs = self.model.colptrs(function)
+        rowvals = self.model.rowvals(function)
+        if function not in multiobs_functions:
+            colptrs, rowvals = [colptrs], [rowvals]
+        return [
+            ' '.join(['sparsity', function, str(index),
+                      'colptrs', str(len(cp)), *map(str, cp),
+                      'rowvals', str(len(rv)), *map(str, rv)])
+            for index, (cp, rv) in enumerate(zip(colptrs, rowvals))
+        ]
+
+    def _header(self) -> List[str]:
+        """Model metadata, see
+        :meth:`amici.ode_export.ODEExporter._write_model_header_cpp`"""
+        model = self.model
+        exporter = self.exporter
+
+        def names(key: str, values) -> List[str]:
+            values = list(values)
+            return [f'{key} {len(values)}',
+                    *(str(value).replace('\n', ' ') for value in values)]
+
+        def values(key: str, entries) -> str:
+            return ' '.join([key, str(len(entries)), *map(str, entries)])
+
+        nx_solver = model.num_states_solver()
+        dimensions = [
+            model.num_states_rdata(),  # nx_rdata
+            model.num_states_rdata(),  # nxtrue_rdata
+            nx_solver,  # nx_solver
+            nx_solver,  # nxtrue_solver
+            model.num_state_reinits(),  # nx_solver_reinit
+            model.num_par(),  # np
+            model.num_const(),  # nk
+            model.num_obs(),  # ny
+            model.num_obs(),  # nytrue
+            0,  # nz
+            0,  # nztrue
+            model.num_events(),  # ne
+            1,  # nJ
+            len(model.sym('w')),  # nw
+            len(model.sparsesym('dwdx')),  # ndwdx
+            len(model.sparsesym(
+                'dwdp', force_generate=exporter.generate_sensitivity_code
+            )),  # ndwdp
+            len(model.sparsesym('dwdw')),  # ndwdw
+            len(model.sparsesym('dxdotdw')),  # ndxdotdw
+            len(model.sparsesym('dx_rdatadx_solver')),  # ndxrdatadxsolver
+            len(model.sparsesym('dx_rdatadtcl')),  # ndxrdatadtcl
+            len(model.sparsesym('dtotal_cldx_rdata')),  # ndtotal_cldx_rdata
+            0,  # nnz
+            nx_solver,  # ubw
+            nx_solver,  # lbw
+        ]
+        return [
+            f'AMICI_BYTECODE {BYTECODE_FORMAT_VERSION}',
+            f'name {exporter.model_name}',
+            f'amici_version {__version__}',
+            f'amici_commit {__commit__ or "unknown"}',
+            ' '.join(['dimensions', *map(str, dimensions)]),
+            values('ndJydy', [len(x) for x in model.sparsesym('dJydy')]),
+            f"ndxdotdp_explicit {len(model.sparsesym('dxdotdp_explicit', force_generate=exporter.generate_sensitivity_code))}",
+            f"ndxdotdx_explicit {len(model.sparsesym('dxdotdx_explicit'))}",
+            f'w_recursion_depth {model._w_recursion_depth}',
+            f'reinit_fixpar_initcond '
+            f'{int(exporter.allow_reinit_fixpar_initcond)}',
+            f'quadratic_llh {int(model._has_quadratic_nllh)}',
+            values('parameters', [repr(float(v)) for v in model.val('p')]),
+            values('fixed_parameters',
+                   [repr(float(v)) for v in model.val('k')]),
+            *names('parameter_names', model.name('p')),
+            *names('fixed_parameter_names', model.name('k')),
+            *names('state_names', model.name('x_rdata')),
+            *names('observable_names', model.name('y')),
+            *names('expression_names', model.name('w')),
+            *names('parameter_ids', map(strip_pysb, model.sym('p'))),
+            *names('fixed_parameter_ids', map(strip_pysb, model.sym('k'))),
+            *names('state_ids', map(strip_pysb, model.sym('x_rdata'))),
+            *names('observable_ids', map(strip_pysb, model.sym('y'))),
+            *names('expression_ids', map(strip_pysb, model.sym('w'))),
+            values('state_idxs_solver', [
+                idx for idx, state in enumerate(model._states)
+                if not state.has_conservation_law()
+            ]),
+            values('observable_scalings',
+                   model.get_observable_transformations()),
+        ]
+
+    def lines(self) -> List[str]:
+        """All lines of the bytecode file"""
+        from .ode_export import (
+            nobody_functions, sensi_functions, sparse_functions,
+            sparse_sensi_functions
+        )
+
+        lines = []
+        for function in self.exporter.functions:
+            if function in nobody_functions:
+                continue
+            if function in sensi_functions + sparse_sensi_functions and \
+                    not self.exporter.generate_sensitivity_code:
+                continue
+            programs = self._programs(function)
+            for index, builder in sorted(programs.items()):
+                lines.extend(builder.to_lines(function, index))
+            if function in sparse_functions and programs:
+                lines.extend(self._sparsity(function))
+
+        return self._header() + lines + ['end']
+
+
+@log_execution_time('writing bytecode', logger)
+def write_bytecode(exporter: 'ODEExporter',
+                   filename: Optional[Union[str, Path]] = None) -> Path:
+    """
+    Write the bytecode of a model.
+
+    :param exporter:
+        exporter of the model. Model options such as
+        ``assume_pow_positivity`` or ``generate_sensitivity_code`` apply to
+        the bytecode as well.
+
+    :param filename:
+        output file, defaults to ``<model_name>.amici_bytecode`` in the
+        model directory
+
+    :return:
+        path of the bytecode file
+    """
+    if filename is None:
+        filename = Path(exporter.model_path,
+                        f'{exporter.model_name}{BYTECODE_SUFFIX}')
+    filename = Path(filename)
+    lines = _BytecodeWriter(exporter).lines()
+    filename.parent.mkdir(parents=True, exist_ok=True)
+    tmp_filename = filename.with_name(f'.{filename.name}.{os.getpid()}')
+    with open(tmp_filename, 'w') as f:
+        f.write('\n'.join(lines))
+        f.write('\n')
+    os.replace(tmp_filename, filename)
+    return filename
+
+
+def get_model(model_name: str, model_dir: Union[str, Path]):
+    """
+    Load a bytecode model written by
+    :meth:`amici.ode_export.ODEExporter.generate_model_bytecode`, e.g. via
+    ``SbmlImporter.sbml2amici(..., backend='bytecode')``.
+
+    :param model_name:
+        name of the model
+
+    :param model_dir:
+        model directory
+
+    :return:
+        :class:`amici.Model` instance
+    """
+    import amici
+
+    return amici.loadBytecodeModel(
+        str(Path(model_dir, f'{model_name}{BYTECODE_SUFFIX}')))
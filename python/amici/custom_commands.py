@@ -1,7 +1,9 @@
 """Custom setuptools commands for AMICI installation"""
 
 import glob
+import hashlib
 import os
+import re
 import subprocess
 import sys
 from shutil import copyfile
@@ -43,7 +45,15 @@ class AmiciInstall(install):
 def compile_parallel(self, sources, output_dir=None, macros=None,
                      include_dirs=None, debug=0, extra_preargs=None,
                      extra_postargs=None, depends=None):
-    """Parallelized version of distutils.ccompiler.compile"""
+    """
+    Parallelized version of distutils.ccompiler.compile
+
+    If the compiler has an ``object_hash_salt`` attribute, object files are
+    only recompiled if the hash of the source, the model headers it includes
+    (from the same directory), the compiler arguments and the salt changed
+    since the last compilation, unless the compiler was created with
+    ``force``.
+    """
 
     macros, objects, extra_postargs, pp_opts, build = \
         self._setup_compile(output_dir, macros, include_dirs, sources,
@@ -57,12 +67,27 @@ def compile_parallel(self, sources, output_dir=None, macros=None,
         num_threads = min(len(objects), max_threads)
         num_threads = max(1, num_threads)
 
+    salt = getattr(self, 'object_hash_salt', None)
+    reuse_objects = salt is not None and not self.force
+
     def _single_compile(obj):
         try:
             src, ext = build[obj]
         except KeyError:
             return
+        if reuse_objects:
+            object_hash = _get_object_hash(
+                src, [*getattr(self, 'compiler_so', []), *cc_args,
+                      *extra_postargs, *pp_opts, salt])
+            hash_file = f'{obj}.sha256'
+            if os.path.isfile(obj) and os.path.isfile(hash_file):
+                with open(hash_file) as f:
+                    if f.read() == object_hash:
+                        return
         self._compile(obj, src, ext, cc_args, extra_postargs, pp_opts)
+        if reuse_objects:
+            with open(hash_file, 'w') as f:
+                f.write(object_hash)
 
     if num_threads > 1:
         import multiprocessing.pool
@@ -76,6 +101,37 @@ def compile_parallel(self, sources, output_dir=None, macros=None,
     return objects
 
 
+def _get_object_hash(src: str, args: List[str]) -> str:
+    """
+    Hash of the inputs of the compilation of a source file
+
+    :param src:
+        source file
+
+    :param args:
+        compiler command and arguments
+
+    :return:
+        hex digest
+    """
+    hasher = hashlib.sha256()
+    for arg in args:
+        hasher.update(arg.encode())
+        hasher.update(b'\0')
+    with open(src, 'rb') as f:
+        code = f.read()
+    hasher.update(code)
+    # generated headers are not covered by the version of AMICI
+    src_dir = os.path.dirname(src)
+    for header in re.findall(rb'^#include "([^"]+)"', code,
+                             flags=re.MULTILINE):
+        header = os.path.join(src_dir, header.decode())
+        if os.path.isfile(header):
+            with open(header, 'rb') as f:
+                hasher.update(f.read())
+    return hasher.hexdigest()
+
+
 class AmiciBuildCLib(build_clib):
     """Custom build_clib"""
 
@@ -229,3 +229,36 @@ def get_switch_statement(condition: str, cases: Dict[int, List[str]],
 
     return lines
 
+
+
+def split_statements(statements: List[str],
+                     max_size: int) -> List[List[str]]:
+    """
+    Split a sequence of C++ statements into chunks of balanced size
+
+    :param statements:
+        Statements, to be executed in the given order
+
+    :param max_size:
+        Approximate maximum number of characters per chunk. Individual
+        statements are never split.
+
+    :return:
+        Consecutive chunks of statements
+    """
+    total_size = sum(map(len, statements))
+    num_chunks = -(-total_size // max_size)
+    if num_chunks <= 1:
+        return [statements]
+
+    target_size = total_size / num_chunks
+    chunks = [[]]
+    chunk_size = 0
+    for statement in statements:
+        # start a new chunk if this gets us closer to the target size
+        if chunks[-1] and chunk_size + len(statement) / 2 > target_size:
+            chunks.append([])
+            chunk_size = 0
+        chunks[-1].append(statement)
+        chunk_size += len(statement)
+    return chunks
@@ -8,7 +8,9 @@ import numpy as np
 import copy
 import collections
 
-from . import ExpDataPtr, ReturnDataPtr, ExpData, ReturnData
+from . import (ExpDataPtr, ReturnDataPtr, ExpData, ReturnData, DoubleVector,
+               IntVector, ReturnDataArena, stdVec2ndarrayView,
+               returnDataArenaStorageView)
 from typing import Union, List, Dict, Iterator
 
 
@@ -16,9 +18,11 @@ class SwigPtrView(collections.abc.Mapping):
     """
     Interface class to expose std::vector<double> and scalar members of
     swig wrapped C++ objects as numpy array attributes and fields. This
-    class is memory efficient as copies of the underlying C++ objects is
-    only created when respective fields are accessed for the first time.
-    Cached copies are used for all subsequent calls.
+    class is memory efficient as numpy arrays are only created when
+    respective fields are accessed for the first time. Vector members are
+    exposed as views that share memory with the underlying C++ object and
+    keep it alive, which are read-only for double vectors, other fields are
+    copied. Cached arrays are used for all subsequent calls.
 
     :ivar _swigptr: pointer to the c++ object
     :ivar _field_names: names of members that will be exposed as numpy arrays
@@ -32,9 +36,9 @@ class SwigPtrView(collections.abc.Mapping):
 
     def __getitem__(self, item: str) -> Union[np.ndarray, float]:
         """
-        Access to field names, copies data from C++ object into numpy
-        array, reshapes according to field dimensions and stores values in
-        cache.
+        Access to field names, wraps or copies data from C++ object into
+        numpy array, reshapes according to field dimensions and stores values
+        in cache.
 
         :param item: field name
         :return: value
@@ -116,6 +120,18 @@ class SwigPtrView(collections.abc.Mapping):
         other._cache = self._cache
         return other
 
+    def __reduce__(self):
+        """
+        Pickle only the underlying C++ object, cached arrays are recreated
+        on access
+
+        :returns: constructor and arguments for unpickling
+        """
+        swigptr = self._swigptr
+        if isinstance(swigptr, (ExpDataPtr, ReturnDataPtr)):
+            swigptr = swigptr.get()
+        return self.__class__, (swigptr,)
+
     def __contains__(self, item) -> bool:
         """
         Faster implementation of __contains__ that avoids copy of the field
@@ -153,12 +169,16 @@ class ReturnDataView(SwigPtrView):
         'ssigmaz', 'sllh', 's2llh', 'J', 'xdot', 'status', 'llh',
         'chi2', 'res', 'sres', 'FIM', 'w', 'preeq_wrms', 'preeq_t',
         'preeq_numsteps', 'preeq_numstepsB', 'preeq_status', 'preeq_cpu_time',
-        'preeq_cpu_timeB', 'posteq_wrms', 'posteq_t', 'posteq_numsteps',
+        'preeq_cpu_timeB', 'preeq_wall_time', 'preeq_wall_timeB',
+        'posteq_wrms', 'posteq_t', 'posteq_numsteps',
         'posteq_numstepsB', 'posteq_status', 'posteq_cpu_time',
-        'posteq_cpu_timeB', 'numsteps', 'numrhsevals',
+        'posteq_cpu_timeB', 'posteq_wall_time', 'posteq_wall_timeB',
+        'numsteps', 'numrhsevals',
         'numerrtestfails', 'numnonlinsolvconvfails', 'order', 'cpu_time',
         'numstepsB', 'numrhsevalsB', 'numerrtestfailsB',
-        'numnonlinsolvconvfailsB', 'cpu_timeB', 'cpu_time_total'
+        'numnonlinsolvconvfailsB', 'cpu_timeB', 'cpu_time_total',
+        'wall_time', 'wall_timeB', 'wall_time_total',
+        'model_workspace_bytes', 'profile_calls', 'profile_time'
     ]
 
     def __init__(self, rdata: Union[ReturnDataPtr, ReturnData]):
@@ -170,12 +190,14 @@ class ReturnDataView(SwigPtrView):
         if not isinstance(rdata, (ReturnDataPtr, ReturnData)):
             raise TypeError(f'Unsupported pointer {type(rdata)}, must be'
                             f'amici.ExpDataPtr!')
+        # state trajectories may be reported at a subset of timepoints only
+        nt_trajectory = rdata.ntTrajectory()
         self._field_dimensions = {
             'ts': [rdata.nt],
-            'x': [rdata.nt, rdata.nx],
+            'x': [nt_trajectory, rdata.nx],
             'x0': [rdata.nx],
             'x_ss': [rdata.nx],
-            'sx': [rdata.nt, rdata.nplist, rdata.nx],
+            'sx': [nt_trajectory, rdata.nplist, rdata.nx],
             'sx0': [rdata.nplist, rdata.nx],
             'sx_ss': [rdata.nplist, rdata.nx],
 
@@ -205,7 +227,7 @@ class ReturnDataView(SwigPtrView):
 
             # diagnosis
             'J': [rdata.nx_solver, rdata.nx_solver],
-            'w': [rdata.nt, rdata.nw],
+            'w': [nt_trajectory, rdata.nw],
             'xdot': [rdata.nx_solver],
             'preeq_numlinsteps': [rdata.newton_maxsteps, 2],
             'preeq_numsteps': [1, 3],
@@ -222,6 +244,9 @@ class ReturnDataView(SwigPtrView):
             'numrhsevalsB': [rdata.nt],
             'numerrtestfailsB': [rdata.nt],
             'numnonlinsolvconvfailsB': [rdata.nt],
+            # indexed by amici.getProfiledFunctionNames()
+            'profile_calls': [len(rdata.profile_calls)],
+            'profile_time': [len(rdata.profile_time)],
         }
         super(ReturnDataView, self).__init__(rdata)
 
@@ -239,6 +264,93 @@ class ReturnDataView(SwigPtrView):
         return super(ReturnDataView, self).__getitem__(item)
 
 
+class ReturnDataArenaView(collections.abc.Mapping):
+    """
+    Interface class for the results of a batch of simulations stored in a
+    C++ ReturnDataArena. Each field is exposed as read-only numpy array of
+    shape ``(number of simulations, *dimensions)``, that shares memory with
+    the arena. The view and its arrays keep the storage of the batch alive,
+    they remain valid when the arena is reused for another batch of
+    simulations or destroyed.
+
+    :ivar _storage: storage of the batch
+    :ivar _cache: dictionary with cached values
+    """
+
+    def __init__(self, arena: ReturnDataArena):
+        """
+        Constructor
+
+        :param arena: arena holding the results
+        """
+        if not isinstance(arena, ReturnDataArena):
+            raise TypeError(f'Unsupported type {type(arena)}, must be'
+                            f'amici.ReturnDataArena!')
+        self._storage = returnDataArenaStorageView(arena)
+        self._num_simulations = arena.getNumSimulations()
+        self._layout = {
+            name: (arena.getFieldOffset(name), arena.getFieldSize(name),
+                   list(arena.getFieldShape(name)))
+            for name in arena.getFieldNames()
+        }
+        self._status = np.array(arena.getStatus(), dtype=np.int64)
+        self._cache = dict()
+        self._field_names = list(self._layout.keys()) + ['status']
+
+    def __getitem__(self, item: str) -> np.ndarray:
+        """
+        Access to field names, `t` is mapped to `ts`
+
+        :param item: field name
+
+        :returns: field values of all simulations
+        """
+        if item == 't':
+            item = 'ts'
+        if item in self._cache:
+            return self._cache[item]
+        if item not in self._field_names:
+            raise KeyError(f'Unknown field name {item}.')
+
+        if item == 'status':
+            value = self._status
+        else:
+            nsim = self._num_simulations
+            offset, size, shape = self._layout[item]
+            value = self._storage[offset:offset + nsim * size].reshape(
+                [nsim, *shape])
+        self._cache[item] = value
+        return value
+
+    def __getattr__(self, item) -> np.ndarray:
+        """
+        Attribute accessor for field names
+
+        :param item: field name
+
+        :returns: value
+        """
+        if item.startswith('_'):
+            raise AttributeError(item)
+        return self.__getitem__(item)
+
+    def __len__(self) -> int:
+        """
+        Returns the number of available fields
+
+        :returns: number of fields
+        """
+        return len(self._field_names)
+
+    def __iter__(self) -> Iterator:
+        """
+        Create an iterator of the fields
+
+        :returns: iterator over field names
+        """
+        return iter(self._field_names)
+
+
 class ExpDataView(SwigPtrView):
     """
     Interface class for C++ Exp Data objects that avoids possibly costly
@@ -246,7 +358,8 @@ class ExpDataView(SwigPtrView):
     """
 
     _field_names = [
-        'observedData', 'observedDataStdDev', 'observedEvents',
+        'observedData', 'observedDataStdDev', 'observedDataIndptr',
+        'observedDataIndices', 'observedEvents',
         'observedEventsStdDev', 'fixedParameters',
         'fixedParametersPreequilibration',
         'fixedParametersPresimulation'
@@ -264,6 +377,9 @@ class ExpDataView(SwigPtrView):
         self._field_dimensions = {  # observables
             'observedData': [edata.nt(), edata.nytrue()],
             'observedDataStdDev': [edata.nt(), edata.nytrue()],
+            # index of set data points in compressed sparse row format
+            'observedDataIndptr': [edata.nt() + 1],
+            'observedDataIndices': [edata.nObservedData()],
 
             # event observables
             'observedEvents': [edata.nmaxevent(), edata.nztrue()],
@@ -276,8 +392,10 @@ class ExpDataView(SwigPtrView):
             'fixedParametersPresimulation': [
                 len(edata.fixedParametersPreequilibration)],
         }
-        edata.observedData = edata.getObservedData()
-        edata.observedDataStdDev = edata.getObservedDataStdDev()
+        edata.observedData = edata.getObservedDataDense()
+        edata.observedDataStdDev = edata.getObservedDataStdDevDense()
+        edata.observedDataIndptr = edata.getObservedDataIndptr()
+        edata.observedDataIndices = edata.getObservedDataIndices()
         edata.observedEvents = edata.getObservedEvents()
         edata.observedEventsStdDev = edata.getObservedEventsStdDev()
         super(ExpDataView, self).__init__(edata)
@@ -289,7 +407,8 @@ def field_as_numpy(field_dimensions: Dict[str, List[int]],
                                                            None]:
     """
     Convert data object field to numpy array with dimensions according to
-    specified field dimensions
+    specified field dimensions. Double vector members are wrapped without
+    copying as read-only arrays.
 
     :param field_dimensions: dimension specifications
             dict({field: list([dim1, dim2, ...])})
@@ -303,7 +422,13 @@ def field_as_numpy(field_dimensions: Dict[str, List[int]],
     if field in field_dimensions.keys():
         if len(attr) == 0:
             return None
-        else:
-            return np.array(attr).reshape(field_dimensions[field])
+        dims = field_dimensions[field]
+        if isinstance(attr, DoubleVector) and len(attr) == np.prod(dims):
+            # zero-copy read-only view on the C++ member, keeps `data` alive
+            return stdVec2ndarrayView(attr, dims, data)
+        if isinstance(attr, IntVector) and len(attr) == np.prod(dims):
+            # copy to int64, as for other integer fields
+            return stdVec2ndarrayView(attr, dims, data).astype(np.int64)
+        return np.array(attr).reshape(dims)
     else:
         return float(attr)
@@ -10,13 +10,17 @@ directly call any function from this module as this will be done by
 """
 import contextlib
 import copy
+import hashlib
 import itertools
 import logging
 import os
+import pickle
 import re
 import shutil
+import stat
 import subprocess
 import sys
+import zlib
 from dataclasses import dataclass
 from itertools import chain, starmap
 from pathlib import Path
@@ -32,7 +36,8 @@ from sympy.matrices.immutable import ImmutableDenseMatrix
 from . import (__commit__, __version__, amiciModulePath, amiciSrcPath,
                amiciSwigPath, sbml_import)
 from .constants import SymbolId
-from .cxxcodeprinter import AmiciCxxCodePrinter, get_switch_statement
+from .cxxcodeprinter import (AmiciCxxCodePrinter, get_switch_statement,
+                             split_statements)
 from .import_utils import (ObservableTransformation, generate_flux_symbol,
                            smart_subs_dict, strip_pysb,
                            symbol_with_assumptions, toposort_symbols)
@@ -53,6 +58,20 @@ SWIG_CMAKE_TEMPLATE_FILE = os.path.join(amiciSwigPath,
 # Template for model/CMakeLists.txt
 MODEL_CMAKE_TEMPLATE_FILE = os.path.join(amiciSrcPath,
                                          'CMakeLists.template.cmake')
+#: Generated function bodies larger than this (characters of C++ code) are
+#: split into several source files, which can be compiled in parallel
+MAX_FUNCTION_BODY_SIZE = 200_000
+#: Generated source files smaller than this are combined into unity sources,
+#: to reduce the overhead of compiling many tiny translation units
+MAX_UNITY_MEMBER_SIZE = 10_000
+#: Number of unity sources the smaller source files are distributed over
+NUM_UNITY_SOURCES = 8
+#: Jacobians with at least this many (equation, variable) pairs are computed
+#: in parallel if ``AMICI_IMPORT_NPROCS`` > 1
+PARALLEL_MIN_JACOBIAN_SIZE = 10_000
+#: Matrices with at least this many distinct nonzero elements are simplified
+#: in parallel if ``AMICI_IMPORT_NPROCS`` > 1
+PARALLEL_MIN_SIMPLIFY_SIZE = 1_000
 
 
 @dataclass
@@ -429,25 +448,34 @@ def smart_jacobian(eq: sp.MutableDenseMatrix,
     ):
         return sp.MutableSparseMatrix(nrow, ncol, dict())
 
-    # preprocess sparsity pattern
-    elements = (
-        (i, j, a, b)
-        for i, a in enumerate(eq)
-        for j, b in enumerate(sym_var)
-        if a.has(b)
-    )
-
-    if (n_procs := int(os.environ.get("AMICI_IMPORT_NPROCS", 1))) == 1:
-        # serial
+    n_procs = _import_nprocs()
+    if n_procs == 1 or nrow * ncol < PARALLEL_MIN_JACOBIAN_SIZE:
+        # serial, preprocess sparsity pattern
+        elements = (
+            (i, j, a, b)
+            for i, a in enumerate(eq)
+            for j, b in enumerate(sym_var)
+            if a.has(b)
+        )
         return sp.MutableSparseMatrix(nrow, ncol,
             dict(starmap(_jacobian_element, elements))
         )
 
-    # parallel
+    # parallel, in blocks of rows to reduce the communication overhead. The
+    # sparsity pattern is determined in the worker processes as well.
+    # The custom Pow derivative is passed on explicitly, since it is not
+    # inherited by spawned worker processes.
     from multiprocessing import Pool
+    sym_var = list(sym_var)
+    patch_pow = sp.Pow._eval_derivative is _custom_pow_eval_derivative
+    blocks = [
+        (list(rows), [eq[i] for i in rows], sym_var, patch_pow)
+        for rows in _interleaved_blocks(nrow, 4 * n_procs)
+    ]
     with Pool(n_procs) as p:
-        mapped = p.starmap(_jacobian_element, elements)
-    return sp.MutableSparseMatrix(nrow, ncol, dict(mapped))
+        mapped = p.starmap(_jacobian_rows, blocks)
+    return sp.MutableSparseMatrix(nrow, ncol,
+                                  dict(chain.from_iterable(mapped)))
 
 
 @log_execution_time('running smart_multiply', logger)
@@ -471,6 +499,211 @@ def smart_multiply(x: Union[sp.MutableDenseMatrix, sp.MutableSparseMatrix],
     return x.multiply(y)
 
 
+def smart_applyfunc(matrix: sp.Matrix, fun: Callable) -> sp.Matrix:
+    """
+    Wrapper around :meth:`sympy.Matrix.applyfunc` that evaluates ``fun`` in
+    parallel for large matrices, if ``AMICI_IMPORT_NPROCS`` > 1. The result
+    is identical to the serial evaluation, as long as ``fun`` is a pure
+    function.
+
+    :param matrix:
+        matrix
+    :param fun:
+        function to apply to every element, e.g. a simplification
+    :return:
+        matrix with ``fun`` applied elementwise
+    """
+    global _parallel_fun
+
+    n_procs = _import_nprocs()
+    if n_procs == 1:
+        return matrix.applyfunc(fun)
+    # each distinct element is evaluated only once
+    elements = list(dict.fromkeys(matrix.values()))
+    if len(elements) < PARALLEL_MIN_SIMPLIFY_SIZE:
+        return matrix.applyfunc(fun)
+
+    import multiprocessing
+    if multiprocessing.get_start_method() == 'fork':
+        # forked workers inherit the function, which may be a lambda or
+        # closure that cannot be pickled
+        _parallel_fun, fun_arg = fun, None
+    else:
+        try:
+            pickle.dumps(fun)
+        except (pickle.PicklingError, AttributeError, TypeError):
+            logger.debug('Cannot evaluate unpicklable function in parallel.')
+            return matrix.applyfunc(fun)
+        fun_arg = fun
+
+    blocks = [
+        ([elements[i] for i in indices], fun_arg)
+        for indices in _interleaved_blocks(len(elements), 4 * n_procs)
+    ]
+    try:
+        with multiprocessing.Pool(n_procs) as p:
+            mapped = p.starmap(_apply_elements, blocks)
+    finally:
+        _parallel_fun = None
+
+    results = dict(zip(chain.from_iterable(block[0] for block in blocks),
+                       chain.from_iterable(mapped)))
+    return matrix.applyfunc(
+        lambda x: results[x] if x in results else fun(x)
+    )
+
+
+def _import_nprocs() -> int:
+    """
+    Number of processes for symbolic computations during model import, set
+    by the environment variable ``AMICI_IMPORT_NPROCS`` (default: 1)
+    """
+    return int(os.environ.get("AMICI_IMPORT_NPROCS", 1))
+
+
+def _interleaved_blocks(n: int, n_blocks: int) -> List[range]:
+    """
+    Split ``range(n)`` into at most ``n_blocks`` interleaved blocks, which
+    balances the load if the cost of the elements is correlated with their
+    position
+    """
+    return [range(i, n, n_blocks) for i in range(min(n, n_blocks))]
+
+
+class SymbolicCache:
+    """
+    Persistent cache for expensive symbolic operations during model import.
+
+    Results are stored as pickle files in the cache directory, keyed by a
+    hash of the operation, the AMICI and SymPy versions and the full
+    representation (:func:`sympy.srepr`) of the inputs. When a model is
+    re-imported after changing some of its equations, e.g. an observable,
+    only operations on the changed expressions are recomputed.
+
+    .. warning::
+
+        Loading a pickle file can execute arbitrary code. Anybody who can
+        write to the cache directory can therefore run code as the user
+        importing models. The cache directory must therefore be owned by
+        the current user and must not be writable by the group or by other
+        users.
+
+    :ivar cache_dir:
+        directory of the cache files
+
+    :ivar hits:
+        number of results loaded from the cache
+
+    :ivar misses:
+        number of results that were computed
+    """
+
+    def __init__(self, cache_dir: Union[str, Path]):
+        """
+        Create a new SymbolicCache instance.
+
+        :param cache_dir:
+            directory of the cache files, created (only accessible by the
+            current user) if it does not exist. Can be shared between models.
+
+        :raises ValueError:
+            if ``cache_dir`` is owned by another user or writable by the group
+            or by other users
+        """
+        self.cache_dir: Path = Path(cache_dir)
+        self.cache_dir.mkdir(mode=0o700, parents=True, exist_ok=True)
+        if os.name == 'posix':
+            st = self.cache_dir.stat()
+            if st.st_uid != os.getuid():
+                problem = 'is owned by another user'
+            elif st.st_mode & (stat.S_IWGRP | stat.S_IWOTH):
+                problem = 'is writable by other users'
+            else:
+                problem = None
+            if problem:
+                raise ValueError(
+                    f'The cache directory {self.cache_dir} {problem}. Cache '
+                    'files are unpickled during model import, please use a '
+                    'directory that is owned by and only writable by the '
+                    'current user.')
+        self.hits: int = 0
+        self.misses: int = 0
+
+    def __call__(self, operation: str, fun: Callable, *args: sp.Basic) -> Any:
+        """
+        Evaluate ``fun(*args)`` or load its result from the cache.
+
+        :param operation:
+            unique identifier of ``fun``, including any settings that
+            affect the result
+
+        :param fun:
+            function to evaluate
+
+        :param args:
+            symbolic arguments of ``fun``
+
+        :return:
+            result of ``fun(*args)``
+        """
+        key = hashlib.sha256('\n'.join(
+            [operation, __version__, __commit__, sp.__version__,
+             *map(sp.srepr, args)]
+        ).encode()).hexdigest()
+        filename = self.cache_dir / f'{key}.pickle'
+        if filename.exists():
+            try:
+                with open(filename, 'rb') as f:
+                    result = pickle.load(f)
+                self.hits += 1
+                return result
+            except Exception as e:
+                logger.debug(f'Ignoring invalid cache file {filename}: {e}')
+
+        self.misses += 1
+        result = fun(*args)
+        # write to a temporary file first, such that concurrent imports never
+        # read incomplete files
+        tmp_filename = filename.with_suffix(f'.{os.getpid()}.tmp')
+        try:
+            with open(tmp_filename, 'wb') as f:
+                pickle.dump(result, f, protocol=pickle.HIGHEST_PROTOCOL)
+            os.replace(tmp_filename, filename)
+        except (pickle.PicklingError, TypeError, AttributeError) as e:
+            logger.debug(f'Cannot cache result of {operation}: {e}')
+            tmp_filename.unlink(missing_ok=True)
+        return result
+
+
+def _function_id(fun: Optional[Callable]) -> str:
+    """
+    Identifier of a function for :class:`SymbolicCache` keys, which changes
+    if the code of the function changes, including lambda functions.
+
+    :param fun:
+        function
+
+    :return:
+        identifier
+    """
+    def code_id(code) -> tuple:
+        # nested code objects (e.g. of inner lambdas) have unstable reprs
+        return code.co_code, code.co_names, tuple(
+            code_id(const) if hasattr(const, 'co_code') else const
+            for const in code.co_consts
+        )
+
+    if fun is None:
+        return 'None'
+    if not hasattr(fun, '__code__'):
+        # e.g. functools.partial
+        return repr(fun)
+    return hashlib.sha256(repr((
+        getattr(fun, '__module__', None), getattr(fun, '__qualname__', None),
+        code_id(fun.__code__), getattr(fun, '__defaults__', None),
+    )).encode()).hexdigest()
+
+
 def smart_is_zero_matrix(x: Union[sp.MutableDenseMatrix,
                                   sp.MutableSparseMatrix]) -> bool:
     """A faster implementation of sympy's is_zero_matrix
@@ -582,6 +815,13 @@ class ODEModel:
         derivative expressions. Receives sympy expressions as only argument.
         To apply multiple simplifications, wrap them in a lambda expression.
 
+    :ivar _symbolic_cache:
+        If not None, persistent cache for derivatives, products and
+        simplifications
+
+    :ivar _simplify_id:
+        Identifier of :attr:`ODEModel._simplify` for the symbolic cache
+
     :ivar _x0_fixedParameters_idx:
         Index list of subset of states for which x0_fixedParameters was
         computed
@@ -599,7 +839,8 @@ class ODEModel:
 
     def __init__(self, verbose: Optional[Union[bool, int]] = False,
                  simplify: Optional[Callable] = sp.powsimp,
-                 cache_simplify: bool = False):
+                 cache_simplify: bool = False,
+                 cache_dir: Optional[Union[str, Path]] = None):
         """
         Create a new ODEModel instance.
 
@@ -613,6 +854,11 @@ class ODEModel:
         :param cache_simplify:
             Whether to cache calls to the simplify method. Can e.g. decrease
             import times for models with events.
+
+        :param cache_dir:
+            Directory for a persistent :class:`SymbolicCache` of derivatives,
+            products and simplifications. Speeds up re-imports of models in
+            which only some equations changed. Disabled by default.
         """
         self._states: List[State] = []
         self._observables: List[Observable] = []
@@ -675,6 +921,9 @@ class ODEModel:
 
         self._lock_total_derivative: List[str] = list()
         self._simplify: Callable = simplify
+        self._symbolic_cache: Optional[SymbolicCache] = \
+            SymbolicCache(cache_dir) if cache_dir is not None else None
+        self._simplify_id: str = _function_id(simplify)
         if cache_simplify and simplify is not None:
             def cached_simplify(
                 expr: sp.Expr,
@@ -796,7 +1045,7 @@ class ODEModel:
                 return dxdt / v
 
         # create dynamics without respecting conservation laws first
-        dxdt = smart_multiply(si.stoichiometric_matrix,
+        dxdt = self._multiply(si.stoichiometric_matrix,
                               MutableDenseMatrix(fluxes))
         for ix, ((species_id, species), formula) in enumerate(zip(
                 symbols[SymbolId.SPECIES].items(),
@@ -1456,18 +1705,18 @@ class ODEModel:
             # if x0_fixedParameters>0 else 0
             # sx0_fixedParameters = sx+deltasx =
             # dx0_fixed_parametersdx*sx+dx0_fixedParametersdp
-            self._eqs[name] = smart_jacobian(
+            self._eqs[name] = self._jacobian(
                 self.eq('x0_fixedParameters'), self.sym('p')
             )
 
-            dx0_fixed_parametersdx = smart_jacobian(
+            dx0_fixed_parametersdx = self._jacobian(
                 self.eq('x0_fixedParameters'), self.sym('x')
             )
 
             if not smart_is_zero_matrix(dx0_fixed_parametersdx):
                 if isinstance(self._eqs[name], ImmutableDenseMatrix):
                     self._eqs[name] = MutableDenseMatrix(self._eqs[name])
-                tmp = smart_multiply(dx0_fixed_parametersdx, self.sym('sx0'))
+                tmp = self._multiply(dx0_fixed_parametersdx, self.sym('sx0'))
                 for ip in range(self._eqs[name].shape[1]):
                     self._eqs[name][:, ip] += tmp
 
@@ -1519,7 +1768,7 @@ class ODEModel:
 
         elif name == 'dx_rdatadp':
             if self.num_cons_law():
-                self._eqs[name] = smart_jacobian(self.eq('x_rdata'),
+                self._eqs[name] = self._jacobian(self.eq('x_rdata'),
                                                  self.sym('p'))
             else:
                 # so far, dx_rdatadp is only required for sx_rdata
@@ -1530,7 +1779,7 @@ class ODEModel:
                              self.num_par())
 
         elif name == 'dx_rdatadtcl':
-            self._eqs[name] = smart_jacobian(self.eq('x_rdata'),
+            self._eqs[name] = self._jacobian(self.eq('x_rdata'),
                                              self.sym('tcl'))
 
         elif name == 'dxdotdx_explicit':
@@ -1542,7 +1791,7 @@ class ODEModel:
             self._derivative('xdot', 'p', name=name)
 
         elif name == 'drootdt':
-            self._eqs[name] = smart_jacobian(self.eq('root'), time_symbol)
+            self._eqs[name] = self._jacobian(self.eq('root'), time_symbol)
 
         elif name == 'drootdt_total':
             # backsubstitution of optimized right-hand side terms into RHS
@@ -1552,7 +1801,7 @@ class ODEModel:
                 toposort_symbols(dict(zip(self._syms['w'], self._eqs['w'])))
             tmp_xdot = smart_subs_dict(self._eqs['xdot'], w_sorted)
             self._eqs[name] = (
-                smart_multiply(self.eq('drootdx'), tmp_xdot)
+                self._multiply(self.eq('drootdx'), tmp_xdot)
                 + self.eq('drootdt')
             )
 
@@ -1570,19 +1819,19 @@ class ODEModel:
 
         elif name == 'ddeltaxdx':
             self._eqs[name] = [
-                smart_jacobian(self.eq('deltax')[ie], self.sym('x'))
+                self._jacobian(self.eq('deltax')[ie], self.sym('x'))
                 for ie in range(self.num_events())
             ]
 
         elif name == 'ddeltaxdt':
             self._eqs[name] = [
-                smart_jacobian(self.eq('deltax')[ie], time_symbol)
+                self._jacobian(self.eq('deltax')[ie], time_symbol)
                 for ie in range(self.num_events())
             ]
 
         elif name == 'ddeltaxdp':
             self._eqs[name] = [
-                smart_jacobian(self.eq('deltax')[ie], self.sym('p'))
+                self._jacobian(self.eq('deltax')[ie], self.sym('p'))
                 for ie in range(self.num_events())
             ]
 
@@ -1598,23 +1847,23 @@ class ODEModel:
                 if event._state_update is not None:
                     # ====== chain rule for the state variables ===============
                     # get xdot with expressions back-substituted
-                    tmp_eq = smart_multiply(
+                    tmp_eq = self._multiply(
                         (self.sym('xdot_old') - self.sym('xdot')),
                         self.eq('stau')[ie])
                     # construct an enhanced state sensitivity, which accounts
                     # for the time point sensitivity as well
                     tmp_dxdp = self.sym('sx') * sp.ones(1, self.num_par())
-                    tmp_dxdp += smart_multiply(self.sym('xdot'),
+                    tmp_dxdp += self._multiply(self.sym('xdot'),
                                                self.eq('stau')[ie])
-                    tmp_eq += smart_multiply(self.eq('ddeltaxdx')[ie],
+                    tmp_eq += self._multiply(self.eq('ddeltaxdx')[ie],
                                              tmp_dxdp)
                     # ====== chain rule for the time point ====================
-                    tmp_eq += smart_multiply(self.eq('ddeltaxdt')[ie],
+                    tmp_eq += self._multiply(self.eq('ddeltaxdt')[ie],
                                              self.eq('stau')[ie])
                     # ====== partial derivative for the parameters ============
                     tmp_eq += self.eq('ddeltaxdp')[ie]
                 else:
-                    tmp_eq = smart_multiply(
+                    tmp_eq = self._multiply(
                         (self.eq('xdot_old') - self.eq('xdot')),
                         self.eq('stau')[ie])
 
@@ -1633,7 +1882,7 @@ class ODEModel:
                 # the insert first in ode_model._add_conservation_law() means
                 # that we need to reverse the order here
                 for cl in reversed(self._conservationlaws)
-            ]) .col_join(smart_jacobian(self.eq('w')[self.num_cons_law():,:],
+            ]) .col_join(self._jacobian(self.eq('w')[self.num_cons_law():,:],
                                         x))
 
         elif match_deriv:
@@ -1656,11 +1905,11 @@ class ODEModel:
         if self._simplify:
             dec = log_execution_time(f'simplifying {name}', logger)
             if isinstance(self._eqs[name], list):
-                self._eqs[name] = [dec(sub_eq.applyfunc)(self._simplify)
+                self._eqs[name] = [dec(self._simplify_matrix)(sub_eq)
                                    for sub_eq in self._eqs[name]]
             else:
                 self._eqs[name] = \
-                    dec(self._eqs[name].applyfunc)(self._simplify)
+                    dec(self._simplify_matrix)(self._eqs[name])
 
     def sym_names(self) -> List[str]:
         """
@@ -1730,7 +1979,7 @@ class ODEModel:
         #  branch
         sym_var = self.sym(var, needs_stripped_symbols)
 
-        derivative = smart_jacobian(sym_eq, sym_var)
+        derivative = self._jacobian(sym_eq, sym_var)
 
         self._eqs[name] = derivative
 
@@ -1756,11 +2005,11 @@ class ODEModel:
         if name == 'dydw' and not smart_is_zero_matrix(derivative):
             dwdw = self.eq('dwdw')
             # h(k) = d{eq}dw*dwdw^k* (k=1)
-            h = smart_multiply(derivative, dwdw)
+            h = self._multiply(derivative, dwdw)
             while not smart_is_zero_matrix(h):
                 self._eqs[name] += h
                 # h(k+1) = d{eq}dw*dwdw^(k+1) = h(k)*dwdw
-                h = smart_multiply(h, dwdw)
+                h = self._multiply(h, dwdw)
 
     def _total_derivative(self, name: str, eq: str, chainvars: List[str],
                           var: str, dydx_name: str = None,
@@ -1815,7 +2064,7 @@ class ODEModel:
             # which is not checked for by sympy
             if not smart_is_zero_matrix(dydx) and not \
                     smart_is_zero_matrix(dxdz):
-                dydx_times_dxdz = smart_multiply(dydx, dxdz)
+                dydx_times_dxdz = self._multiply(dydx, dxdz)
                 if dxdz.shape[1] == 1 and \
                         self._eqs[name].shape[1] != dxdz.shape[1]:
                     for iz in range(self._eqs[name].shape[1]):
@@ -1884,7 +2133,35 @@ class ODEModel:
         xx = variables[x].transpose() if transpose_x else variables[x]
         yy = variables[y]
 
-        self._eqs[name] = sign * smart_multiply(xx, yy)
+        self._eqs[name] = sign * self._multiply(xx, yy)
+
+    def _jacobian(self, eq: sp.Matrix, sym_var: sp.Matrix) -> sp.Matrix:
+        """
+        :func:`smart_jacobian`, using the symbolic cache if enabled
+        """
+        if self._symbolic_cache is None:
+            return smart_jacobian(eq, sym_var)
+        return self._symbolic_cache('jacobian', smart_jacobian, eq, sym_var)
+
+    def _multiply(self, x: sp.Matrix, y: sp.Matrix) -> sp.Matrix:
+        """
+        :func:`smart_multiply`, using the symbolic cache if enabled
+        """
+        if self._symbolic_cache is None:
+            return smart_multiply(x, y)
+        return self._symbolic_cache('multiply', smart_multiply, x, y)
+
+    def _simplify_matrix(self, matrix: sp.Matrix) -> sp.Matrix:
+        """
+        Applies :attr:`ODEModel._simplify` to all elements of a matrix, using
+        the symbolic cache if enabled
+        """
+        if self._symbolic_cache is None:
+            return smart_applyfunc(matrix, self._simplify)
+        return self._symbolic_cache(f'simplify {self._simplify_id}',
+                                    lambda m: smart_applyfunc(m,
+                                                              self._simplify),
+                                    matrix)
 
     def _equation_from_component(self, name: str, component: str) -> None:
         """
@@ -2270,6 +2547,8 @@ class ODEExporter:
         self.allow_reinit_fixpar_initcond: bool = allow_reinit_fixpar_initcond
         self._build_hints = set()
         self.generate_sensitivity_code: bool = generate_sensitivity_code
+        # generated function sources by file name, see _write_sources
+        self._sources: Dict[str, str] = {}
 
     @log_execution_time('generating cpp code', logger)
     def generate_model_code(self) -> None:
@@ -2284,6 +2563,21 @@ class ODEExporter:
             self._generate_c_code()
             self._generate_m_code()
 
+    def generate_model_bytecode(self) -> Path:
+        """
+        Generates bytecode for the loaded model, which can be simulated
+        without compilation, see :mod:`amici.bytecode`
+
+        :return:
+            path of the bytecode file
+        """
+        from .bytecode import write_bytecode
+
+        with _monkeypatched(sp.Pow, '_eval_derivative',
+                            _custom_pow_eval_derivative):
+            os.makedirs(self.model_path, exist_ok=True)
+            return write_bytecode(self)
+
     @log_execution_time('compiling cpp code', logger)
     def compile_model(self) -> None:
         """
@@ -2333,6 +2627,7 @@ class ODEExporter:
                 continue
             self._write_index_files(name)
 
+        self._write_sources()
         self._write_wrapfunctions_cpp()
         self._write_wrapfunctions_header()
         self._write_model_header_cpp()
@@ -2343,6 +2638,10 @@ class ODEExporter:
         shutil.copy(CXX_MAIN_TEMPLATE_FILE,
                     os.path.join(self.model_path, 'main.cpp'))
 
+        if (cache := self.model._symbolic_cache) is not None:
+            logger.info(f'Loaded {cache.hits} of {cache.hits + cache.misses} '
+                        f'symbolic operations from {cache.cache_dir}')
+
     def _compile_c_code(self,
                         verbose: Optional[Union[bool, int]] = False,
                         compiler: Optional[str] = None) -> None:
@@ -2520,15 +2819,6 @@ class ODEExporter:
                 function not in non_unique_id_symbols:
             lines.append(f'#include "{self.model_name}_{function}.h"')
 
-        lines.extend([
-            '',
-            'namespace amici {',
-            f'namespace model_{self.model_name} {{',
-            '',
-            f'{func_info.return_type} {function}_{self.model_name}'
-            f'({func_info.arguments}){{'
-        ])
-
         # function body
         body = self._get_function_body(function, equations)
         if self.assume_pow_positivity and func_info.assume_pow_positivity:
@@ -2544,13 +2834,78 @@ class ODEExporter:
 
         self.functions[function].body = body
 
-        lines += body
-        lines.extend([
+        # split huge bodies of independent statements, but no control flow
+        if any(line.rstrip().endswith(('{', '}')) for line in body):
+            chunks = [body]
+        else:
+            chunks = split_statements(body, MAX_FUNCTION_BODY_SIZE)
+
+        func_name = f'{function}_{self.model_name}'
+        if len(chunks) == 1:
+            self._add_function_source(
+                f'{self.model_name}_{function}.cpp', lines,
+                f'{func_info.return_type} {func_name}'
+                f'({func_info.arguments})', body)
+            return
+
+        call_args = remove_typedefs(func_info.arguments)
+        declarations = []
+        calls = []
+        for ichunk, chunk in enumerate(chunks):
+            signature = f'void {func_name}_part{ichunk}' \
+                        f'({func_info.arguments})'
+            self._add_function_source(
+                f'{self.model_name}_{function}_part{ichunk}.cpp', lines,
+                signature, chunk)
+            declarations.append(f'{signature};')
+            calls.append(f'    {func_name}_part{ichunk}({call_args});')
+        self._add_function_source(
+            f'{self.model_name}_{function}.cpp', lines,
+            f'{func_info.return_type} {func_name}({func_info.arguments})',
+            calls, declarations)
+
+    def _add_function_source(
+            self,
+            filename: str,
+            includes: List[str],
+            signature: str,
+            body: List[str],
+            declarations: Sequence[str] = ()
+    ) -> None:
+        """
+        Add the source file of a generated function, to be written by
+        :meth:`_write_sources`.
+
+        :param filename:
+            name of the source file
+
+        :param includes:
+            include directives
+
+        :param signature:
+            function signature
+
+        :param body:
+            function body
+
+        :param declarations:
+            declarations of functions called in the body
+        """
+        lines = [
+            *includes,
+            '',
+            'namespace amici {',
+            f'namespace model_{self.model_name} {{',
+            '',
+            *declarations,
+            *([''] if declarations else []),
+            f'{signature}{{',
+            *body,
             '}',
             '',
             f'}} // namespace model_{self.model_name}',
             '} // namespace amici\n',
-        ])
+        ]
 
         # check custom functions
         for fun in CUSTOM_FUNCTIONS:
@@ -2559,11 +2914,68 @@ class ODEExporter:
                     self._build_hints.add(fun['build_hint'])
                 lines.insert(0, fun['include'])
 
-        # if not body is None:
-        filename = os.path.join(self.model_path,
-                                f'{self.model_name}_{function}.cpp')
+        self._sources[filename] = '\n'.join(lines)
+
+    def _write_sources(self) -> None:
+        """
+        Write the generated function sources. Sources smaller than
+        :data:`MAX_UNITY_MEMBER_SIZE` are combined into
+        :data:`NUM_UNITY_SOURCES` unity sources. The unity source of a file
+        only depends on its name, so that changes of other functions do not
+        change the composition of unrelated unity sources, which would
+        require recompiling them. Macros defined by the model headers are
+        undefined after each member of a unity source, since different
+        functions may use the same symbol names.
+        """
+        batches = [[] for _ in range(NUM_UNITY_SOURCES)]
+        for filename in sorted(self._sources):
+            code = self._sources[filename]
+            if len(code) >= MAX_UNITY_MEMBER_SIZE:
+                self._write_source(filename, code)
+                continue
+            # independent of the model name and stable across sessions,
+            # unlike hash()
+            function_name = filename[len(self.model_name):] \
+                if filename.startswith(self.model_name) else filename
+            batches[zlib.crc32(function_name.encode()) % len(batches)]\
+                .append(filename)
+
+        for ibatch, batch in enumerate(batches):
+            if len(batch) == 1:
+                self._write_source(batch[0], self._sources[batch[0]])
+            if len(batch) <= 1:
+                continue
+            lines = []
+            for filename in batch:
+                code = self._sources[filename]
+                lines.extend([f'// {filename}', code])
+                for header in re.findall(r'^#include "(\w+\.h)"', code,
+                                         flags=re.MULTILINE):
+                    header = os.path.join(self.model_path, header)
+                    if not os.path.isfile(header):
+                        continue
+                    with open(header) as f:
+                        lines.extend(
+                            f'#undef {macro}' for macro in re.findall(
+                                r'^#define (\w+)', f.read(),
+                                flags=re.MULTILINE))
+            self._write_source(f'{self.model_name}_unity{ibatch}.cpp',
+                               '\n'.join(lines))
+        self._sources.clear()
+
+    def _write_source(self, filename: str, code: str) -> None:
+        """
+        Write a source file to the model directory.
+
+        :param filename:
+            name of the source file
+
+        :param code:
+            file content
+        """
+        filename = os.path.join(self.model_path, filename)
         with open(filename, 'w') as fileout:
-            fileout.write('\n'.join(lines))
+            fileout.write(code)
 
     def _write_function_index(self, function: str, indextype: str) -> None:
         """
@@ -2653,10 +3065,7 @@ class ODEExporter:
         ])
 
         filename = f'{self.model_name}_{function}_{indextype}.cpp'
-        filename = os.path.join(self.model_path, filename)
-
-        with open(filename, 'w') as fileout:
-            fileout.write('\n'.join(lines))
+        self._sources[filename] = '\n'.join(lines)
 
     def _get_function_body(
             self,
@@ -3382,3 +3791,34 @@ def _custom_pow_eval_derivative(self, s):
 def _jacobian_element(i, j, eq_i, sym_var_j):
     """Compute a single element of a jacobian"""
     return (i, j), eq_i.diff(sym_var_j)
+
+
+def _jacobian_rows(rows: List[int], eqs: List[sp.Expr],
+                   sym_var: List[sp.Symbol], patch_pow: bool
+                   ) -> List[Tuple[Tuple[int, int], sp.Expr]]:
+    """
+    Compute the nonzero elements of some rows of a jacobian, see
+    :func:`smart_jacobian`
+    """
+    with _monkeypatched(sp.Pow, '_eval_derivative',
+                        _custom_pow_eval_derivative) if patch_pow \
+            else contextlib.nullcontext():
+        return [
+            _jacobian_element(i, j, eq_i, var_j)
+            for i, eq_i in zip(rows, eqs)
+            for j, var_j in enumerate(sym_var)
+            if eq_i.has(var_j)
+        ]
+
+
+#: function evaluated by :func:`_apply_elements` in forked worker processes
+_parallel_fun: Optional[Callable] = None
+
+
+def _apply_elements(elements: List[sp.Expr], fun: Optional[Callable]
+                    ) -> List[sp.Expr]:
+    """
+    Apply a function to some matrix elements, see :func:`smart_applyfunc`
+    """
+    fun = fun or _parallel_fun
+    return [fun(element) for element in elements]
@@ -585,20 +585,11 @@ def create_edata_for_condition(
                      f"{states_in_condition_table}")
 
     ##########################################################################
-    # timepoints
-
-    # find replicate numbers of time points
-    timepoints_w_reps = _get_timepoints_with_replicates(
-        df_for_condition=measurement_df)
+    # timepoints, measurements and sigmas
+    timepoints_w_reps, it, iy, y, sigma_y = _get_measurement_coordinates(
+        df_for_condition=measurement_df, observable_ids=observable_ids)
     edata.setTimepoints(timepoints_w_reps)
-
-    ##########################################################################
-    # measurements and sigmas
-    y, sigma_y = _get_measurements_and_sigmas(
-        df_for_condition=measurement_df, timepoints_w_reps=timepoints_w_reps,
-        observable_ids=observable_ids)
-    edata.setObservedData(y.flatten())
-    edata.setObservedDataStdDev(sigma_y.flatten())
+    edata.setObservedDataSparse(it, iy, y, sigma_y)
 
     return edata
 
@@ -619,95 +610,56 @@ def subset_dict(full: Dict[Any, Any],
         yield {key: val for (key, val) in full.items() if key in keys}
 
 
-def _get_timepoints_with_replicates(
-        df_for_condition: pd.DataFrame) -> List[numbers.Number]:
-    """
-    Get list of timepoints including replicate measurements
-
-    :param df_for_condition:
-        PEtab measurement table subset for a single condition.
-
-    :return:
-        Sorted list of timepoints, including multiple timepoints accounting
-        for replicate measurements.
-    """
-    # create sorted list of all timepoints for which measurements exist
-    timepoints = sorted(df_for_condition[TIME].unique().astype(float))
-
-    # find replicate numbers of time points
-    timepoints_w_reps = []
-    for time in timepoints:
-        # subselect for time
-        df_for_time = df_for_condition[
-            df_for_condition.time.astype(float) == time
-        ]
-        # rep number is maximum over rep numbers for observables
-        n_reps = max(df_for_time.groupby(
-            [OBSERVABLE_ID, TIME]).size())
-        # append time point n_rep times
-        timepoints_w_reps.extend([time] * n_reps)
-
-    return timepoints_w_reps
-
-
-def _get_measurements_and_sigmas(
+def _get_measurement_coordinates(
         df_for_condition: pd.DataFrame,
-        timepoints_w_reps: Sequence[numbers.Number],
         observable_ids: Sequence[str],
-    ) -> Tuple[np.array, np.array]:
+) -> Tuple[List[float], List[int], List[int], List[float], List[float]]:
     """
-    Get measurements and sigmas
+    Get timepoints and measurements in coordinate format
 
-    Generate arrays with measurements and sigmas in AMICI format from a
-    PEtab measurement table subset for a single condition.
+    Timepoints are repeated as often as the maximum number of replicate
+    measurements of any observable at that time. Measurements and sigmas
+    are returned as lists of (timepoint index, observable index, value),
+    which avoids filling dense arrays row by row.
 
     :param df_for_condition:
         Subset of PEtab measurement table for one condition
 
-    :param timepoints_w_reps:
-        Timepoints for which there exist measurements, including replicates
-
     :param observable_ids:
         List of observable IDs for mapping IDs to indices.
 
     :return:
-        arrays for measurement and sigmas
+        Sorted list of timepoints including replicates, timepoint indices,
+        observable indices, measurements and sigmas (NaN if not numeric)
     """
-    # prepare measurement matrix
-    y = np.full(shape=(len(timepoints_w_reps), len(observable_ids)),
-                fill_value=np.nan)
-    # prepare sigma matrix
-    sigma_y = y.copy()
-
-    timepoints = sorted(df_for_condition[TIME].unique().astype(float))
-
-    for time in timepoints:
-        # subselect for time
-        df_for_time = df_for_condition[df_for_condition[TIME] == time]
-        time_ix_0 = timepoints_w_reps.index(time)
-
-        # remember used time indices for each observable
-        time_ix_for_obs_ix = {}
-
-        # iterate over measurements
-        for _, measurement in df_for_time.iterrows():
-            # extract observable index
-            observable_ix = observable_ids.index(measurement[OBSERVABLE_ID])
-
-            # update time index for observable
-            if observable_ix in time_ix_for_obs_ix:
-                time_ix_for_obs_ix[observable_ix] += 1
-            else:
-                time_ix_for_obs_ix[observable_ix] = time_ix_0
-
-            # fill observable and possibly noise parameter
-            y[time_ix_for_obs_ix[observable_ix],
-              observable_ix] = measurement[MEASUREMENT]
-            if isinstance(measurement.get(NOISE_PARAMETERS, None),
-                          numbers.Number):
-                sigma_y[time_ix_for_obs_ix[observable_ix],
-                        observable_ix] = measurement[NOISE_PARAMETERS]
-    return y, sigma_y
+    time = df_for_condition[TIME].astype(float)
+    observable_ix = df_for_condition[OBSERVABLE_ID].map(
+        {observable_id: ix for ix, observable_id in enumerate(observable_ids)})
+    if observable_ix.isna().any():
+        unknown = df_for_condition[OBSERVABLE_ID][observable_ix.isna()]
+        raise ValueError(f'Unknown observables {set(unknown)}.')
+
+    # replicate number of each measurement in the order of the table
+    replicate = df_for_condition.groupby(
+        [df_for_condition[OBSERVABLE_ID], time]).cumcount()
+    # every timepoint is repeated as often as its most replicated observable
+    n_reps = replicate.groupby(time).max() + 1
+    offsets = n_reps.cumsum() - n_reps
+    timepoints_w_reps = np.repeat(n_reps.index.values, n_reps.values)
+
+    it = time.map(offsets) + replicate
+
+    if NOISE_PARAMETERS in df_for_condition:
+        sigma_y = df_for_condition[NOISE_PARAMETERS].map(
+            lambda x: x if isinstance(x, numbers.Number) else np.nan)
+    else:
+        sigma_y = pd.Series(np.nan, index=df_for_condition.index)
+
+    # lists, since swig does not convert numpy integer types
+    return (timepoints_w_reps.tolist(), it.astype(int).tolist(),
+            observable_ix.astype(int).tolist(),
+            df_for_condition[MEASUREMENT].astype(float).tolist(),
+            sigma_y.astype(float).tolist())
 
 
 def rdatas_to_measurement_df(
@@ -0,0 +1,231 @@
+"""
+Profile-guided optimization
+---------------------------
+This module provides functions to build model extensions with profile-guided
+optimization (PGO) and link-time optimization (LTO).
+
+The model extension is first built with instrumentation, then a training
+simulation is run, and finally the extension is rebuilt using the recorded
+profile. Inlining across libamici and the generated model code additionally
+requires the AMICI package to be installed with ``ENABLE_AMICI_LTO=TRUE``.
+
+Requires GCC or Clang, for the latter ``llvm-profdata`` has to be available.
+"""
+import logging
+import os
+import shutil
+import subprocess
+import sys
+import time
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Union
+
+from .logging import get_logger
+
+logger = get_logger(__name__, logging.INFO)
+
+#: prefix of the line with the simulation time printed by the default training
+_TRAINING_TIME_PREFIX = 'AMICI_TRAINING_TIME'
+
+
+def compile_model_pgo(
+        model_name: str,
+        model_dir: Union[Path, str],
+        training_command: Optional[Sequence[str]] = None,
+        lto: bool = True,
+        verbose: Optional[Union[bool, int]] = False,
+        compiler: Optional[str] = None,
+) -> Dict[str, float]:
+    """
+    Build a model extension with profile-guided optimization.
+
+    If the model extension has already been built, the training simulation
+    is run with that build first, to report the speedup.
+
+    :param model_name:
+        Name of the model package
+
+    :param model_dir:
+        Directory of the model package, as used for model import
+
+    :param training_command:
+        Command that simulates the model with representative settings, run
+        in the current working directory. Defaults to :func:`train`, which
+        simulates the model with its default settings.
+
+    :param lto:
+        Build the model extension with link-time optimization
+
+    :param verbose:
+        Make model compilation verbose
+
+    :param compiler:
+        distutils/setuptools compiler selection to build the python extension
+
+    :return:
+        Wall times [s] of the training simulation with the previous build
+        (``'baseline'``, if it exists) and the optimized build (``'pgo'``)
+    """
+    model_dir = Path(model_dir).absolute()
+    profile_dir = model_dir / 'pgo_profile'
+    if training_command is None:
+        training_command = [sys.executable, '-m', 'amici.pgo', model_name,
+                            str(model_dir)]
+
+    times = {}
+    if list((model_dir / model_name).glob(f'_{model_name}*')):
+        times['baseline'] = _run_training(training_command)
+
+    shutil.rmtree(profile_dir, ignore_errors=True)
+    env = {'ENABLE_AMICI_LTO': 'TRUE'} if lto else {}
+    logger.info('Building instrumented model extension')
+    _build_extension(model_dir, verbose, compiler,
+                     {**env, 'AMICI_PGO_GENERATE': str(profile_dir)})
+    _run_training(training_command)
+    _merge_clang_profiles(profile_dir)
+    logger.info('Building optimized model extension')
+    _build_extension(model_dir, verbose, compiler,
+                     {**env, 'AMICI_PGO_USE': str(profile_dir)})
+
+    times['pgo'] = _run_training(training_command)
+    if 'baseline' in times:
+        logger.info(f"Training simulation took {times['pgo']:.3g}s "
+                    f"(previous build: {times['baseline']:.3g}s, "
+                    f"speedup {times['baseline'] / times['pgo']:.2f}x)")
+    return times
+
+
+def train(model_name: str, model_dir: Union[Path, str]) -> float:
+    """
+    Default training for :func:`compile_model_pgo`.
+
+    Simulates the model with its default parameters, timepoints and solver
+    settings, without sensitivities and with forward and adjoint
+    sensitivities, and prints the total simulation time. The model is fitted
+    to example data generated from a simulation with the default settings
+    (:class:`amici.amici.ExpData` created from its ReturnData with unit noise
+    standard deviations), so that the objective function and its gradient
+    are part of the profile.
+
+    :param model_name:
+        Name of the model package
+
+    :param model_dir:
+        Directory of the model package
+
+    :return:
+        Wall time of all simulations [s]
+    """
+    import amici
+
+    model_module = amici.import_model_module(model_name, model_dir)
+    model = model_module.getModel()
+    if not len(model.getTimepoints()):
+        raise ValueError('The model has no timepoints, please provide a '
+                         'training_command with representative settings.')
+    solver = model.getSolver()
+    rdata = amici.runAmiciSimulation(model, solver)
+    if rdata['status'] != amici.AMICI_SUCCESS:
+        raise RuntimeError(f'Simulation with the default settings failed '
+                           f'with status {rdata["status"]}.')
+    edata = amici.ExpData(rdata, 1.0, 1.0)
+
+    wall_time = 0.0
+    for method in (amici.SensitivityMethod.none,
+                   amici.SensitivityMethod.forward,
+                   amici.SensitivityMethod.adjoint):
+        if method == amici.SensitivityMethod.adjoint and not model.ny:
+            continue
+        solver.setSensitivityMethod(method)
+        solver.setSensitivityOrder(
+            amici.SensitivityOrder.none
+            if method == amici.SensitivityMethod.none
+            else amici.SensitivityOrder.first)
+        start = time.perf_counter()
+        rdata = amici.runAmiciSimulation(model, solver, edata)
+        wall_time += time.perf_counter() - start
+        if rdata['status'] != amici.AMICI_SUCCESS:
+            raise RuntimeError(f'Training simulation failed with status '
+                               f'{rdata["status"]}.')
+    print(f'{_TRAINING_TIME_PREFIX} {wall_time}')
+    return wall_time
+
+
+def _run_training(training_command: Sequence[str]) -> float:
+    """
+    Run the training command.
+
+    :return:
+        Simulation time reported by :func:`train`, otherwise the wall time
+        of the command [s]
+    """
+    start = time.perf_counter()
+    result = subprocess.run(list(training_command),
+                            stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT)
+    wall_time = time.perf_counter() - start
+    output = result.stdout.decode('utf-8')
+    if result.returncode:
+        print(output)
+        raise RuntimeError('PGO training simulation failed.')
+
+    for line in output.splitlines():
+        if line.startswith(_TRAINING_TIME_PREFIX):
+            return float(line.split()[1])
+    return wall_time
+
+
+def _build_extension(model_dir: Path,
+                     verbose: Optional[Union[bool, int]],
+                     compiler: Optional[str],
+                     env: Dict[str, str]) -> None:
+    """
+    Rebuild the model extension with additional environment variables, see
+    :meth:`amici.ode_export.ODEExporter._compile_c_code`.
+    """
+    script_args: List[str] = [sys.executable,
+                              str(model_dir / 'setup.py'),
+                              '--verbose' if verbose else '--quiet',
+                              'build_ext', f'--build-lib={model_dir}',
+                              '--force']
+    if compiler is not None:
+        script_args.append(f'--compiler={compiler}')
+
+    try:
+        result = subprocess.run(script_args,
+                                cwd=model_dir,
+                                env={**os.environ, **env},
+                                stdout=subprocess.PIPE,
+                                stderr=subprocess.STDOUT,
+                                check=True)
+    except subprocess.CalledProcessError as e:
+        print(e.output.decode('utf-8'))
+        print("Failed building the model extension.")
+        raise
+
+    if verbose:
+        print(result.stdout.decode('utf-8'))
+
+
+def _merge_clang_profiles(profile_dir: Path) -> None:
+    """
+    Merge raw profiles written by Clang-instrumented builds, which, unlike
+    the profiles written by GCC, cannot be used directly.
+    """
+    raw_profiles = [str(f) for f in profile_dir.glob('*.profraw')]
+    if not raw_profiles:
+        return
+
+    llvm_profdata = os.environ.get('LLVM_PROFDATA',
+                                   shutil.which('llvm-profdata'))
+    if llvm_profdata is None:
+        raise RuntimeError('llvm-profdata is required for profile-guided '
+                           'optimization with Clang. Set LLVM_PROFDATA to '
+                           'its location.')
+    subprocess.run([llvm_profdata, 'merge',
+                    f'-output={profile_dir / "default.profdata"}',
+                    *raw_profiles], check=True)
+
+
+if __name__ == '__main__':
+    train(*sys.argv[1:3])
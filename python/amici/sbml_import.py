@@ -221,8 +221,10 @@ class SbmlImporter:
             compute_conservation_laws: bool = True,
             simplify: Callable = lambda x: sp.powsimp(x, deep=True),
             cache_simplify: bool = False,
+            cache_dir: Optional[Union[str, Path]] = None,
             log_as_log10: bool = True,
             generate_sensitivity_code: bool = True,
+            backend: str = 'cpp',
     ) -> None:
         """
         Generate and compile AMICI C++ files for the model provided to the
@@ -304,6 +306,14 @@ class SbmlImporter:
         :param cache_simplify:
                 see :func:`amici.ODEModel.__init__`
 
+        :param cache_dir:
+            Directory for caching symbolic derivatives, see
+            :class:`amici.ode_export.SymbolicCache`. Re-importing a model
+            with some changed equations, e.g. observables, will only
+            recompute the derivatives of the changed equations. The cache
+            files are unpickled, so the directory must be owned by and only
+            writable by the current user.
+
         :param log_as_log10:
             If ``True``, log in the SBML model will be parsed as ``log10``
             (default), if ``False``, log will be parsed as natural logarithm
@@ -313,7 +323,19 @@ class SbmlImporter:
             If ``False``, the code required for sensitivity computation will
             not be generated
 
+        :param backend:
+            ``'cpp'`` (default) to generate and compile C++ code, or
+            ``'bytecode'`` to only write ``<model_name>.amici_bytecode`` to
+            the model directory, which can be loaded without compilation via
+            :func:`amici.bytecode.get_model`. Simulation of bytecode models is
+            slower, but they are available almost immediately, see
+            :mod:`amici.bytecode`.
+
         """
+        if backend not in ('cpp', 'bytecode'):
+            raise ValueError(f'Unknown backend {backend}, must be one of '
+                             '"cpp" or "bytecode".')
+
         set_log_level(logger, verbose)
 
         constant_parameters = list(constant_parameters) \
@@ -349,6 +371,7 @@ class SbmlImporter:
             verbose=verbose,
             simplify=simplify,
             cache_simplify=cache_simplify,
+            cache_dir=cache_dir,
         )
         ode_model.import_from_sbml_importer(
             self, compute_cls=compute_conservation_laws)
@@ -362,6 +385,10 @@ class SbmlImporter:
             allow_reinit_fixpar_initcond=allow_reinit_fixpar_initcond,
             generate_sensitivity_code=generate_sensitivity_code
         )
+        if backend == 'bytecode':
+            exporter.generate_model_bytecode()
+            return
+
         exporter.generate_model_code()
 
         if compile:
@@ -4,14 +4,17 @@ import os
 import sys
 from typing import List
 
-from amici import amici_path, hdf5_enabled, compiledWithOpenMP
+from amici import (amici_path, hdf5_enabled, compiledWithOpenMP,
+                   __commit__, __version__)
 from amici.custom_commands import (set_compiler_specific_extension_options,
                                    compile_parallel)
 from amici.setuptools import (get_blas_config,
                               get_hdf5_config,
                               add_coverage_flags_if_required,
                               add_debug_flags_if_required,
+                              add_lto_flags_if_required,
                               add_openmp_flags,
+                              add_pgo_flags_if_required,
                               )
 from setuptools import find_packages, setup, Extension
 from setuptools.command.build_ext import build_ext
@@ -33,6 +36,8 @@ class ModelBuildExt(build_ext):
             import setuptools._distutils.ccompiler
             self.compiler.compile = compile_parallel.__get__(
                 self.compiler, setuptools._distutils.ccompiler.CCompiler)
+            # reuse objects of unchanged sources after model re-import
+            self.compiler.object_hash_salt = f'{__version__} {__commit__}'
 
         print(f"Building model extension in {os.getcwd()}")
 
@@ -78,6 +83,8 @@ def get_extension() -> Extension:
 
     add_coverage_flags_if_required(cxx_flags, linker_flags)
     add_debug_flags_if_required(cxx_flags, linker_flags)
+    add_lto_flags_if_required(cxx_flags, linker_flags)
+    add_pgo_flags_if_required(cxx_flags, linker_flags)
 
     h5pkgcfg = get_hdf5_config()
 
@@ -8,6 +8,7 @@ import os
 import sys
 import shlex
 import subprocess
+import sysconfig
 
 from .swig import find_swig, get_swig_version
 
@@ -178,6 +179,57 @@ def get_hdf5_config() -> PackageInfo:
     return h5pkgcfg
 
 
+def get_boost_serialization_config() -> PackageInfo:
+    """
+    Find boost::serialization include dir and library
+
+    :return:
+        boost::serialization related package information
+    """
+    include_dir_hints = ['/usr/local/include', '/usr/include']
+    library_dir_hints = [
+        '/usr/lib/x86_64-linux-gnu/',
+        '/usr/local/lib',
+        '/usr/lib64/',
+        '/usr/lib',
+    ]
+
+    for env_var in ['CONDA_DIR', 'BOOST_ROOT']:
+        if env_var in os.environ:
+            include_dir_hints.insert(
+                0, os.path.join(os.environ[env_var], 'include'))
+            library_dir_hints.insert(
+                0, os.path.join(os.environ[env_var], 'lib'))
+
+    pkgcfg = {'include_dirs': [],
+              'library_dirs': [],
+              'libraries': [],
+              'define_macros': [],
+              'found': False}
+
+    include_dir = next(
+        (hint for hint in include_dir_hints
+         if os.path.isfile(os.path.join(hint, 'boost', 'serialization',
+                                        'vector.hpp'))),
+        None)
+    library_dir = next(
+        (hint for hint in library_dir_hints
+         if any(os.path.isfile(os.path.join(hint, lib_filename))
+                for lib_filename in ['libboost_serialization.a',
+                                     'libboost_serialization.so',
+                                     'libboost_serialization.dylib'])),
+        None)
+
+    if include_dir is not None and library_dir is not None:
+        print(f"boost::serialization found in {include_dir}, {library_dir}")
+        pkgcfg['include_dirs'] = [include_dir]
+        pkgcfg['library_dirs'] = [library_dir]
+        pkgcfg['libraries'] = ['boost_serialization']
+        pkgcfg['found'] = True
+
+    return pkgcfg
+
+
 def add_coverage_flags_if_required(cxx_flags: List[str],
                                    linker_flags: List[str]) -> None:
     """
@@ -217,8 +269,84 @@ def add_debug_flags_if_required(cxx_flags: List[str],
         linker_flags.extend(['-g'])
 
 
-def generate_swig_interface_files(swig_outdir: str = None,
-                                  with_hdf5: bool = None) -> None:
+def add_lto_flags_if_required(cxx_flags: List[str],
+                              linker_flags: List[str]) -> None:
+    """
+    Add compiler and linker flags for link-time optimization if requested
+
+    Objects are compiled with ``-ffat-lto-objects``, so that libraries built
+    this way can still be linked without link-time optimization.
+
+    :param cxx_flags:
+        list of existing cxx flags
+
+    :param linker_flags:
+        list of existing linker flags
+    """
+    if os.environ.get('ENABLE_AMICI_LTO') == 'TRUE':
+        print("ENABLE_AMICI_LTO was set to TRUE."
+              " Building AMICI with link-time optimization.")
+        cxx_flags.extend(['-flto', '-ffat-lto-objects'])
+        linker_flags.extend(['-flto'])
+
+
+def add_pgo_flags_if_required(cxx_flags: List[str],
+                              linker_flags: List[str]) -> None:
+    """
+    Add compiler and linker flags for profile-guided optimization if
+    requested, see :func:`amici.pgo.compile_model_pgo`
+
+    ``AMICI_PGO_GENERATE`` is the directory to which an instrumented build
+    writes its profile, ``AMICI_PGO_USE`` the directory of the profile to
+    optimize for.
+
+    :param cxx_flags:
+        list of existing cxx flags
+
+    :param linker_flags:
+        list of existing linker flags
+    """
+    if 'AMICI_PGO_GENERATE' in os.environ:
+        profile_dir = os.environ['AMICI_PGO_GENERATE']
+        print(f"Building AMICI with profiling instrumentation, writing "
+              f"profiles to {profile_dir}.")
+        # simulations may run in parallel threads
+        cxx_flags.extend([f'-fprofile-generate={profile_dir}',
+                          '-fprofile-update=atomic'])
+        linker_flags.extend([f'-fprofile-generate={profile_dir}'])
+    elif 'AMICI_PGO_USE' in os.environ:
+        profile_dir = os.environ['AMICI_PGO_USE']
+        print(f"Building AMICI with profile-guided optimization using the "
+              f"profiles in {profile_dir}.")
+        cxx_flags.append(f'-fprofile-use={profile_dir}')
+        if _cxx_is_gcc():
+            # counters of multi-threaded training runs may be inconsistent
+            cxx_flags.append('-fprofile-correction')
+        linker_flags.extend([f'-fprofile-use={profile_dir}'])
+
+
+def _cxx_is_gcc() -> bool:
+    """
+    Check whether the C++ compiler used by setuptools (``CXX`` or the
+    compiler Python was built with) is GCC
+    """
+    cxx = os.environ.get('CXX', sysconfig.get_config_var('CXX') or 'c++')
+    try:
+        result = subprocess.run([*shlex.split(cxx), '--version'],
+                                stdout=subprocess.PIPE,
+                                stderr=subprocess.DEVNULL, check=True)
+    except (OSError, subprocess.CalledProcessError):
+        return False
+    version = result.stdout.decode('utf-8', errors='replace')
+    return 'clang' not in version.lower() \
+        and 'Free Software Foundation' in version
+
+
+def generate_swig_interface_files(
+        swig_outdir: str = None,
+        with_hdf5: bool = None,
+        with_boost_serialization: bool = None
+) -> None:
     """
     Compile the swig python interface to amici
     """
@@ -245,6 +373,13 @@ def generate_swig_interface_files(swig_outdir: str = None,
     if not with_hdf5:
         swig_args.append('-DAMICI_SWIG_WITHOUT_HDF5')
 
+    # Is boost::serialization available for pickling support?
+    if with_boost_serialization is None:
+        with_boost_serialization = get_boost_serialization_config()['found']
+
+    if not with_boost_serialization:
+        swig_args.append('-DAMICI_SWIG_WITHOUT_BOOST_SERIALIZATION')
+
     if swig_outdir is not None:
         swig_args.extend(['-outdir', swig_outdir])
 
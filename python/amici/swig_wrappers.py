@@ -1,5 +1,7 @@
 """Convenience wrappers for the swig interface"""
 import sys
+import threading
+from concurrent.futures import Future
 from contextlib import contextmanager, suppress
 from typing import List, Optional, Union, Sequence, Dict, Any
 import amici.amici as amici_swig
@@ -10,7 +12,7 @@ __all__ = [
     'readSolverSettingsFromHDF5', 'writeSolverSettingsToHDF5',
     'set_model_settings', 'get_model_settings',
     'AmiciModel', 'AmiciSolver', 'AmiciExpData', 'AmiciReturnData',
-    'AmiciExpDataVector'
+    'AmiciExpDataVector', 'submitSimulation', 'submitSimulations'
 ]
 
 AmiciModel = Union['amici.Model', 'amici.ModelPtr']
@@ -111,7 +113,8 @@ def runAmiciSimulations(
         edata_list: AmiciExpDataVector,
         failfast: bool = True,
         num_threads: int = 1,
-) -> List['numpy.ReturnDataView']:
+        arena: Optional['amici_swig.ReturnDataArena'] = None,
+) -> Union[List['numpy.ReturnDataView'], 'numpy.ReturnDataArenaView']:
     """
     Convenience wrapper for loops of amici.runAmiciSimulation
 
@@ -121,9 +124,27 @@ def runAmiciSimulations(
     :param failfast: returns as soon as an integration failure is encountered
     :param num_threads: number of threads to use (only used if compiled
         with openmp)
+    :param arena: if provided, the results of all simulations are stored in
+        this :class:`amici.ReturnDataArena` instead of individual ReturnData
+        objects. The arena can be reused for subsequent calls. Its storage
+        is only overwritten if no view on previous results is alive.
 
-    :returns: list of simulation results
+    :returns: list of simulation results, or a view on the arena
     """
+    if arena is not None:
+        arena.reset(len(edata_list))
+        with _capture_cstdout():
+            edata_ptr_vector = amici_swig.ExpDataPtrVector(edata_list)
+            amici_swig.runAmiciSimulations(
+                _get_ptr(solver),
+                edata_ptr_vector,
+                _get_ptr(model),
+                arena,
+                failfast,
+                num_threads
+            )
+        return numpy.ReturnDataArenaView(arena)
+
     with _capture_cstdout():
         edata_ptr_vector = amici_swig.ExpDataPtrVector(edata_list)
         rdata_ptr_list = amici_swig.runAmiciSimulations(
@@ -136,6 +157,96 @@ def runAmiciSimulations(
     return [numpy.ReturnDataView(r) for r in rdata_ptr_list]
 
 
+#: (handle, future) pairs of pending asynchronous simulations by handle id
+_pending_simulations = {}
+_pending_lock = threading.Lock()
+_completer_thread = None
+
+
+def _complete_simulations():
+    """Resolve futures of asynchronous simulations as they complete.
+
+    Runs in a daemon thread, which waits for the next completed simulation
+    without holding the GIL."""
+    while True:
+        handle_id = amici_swig._nextCompletedSimulation()
+        # the submitting thread registers the handle while holding the lock
+        with _pending_lock:
+            handle, future = _pending_simulations.pop(handle_id)
+        try:
+            rdata = handle.get()
+        except Exception as e:
+            future.set_exception(e)
+        else:
+            future.set_result(numpy.ReturnDataView(rdata))
+
+
+def _submit(solver: AmiciSolver, edata: Optional[AmiciExpData],
+            model: AmiciModel) -> Future:
+    """Submit a simulation to the worker pool and return its
+    :class:`concurrent.futures.Future`"""
+    global _completer_thread
+    future = Future()
+    future.set_running_or_notify_cancel()
+    with _pending_lock:
+        if _completer_thread is None:
+            _completer_thread = threading.Thread(
+                target=_complete_simulations, daemon=True,
+                name='amici-simulation-completer')
+            _completer_thread.start()
+        handle = amici_swig._submitSimulation(
+            _get_ptr(solver), _get_ptr(edata), _get_ptr(model))
+        _pending_simulations[handle.id()] = (handle, future)
+    return future
+
+
+def submitSimulation(
+        model: AmiciModel,
+        solver: AmiciSolver,
+        edata: Optional[AmiciExpData] = None
+) -> Future:
+    """
+    Asynchronous version of :py:func:`runAmiciSimulation`.
+
+    The simulation is run on AMICI's worker pool and does not block the
+    calling thread. Model, solver and data are copied at submission, so they
+    may be modified or deleted afterwards. Use
+    :func:`asyncio.wrap_future` to await the result from a coroutine.
+
+    :param model:
+        Model instance
+
+    :param solver:
+        Solver instance, must be generated from
+        :py:meth:`amici.amici.Model.getSolver`
+
+    :param edata:
+        ExpData instance (optional)
+
+    :returns:
+        Future resolving to the ReturnDataView of the simulation
+    """
+    return _submit(solver, edata, model)
+
+
+def submitSimulations(
+        model: AmiciModel,
+        solver: AmiciSolver,
+        edata_list: AmiciExpDataVector,
+) -> List[Future]:
+    """
+    Asynchronous version of :py:func:`runAmiciSimulations`.
+
+    :param model: Model instance
+    :param solver: Solver instance, must be generated from Model.getSolver()
+    :param edata_list: list of ExpData instances
+
+    :returns: list of futures resolving to the simulation results, in the
+        order of `edata_list`
+    """
+    return [submitSimulation(model, solver, edata) for edata in edata_list]
+
+
 def readSolverSettingsFromHDF5(
         file: str,
         solver: AmiciSolver,
@@ -28,8 +28,10 @@ from amici.custom_commands import (
 from amici.setuptools import (
     get_blas_config,
     get_hdf5_config,
+    get_boost_serialization_config,
     add_coverage_flags_if_required,
     add_debug_flags_if_required,
+    add_lto_flags_if_required,
     add_openmp_flags,
 )
 
@@ -67,6 +69,18 @@ def main():
         print("HDF5 library NOT found. Building AMICI WITHOUT HDF5 support.")
         define_macros.append(('AMICI_SWIG_WITHOUT_HDF5', None))
 
+    boostpkgcfg = get_boost_serialization_config()
+
+    if boostpkgcfg['found']:
+        print("boost::serialization found. Building AMICI with pickling "
+              "support.")
+        amici_module_linker_flags.extend(
+            f'-l{lib}' for lib in boostpkgcfg['libraries'])
+    else:
+        print("boost::serialization NOT found. Building AMICI WITHOUT "
+              "pickling support.")
+        define_macros.append(('AMICI_SWIG_WITHOUT_BOOST_SERIALIZATION', None))
+
     add_coverage_flags_if_required(
         cxx_flags,
         amici_module_linker_flags,
@@ -77,6 +91,11 @@ def main():
         amici_module_linker_flags,
     )
 
+    add_lto_flags_if_required(
+        cxx_flags,
+        amici_module_linker_flags,
+    )
+
     # compiler and linker flags for libamici
     if 'AMICI_CXXFLAGS' in os.environ:
         cxx_flags.extend(os.environ['AMICI_CXXFLAGS'].split(' '))
@@ -121,6 +140,7 @@ def main():
             *libsundials[1]['include_dirs'],
             *libsuitesparse[1]['include_dirs'],
             *h5pkgcfg['include_dirs'],
+            *boostpkgcfg['include_dirs'],
             *blaspkgcfg['include_dirs'],
             np.get_include()
         ],
@@ -131,6 +151,7 @@ def main():
         define_macros=define_macros,
         library_dirs=[
             *h5pkgcfg['library_dirs'],
+            *boostpkgcfg['library_dirs'],
             *blaspkgcfg['library_dirs'],
             'amici/libs',  # clib target directory
         ],
@@ -6,6 +6,7 @@ however we want to keep the static libs to avoid recompilation for
 AMICI-generated models.
 """
 
+import os
 import re
 from pathlib import Path
 from typing import Any, Dict, List, Optional, Tuple, Union
@@ -171,7 +172,8 @@ def get_amici_base_sources(
     amici_base_sources = (base_dir / 'src').glob('*.cpp')
     amici_base_sources = [
         str(src) for src in amici_base_sources
-        if not re.search(r'(matlab)|(\.(ODE_)?template\.)', str(src))
+        if not re.search(r'(matlab)|(\.(ODE_)?template\.)|(mpi\.cpp$)'
+                         r'|(serve\.cpp$)', str(src))
     ]
 
     if not with_hdf5:
@@ -299,4 +301,9 @@ def get_lib_amici(
     if blaspkgcfg and 'extra_compile_args' in blaspkgcfg:
         libamici[1]['cflags'].extend(blaspkgcfg['extra_compile_args'])
 
+    if os.environ.get('ENABLE_AMICI_PROFILING') == 'TRUE':
+        print("ENABLE_AMICI_PROFILING was set to TRUE."
+              " Building AMICI with profiling of model functions.")
+        libamici[1]['macros'].append(('AMICI_PROFILING', None))
+
     return libamici
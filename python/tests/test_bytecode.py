@@ -0,0 +1,162 @@
+"""Tests for the bytecode model backend"""
+import math
+
+import numpy as np
+import pytest
+import sympy as sp
+from amici.bytecode import ProgramBuilder, get_model
+from amici.import_utils import (generate_measurement_symbol,
+                                symbol_with_assumptions)
+from amici.ode_export import ODEExporter, ODEModel
+from amici.ode_model import (Constant, Expression, LogLikelihood, Observable,
+                             Parameter, SigmaY, State)
+
+
+def _evaluate(builder: ProgramBuilder, values: dict) -> dict:
+    """Evaluate a program like ``amici::bytecode::Program::evaluate``"""
+    unary = {
+        'neg': lambda a: -a, 'sqrt': math.sqrt, 'cbrt': np.cbrt,
+        'exp': math.exp, 'log': math.log, 'sin': math.sin,
+        'fabs': abs, 'not': lambda a: float(not a),
+        'sign': lambda a: float(np.sign(a)),
+    }
+    binary = {
+        'add': lambda a, b: a + b, 'sub': lambda a, b: a - b,
+        'mul': lambda a, b: a * b, 'div': lambda a, b: a / b,
+        'pow': math.pow, 'pos_pow': lambda a, b: math.pow(max(a, 0.0), b),
+        'max': max, 'min': min, 'lt': lambda a, b: float(a < b),
+        'le': lambda a, b: float(a <= b), 'gt': lambda a, b: float(a > b),
+        'ge': lambda a, b: float(a >= b),
+        'and': lambda a, b: float(bool(a) and bool(b)),
+        'or': lambda a, b: float(bool(a) or bool(b)),
+        'heaviside': lambda a, b: 0.0 if a < 0 else 1.0 if a > 0 else b,
+    }
+    registers = [0.0] * builder.n_registers
+    out = {}
+    for instruction in builder.instructions:
+        op, *args = instruction.split()
+        if op == 'store':
+            out[int(args[0])] = registers[int(args[1])]
+            continue
+        dst, *operands = args
+        if op == 'const':
+            value = builder.constants[int(operands[0])]
+        elif op == 'load':
+            value = out[int(operands[1])] if operands[0] == 'out' \
+                else values[operands[0]][int(operands[1])]
+        elif op == 'select':
+            c, a, b = (registers[int(r)] for r in operands)
+            value = a if c else b
+        elif op in unary:
+            value = unary[op](registers[int(operands[0])])
+        else:
+            value = binary[op](*(registers[int(r)] for r in operands))
+        registers[int(dst)] = value
+    return out
+
+
+def test_program_builder():
+    """Compiled expressions evaluate to the same values as in sympy"""
+    x0, x1, p0 = sp.symbols('x0 x1 p0')
+    symbols = {'x0': ('x', 0), 'x1': ('x', 1), 'p0': ('p', 0)}
+    values = {'x': [0.7, 2.5], 'p': [1.3]}
+    subs = {x0: 0.7, x1: 2.5, p0: 1.3}
+
+    expressions = [
+        -x0 * p0 + 2 * x1 / (x0 + 1),
+        x0 ** p0 - sp.sqrt(x1) + 1 / sp.sqrt(p0) + x1 ** sp.Rational(1, 3),
+        sp.exp(-p0 * x0) * sp.log(x1) - sp.sin(x0) / 3,
+        sp.Max(x0, p0, 1.0) - sp.Min(x1, p0),
+        sp.Piecewise((x0, x1 < 1), (p0, sp.And(x1 >= 2, x0 <= 1)),
+                     (x1, True)),
+        sp.Piecewise((x0, x1 > 3)),
+        sp.Heaviside(x0 - p0) + sp.Heaviside(p0 - x0, 0.3) * sp.Abs(x0 - x1),
+        sp.pi * x0 ** 2 - x0 ** 2 / p0,
+    ]
+    builder = ProgramBuilder(symbols)
+    for index, expr in enumerate(expressions):
+        builder.store(index, expr)
+    result = _evaluate(builder, values)
+
+    for index, expr in enumerate(expressions):
+        expected = float(expr.subs(subs).evalf()) \
+            if expr.subs(subs) != sp.nan else np.nan
+        np.testing.assert_allclose(result[index], expected, rtol=1e-12,
+                                   err_msg=str(expr))
+
+    # common subexpressions are only computed once
+    assert len(builder.instructions) == len(set(builder.instructions))
+
+
+def test_program_builder_stored_outputs():
+    """Outputs that were stored before can be read again"""
+    x0, w0, w1 = sp.symbols('x0 w0 w1')
+    builder = ProgramBuilder({'x0': ('x', 0), 'w0': ('out', 0),
+                              'w1': ('out', 1)})
+    builder.store(0, 2 * x0)
+    builder.store(1, w0 + 1)
+    builder.store(2, w0 * w1)
+    assert _evaluate(builder, {'x': [3.0]}) == {0: 6.0, 1: 7.0, 2: 42.0}
+    assert not any(instr.startswith('load') and 'out' in instr
+                   for instr in builder.instructions)
+
+    builder = ProgramBuilder({'p0': ('p', 0)}, pos_pow=True)
+    builder.store(0, sp.Symbol('p0') ** 2.5)
+    assert builder.instructions[-2].startswith('pos_pow')
+
+    with pytest.raises(ValueError):
+        ProgramBuilder({}).store(0, x0)
+
+    with pytest.raises(NotImplementedError):
+        ProgramBuilder({'x0': ('x', 0)}).store(0, sp.polygamma(0, x0))
+
+
+def test_bytecode_model(tmp_path):
+    """Simulate a bytecode model with a parameter-dependent discontinuity"""
+    model = ODEModel()
+    x1, x2, p1, p2, k1, w1 = sp.symbols('x1 x2 p1 p2 k1 w1')
+    t = symbol_with_assumptions('t')
+    model.add_component(Parameter(p1, 'p1', 0.5))
+    model.add_component(Parameter(p2, 'p2', 2.0))
+    model.add_component(Constant(k1, 'k1', 3.0))
+    model.add_component(Expression(w1, 'w1', p2 * x1 / (1 + x1 ** 2)))
+    model.add_component(State(x1, 'x1', k1, -p1 * x1 + sp.Max(x2, 0.1)))
+    model.add_component(State(
+        x2, 'x2', 1.0, w1 - sp.sqrt(x2 + 1) + p1 * sp.Heaviside(t - p2)))
+    y1, sigma_y1 = sp.Symbol('y1'), sp.Symbol('sigma_y1')
+    model.add_component(Observable(y1, 'y1', x1 + x2))
+    model.add_component(SigmaY(sigma_y1, 'sigma_y1', 1.0))
+    my1 = generate_measurement_symbol(y1)
+    model.add_component(LogLikelihood(
+        sp.Symbol('llh_y1'), 'llh_y1',
+        0.5 * sp.log(2 * sp.pi * sigma_y1 ** 2)
+        + 0.5 * ((y1 - my1) / sigma_y1) ** 2))
+    model.generate_basic_variables()
+
+    exporter = ODEExporter(model, model_name='bytecode_test',
+                           outdir=tmp_path)
+    exporter.generate_model_bytecode()
+
+    import amici
+    amici_model = get_model('bytecode_test', tmp_path)
+    assert list(amici_model.getParameterIds()) == ['p1', 'p2']
+    amici_model.setTimepoints([0.0, 1.0, 2.5, 5.0])
+    solver = amici_model.getSolver()
+    solver.setSensitivityOrder(amici.SensitivityOrder.first)
+    solver.setSensitivityMethod(amici.SensitivityMethod.forward)
+    solver.setRelativeTolerance(1e-12)
+    solver.setAbsoluteTolerance(1e-14)
+    edata = amici.ExpData(amici_model)
+    edata.setObservedData([1.0, 2.0, 3.0, 4.0])
+    edata.setObservedDataStdDev([1.0] * 4)
+    rdata = amici.runAmiciSimulation(amici_model, solver, edata)
+
+    # reference: RK4 with step size 1e-4 and central finite differences
+    assert rdata['status'] == amici.AMICI_SUCCESS
+    np.testing.assert_allclose(
+        rdata['x'],
+        [[3.0, 1.0], [2.31461944, 0.37204902], [1.29567365, 0.27041484],
+         [1.3009069, 0.82707254]], rtol=1e-7)
+    np.testing.assert_allclose(rdata['llh'], -11.1917925192, rtol=1e-8)
+    np.testing.assert_allclose(rdata['sllh'], [4.50411980, 3.29489031],
+                               rtol=1e-6)
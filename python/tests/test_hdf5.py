@@ -7,10 +7,14 @@ import amici
 import pytest
 
 
+# runtime state that is not part of the solver settings
+_solver_attrs_not_stored = ['setCancellationToken']
+
+
 def _modify_solver_attrs(solver):
     # change to non-default values
     for attr in dir(solver):
-        if not attr.startswith('set'):
+        if not attr.startswith('set') or attr in _solver_attrs_not_stored:
             continue
 
         val = getattr(solver, attr.replace('set', 'get'))()
@@ -21,6 +25,10 @@ def _modify_solver_attrs(solver):
             cval = 0
         elif attr == 'setReturnDataReportingMode':
             cval = amici.RDataReporting.likelihood
+        elif attr == 'setReturnDataFields':
+            cval = amici.RDataField.x
+        elif attr == 'setReturnDataTrajectoryTimepoints':
+            cval = [0]
         elif attr == 'setMaxTime':
             # default value is the maximum, must not add to that
             cval = random.random()
@@ -49,7 +57,7 @@ def test_solver_hdf5_roundtrip(sbml_example_presimulation_module):
 
     # check that we changed everything
     for attr in dir(solver):
-        if not attr.startswith('set'):
+        if not attr.startswith('set') or attr in _solver_attrs_not_stored:
             continue
 
         assert getattr(solver, attr.replace('set', 'get'))() \
@@ -59,7 +67,7 @@ def test_solver_hdf5_roundtrip(sbml_example_presimulation_module):
 
     # check that reading in settings worked
     for attr in dir(solver):
-        if not attr.startswith('set'):
+        if not attr.startswith('set') or attr in _solver_attrs_not_stored:
             continue
 
         assert getattr(solver, attr.replace('set', 'get'))() \
@@ -1,7 +1,15 @@
 """Miscellaneous AMICI Python interface tests"""
 
+import os
+import shutil
+import subprocess
+from unittest.mock import patch
+
+import pytest
 import sympy as sp
-from amici.cxxcodeprinter import AmiciCxxCodePrinter
+from amici.cxxcodeprinter import AmiciCxxCodePrinter, split_statements
+from amici import ode_export
+from amici.ode_export import SymbolicCache, smart_applyfunc, smart_jacobian
 
 
 def test_csc_matrix():
@@ -61,3 +69,140 @@ def test_csc_matrix_vector():
     assert sparse_list == sp.Matrix([[3]])
     assert symbol_list == ['da2_db_1']
     assert str(sparse_matrix) == 'Matrix([[0], [da2_db_1]])'
+
+
+def test_split_statements():
+    """Test splitting of function bodies into chunks of balanced size"""
+    statements = [f'    x[{i}] = {i};' for i in range(100)]
+    assert split_statements(statements, 10_000) == [statements]
+
+    chunks = split_statements(statements, 500)
+    assert sum(chunks, []) == statements
+    sizes = [sum(map(len, chunk)) for chunk in chunks]
+    assert len(chunks) == -(-sum(sizes) // 500)
+    assert max(sizes) - min(sizes) <= max(map(len, statements))
+
+    # statements are never split
+    assert split_statements(['a' * 100, 'b', 'c'], 10) == [['a' * 100],
+                                                          ['b', 'c']]
+
+
+def test_symbolic_cache(tmp_path):
+    """Test that cached derivatives are reused only for identical inputs"""
+    x, y = sp.symbols('x y', real=True)
+    calls = []
+
+    def jacobian(eq, sym_var):
+        calls.append(eq)
+        return smart_jacobian(eq, sym_var)
+
+    eq = sp.Matrix([x ** 2 * y, sp.exp(x)])
+    sym_var = sp.Matrix([x, y])
+    cache = SymbolicCache(tmp_path)
+    expected = smart_jacobian(eq, sym_var)
+    assert cache('jacobian', jacobian, eq, sym_var) == expected
+
+    # persistent across instances
+    cache = SymbolicCache(tmp_path)
+    assert cache('jacobian', jacobian, eq, sym_var) == expected
+    assert (cache.hits, cache.misses) == (1, 0)
+    assert len(calls) == 1
+
+    # changed equation, or same name with different assumptions
+    cache('jacobian', jacobian, sp.Matrix([x * y, sp.exp(x)]), sym_var)
+    cache('jacobian', jacobian, eq.subs(x, sp.Symbol('x')), sym_var)
+    assert (cache.hits, cache.misses) == (1, 2)
+    assert len(calls) == 3
+
+
+def test_parallel_jacobian_and_simplification(monkeypatch):
+    """Test that parallel results are identical to serial results"""
+    x = sp.symbols('x0:20', real=True)
+    eq = sp.Matrix([x[i] ** (i % 3) * sp.exp(x[(i + 1) % 20]) * x[i - 1]
+                    for i in range(20)])
+    sym_var = sp.Matrix(x)
+    simplify = lambda expr: sp.powsimp(expr, deep=True)  # noqa: E731
+
+    monkeypatch.setenv('AMICI_IMPORT_NPROCS', '1')
+    jacobian = smart_jacobian(eq, sym_var)
+    simplified = smart_applyfunc(jacobian, simplify)
+
+    monkeypatch.setenv('AMICI_IMPORT_NPROCS', '2')
+    monkeypatch.setattr(ode_export, 'PARALLEL_MIN_JACOBIAN_SIZE', 0)
+    monkeypatch.setattr(ode_export, 'PARALLEL_MIN_SIMPLIFY_SIZE', 0)
+    parallel_jacobian = smart_jacobian(eq, sym_var)
+    parallel_simplified = smart_applyfunc(parallel_jacobian, simplify)
+
+    assert str(parallel_jacobian) == str(jacobian)
+    assert str(parallel_simplified) == str(simplified)
+
+
+def _unity_exporter(model_path):
+    """Exporter with just enough state to write function sources"""
+    exporter = ode_export.ODEExporter.__new__(ode_export.ODEExporter)
+    exporter.model_name = 'm'
+    exporter.model_path = str(model_path)
+    exporter._build_hints = set()
+    exporter._sources = {}
+    (model_path / 'm_p.h').write_text('#define k p[0]')
+    exporter._add_function_source(
+        'm_fp.cpp', ['#include "m_p.h"'], 'double fp(const double *p)',
+        ['    return k;'])
+    # breaks if the macro of m_fp.cpp is still defined
+    exporter._add_function_source(
+        'm_fx.cpp', [], 'double fx(const double *x)',
+        ['    const double k = x[0];', '    return k;'])
+    return exporter
+
+
+def test_unity_sources(tmp_path, monkeypatch):
+    """Test that unity sources with colliding macros compile, and that the
+    unity source of a function does not depend on the other functions"""
+    monkeypatch.setattr(ode_export, 'NUM_UNITY_SOURCES', 1)
+    _unity_exporter(tmp_path)._write_sources()
+    unity_source = tmp_path / 'm_unity0.cpp'
+    code = unity_source.read_text()
+    assert code.index('m_fp.cpp') < code.index('#undef k') \
+        < code.index('m_fx.cpp')
+    assert not (tmp_path / 'm_fp.cpp').exists()
+
+    compiler = shutil.which(os.environ.get('CXX', 'c++'))
+    if compiler is None:
+        pytest.skip('No C++ compiler available.')
+    subprocess.run([compiler, '-fsyntax-only', str(unity_source)],
+                   cwd=tmp_path, check=True)
+
+    # adding a function only changes the unity source it is assigned to
+    monkeypatch.setattr(ode_export, 'NUM_UNITY_SOURCES', 8)
+    sources = {}
+    for extra in ((), ('m_fy.cpp',)):
+        directory = tmp_path / str(len(extra))
+        directory.mkdir()
+        exporter = _unity_exporter(directory)
+        for filename in extra:
+            exporter._sources[filename] = '// no includes'
+        exporter._write_sources()
+        sources[extra] = {f.name: f.read_text()
+                          for f in directory.glob('*.cpp')}
+    changed = [name for name, code in sources[('m_fy.cpp',)].items()
+               if sources[()].get(name) != code]
+    assert len(changed) == 1
+
+
+@pytest.mark.skipif(os.name != 'posix', reason='POSIX permissions only')
+def test_symbolic_cache_rejects_shared_directories(tmp_path):
+    """Test that cache files are only loaded from private directories"""
+    cache_dir = tmp_path / 'cache'
+    SymbolicCache(cache_dir)
+    assert not cache_dir.stat().st_mode & 0o077
+
+    for mode in (0o777, 0o770):
+        cache_dir.chmod(mode)
+        with pytest.raises(ValueError, match='writable'):
+            SymbolicCache(cache_dir)
+    cache_dir.chmod(0o755)
+    SymbolicCache(cache_dir)
+
+    with patch('os.getuid', return_value=os.getuid() + 1), \
+            pytest.raises(ValueError, match='owned'):
+        SymbolicCache(cache_dir)
@@ -1,5 +1,6 @@
 """Tests related to amici.sbml_import"""
 import os
+import pickle
 import re
 import shutil
 from urllib.request import urlopen
@@ -239,6 +240,24 @@ def test_steadystate_simulation(model_steadystate_module):
     assert rdata[0].status == amici.AMICI_SUCCESS
     assert rdata[0].id == edata[0].id
 
+    # vector fields are views on the C++ object
+    x = rdata[0]['x']
+    assert not x.flags['OWNDATA']
+    assert x.shape == (rdata[0].nt, rdata[0].nx)
+    assert np.array_equal(x.flatten(), np.asarray(rdata[0]['ptr'].x))
+    assert not x.flags['WRITEABLE']
+    assert rdata[0]['numsteps'].dtype == np.int64
+
+    # results of all conditions in a single arena
+    arena = amici.ReturnDataArena()
+    results = amici.runAmiciSimulations(model, solver, edata * 2,
+                                        arena=arena)
+    assert isinstance(results, amici.numpy.ReturnDataArenaView)
+    assert results['x'].shape == (2, rdata[0].nt, rdata[0].nx)
+    assert np.array_equal(results['x'][1], x)
+    assert np.array_equal(results['status'], [amici.AMICI_SUCCESS] * 2)
+    assert results['llh'][0] == rdata[0]['llh']
+
     # check roundtripping of DataFrame conversion
     df_edata = amici.getDataObservablesAsDataFrame(model, edata)
     edata_reconstructed = amici.getEdataFromDataFrame(model, df_edata)
@@ -275,6 +294,22 @@ def test_steadystate_simulation(model_steadystate_module):
     assert np.isclose(rdata[0]['w'],
                       df_expr[list(model.getExpressionIds())].values).all()
 
+    if hasattr(amici.amici, '_returnDataToBytes'):
+        # pickling support requires boost::serialization
+        rdata_unpickled = pickle.loads(pickle.dumps(rdata[0]))
+        assert np.array_equal(rdata[0]['y'], rdata_unpickled['y'])
+        assert rdata[0]['llh'] == rdata_unpickled['llh']
+        edata_unpickled = pickle.loads(pickle.dumps(edata[0]))
+        assert np.array_equal(edata[0].getObservedData(),
+                              edata_unpickled.getObservedData(),
+                              equal_nan=True)
+
+    futures = amici.submitSimulations(model, solver, edata)
+    for rd, future in zip(rdata, futures):
+        rdata_async = future.result(timeout=60)
+        assert rdata_async['status'] == amici.AMICI_SUCCESS
+        assert np.array_equal(rd['y'], rdata_async['y'])
+
     solver.setRelativeTolerance(1e-12)
     solver.setAbsoluteTolerance(1e-12)
     check_derivatives(model, solver, edata[0], atol=1e-3,
@@ -55,6 +55,52 @@ target_link_libraries(${PROJECT_NAME}
     PUBLIC Upstream::amici
 )
 
+# Shared library that can be loaded at runtime by amici::ModelRegistry,
+# installed as <dir>/lib<model>.so or <dir>/<model>/<version>/lib<model>.so
+option(BUILD_MODEL_PLUGIN "Build model plugin for amici::ModelRegistry?" OFF)
+set(MODEL_VERSION "" CACHE STRING "Model version reported by the model plugin")
+if(BUILD_MODEL_PLUGIN)
+    file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/model_plugin.cpp.tmp
+"#include \"wrapfunctions.h\"
+#include <amici/model_registry.h>
+
+AMICI_MODEL_PLUGIN(\"${PROJECT_NAME}\", \"${MODEL_VERSION}\",
+                   amici::generic_model::getModel)
+")
+    # only touch the source if it changed
+    configure_file(${CMAKE_CURRENT_BINARY_DIR}/model_plugin.cpp.tmp
+        ${CMAKE_CURRENT_BINARY_DIR}/model_plugin.cpp COPYONLY)
+    add_library(${PROJECT_NAME}_plugin MODULE
+        ${SRC_LIST_LIB} ${CMAKE_CURRENT_BINARY_DIR}/model_plugin.cpp)
+    set_target_properties(${PROJECT_NAME}_plugin PROPERTIES
+        OUTPUT_NAME ${PROJECT_NAME}
+        PREFIX "${CMAKE_SHARED_LIBRARY_PREFIX}"
+        SUFFIX "${CMAKE_SHARED_LIBRARY_SUFFIX}")
+    if(APPLE)
+        set_target_properties(${PROJECT_NAME}_plugin PROPERTIES SUFFIX ".so")
+    endif()
+    target_include_directories(${PROJECT_NAME}_plugin
+        PRIVATE "${CMAKE_CURRENT_SOURCE_DIR}")
+    get_target_property(AMICI_LIBRARY_TYPE Upstream::amici TYPE)
+    if(AMICI_LIBRARY_TYPE STREQUAL "SHARED_LIBRARY")
+        target_link_libraries(${PROJECT_NAME}_plugin PRIVATE Upstream::amici)
+    else()
+        # Embedding a static libamici would give the plugin its own copy of
+        # AMICI. The AMICI symbols are resolved from the application loading
+        # the plugin instead, which has to export them.
+        target_include_directories(${PROJECT_NAME}_plugin PRIVATE
+            $<TARGET_PROPERTY:Upstream::amici,INTERFACE_INCLUDE_DIRECTORIES>)
+        target_compile_definitions(${PROJECT_NAME}_plugin PRIVATE
+            $<TARGET_PROPERTY:Upstream::amici,INTERFACE_COMPILE_DEFINITIONS>)
+        target_compile_options(${PROJECT_NAME}_plugin PRIVATE
+            $<TARGET_PROPERTY:Upstream::amici,INTERFACE_COMPILE_OPTIONS>)
+        if(APPLE)
+            set_property(TARGET ${PROJECT_NAME}_plugin APPEND_STRING
+                PROPERTY LINK_FLAGS " -undefined dynamic_lookup")
+        endif()
+    endif()
+endif()
+
 set(SRC_LIST_EXE main.cpp)
 
 add_executable(simulate_${PROJECT_NAME} ${SRC_LIST_EXE})
@@ -9,6 +9,8 @@
 #include "amici/backwardproblem.h"
 #include "amici/forwardproblem.h"
 #include "amici/misc.h"
+#include "amici/profiling.h"
+#include "amici/trace.h"
 
 #include <cvodes/cvodes.h>           //return codes
 #include <sundials/sundials_types.h> //realtype
@@ -17,6 +19,8 @@
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <type_traits>
@@ -98,15 +102,42 @@ runAmiciSimulations(const Solver& solver,
 #endif
 }
 
+void
+runAmiciSimulations(const Solver& solver,
+                    const std::vector<ExpData*>& edatas,
+                    const Model& model,
+                    ReturnDataConsumer& consumer,
+                    const bool failfast,
+#if defined(_OPENMP)
+                    int num_threads
+#else
+                    int /* num_threads */
+#endif
+)
+{
+#if defined(_OPENMP)
+    defaultContext.runAmiciSimulations(
+      solver, edatas, model, consumer, failfast, num_threads);
+#else
+    defaultContext.runAmiciSimulations(solver, edatas, model, consumer,
+                                       failfast, 1);
+#endif
+}
+
 std::unique_ptr<ReturnData>
 AmiciApplication::runAmiciSimulation(Solver& solver,
                                      const ExpData* edata,
                                      Model& model,
                                      bool rethrow)
 {
-    auto start_time_total = clock();
+    CpuTimer timer_total;
     solver.startTimer();
 
+    // collects timings of model functions, if enabled
+    Profile profile;
+    ProfileContext profile_context(solver.getProfiling() ? &profile : nullptr);
+    TraceScope trace_scope("simulation", edata ? edata->id : std::string());
+
     /* Applies condition-specific model settings and restores them when going
      * out of scope */
     ConditionContext cc1(&model, edata, FixedParameterContext::simulation);
@@ -130,6 +161,8 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
                 &model, edata, FixedParameterContext::preequilibration
             );
 
+            AMICI_PROFILE_SCOPE(preequilibration);
+            TraceScope trace_scope("preequilibration");
             preeq = std::make_unique<SteadystateProblem>(solver, model);
             preeq->workSteadyStateProblem(solver, model, -1);
         }
@@ -141,6 +174,8 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
 
 
         if (fwd->getCurrentTimeIteration() < model.nt()) {
+            AMICI_PROFILE_SCOPE(postequilibration);
+            TraceScope trace_scope("postequilibration");
             posteq = std::make_unique<SteadystateProblem>(solver, model);
             posteq->workSteadyStateProblem(solver, model,
                                            fwd->getCurrentTimeIteration());
@@ -173,14 +208,19 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
         rdata->status = AMICI_SUCCESS;
 
     } catch (amici::IntegrationFailure const& ex) {
-        if(ex.error_code == AMICI_RHSFUNC_FAIL && solver.timeExceeded()) {
-            rdata->status = AMICI_MAX_TIME_EXCEEDED;
+        auto interrupt_status = solver.getInterruptStatus();
+        if(interrupt_status != AMICI_SUCCESS
+            && (ex.error_code == AMICI_RHSFUNC_FAIL
+                || ex.error_code == interrupt_status)) {
+            rdata->status = interrupt_status;
             if(rethrow)
                 throw;
-            warningF("AMICI:simulation",
-                     "AMICI forward simulation failed at t = %f: "
-                     "Maximum time exceeed.\n",
-                     ex.time);
+            // cancellation is requested by the user, no need to warn
+            if (interrupt_status == AMICI_MAX_TIME_EXCEEDED)
+                warningF("AMICI:simulation",
+                         "AMICI forward simulation failed at t = %f: "
+                         "Maximum time exceeed.\n",
+                         ex.time);
         } else {
             rdata->status = ex.error_code;
             if (rethrow)
@@ -192,15 +232,19 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
 
         }
     } catch (amici::IntegrationFailureB const& ex) {
-        if(ex.error_code == AMICI_RHSFUNC_FAIL && solver.timeExceeded()) {
-            rdata->status = AMICI_MAX_TIME_EXCEEDED;
+        auto interrupt_status = solver.getInterruptStatus();
+        if(interrupt_status != AMICI_SUCCESS
+            && (ex.error_code == AMICI_RHSFUNC_FAIL
+                || ex.error_code == interrupt_status)) {
+            rdata->status = interrupt_status;
             if (rethrow)
                 throw;
-            warningF(
-                "AMICI:simulation",
-                "AMICI backward simulation failed when trying to solve until "
-                "t = %f: Maximum time exceeed.\n",
-                ex.time);
+            if (interrupt_status == AMICI_MAX_TIME_EXCEEDED)
+                warningF(
+                    "AMICI:simulation",
+                    "AMICI backward simulation failed when trying to solve "
+                    "until t = %f: Maximum time exceeed.\n",
+                    ex.time);
 
         } else {
             rdata->status = ex.error_code;
@@ -214,7 +258,9 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
                 ex.what());
         }
     } catch (amici::AmiException const& ex) {
-        rdata->status = AMICI_ERROR;
+        auto interrupt_status = solver.getInterruptStatus();
+        rdata->status = interrupt_status == AMICI_SUCCESS ? AMICI_ERROR
+                                                          : interrupt_status;
         if (rethrow)
             throw;
         warningF("AMICI:simulation",
@@ -235,8 +281,17 @@ AmiciApplication::runAmiciSimulation(Solver& solver,
         bwd_success ? bwd.get() : nullptr,
         posteq.get(), model, solver, edata);
 
-    rdata->cpu_time_total = static_cast<double>(clock() - start_time_total)
-                            * 1000.0 / CLOCKS_PER_SEC;
+    rdata->cpu_time_total = timer_total.elapsedMilliseconds();
+    rdata->wall_time_total = timer_total.elapsedWallMilliseconds();
+    rdata->model_workspace_bytes =
+        static_cast<long long>(model.getWorkspaceMemoryUsage());
+
+#ifdef AMICI_PROFILING
+    if (solver.getProfiling()) {
+        rdata->profile_calls = profile.getCalls();
+        rdata->profile_time = profile.getTime();
+    }
+#endif
 
     return rdata;
 }
@@ -254,32 +309,96 @@ AmiciApplication::runAmiciSimulations(const Solver& solver,
 
 )
 {
-    std::vector<std::unique_ptr<ReturnData>> results(edatas.size());
+    /** collects results in the order of the conditions */
+    class ReturnDataCollector : public ReturnDataConsumer {
+      public:
+        explicit ReturnDataCollector(std::size_t size) : results(size) {}
+
+        void consume(int index, std::unique_ptr<ReturnData> rdata) override {
+            results[index] = std::move(rdata);
+        }
+
+        std::vector<std::unique_ptr<ReturnData>> results;
+    } collector(edatas.size());
+
+#if defined(_OPENMP)
+    runAmiciSimulations(solver, edatas, model, collector, failfast,
+                        num_threads);
+#else
+    runAmiciSimulations(solver, edatas, model, collector, failfast, 1);
+#endif
+
+    return std::move(collector.results);
+}
+
+void
+AmiciApplication::runAmiciSimulations(const Solver& solver,
+                                      const std::vector<ExpData*>& edatas,
+                                      const Model& model,
+                                      ReturnDataConsumer& consumer,
+                                      bool failfast,
+#if defined(_OPENMP)
+                                      int num_threads
+#else
+                                      int /* num_threads */
+#endif
+
+)
+{
     // is set to true if one simulation fails and we should skip the rest.
     // shared across threads.
-    bool skipThrough = false;
+    std::atomic<bool> skipThrough {false};
+    auto token = solver.getCancellationToken();
+    // exceptions must not leave the parallel region, they are recorded per
+    // simulation and reported after the loop
+    std::vector<std::string> errors(edatas.size());
 
 #if defined(_OPENMP)
 #pragma omp parallel for num_threads(num_threads)
 #endif
     for (int i = 0; i < (int)edatas.size(); ++i) {
-        auto mySolver = std::unique_ptr<Solver>(solver.clone());
-        auto myModel = std::unique_ptr<Model>(model.clone());
-
-        /* if we fail we need to write empty return datas for the python
-         interface */
-        if (skipThrough) {
-            ConditionContext conditionContext(myModel.get(), edatas[i]);
-            results[i] =
-              std::unique_ptr<ReturnData>(new ReturnData(solver, model));
-        } else {
-            results[i] = runAmiciSimulation(*mySolver, edatas[i], *myModel);
-        }
+        try {
+            auto mySolver = std::unique_ptr<Solver>(solver.clone());
+            auto myModel = std::unique_ptr<Model>(model.clone());
+            std::unique_ptr<ReturnData> result;
+
+            /* if we fail we need to write empty return datas for the python
+             interface */
+            if (skipThrough || (token && token->isCancelled())) {
+                ConditionContext conditionContext(myModel.get(), edatas[i]);
+                result =
+                  std::unique_ptr<ReturnData>(new ReturnData(solver, model));
+                if (token && token->isCancelled()) {
+                    result->status = token->getStatus();
+                    if (edatas[i])
+                        result->id = edatas[i]->id;
+                }
+            } else {
+                result = runAmiciSimulation(*mySolver, edatas[i], *myModel);
+            }
 
-        skipThrough |= failfast && results[i]->status < 0;
+            if (failfast && result->status < 0)
+                skipThrough = true;
+            consumer.consume(i, std::move(result));
+        } catch (std::exception const& ex) {
+            errors[i] = ex.what();
+            if (failfast)
+                skipThrough = true;
+        }
     }
 
-    return results;
+    auto failed = std::find_if(errors.begin(), errors.end(),
+                               [](std::string const& e) { return !e.empty(); });
+    if (failed != errors.end()) {
+        auto nfailed = std::count_if(
+            failed, errors.end(),
+            [](std::string const& e) { return !e.empty(); });
+        throw AmiException("Processing the results of %d simulation(s) "
+                           "failed, first failure (simulation %d): %s",
+                           static_cast<int>(nfailed),
+                           static_cast<int>(failed - errors.begin()),
+                           failed->c_str());
+    }
 }
 
 void
@@ -323,4 +442,106 @@ AmiciApplication::checkFinite(gsl::span<const realtype> array, const char* fun)
     return AMICI_SUCCESS;
 }
 
+SimulationWorkerPool::SimulationWorkerPool(int num_threads)
+{
+    if (num_threads <= 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i)
+        workers_.emplace_back(&SimulationWorkerPool::work, this);
+}
+
+SimulationWorkerPool::~SimulationWorkerPool()
+{
+    std::deque<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        cancelled.swap(queue_);
+    }
+    cv_.notify_all();
+    for (auto& job: cancelled) {
+        // destroying the task without running it breaks its promise
+        job.task = {};
+        if (job.on_completion)
+            job.on_completion();
+    }
+    for (auto& worker: workers_)
+        worker.join();
+}
+
+std::future<std::unique_ptr<ReturnData>>
+SimulationWorkerPool::submit(const Solver& solver,
+                             const ExpData* edata,
+                             const Model& model,
+                             std::function<void()> on_completion)
+{
+    // copies, so the caller is free to modify the originals
+    std::packaged_task<std::unique_ptr<ReturnData>()> task(
+        [solver = std::unique_ptr<Solver>(solver.clone()),
+         model = std::unique_ptr<Model>(model.clone()),
+         edata = std::unique_ptr<ExpData>(edata ? new ExpData(*edata)
+                                                : nullptr)]() {
+            return runAmiciSimulation(*solver, edata.get(), *model);
+        });
+    auto result = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back({std::move(task), std::move(on_completion)});
+    }
+    cv_.notify_one();
+    return result;
+}
+
+std::vector<std::future<std::unique_ptr<ReturnData>>>
+SimulationWorkerPool::submit(const Solver& solver,
+                             const std::vector<ExpData*>& edatas,
+                             const Model& model)
+{
+    std::vector<std::future<std::unique_ptr<ReturnData>>> results;
+    results.reserve(edatas.size());
+    for (auto edata: edatas)
+        results.push_back(submit(solver, edata, model));
+    return results;
+}
+
+void SimulationWorkerPool::work()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (stop_)
+                return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        // exceptions end up in the future
+        job.task();
+        if (job.on_completion)
+            job.on_completion();
+    }
+}
+
+SimulationWorkerPool& defaultSimulationWorkerPool()
+{
+    static SimulationWorkerPool pool;
+    return pool;
+}
+
+std::future<std::unique_ptr<ReturnData>>
+submitSimulation(const Solver& solver, const ExpData* edata, const Model& model)
+{
+    return defaultSimulationWorkerPool().submit(solver, edata, model);
+}
+
+std::vector<std::future<std::unique_ptr<ReturnData>>>
+submitSimulations(const Solver& solver,
+                  const std::vector<ExpData*>& edatas,
+                  const Model& model)
+{
+    return defaultSimulationWorkerPool().submit(solver, edatas, model);
+}
+
 } // namespace amici
@@ -0,0 +1,99 @@
+/*
+ * amici-serve: simulation daemon serving model plugins over a Unix domain
+ * socket, see amici/serve.h for the protocol.
+ */
+
+#include <amici/exception.h>
+#include <amici/model_registry.h>
+#include <amici/serve.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+/** server to stop on SIGINT and SIGTERM, lock-free for the signal handler */
+std::atomic<amici::serve::Server *> server{nullptr};
+
+extern "C" void handleSignal(int /*signal*/) {
+    if (auto *instance = server.load())
+        instance->stop();
+}
+
+/** Makes a server available to the signal handler during its lifetime */
+struct SignalRegistration {
+    explicit SignalRegistration(amici::serve::Server &instance) {
+        server = &instance;
+    }
+    ~SignalRegistration() { server = nullptr; }
+    SignalRegistration(SignalRegistration const &) = delete;
+    SignalRegistration &operator=(SignalRegistration const &) = delete;
+};
+
+void printUsage(char const *program) {
+    std::cerr
+        << "Usage: " << program
+        << " --socket PATH --model-path DIR [--model-path DIR ...]\n"
+           "       [--threads N] [--max-models N]\n\n"
+           "Serve simulations of the model plugins found in the given\n"
+           "directories (see amici::ModelRegistry) on the Unix domain socket\n"
+           "PATH, until interrupted.\n\n"
+           "  --threads N     number of connections served concurrently\n"
+           "                  (default: 1)\n"
+           "  --max-models N  number of models kept resident per thread\n"
+           "                  (default: 16)\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string socket_path;
+    amici::ModelRegistry registry;
+    amici::serve::ServerOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string const arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 == argc)
+                throw amici::AmiException("Missing value for %s.", arg.c_str());
+            std::string const value = argv[++i];
+            if (arg == "--socket")
+                socket_path = value;
+            else if (arg == "--model-path")
+                registry.addSearchPath(value);
+            else if (arg == "--threads")
+                options.num_threads = std::stoi(value);
+            else if (arg == "--max-models")
+                options.max_models_per_thread = std::stoi(value);
+            else
+                throw amici::AmiException("Unknown option %s.", arg.c_str());
+        }
+        if (socket_path.empty())
+            throw amici::AmiException("No socket path given.");
+    } catch (std::exception const &e) {
+        std::cerr << "amici-serve: " << e.what() << "\n\n";
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        amici::serve::Server instance(socket_path, registry, options);
+        // unregistered before the server is destroyed, also on exceptions
+        SignalRegistration const registration(instance);
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        std::cerr << "amici-serve: listening on " << socket_path << std::endl;
+        instance.run();
+    } catch (std::exception const &e) {
+        std::cerr << "amici-serve: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
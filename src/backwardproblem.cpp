@@ -7,6 +7,8 @@
 #include "amici/forwardproblem.h"
 #include "amici/steadystateproblem.h"
 #include "amici/misc.h"
+#include "amici/profiling.h"
+#include "amici/trace.h"
 
 #include <cstring>
 #include <cassert>
@@ -57,6 +59,8 @@ BackwardProblem::BackwardProblem(const ForwardProblem &fwd,
 
 
 void BackwardProblem::workBackwardProblem() {
+    AMICI_PROFILE_SCOPE(backward);
+    TraceScope trace_scope("backward");
 
     if (model_->nx_solver <= 0 ||
         solver_->getSensitivityOrder() < SensitivityOrder::first ||
@@ -123,6 +127,8 @@ void BackwardProblem::workBackwardProblem() {
 
 
 void BackwardProblem::handleEventB() {
+    AMICI_PROFILE_SCOPE(events);
+    TraceScope trace_scope("events");
     auto rootidx = root_idx_.back();
     this->root_idx_.pop_back();
 
@@ -165,6 +171,7 @@ void BackwardProblem::handleEventB() {
 }
 
 void BackwardProblem::handleDataPointB(const int it) {
+    AMICI_PROFILE_SCOPE(dataPoints);
     solver_->storeDiagnosisB(which);
 
     for (int ix = 0; ix < model_->nxtrue_solver; ix++) {
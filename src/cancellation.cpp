@@ -0,0 +1,80 @@
+#include "amici/cancellation.h"
+
+#include "amici/defines.h"
+
+namespace amici {
+
+void CancellationToken::cancel(Reason reason) {
+    // keep the first reason if cancelled concurrently
+    int expected = static_cast<int>(Reason::none);
+    reason_.compare_exchange_strong(expected, static_cast<int>(reason));
+    cancelled_.store(true, std::memory_order_relaxed);
+}
+
+CancellationToken::Reason CancellationToken::getReason() const {
+    return static_cast<Reason>(reason_.load());
+}
+
+int CancellationToken::getStatus() const {
+    switch (getReason()) {
+    case Reason::none:
+        return AMICI_SUCCESS;
+    case Reason::deadline:
+        return AMICI_MAX_TIME_EXCEEDED;
+    default:
+        return AMICI_CANCELLED;
+    }
+}
+
+void CancellationToken::setTimeout(double seconds) {
+    auto timeout = std::chrono::duration<double>(seconds);
+    if (timeout >= clock::duration::max() - clock::now().time_since_epoch()) {
+        deadline_ = clock::duration::max().count();
+        return;
+    }
+    deadline_ = (clock::now().time_since_epoch()
+                 + std::chrono::duration_cast<clock::duration>(timeout))
+                    .count();
+}
+
+void CancellationToken::setMaxRHSEvaluations(long int max_evaluations) {
+    max_rhs_evaluations_ = max_evaluations;
+}
+
+void CancellationToken::setMaxSteps(long int max_steps) {
+    max_steps_ = max_steps;
+}
+
+long int CancellationToken::getNumRHSEvaluations() const {
+    return rhs_evaluations_;
+}
+
+long int CancellationToken::getNumSteps() const { return steps_; }
+
+void CancellationToken::reset() {
+    rhs_evaluations_ = 0;
+    steps_ = 0;
+    reason_ = static_cast<int>(Reason::none);
+    cancelled_ = false;
+}
+
+bool CancellationToken::charge(long int rhs_evaluations, long int steps) {
+    auto total_rhs = rhs_evaluations_ += rhs_evaluations;
+    auto total_steps = steps_ += steps;
+
+    if (isCancelled())
+        return true;
+
+    auto max_rhs = max_rhs_evaluations_.load();
+    if (max_rhs >= 0 && total_rhs > max_rhs)
+        cancel(Reason::rhsEvaluations);
+    auto max_steps = max_steps_.load();
+    if (max_steps >= 0 && total_steps > max_steps)
+        cancel(Reason::steps);
+    if (clock::now().time_since_epoch().count() > deadline_.load())
+        cancel(Reason::deadline);
+
+    return isCancelled();
+}
+
+} // namespace amici
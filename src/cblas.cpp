@@ -37,6 +37,14 @@ void amici_dgemv(BLASLayout layout, BLASTranspose TransA,
                 lda, X, incX, beta, Y, incY);
 }
 
+void amici_dsyrk(BLASLayout layout, BLASUplo uplo, BLASTranspose Trans,
+                 const int N, const int K, const double alpha,
+                 const double *A, const int lda, const double beta, double *C,
+                 const int ldc) {
+    cblas_dsyrk((CBLAS_ORDER)layout, (CBLAS_UPLO)uplo,
+                (CBLAS_TRANSPOSE)Trans, N, K, alpha, A, lda, beta, C, ldc);
+}
+
 void amici_daxpy(int n, double alpha, const double *x, const int incx, double *y, int incy) {
     cblas_daxpy(n, alpha, x, incx, y, incy);
 }
@@ -8,6 +8,7 @@
 #include <random>
 #include <utility>
 #include <algorithm>
+#include <numeric>
 
 namespace amici {
 
@@ -90,6 +91,7 @@ ExpData::ExpData(ReturnData const& rdata, std::vector<realtype> sigma_y,
             observed_data_std_dev_.at(iy + nytrue_ * it) = sigma;
         }
     }
+    updateObservedDataIndex();
 
     for (int iz = 0; iz < nztrue_; ++iz) {
         for (int ie = 0; ie < nmaxevent_; ++ie) {
@@ -124,29 +126,52 @@ realtype ExpData::getTimepoint(int it) const {
 
 void ExpData::setObservedData(const std::vector<realtype> &observedData) {
     checkDataDimension(observedData, "observedData");
+    densifyObservedData();
 
     if (observedData.size() == (unsigned) nt() * nytrue_)
         observed_data_ = observedData;
     else if (observedData.empty())
         observed_data_.clear();
+    updateObservedDataIndex();
 }
 
 void ExpData::setObservedData(const std::vector<realtype> &observedData, int iy) {
     if (observedData.size() != (unsigned) nt())
         throw AmiException("Input observedData did not match dimensions nt (%i), was %i", nt(), observedData.size());
 
+    densifyObservedData();
     for (int it = 0; it < nt(); ++it)
         observed_data_.at(iy + it*nytrue_) = observedData.at(it);
+    updateObservedDataIndex();
 }
 
 bool ExpData::isSetObservedData(int it, int iy) const {
+    if (observed_data_sparse_)
+        return findObservedData(it, iy) >= 0;
     return !observed_data_.empty() && !isNaN(observed_data_.at(it * nytrue_ + iy));
 }
 
-std::vector<realtype> const& ExpData::getObservedData() const {
+std::vector<realtype> const &ExpData::getObservedData() const {
+    if (observed_data_sparse_)
+        throw AmiException("Observed data is stored sparse, use "
+                           "getObservedDataDense()");
     return observed_data_;
 }
 
+std::vector<realtype> ExpData::getObservedDataDense() const {
+    if (!observed_data_sparse_)
+        return observed_data_;
+
+    std::vector<realtype> observedData(nt() * nytrue_, getNaN());
+    for (int it = 0; it < nt(); ++it) {
+        auto indices = getObservedDataIndices(it);
+        auto values = getObservedDataValues(it);
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            observedData[it * nytrue_ + indices[i]] = values[i];
+    }
+    return observedData;
+}
+
 const realtype *ExpData::getObservedDataPtr(int it) const {
     if (!observed_data_.empty())
         return &observed_data_.at(it*nytrue_);
@@ -154,9 +179,125 @@ const realtype *ExpData::getObservedDataPtr(int it) const {
     return nullptr;
 }
 
+const realtype *ExpData::getObservedDataPtr(int it,
+                                            std::vector<realtype> &buffer) const {
+    if (!observed_data_sparse_)
+        return getObservedDataPtr(it);
+
+    buffer.assign(nytrue_, getNaN());
+    auto indices = getObservedDataIndices(it);
+    auto values = getObservedDataValues(it);
+    for (std::size_t i = 0; i < indices.size(); ++i)
+        buffer[indices[i]] = values[i];
+    return buffer.data();
+}
+
+void ExpData::setObservedDataSparse(
+    std::vector<int> const &it, std::vector<int> const &iy,
+    std::vector<realtype> const &observedData,
+    std::vector<realtype> const &observedDataStdDev) {
+    if (it.size() != observedData.size() || iy.size() != observedData.size())
+        throw AmiException("Dimensions of timepoint indices (%zu), observable "
+                           "indices (%zu) and observedData (%zu) do not match",
+                           it.size(), iy.size(), observedData.size());
+    if (!observedDataStdDev.empty()
+        && observedDataStdDev.size() != observedData.size())
+        throw AmiException("Dimensions of observedDataStdDev (%zu) and "
+                           "observedData (%zu) do not match",
+                           observedDataStdDev.size(), observedData.size());
+    checkSigmaPositivity(observedDataStdDev, "observedDataStdDev");
+    // check all indices first, so that invalid input leaves the data as is
+    for (std::size_t idata = 0; idata < observedData.size(); ++idata) {
+        if (it[idata] < 0 || it[idata] >= nt() || iy[idata] < 0
+            || iy[idata] >= nytrue_)
+            throw AmiException("Data point index (%i, %i) out of range "
+                               "nt (%i) x nytrue (%i)",
+                               it[idata], iy[idata], nt(), nytrue_);
+    }
+
+    // order by timepoint and observable, the last of duplicate data points
+    // takes precedence as for dense data
+    std::vector<std::size_t> order(observedData.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) {
+                         return std::make_pair(it[a], iy[a])
+                                < std::make_pair(it[b], iy[b]);
+                     });
+
+    observed_data_indptr_.assign(nt() + 1, 0);
+    observed_data_indices_.clear();
+    observed_data_values_.clear();
+    observed_data_std_dev_values_.clear();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        auto idata = order[i];
+        if (i + 1 < order.size() && it[order[i + 1]] == it[idata]
+            && iy[order[i + 1]] == iy[idata])
+            continue;
+        ++observed_data_indptr_[it[idata] + 1];
+        observed_data_indices_.push_back(iy[idata]);
+        observed_data_values_.push_back(observedData[idata]);
+        if (!observedDataStdDev.empty())
+            observed_data_std_dev_values_.push_back(
+                observedDataStdDev[idata]);
+    }
+    std::partial_sum(observed_data_indptr_.begin(),
+                     observed_data_indptr_.end(),
+                     observed_data_indptr_.begin());
+
+    // release the dense storage
+    std::vector<realtype>().swap(observed_data_);
+    std::vector<realtype>().swap(observed_data_std_dev_);
+    observed_data_sparse_ = true;
+}
+
+bool ExpData::isObservedDataSparse() const {
+    return observed_data_sparse_;
+}
+
+gsl::span<const realtype> ExpData::getObservedDataValues(int it) const {
+    if (!observed_data_sparse_)
+        return gsl::span<const realtype>();
+
+    auto begin = observed_data_indptr_.at(it);
+    return gsl::make_span(observed_data_values_.data() + begin,
+                          observed_data_indptr_.at(it + 1) - begin);
+}
+
+gsl::span<const realtype> ExpData::getObservedDataStdDevValues(int it) const {
+    if (!observed_data_sparse_ || observed_data_std_dev_values_.empty())
+        return gsl::span<const realtype>();
+
+    auto begin = observed_data_indptr_.at(it);
+    return gsl::make_span(observed_data_std_dev_values_.data() + begin,
+                          observed_data_indptr_.at(it + 1) - begin);
+}
+
+int ExpData::nObservedData() const {
+    return static_cast<int>(observed_data_indices_.size());
+}
+
+std::vector<int> const &ExpData::getObservedDataIndptr() const {
+    return observed_data_indptr_;
+}
+
+std::vector<int> const &ExpData::getObservedDataIndices() const {
+    return observed_data_indices_;
+}
+
+gsl::span<const int> ExpData::getObservedDataIndices(int it) const {
+    if (observed_data_indices_.empty())
+        return gsl::span<const int>();
+
+    auto begin = observed_data_indptr_.at(it);
+    return gsl::make_span(observed_data_indices_.data() + begin,
+                          observed_data_indptr_.at(it + 1) - begin);
+}
+
 void ExpData::setObservedDataStdDev(const std::vector<realtype> &observedDataStdDev) {
     checkDataDimension(observedDataStdDev, "observedDataStdDev");
     checkSigmaPositivity(observedDataStdDev, "observedDataStdDev");
+    densifyObservedData();
 
     if (observedDataStdDev.size() == (unsigned) nt()*nytrue_)
         observed_data_std_dev_ = observedDataStdDev;
@@ -166,6 +307,7 @@ void ExpData::setObservedDataStdDev(const std::vector<realtype> &observedDataStd
 
 void ExpData::setObservedDataStdDev(const realtype stdDev) {
     checkSigmaPositivity(stdDev, "stdDev");
+    densifyObservedData();
     std::fill(observed_data_std_dev_.begin() ,observed_data_std_dev_.end(), stdDev);
 }
 
@@ -174,24 +316,48 @@ void ExpData::setObservedDataStdDev(const std::vector<realtype> &observedDataStd
         throw AmiException("Input observedDataStdDev did not match dimensions nt (%i), was %i", nt(), observedDataStdDev.size());
     checkSigmaPositivity(observedDataStdDev, "observedDataStdDev");
 
+    densifyObservedData();
     for (int it = 0; it < nt(); ++it)
         observed_data_std_dev_.at(iy + it*nytrue_) = observedDataStdDev.at(it);
 }
 
 void ExpData::setObservedDataStdDev(const realtype stdDev, int iy) {
     checkSigmaPositivity(stdDev, "stdDev");
+    densifyObservedData();
     for (int it = 0; it < nt(); ++it)
         observed_data_std_dev_.at(iy + it*nytrue_) = stdDev;
 }
 
 bool ExpData::isSetObservedDataStdDev(int it, int iy) const {
+    if (observed_data_sparse_) {
+        auto pos = findObservedData(it, iy);
+        return pos >= 0 && !observed_data_std_dev_values_.empty()
+               && !isNaN(observed_data_std_dev_values_[pos]);
+    }
     return !observed_data_std_dev_.empty() && !isNaN(observed_data_std_dev_.at(it * nytrue_ + iy));
 }
 
-std::vector<realtype> const& ExpData::getObservedDataStdDev() const {
+std::vector<realtype> const &ExpData::getObservedDataStdDev() const {
+    if (observed_data_sparse_)
+        throw AmiException("Observed data is stored sparse, use "
+                           "getObservedDataStdDevDense()");
     return observed_data_std_dev_;
 }
 
+std::vector<realtype> ExpData::getObservedDataStdDevDense() const {
+    if (!observed_data_sparse_)
+        return observed_data_std_dev_;
+
+    std::vector<realtype> observedDataStdDev(nt() * nytrue_, getNaN());
+    for (int it = 0; it < nt(); ++it) {
+        auto indices = getObservedDataIndices(it);
+        auto values = getObservedDataStdDevValues(it);
+        for (std::size_t i = 0; i < values.size(); ++i)
+            observedDataStdDev[it * nytrue_ + indices[i]] = values[i];
+    }
+    return observedDataStdDev;
+}
+
 const realtype *ExpData::getObservedDataStdDevPtr(int it) const {
     if (!observed_data_std_dev_.empty())
         return &observed_data_std_dev_.at(it*nytrue_);
@@ -287,8 +453,20 @@ void ExpData::applyDimensions() {
 }
 
 void ExpData::applyDataDimension() {
+    if (observed_data_sparse_) {
+        // drop data points beyond the last timepoint
+        auto nt_old = static_cast<int>(observed_data_indptr_.size()) - 1;
+        auto ndata = observed_data_indptr_.at(std::min(nt(), nt_old));
+        observed_data_indptr_.resize(nt() + 1, ndata);
+        observed_data_indices_.resize(ndata);
+        observed_data_values_.resize(ndata);
+        if (!observed_data_std_dev_values_.empty())
+            observed_data_std_dev_values_.resize(ndata);
+        return;
+    }
     observed_data_.resize(nt()*nytrue_, getNaN());
     observed_data_std_dev_.resize(nt()*nytrue_, getNaN());
+    updateObservedDataIndex();
 }
 
 void ExpData::applyEventDimension() {
@@ -296,6 +474,62 @@ void ExpData::applyEventDimension() {
     observed_events_std_dev_.resize(nmaxevent_*nztrue_, getNaN());
 }
 
+void ExpData::updateObservedDataIndex() {
+    observed_data_indptr_.assign(nt() + 1, 0);
+    observed_data_indices_.clear();
+    for (int it = 0; it < nt(); ++it) {
+        for (int iy = 0; iy < nytrue_; ++iy)
+            if (isSetObservedData(it, iy))
+                observed_data_indices_.push_back(iy);
+        observed_data_indptr_[it + 1] =
+            static_cast<int>(observed_data_indices_.size());
+    }
+}
+
+void ExpData::densifyObservedData() {
+    if (!observed_data_sparse_)
+        return;
+
+    observed_data_ = getObservedDataDense();
+    observed_data_std_dev_ = getObservedDataStdDevDense();
+    observed_data_sparse_ = false;
+    std::vector<realtype>().swap(observed_data_values_);
+    std::vector<realtype>().swap(observed_data_std_dev_values_);
+}
+
+int ExpData::findObservedData(int it, int iy) const {
+    auto begin = observed_data_indices_.begin() + observed_data_indptr_.at(it);
+    auto end = observed_data_indices_.begin() + observed_data_indptr_.at(it + 1);
+    auto pos = std::lower_bound(begin, end, iy);
+    if (pos == end || *pos != iy)
+        return -1;
+    return static_cast<int>(pos - observed_data_indices_.begin());
+}
+
+void ExpData::checkObservedDataIndex() const {
+    auto ndata = observed_data_indices_.size();
+    if (observed_data_indptr_.size() != static_cast<std::size_t>(nt() + 1)
+        || observed_data_indptr_.front() != 0
+        || observed_data_indptr_.back() != static_cast<int>(ndata)
+        || observed_data_values_.size() != ndata
+        || (!observed_data_std_dev_values_.empty()
+            && observed_data_std_dev_values_.size() != ndata))
+        throw AmiException("Inconsistent dimensions of sparse observed data");
+    for (int it = 0; it < nt(); ++it) {
+        if (observed_data_indptr_[it] > observed_data_indptr_[it + 1])
+            throw AmiException("Invalid row pointers of sparse observed data");
+        for (auto i = observed_data_indptr_[it];
+             i < observed_data_indptr_[it + 1]; ++i) {
+            auto iy = observed_data_indices_[i];
+            if (iy < 0 || iy >= nytrue_
+                || (i > observed_data_indptr_[it]
+                    && iy <= observed_data_indices_[i - 1]))
+                throw AmiException("Invalid observable indices of sparse "
+                                   "observed data");
+        }
+    }
+}
+
 void ExpData::checkDataDimension(std::vector<realtype> const& input, const char *fieldname) const {
     if (input.size() != (unsigned) nt()*nytrue_ && !input.empty())
         throw AmiException("Input %s did not match dimensions nt (%i) x nytrue (%i), was %i", fieldname, nt(), nytrue_, input.size());
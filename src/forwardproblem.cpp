@@ -2,6 +2,8 @@
 
 #include "amici/cblas.h"
 #include "amici/misc.h"
+#include "amici/profiling.h"
+#include "amici/trace.h"
 #include "amici/model.h"
 #include "amici/solver.h"
 #include "amici/exception.h"
@@ -44,6 +46,8 @@ ForwardProblem::ForwardProblem(const ExpData *edata, Model *model,
 }
 
 void ForwardProblem::workForwardProblem() {
+    AMICI_PROFILE_SCOPE(forward);
+    TraceScope trace_scope("forward");
     FinalStateStorer fss(this);
 
     auto presimulate = edata && edata->t_presim > 0;
@@ -140,6 +144,8 @@ void ForwardProblem::handlePresimulation()
 
 
 void ForwardProblem::handleEvent(realtype *tlastroot, const bool seflag) {
+    AMICI_PROFILE_SCOPE(events);
+    TraceScope trace_scope("events");
     /* store Heaviside information at event occurrence */
     model->froot(t_, x_, dx_, rootvals_);
 
@@ -298,6 +304,7 @@ void ForwardProblem::storeEvent() {
 }
 
 void ForwardProblem::handleDataPoint(int /*it*/) {
+    AMICI_PROFILE_SCOPE(dataPoints);
     /* We only store the simulation state if it's not the initial state, as the
        initial state is stored anyway and we want to avoid storing it twice */
     if (t_ != model->t0() && timepoint_states_.count(t_) == 0)
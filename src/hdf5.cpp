@@ -121,7 +121,30 @@ std::unique_ptr<ExpData> readSimulationExpData(std::string const& hdf5Filename,
         edata->id = getStringAttribute(file, hdf5Root, "id");
     }
 
-    if (model.ny * model.nt() > 0) {
+    if (model.ny * model.nt() > 0
+        && !locationExists(file, hdf5Root + "/Y")
+        && locationExists(file, hdf5Root + "/Y_indptr")) {
+        // compressed sparse rows of set data points
+        auto indptr = getIntDataset1D(file, hdf5Root + "/Y_indptr");
+        if (indptr.size() != static_cast<unsigned>(model.nt() + 1))
+            throw AmiException("Y_indptr must have length %d, was %zu",
+                               model.nt() + 1, indptr.size());
+        auto iy = getIntDataset1D(file, hdf5Root + "/Y_indices");
+        auto my = getDoubleDataset1D(file, hdf5Root + "/Y_data");
+        std::vector<double> sigmay;
+        if(locationExists(file,  hdf5Root + "/Sigma_Y_data"))
+            sigmay = getDoubleDataset1D(file, hdf5Root + "/Sigma_Y_data");
+        std::vector<int> it(iy.size());
+        for (int jt = 0; jt < model.nt(); ++jt) {
+            if (indptr[jt] > indptr[jt + 1]
+                || indptr[jt + 1] > static_cast<int>(it.size()))
+                throw AmiException("Invalid Y_indptr in %s",
+                                   hdf5Filename.c_str());
+            std::fill(it.begin() + indptr[jt], it.begin() + indptr[jt + 1],
+                      jt);
+        }
+        edata->setObservedDataSparse(it, iy, my, sigmay);
+    } else if (model.ny * model.nt() > 0) {
         if(locationExists(file,  hdf5Root + "/Y")) {
             auto my = getDoubleDataset2D(file, hdf5Root + "/Y", m, n);
             checkMeasurementDimensionsCompatible(m, n, model);
@@ -194,8 +217,382 @@ std::unique_ptr<ExpData> readSimulationExpData(std::string const& hdf5Filename,
     return edata;
 }
 
+/**
+ * @brief Writes strings as fixed-length string dataset
+ * @param file HDF5 file
+ * @param path dataset path
+ * @param values strings
+ */
+static void writeStringDataset(H5::H5File const& file,
+                               std::string const& path,
+                               std::vector<std::string> const& values) {
+    std::size_t length = 1;
+    for (auto const& value : values)
+        length = std::max(length, value.size());
+    std::vector<char> buffer(values.size() * length, '\0');
+    for (std::size_t i = 0; i < values.size(); ++i)
+        std::copy(values[i].begin(), values[i].end(),
+                  buffer.begin() + i * length);
+
+    H5::StrType type(H5::PredType::C_S1, length);
+    type.setStrpad(H5T_STR_NULLPAD);
+    hsize_t size = values.size();
+    H5::DataSpace dataspace(1, &size);
+    auto dataset = file.createDataSet(path.c_str(), type, dataspace);
+    dataset.write(buffer.data(), type);
+}
+
+/**
+ * @brief Reads a fixed-length string dataset
+ * @param file HDF5 file
+ * @param path dataset path
+ * @return strings
+ */
+static std::vector<std::string> readStringDataset(H5::H5File const& file,
+                                                  std::string const& path) {
+    auto dataset = file.openDataSet(path.c_str());
+    auto type = dataset.getStrType();
+    if (type.isVariableStr())
+        throw AmiException("Variable-length strings in %s are not supported",
+                           path.c_str());
+    auto dataspace = dataset.getSpace();
+    if (dataspace.getSimpleExtentNdims() != 1)
+        throw AmiException("Expected array of rank 1 in %s", path.c_str());
+    hsize_t size;
+    dataspace.getSimpleExtentDims(&size);
+
+    auto length = type.getSize();
+    std::vector<char> buffer(size * length);
+    if (size)
+        dataset.read(buffer.data(), type);
+    std::vector<std::string> values;
+    values.reserve(size);
+    for (hsize_t i = 0; i < size; ++i) {
+        auto begin = buffer.begin() + i * length;
+        values.emplace_back(begin, std::find(begin, begin + length, '\0'));
+    }
+    return values;
+}
+
+/**
+ * @brief Reads a stacked per-condition parameter dataset, rows of NaN denote
+ * absent parameters
+ * @param file HDF5 file
+ * @param path dataset path
+ * @param ncond number of conditions
+ * @return parameters per condition
+ */
+static std::vector<std::vector<realtype>>
+readStackedParameters(H5::H5File const& file, std::string const& path,
+                      hsize_t ncond) {
+    std::vector<std::vector<realtype>> result(ncond);
+    if (!locationExists(file, path))
+        return result;
+
+    hsize_t m, n;
+    auto buffer = getDoubleDataset2D(file, path, m, n);
+    if (m != ncond)
+        throw AmiException("Expected %llu rows in %s, got %llu",
+                           static_cast<unsigned long long>(ncond),
+                           path.c_str(), static_cast<unsigned long long>(m));
+    for (hsize_t icond = 0; icond < ncond; ++icond) {
+        auto row = buffer.begin() + icond * n;
+        if (std::all_of(row, row + n, [](realtype p) { return isNaN(p); }))
+            continue;
+        result[icond].assign(row, row + n);
+    }
+    return result;
+}
+
+std::vector<std::unique_ptr<ExpData>>
+readSimulationExpDatas(std::string const& hdf5Filename,
+                       std::string const& hdf5Root, Model const& model) {
+    H5::H5File file(hdf5Filename.c_str(), H5F_ACC_RDONLY);
+
+    hsize_t ncond, nt, ny, nmaxevent = model.nMaxEvent(), nz;
+
+    auto my = getDoubleDataset3D(file, hdf5Root + "/Y", ncond, nt, ny);
+    if (ny != static_cast<hsize_t>(model.nytrue))
+        throw AmiException("Number of observables in %s/Y (%llu) does not "
+                           "match model (%d)", hdf5Root.c_str(),
+                           static_cast<unsigned long long>(ny), model.nytrue);
+
+    std::vector<double> sigmay;
+    if (locationExists(file, hdf5Root + "/Sigma_Y")) {
+        hsize_t m, n, o;
+        sigmay = getDoubleDataset3D(file, hdf5Root + "/Sigma_Y", m, n, o);
+        if (m != ncond || n != nt || o != ny)
+            throw AmiException("Dimensions of %s/Sigma_Y and %s/Y do not "
+                               "match", hdf5Root.c_str(), hdf5Root.c_str());
+    }
+
+    std::vector<double> ts;
+    if (locationExists(file, hdf5Root + "/ts")) {
+        hsize_t m, n;
+        ts = getDoubleDataset2D(file, hdf5Root + "/ts", m, n);
+        if (m != ncond || n != nt)
+            throw AmiException("Dimensions of %s/ts and %s/Y do not match",
+                               hdf5Root.c_str(), hdf5Root.c_str());
+    } else if (nt != static_cast<hsize_t>(model.nt())) {
+        throw AmiException("Number of timepoints in %s/Y (%llu) does not "
+                           "match model (%d)", hdf5Root.c_str(),
+                           static_cast<unsigned long long>(nt), model.nt());
+    }
+
+    std::vector<double> mz, sigmaz;
+    nz = model.nztrue;
+    if (locationExists(file, hdf5Root + "/Z")) {
+        hsize_t m, n, o;
+        mz = getDoubleDataset3D(file, hdf5Root + "/Z", m, nmaxevent, nz);
+        if (m != ncond || nz != static_cast<hsize_t>(model.nztrue)
+            || nmaxevent != static_cast<hsize_t>(model.nMaxEvent()))
+            throw AmiException("Dimensions of %s/Z do not match",
+                               hdf5Root.c_str());
+        if (locationExists(file, hdf5Root + "/Sigma_Z")) {
+            sigmaz = getDoubleDataset3D(file, hdf5Root + "/Sigma_Z", m, n, o);
+            if (m != ncond || n != nmaxevent || o != nz)
+                throw AmiException("Dimensions of %s/Sigma_Z and %s/Z do not "
+                                   "match", hdf5Root.c_str(),
+                                   hdf5Root.c_str());
+        }
+    }
+
+    std::vector<double> t_presim;
+    if (locationExists(file, hdf5Root + "/t_presim")) {
+        t_presim = getDoubleDataset1D(file, hdf5Root + "/t_presim");
+        if (t_presim.size() != ncond)
+            throw AmiException("Expected %llu entries in %s/t_presim, got "
+                               "%zu", static_cast<unsigned long long>(ncond),
+                               hdf5Root.c_str(), t_presim.size());
+    }
+
+    auto fixedParameters =
+        readStackedParameters(file, hdf5Root + "/condition", ncond);
+    auto fixedParametersPreeq = readStackedParameters(
+        file, hdf5Root + "/conditionPreequilibration", ncond);
+    auto fixedParametersPresim = readStackedParameters(
+        file, hdf5Root + "/conditionPresimulation", ncond);
+
+    auto ndata = nt * ny;
+    auto nevent_data = nmaxevent * nz;
+    auto slice = [](std::vector<double> const& buffer, hsize_t icond,
+                    hsize_t size) {
+        if (buffer.empty())
+            return std::vector<realtype>();
+        return std::vector<realtype>(buffer.begin() + icond * size,
+                                     buffer.begin() + (icond + 1) * size);
+    };
+
+    std::vector<std::string> ids;
+    if (locationExists(file, hdf5Root + "/ids")) {
+        ids = readStringDataset(file, hdf5Root + "/ids");
+        if (ids.size() != ncond)
+            throw AmiException("Expected %llu entries in %s/ids, got %zu",
+                               static_cast<unsigned long long>(ncond),
+                               hdf5Root.c_str(), ids.size());
+    }
+
+    std::vector<int> reinitialize;
+    if (locationExists(file,
+                       hdf5Root + "/reinitializeFixedParameterInitialStates")) {
+        reinitialize = getIntDataset1D(
+            file, hdf5Root + "/reinitializeFixedParameterInitialStates");
+        if (reinitialize.size() != ncond)
+            throw AmiException("Expected %llu entries in "
+                               "%s/reinitializeFixedParameterInitialStates, "
+                               "got %zu",
+                               static_cast<unsigned long long>(ncond),
+                               hdf5Root.c_str(), reinitialize.size());
+    }
+
+    // reinitialized states per condition in compressed sparse row format
+    std::vector<int> reinit_indptr, reinit_idxs;
+    if (locationExists(file,
+                       hdf5Root + "/reinitialization_state_idxs_sim_indptr")) {
+        reinit_indptr = getIntDataset1D(
+            file, hdf5Root + "/reinitialization_state_idxs_sim_indptr");
+        if (locationExists(file,
+                           hdf5Root + "/reinitialization_state_idxs_sim"))
+            reinit_idxs = getIntDataset1D(
+                file, hdf5Root + "/reinitialization_state_idxs_sim");
+        if (reinit_indptr.size() != ncond + 1 || reinit_indptr.front() != 0
+            || reinit_indptr.back() != static_cast<int>(reinit_idxs.size())
+            || !std::is_sorted(reinit_indptr.begin(), reinit_indptr.end()))
+            throw AmiException("Invalid %s/reinitialization_state_idxs_sim",
+                               hdf5Root.c_str());
+    }
+
+    std::vector<std::unique_ptr<ExpData>> edatas;
+    edatas.reserve(ncond);
+    for (hsize_t icond = 0; icond < ncond; ++icond) {
+        auto edata = std::make_unique<ExpData>(model);
+        if (!ids.empty())
+            edata->id = ids[icond];
+        if (!ts.empty())
+            edata->setTimepoints(slice(ts, icond, nt));
+        if (!my.empty())
+            edata->setObservedData(slice(my, icond, ndata));
+        if (!sigmay.empty())
+            edata->setObservedDataStdDev(slice(sigmay, icond, ndata));
+        if (!mz.empty())
+            edata->setObservedEvents(slice(mz, icond, nevent_data));
+        if (!sigmaz.empty())
+            edata->setObservedEventsStdDev(slice(sigmaz, icond, nevent_data));
+        if (!fixedParameters[icond].empty())
+            edata->fixedParameters = std::move(fixedParameters[icond]);
+        if (!fixedParametersPreeq[icond].empty())
+            edata->fixedParametersPreequilibration =
+                std::move(fixedParametersPreeq[icond]);
+        if (!fixedParametersPresim[icond].empty())
+            edata->fixedParametersPresimulation =
+                std::move(fixedParametersPresim[icond]);
+        if (!t_presim.empty())
+            edata->t_presim = t_presim[icond];
+        if (!reinitialize.empty())
+            edata->reinitializeFixedParameterInitialStates =
+                static_cast<bool>(reinitialize[icond]);
+        if (!reinit_indptr.empty())
+            edata->reinitialization_state_idxs_sim.assign(
+                reinit_idxs.begin() + reinit_indptr[icond],
+                reinit_idxs.begin() + reinit_indptr[icond + 1]);
+        edatas.push_back(std::move(edata));
+    }
+
+    return edatas;
+}
+
+/**
+ * @brief Writes per-condition parameters as stacked dataset, rows of NaN
+ * denote absent parameters
+ * @param file HDF5 file
+ * @param path dataset path
+ * @param edatas conditions
+ * @param getter returns the parameters of a condition
+ */
+template <typename Getter>
+static void writeStackedParameters(H5::H5File const& file,
+                                   std::string const& path,
+                                   std::vector<ExpData *> const& edatas,
+                                   Getter getter) {
+    std::size_t n = 0;
+    for (auto edata : edatas)
+        n = std::max(n, getter(*edata).size());
+    if (n == 0)
+        return;
+
+    std::vector<double> buffer(edatas.size() * n, getNaN());
+    for (std::size_t icond = 0; icond < edatas.size(); ++icond) {
+        auto const& p = getter(*edatas[icond]);
+        if (p.empty())
+            continue;
+        if (p.size() != n)
+            throw AmiException("Inconsistent number of parameters for %s",
+                               path.c_str());
+        std::copy(p.begin(), p.end(), buffer.begin() + icond * n);
+    }
+    createAndWriteDouble2DDataset(file, path, buffer, edatas.size(), n);
+}
+
+void writeSimulationExpDatas(std::vector<ExpData *> const& edatas,
+                             H5::H5File const& file,
+                             std::string const& hdf5Location) {
+    if (edatas.empty())
+        return;
+
+    if(!locationExists(file, hdf5Location))
+        createGroup(file, hdf5Location);
+
+    auto const& first = *edatas.front();
+    for (auto edata : edatas) {
+        if (edata->nt() != first.nt() || edata->nytrue() != first.nytrue()
+            || edata->nztrue() != first.nztrue()
+            || edata->nmaxevent() != first.nmaxevent())
+            throw AmiException("All ExpData need to have the same dimensions "
+                               "to be written to stacked datasets");
+    }
+
+    auto ncond = edatas.size();
+    auto stack = [&](auto getter, std::size_t size, char const* name,
+                     int dim1, int dim2) {
+        std::vector<double> buffer;
+        buffer.reserve(ncond * size);
+        for (auto edata : edatas) {
+            auto const& values = getter(*edata);
+            if (values.empty())
+                buffer.insert(buffer.end(), size, getNaN());
+            else
+                buffer.insert(buffer.end(), values.begin(), values.end());
+        }
+        createAndWriteDouble3DDataset(file, hdf5Location + "/" + name, buffer,
+                                      ncond, dim1, dim2);
+    };
+
+    auto ndata = static_cast<std::size_t>(first.nt() * first.nytrue());
+    stack([](ExpData const& e) { return e.getObservedDataDense(); },
+          ndata, "Y", first.nt(), first.nytrue());
+    stack([](ExpData const& e) { return e.getObservedDataStdDevDense(); },
+          ndata, "Sigma_Y", first.nt(), first.nytrue());
+
+    auto nevent_data =
+        static_cast<std::size_t>(first.nmaxevent() * first.nztrue());
+    if (nevent_data > 0) {
+        stack([](ExpData const& e) -> std::vector<realtype> const& {
+                  return e.getObservedEvents(); },
+              nevent_data, "Z", first.nmaxevent(), first.nztrue());
+        stack([](ExpData const& e) -> std::vector<realtype> const& {
+                  return e.getObservedEventsStdDev(); },
+              nevent_data, "Sigma_Z", first.nmaxevent(), first.nztrue());
+    }
+
+    std::vector<double> ts, t_presim;
+    ts.reserve(ncond * first.nt());
+    for (auto edata : edatas) {
+        ts.insert(ts.end(), edata->getTimepoints().begin(),
+                  edata->getTimepoints().end());
+        t_presim.push_back(edata->t_presim);
+    }
+    createAndWriteDouble2DDataset(file, hdf5Location + "/ts", ts, ncond,
+                                  first.nt());
+    createAndWriteDouble1DDataset(file, hdf5Location + "/t_presim", t_presim);
+
+    writeStackedParameters(
+        file, hdf5Location + "/condition", edatas,
+        [](ExpData const& e) -> std::vector<realtype> const& {
+            return e.fixedParameters; });
+    writeStackedParameters(
+        file, hdf5Location + "/conditionPreequilibration", edatas,
+        [](ExpData const& e) -> std::vector<realtype> const& {
+            return e.fixedParametersPreequilibration; });
+    writeStackedParameters(
+        file, hdf5Location + "/conditionPresimulation", edatas,
+        [](ExpData const& e) -> std::vector<realtype> const& {
+            return e.fixedParametersPresimulation; });
+
+    std::vector<std::string> ids;
+    std::vector<int> reinitialize, reinit_indptr{0}, reinit_idxs;
+    for (auto edata : edatas) {
+        ids.push_back(edata->id);
+        reinitialize.push_back(edata->reinitializeFixedParameterInitialStates);
+        reinit_idxs.insert(reinit_idxs.end(),
+                           edata->reinitialization_state_idxs_sim.begin(),
+                           edata->reinitialization_state_idxs_sim.end());
+        reinit_indptr.push_back(static_cast<int>(reinit_idxs.size()));
+    }
+    writeStringDataset(file, hdf5Location + "/ids", ids);
+    createAndWriteInt1DDataset(
+        file, hdf5Location + "/reinitializeFixedParameterInitialStates",
+        reinitialize);
+    createAndWriteInt1DDataset(
+        file, hdf5Location + "/reinitialization_state_idxs_sim_indptr",
+        reinit_indptr);
+    if (!reinit_idxs.empty())
+        createAndWriteInt1DDataset(
+            file, hdf5Location + "/reinitialization_state_idxs_sim",
+            reinit_idxs);
+}
+
 void writeSimulationExpData(const ExpData &edata, H5::H5File const& file,
-                            const std::string &hdf5Location)
+                            const std::string &hdf5Location, bool sparse)
 {
 
     if(!locationExists(file, hdf5Location))
@@ -226,14 +623,45 @@ void writeSimulationExpData(const ExpData &edata, H5::H5File const& file,
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(), "t_presim",
                              &edata.t_presim, 1);
 
-    if (!edata.getObservedData().empty())
-        createAndWriteDouble2DDataset(
-                    file, hdf5Location + "/Y", edata.getObservedData(),
-                    edata.nt(), edata.nytrue());
-    if (!edata.getObservedDataStdDev().empty())
-        createAndWriteDouble2DDataset(
-                    file, hdf5Location + "/Sigma_Y",
-                    edata.getObservedDataStdDev(), edata.nt(), edata.nytrue());
+    if (sparse) {
+        std::vector<double> my, sigmay;
+        my.reserve(edata.nObservedData());
+        for (int it = 0; it < edata.nt(); ++it) {
+            if (edata.isObservedDataSparse()) {
+                auto values = edata.getObservedDataValues(it);
+                auto stdDevs = edata.getObservedDataStdDevValues(it);
+                my.insert(my.end(), values.begin(), values.end());
+                sigmay.insert(sigmay.end(), stdDevs.begin(), stdDevs.end());
+                continue;
+            }
+            auto values = edata.getObservedDataPtr(it);
+            auto stdDevs = edata.getObservedDataStdDevPtr(it);
+            for (auto iy : edata.getObservedDataIndices(it)) {
+                my.push_back(values[iy]);
+                if (stdDevs)
+                    sigmay.push_back(stdDevs[iy]);
+            }
+        }
+        createAndWriteInt1DDataset(file, hdf5Location + "/Y_indptr",
+                                   edata.getObservedDataIndptr());
+        createAndWriteInt1DDataset(file, hdf5Location + "/Y_indices",
+                                   edata.getObservedDataIndices());
+        createAndWriteDouble1DDataset(file, hdf5Location + "/Y_data", my);
+        if (!sigmay.empty())
+            createAndWriteDouble1DDataset(file, hdf5Location + "/Sigma_Y_data",
+                                          sigmay);
+    } else {
+        auto const& observedData = edata.getObservedData();
+        if (!observedData.empty())
+            createAndWriteDouble2DDataset(
+                        file, hdf5Location + "/Y", observedData,
+                        edata.nt(), edata.nytrue());
+        auto const& observedDataStdDev = edata.getObservedDataStdDev();
+        if (!observedDataStdDev.empty())
+            createAndWriteDouble2DDataset(
+                        file, hdf5Location + "/Sigma_Y",
+                        observedDataStdDev, edata.nt(), edata.nytrue());
+    }
     if (!edata.getObservedEvents().empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/Z",
                                       edata.getObservedEvents(),
@@ -276,7 +704,8 @@ void writeReturnData(const ReturnData &rdata, H5::H5File const& file, const std:
         createAndWriteDouble1DDataset(file, hdf5Location + "/res", rdata.res);
     if (!rdata.sres.empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/sres", rdata.sres,
-                                      rdata.nt*rdata.nytrue, rdata.nplist);
+                                      rdata.sres.size() / rdata.nplist,
+                                      rdata.nplist);
     if (!rdata.FIM.empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/FIM",
                                       rdata.FIM, rdata.nplist, rdata.nplist);
@@ -286,7 +715,7 @@ void writeReturnData(const ReturnData &rdata, H5::H5File const& file, const std:
 
     if (!rdata.x.empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/x", rdata.x,
-                                      rdata.nt, rdata.nx);
+                                      rdata.ntTrajectory(), rdata.nx);
 
     if (!rdata.y.empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/y", rdata.y,
@@ -318,7 +747,8 @@ void writeReturnData(const ReturnData &rdata, H5::H5File const& file, const std:
 
     if (!rdata.sx.empty())
         createAndWriteDouble3DDataset(file, hdf5Location + "/sx", rdata.sx,
-                                      rdata.nt, rdata.nplist, rdata.nx);
+                                      rdata.ntTrajectory(), rdata.nplist,
+                                      rdata.nx);
 
     if (!rdata.sy.empty())
         createAndWriteDouble3DDataset(file, hdf5Location + "/sy", rdata.sy,
@@ -413,6 +843,12 @@ void writeReturnDataDiagnosis(const ReturnData &rdata,
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
                              "preeq_cpu_timeB", &rdata.preeq_cpu_timeB, 1);
 
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "preeq_wall_time", &rdata.preeq_wall_time, 1);
+
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "preeq_wall_timeB", &rdata.preeq_wall_timeB, 1);
+
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(), "preeq_t",
                              &rdata.preeq_t, 1);
 
@@ -440,6 +876,12 @@ void writeReturnDataDiagnosis(const ReturnData &rdata,
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
                              "posteq_cpu_timeB", &rdata.posteq_cpu_timeB, 1);
 
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "posteq_wall_time", &rdata.posteq_wall_time, 1);
+
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "posteq_wall_timeB", &rdata.posteq_wall_timeB, 1);
+
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(), "posteq_t",
                              &rdata.posteq_t, 1);
 
@@ -455,9 +897,30 @@ void writeReturnDataDiagnosis(const ReturnData &rdata,
     H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
                              "cpu_time_total", &rdata.cpu_time_total, 1);
 
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "wall_time", &rdata.wall_time, 1);
+
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "wall_timeB", &rdata.wall_timeB, 1);
+
+    H5LTset_attribute_double(file.getId(), hdf5Location.c_str(),
+                             "wall_time_total", &rdata.wall_time_total, 1);
+
+    H5LTset_attribute_long_long(file.getId(), hdf5Location.c_str(),
+                                "model_workspace_bytes",
+                                &rdata.model_workspace_bytes, 1);
+
+    if (!rdata.profile_calls.empty())
+        createAndWriteInt1DDataset(file, hdf5Location + "/profile_calls",
+                                   rdata.profile_calls);
+
+    if (!rdata.profile_time.empty())
+        createAndWriteDouble1DDataset(file, hdf5Location + "/profile_time",
+                                      rdata.profile_time);
+
     if (!rdata.J.empty())
         createAndWriteDouble2DDataset(file, hdf5Location + "/J", rdata.J,
-                                      rdata.nx, rdata.nx);
+                                      rdata.nx_solver, rdata.nx_solver);
 
 }
 
@@ -560,6 +1023,11 @@ void createAndWriteDouble2DDataset(const H5::H5File &file,
                                    std::string const& datasetName,
                                    gsl::span<const double> buffer, hsize_t m,
                                    hsize_t n) {
+    if (static_cast<hsize_t>(buffer.size()) != m * n)
+        throw AmiException("Size of data for %s (%zu) does not match the "
+                           "dataset dimensions (%llu)", datasetName.c_str(),
+                           static_cast<std::size_t>(buffer.size()),
+                           static_cast<unsigned long long>(m * n));
     const hsize_t adims[] {m, n};
     H5::DataSpace dataspace(2, adims);
     auto dataset = file.createDataSet(datasetName.c_str(), H5::PredType::NATIVE_DOUBLE,
@@ -571,6 +1039,11 @@ void createAndWriteInt2DDataset(H5::H5File const& file,
                                 std::string const& datasetName,
                                 gsl::span<const int> buffer, hsize_t m,
                                 hsize_t n) {
+    if (static_cast<hsize_t>(buffer.size()) != m * n)
+        throw AmiException("Size of data for %s (%zu) does not match the "
+                           "dataset dimensions (%llu)", datasetName.c_str(),
+                           static_cast<std::size_t>(buffer.size()),
+                           static_cast<unsigned long long>(m * n));
     const hsize_t adims[] {m, n};
     H5::DataSpace dataspace(2, adims);
     auto dataset = file.createDataSet(datasetName.c_str(), H5::PredType::NATIVE_INT,
@@ -582,6 +1055,11 @@ void createAndWriteDouble3DDataset(H5::H5File const& file,
                                    std::string const& datasetName,
                                    gsl::span<const double> buffer, hsize_t m,
                                    hsize_t n, hsize_t o) {
+    if (static_cast<hsize_t>(buffer.size()) != m * n * o)
+        throw AmiException("Size of data for %s (%zu) does not match the "
+                           "dataset dimensions (%llu)", datasetName.c_str(),
+                           static_cast<std::size_t>(buffer.size()),
+                           static_cast<unsigned long long>(m * n * o));
     const hsize_t adims[] {m, n, o};
     H5::DataSpace dataspace(3, adims);
     auto dataset = file.createDataSet(datasetName.c_str(), H5::PredType::NATIVE_DOUBLE,
@@ -748,6 +1226,15 @@ void writeSolverSettingsToHDF5(Solver const& solver,
     ibuffer = static_cast<int>(solver.getReturnDataReportingMode());
     H5LTset_attribute_int(file.getId(), hdf5Location.c_str(),
                           "rdrm", &ibuffer, 1);
+
+    ibuffer = solver.getReturnDataFields();
+    H5LTset_attribute_int(file.getId(), hdf5Location.c_str(),
+                          "rdata_fields", &ibuffer, 1);
+
+    if (!solver.getReturnDataTrajectoryTimepoints().empty())
+        createAndWriteInt1DDataset(
+            file, hdf5Location + "/rdata_trajectory_its",
+            solver.getReturnDataTrajectoryTimepoints());
     
     ibuffer = static_cast<int>(solver.getNewtonStepSteadyStateCheck());
     H5LTset_attribute_int(file.getId(), hdf5Location.c_str(),
@@ -756,6 +1243,10 @@ void writeSolverSettingsToHDF5(Solver const& solver,
     ibuffer = static_cast<int>(solver.getSensiSteadyStateCheck());
     H5LTset_attribute_int(file.getId(), hdf5Location.c_str(),
                           "check_sensi_steadystate_conv", &ibuffer, 1);
+
+    ibuffer = static_cast<int>(solver.getProfiling());
+    H5LTset_attribute_int(file.getId(), hdf5Location.c_str(),
+                          "profiling", &ibuffer, 1);
 }
 
 void readSolverSettingsFromHDF5(H5::H5File const& file, Solver &solver,
@@ -928,6 +1419,16 @@ void readSolverSettingsFromHDF5(H5::H5File const& file, Solver &solver,
                     static_cast<RDataReporting>(
                         getIntScalarAttribute(file, datasetPath, "rdrm")));
     }
+
+    if(attributeExists(file, datasetPath, "rdata_fields")) {
+        solver.setReturnDataFields(
+                    getIntScalarAttribute(file, datasetPath, "rdata_fields"));
+    }
+
+    if(locationExists(file, datasetPath + "/rdata_trajectory_its")) {
+        solver.setReturnDataTrajectoryTimepoints(
+                    getIntDataset1D(file, datasetPath + "/rdata_trajectory_its"));
+    }
     
     if(attributeExists(file, datasetPath, "newton_step_steadystate_conv")) {
         solver.setNewtonStepSteadyStateCheck(
@@ -938,6 +1439,11 @@ void readSolverSettingsFromHDF5(H5::H5File const& file, Solver &solver,
         solver.setSensiSteadyStateCheck(
                     getIntScalarAttribute(file, datasetPath, "check_sensi_steadystate_conv"));
     }
+
+    if(attributeExists(file, datasetPath, "profiling")) {
+        solver.setProfiling(
+                    getIntScalarAttribute(file, datasetPath, "profiling"));
+    }
 }
 
 void readSolverSettingsFromHDF5(const std::string &hdffile, Solver &solver,
@@ -1152,5 +1658,270 @@ std::vector<double> getDoubleDataset3D(const H5::H5File &file,
     return result;
 }
 
+namespace {
+
+/**
+ * @brief Checks the options of ReturnDataBatchWriter, so that invalid
+ * options do not leave a new file behind
+ * @param hdf5Filename HDF5 file to write to
+ * @param compression deflate compression level
+ * @param chunkSize number of simulations per chunk
+ * @param queueCapacity maximum number of queued results
+ * @return hdf5Filename
+ */
+std::string const& checkBatchWriterOptions(std::string const& hdf5Filename,
+                                           int compression, int chunkSize,
+                                           int queueCapacity) {
+    if (compression < 0 || compression > 9)
+        throw AmiException("Compression level must be in [0, 9], was %d",
+                           compression);
+    if (chunkSize < 1)
+        throw AmiException("Chunk size must be positive, was %d", chunkSize);
+    if (queueCapacity < 1)
+        throw AmiException("Queue capacity must be positive, was %d",
+                           queueCapacity);
+    return hdf5Filename;
+}
+
+} // namespace
+
+ReturnDataBatchWriter::ReturnDataBatchWriter(std::string const& hdf5Filename,
+                                             std::string const& hdf5Location,
+                                             int compression, bool shuffle,
+                                             int chunkSize, int queueCapacity)
+    : file_(createOrOpenForWriting(
+          checkBatchWriterOptions(hdf5Filename, compression, chunkSize,
+                                  queueCapacity))),
+      location_(hdf5Location), compression_(compression), shuffle_(shuffle),
+      chunk_size_(chunkSize),
+      queue_capacity_(static_cast<std::size_t>(queueCapacity))
+{
+    if(!locationExists(file_, location_))
+        createGroup(file_, location_);
+
+    thread_ = std::thread(&ReturnDataBatchWriter::run, this);
+}
+
+ReturnDataBatchWriter::~ReturnDataBatchWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void ReturnDataBatchWriter::consume(int index,
+                                    std::unique_ptr<ReturnData> rdata) {
+    if (index < 0)
+        throw AmiException("Simulation index must be non-negative, was %d",
+                           index);
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] {
+        return queue_.size() < queue_capacity_ || closing_;
+    });
+    if (closing_)
+        throw AmiException("Cannot write to closed ReturnDataBatchWriter");
+    queue_.emplace_back(index, std::move(rdata));
+    cv_.notify_all();
+}
+
+void ReturnDataBatchWriter::append(int index, ReturnData const& rdata) {
+    consume(index, std::make_unique<ReturnData>(rdata));
+}
+
+void ReturnDataBatchWriter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closing_ && !thread_.joinable())
+            return;
+        closing_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+
+    datasets_.clear();
+    file_.close();
+
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+void ReturnDataBatchWriter::run() {
+    while (true) {
+        std::pair<int, std::unique_ptr<ReturnData>> item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !queue_.empty() || closing_; });
+            if (queue_.empty())
+                return;
+            item = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        // free a slot before the comparatively slow write
+        cv_.notify_all();
+
+        if (error_)
+            continue;
+        try {
+            write(item.first, *item.second);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+        }
+    }
+}
+
+void ReturnDataBatchWriter::write(int index, ReturnData const& rdata) {
+    using dims_t = std::vector<hsize_t>;
+    auto nt = static_cast<hsize_t>(rdata.nt);
+    auto nt_trajectory = static_cast<hsize_t>(rdata.ntTrajectory());
+    auto nx = static_cast<hsize_t>(rdata.nx);
+    auto ny = static_cast<hsize_t>(rdata.ny);
+    auto nz = static_cast<hsize_t>(rdata.nz);
+    auto nplist = static_cast<hsize_t>(rdata.nplist);
+    auto ne = static_cast<hsize_t>(rdata.nmaxevent);
+    auto nx_solver = static_cast<hsize_t>(rdata.nx_solver);
+
+    auto writeDouble = [&](char const* name, std::vector<realtype> const& vec,
+                           dims_t dims) {
+        if (vec.empty())
+            return;
+        hsize_t size = 1;
+        for (auto dim : dims)
+            size *= dim;
+        if (size != vec.size())
+            throw AmiException("Size of ReturnData field %s (%zu) does not "
+                               "match its dimensions (%llu)", name,
+                               vec.size(),
+                               static_cast<unsigned long long>(size));
+        writeField(name, H5::PredType::NATIVE_DOUBLE, vec.data(), dims,
+                   index);
+    };
+    auto writeInt = [&](char const* name, std::vector<int> const& vec) {
+        if (!vec.empty())
+            writeField(name, H5::PredType::NATIVE_INT, vec.data(),
+                       {vec.size()}, index);
+    };
+
+    writeDouble("ts", rdata.ts, {nt});
+    writeDouble("x", rdata.x, {nt_trajectory, nx});
+    writeDouble("sx", rdata.sx, {nt_trajectory, nplist, nx});
+    writeDouble("x0", rdata.x0, {nx});
+    writeDouble("sx0", rdata.sx0, {nplist, nx});
+    writeDouble("x_ss", rdata.x_ss, {nx});
+    writeDouble("sx_ss", rdata.sx_ss, {nplist, nx});
+    writeDouble("w", rdata.w,
+                {nt_trajectory, static_cast<hsize_t>(rdata.nw)});
+    writeDouble("y", rdata.y, {nt, ny});
+    writeDouble("sigmay", rdata.sigmay, {nt, ny});
+    writeDouble("sy", rdata.sy, {nt, nplist, ny});
+    writeDouble("ssigmay", rdata.ssigmay, {nt, nplist, ny});
+    writeDouble("z", rdata.z, {ne, nz});
+    writeDouble("rz", rdata.rz, {ne, nz});
+    writeDouble("sigmaz", rdata.sigmaz, {ne, nz});
+    writeDouble("sz", rdata.sz, {ne, nplist, nz});
+    writeDouble("srz", rdata.srz, {ne, nplist, nz});
+    writeDouble("ssigmaz", rdata.ssigmaz, {ne, nplist, nz});
+    writeDouble("res", rdata.res, {rdata.res.size()});
+    writeDouble("sres", rdata.sres,
+                {nplist ? rdata.sres.size() / nplist : 0, nplist});
+    writeDouble("FIM", rdata.FIM, {nplist, nplist});
+    writeDouble("sllh", rdata.sllh, {nplist});
+    writeDouble("s2llh", rdata.s2llh, {rdata.s2llh.size()});
+    writeDouble("J", rdata.J, {nx_solver, nx_solver});
+    writeDouble("xdot", rdata.xdot, {nx_solver});
+
+    writeInt("numsteps", rdata.numsteps);
+    writeInt("numrhsevals", rdata.numrhsevals);
+    writeInt("numerrtestfails", rdata.numerrtestfails);
+    writeInt("numnonlinsolvconvfails", rdata.numnonlinsolvconvfails);
+    writeInt("order", rdata.order);
+
+    writeField("llh", H5::PredType::NATIVE_DOUBLE, &rdata.llh, {}, index);
+    writeField("chi2", H5::PredType::NATIVE_DOUBLE, &rdata.chi2, {}, index);
+    writeField("cpu_time", H5::PredType::NATIVE_DOUBLE, &rdata.cpu_time, {},
+               index);
+    writeField("cpu_timeB", H5::PredType::NATIVE_DOUBLE, &rdata.cpu_timeB, {},
+               index);
+    writeField("status", H5::PredType::NATIVE_INT, &rdata.status, {}, index);
+}
+
+void ReturnDataBatchWriter::writeField(std::string const& name,
+                                       H5::PredType const& type,
+                                       void const* buffer,
+                                       std::vector<hsize_t> const& dims,
+                                       int index) {
+    auto rank = static_cast<int>(dims.size()) + 1;
+    std::vector<hsize_t> extent(rank), offset(rank, 0), count(rank);
+    count[0] = 1;
+    std::copy(dims.begin(), dims.end(), count.begin() + 1);
+
+    auto it = datasets_.find(name);
+    if (it == datasets_.end()) {
+        std::vector<hsize_t> maxdims(count);
+        maxdims[0] = H5S_UNLIMITED;
+        // at most chunk_size_ simulations per chunk, and not more than fits
+        // into the default chunk cache (1 MiB), splitting the leading
+        // dimensions first
+        std::vector<hsize_t> chunk(count);
+        chunk[0] = static_cast<hsize_t>(chunk_size_);
+        auto chunkBytes = [&chunk, &type]() {
+            hsize_t bytes = type.getSize();
+            for (auto dim : chunk)
+                bytes *= dim;
+            return bytes;
+        };
+        for (auto &dim : chunk) {
+            while (dim > 1 && chunkBytes() > max_chunk_bytes)
+                dim = (dim + 1) / 2;
+        }
+        extent = count;
+        extent[0] = 0;
+
+        H5::DSetCreatPropList plist;
+        plist.setChunk(rank, chunk.data());
+        if (shuffle_)
+            plist.setShuffle();
+        if (compression_ > 0)
+            plist.setDeflate(compression_);
+        if (type == H5::PredType::NATIVE_DOUBLE) {
+            auto fill = getNaN();
+            plist.setFillValue(type, &fill);
+        } else if (name == "status") {
+            // rows of simulations that were not written must not read as
+            // successful
+            int fill = AMICI_ERROR;
+            plist.setFillValue(type, &fill);
+        }
+
+        H5::DataSpace space(rank, extent.data(), maxdims.data());
+        auto path = location_ + "/" + name;
+        it = datasets_.emplace(name, file_.createDataSet(path.c_str(), type,
+                                                         space, plist))
+                 .first;
+    }
+    auto &dataset = it->second;
+
+    auto filespace = dataset.getSpace();
+    if (filespace.getSimpleExtentNdims() != rank)
+        throw AmiException("Inconsistent rank of %s across simulations",
+                           name.c_str());
+    filespace.getSimpleExtentDims(extent.data());
+    if (!std::equal(extent.begin() + 1, extent.end(), count.begin() + 1))
+        throw AmiException("Inconsistent dimensions of %s across simulations",
+                           name.c_str());
+
+    if (extent[0] <= static_cast<hsize_t>(index)) {
+        extent[0] = static_cast<hsize_t>(index) + 1;
+        dataset.extend(extent.data());
+        filespace = dataset.getSpace();
+    }
+
+    offset[0] = static_cast<hsize_t>(index);
+    filespace.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+    H5::DataSpace memspace(rank, count.data());
+    dataset.write(buffer, type, memspace, filespace);
+}
+
 } // namespace hdf5
 } // namespace amici
@@ -97,6 +97,23 @@ void amici_dgemv(BLASLayout layout, BLASTranspose TransA,
     FORTRAN_WRAPPER(dgemv)(&transA, &M_, &N_, &alpha, A, &lda_, X, &incX_, &beta, Y, &incY_);
 }
 
+void amici_dsyrk(BLASLayout layout, BLASUplo uplo, BLASTranspose Trans,
+                 const int N, const int K, const double alpha,
+                 const double *A, const int lda, const double beta, double *C,
+                 const int ldc) {
+    assert(layout == BLASLayout::colMajor);
+
+    const ptrdiff_t N_ = N;
+    const ptrdiff_t K_ = K;
+    const ptrdiff_t lda_ = lda;
+    const ptrdiff_t ldc_ = ldc;
+    const char uplo_ = uplo == BLASUplo::upper ? 'U' : 'L';
+    const char trans = amici_blasCBlasTransToBlasTrans(Trans);
+
+    FORTRAN_WRAPPER(dsyrk)(&uplo_, &trans, &N_, &K_, &alpha, A, &lda_, &beta,
+                           C, &ldc_);
+}
+
 void amici_daxpy(int n, double alpha, const double *x, const int incx, double *y, int incy) {
 
     const ptrdiff_t n_ = n;
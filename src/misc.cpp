@@ -4,6 +4,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <sstream>
 #include <cstdarg>
 
@@ -13,7 +14,15 @@
 #define PLATFORM_WINDOWS // Windows
 #elif defined(__CYGWIN__) && !defined(_WIN32)
 #define PLATFORM_WINDOWS // Windows (Cygwin POSIX under Microsoft Window)
-#else
+#endif
+
+#if defined(PLATFORM_WINDOWS) && !defined(__CYGWIN__)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h> // for GetThreadTimes
+#elif !defined(PLATFORM_WINDOWS)
+#include <time.h>
 #include <execinfo.h>
 #include <dlfcn.h>    // for dladdr
 #include <cxxabi.h>   // for __cxa_demangle
@@ -178,4 +187,39 @@ std::string printfToString(const char *fmt, va_list ap) {
     return str;
 }
 
+void CpuTimer::reset() {
+    start_cpu_ = threadCpuTime();
+    start_wall_ = std::chrono::steady_clock::now();
+}
+
+double CpuTimer::elapsedMilliseconds() const {
+    return threadCpuTime() - start_cpu_;
+}
+
+double CpuTimer::elapsedWallMilliseconds() const {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start_wall_)
+        .count();
+}
+
+double CpuTimer::threadCpuTime() {
+#if defined(PLATFORM_WINDOWS) && !defined(__CYGWIN__)
+    FILETIME creation, exit, kernel, user;
+    if (GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        // 100 ns intervals
+        auto ticks = [](FILETIME const &ft) {
+            return (static_cast<unsigned long long>(ft.dwHighDateTime) << 32)
+                   + ft.dwLowDateTime;
+        };
+        return static_cast<double>(ticks(kernel) + ticks(user)) / 1e4;
+    }
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return static_cast<double>(ts.tv_sec) * 1e3
+               + static_cast<double>(ts.tv_nsec) / 1e6;
+#endif
+    return static_cast<double>(std::clock()) * 1000.0 / CLOCKS_PER_SEC;
+}
+
 } // namespace amici
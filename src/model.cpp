@@ -2,6 +2,7 @@
 #include "amici/amici.h"
 #include "amici/exception.h"
 #include "amici/misc.h"
+#include "amici/profiling.h"
 #include "amici/symbolic_functions.h"
 
 #include <algorithm>
@@ -101,11 +102,11 @@ Model::Model(ModelDimensions const & model_dimensions,
              const bool pythonGenerated, const int ndxdotdp_explicit,
              const int ndxdotdx_explicit, const int w_recursion_depth)
     : ModelDimensions(model_dimensions), pythonGenerated(pythonGenerated),
-      o2mode(o2mode), idlist(std::move(idlist)),
-      derived_state_(model_dimensions),
-      z2event_(std::move(z2event)),
+      o2mode(o2mode),
+      definition_(std::make_shared<ModelDefinition const>(ModelDefinition{
+          std::move(idlist), std::move(z2event), ndxdotdp_explicit,
+          ndxdotdx_explicit, w_recursion_depth})),
       state_is_non_negative_(nx_solver, false),
-      w_recursion_depth_(w_recursion_depth),
       simulation_parameters_(std::move(simulation_parameters)) {
     Expects(model_dimensions.np == static_cast<int>(simulation_parameters_.parameters.size()));
     Expects(model_dimensions.nk == static_cast<int>(simulation_parameters_.fixedParameters.size()));
@@ -121,53 +122,97 @@ Model::Model(ModelDimensions const & model_dimensions,
     state_.fixedParameters = simulation_parameters_.fixedParameters;
     state_.plist = simulation_parameters_.plist;
 
+    initializeWorkspace();
+    requireSensitivitiesForAllParameters();
+}
+
+Model::Model(Model const &other)
+    : AbstractModel(other), ModelDimensions(other),
+      pythonGenerated(other.pythonGenerated), o2mode(other.o2mode),
+      app(other.app), state_(other.state_), definition_(other.definition_),
+      x0data_(other.x0data_), sx0data_(other.sx0data_),
+      state_is_non_negative_(other.state_is_non_negative_),
+      any_state_non_negative_(other.any_state_non_negative_),
+      nmaxevent_(other.nmaxevent_),
+      steadystate_sensitivity_mode_(other.steadystate_sensitivity_mode_),
+      always_check_finite_(other.always_check_finite_),
+      sigma_res_(other.sigma_res_), min_sigma_(other.min_sigma_),
+      simulation_parameters_(other.simulation_parameters_) {
+    // the workspace only holds intermediate results and is not copied
+    initializeWorkspace();
+}
+
+void Model::initializeWorkspace() {
+    derived_state_ = ModelStateDerived(*this);
+
     /* If Matlab wrapped: dxdotdp is a full AmiVector,
        if Python wrapped: dxdotdp_explicit and dxdotdp_implicit are CSC matrices
      */
     if (pythonGenerated) {
+        auto const &def = *definition_;
 
-        dwdw_ = SUNMatrixWrapper(nw, nw, ndwdw, CSC_MAT);
-        // size dynamically adapted for dwdx_ and dwdp_
+        derived_state_.dwdw_ = SUNMatrixWrapper(nw, nw, ndwdw, CSC_MAT);
+        // size dynamically adapted for dwdx_
         derived_state_.dwdx_ = SUNMatrixWrapper(nw, nx_solver, 0, CSC_MAT);
-        derived_state_.dwdp_ = SUNMatrixWrapper(nw, np(), 0, CSC_MAT);
 
-        for (int irec = 0; irec <= w_recursion_depth_; ++irec) {
+        for (int irec = 0; irec <= def.w_recursion_depth; ++irec) {
             /* for the first element we know the exact size, while for all others we
                guess the size*/
-            dwdp_hierarchical_.emplace_back(
-                SUNMatrixWrapper(nw, np(), irec * ndwdw + ndwdp, CSC_MAT));
-            dwdx_hierarchical_.emplace_back(
+            derived_state_.dwdx_hierarchical_.emplace_back(
                 SUNMatrixWrapper(nw, nx_solver, irec * ndwdw + ndwdx, CSC_MAT));
         }
-        assert(static_cast<int>(dwdp_hierarchical_.size()) ==
-               w_recursion_depth_ + 1);
-        assert(static_cast<int>(dwdx_hierarchical_.size()) ==
-               w_recursion_depth_ + 1);
+        assert(static_cast<int>(derived_state_.dwdx_hierarchical_.size()) ==
+               def.w_recursion_depth + 1);
 
-        derived_state_.dxdotdp_explicit = SUNMatrixWrapper(
-                    nx_solver, np(), ndxdotdp_explicit, CSC_MAT);
-        // guess size, will be dynamically reallocated
-        derived_state_.dxdotdp_implicit = SUNMatrixWrapper(
-                    nx_solver, np(), ndwdp + ndxdotdw, CSC_MAT);
         derived_state_.dxdotdx_explicit = SUNMatrixWrapper(
-                    nx_solver, nx_solver, ndxdotdx_explicit, CSC_MAT);
+                    nx_solver, nx_solver, def.ndxdotdx_explicit, CSC_MAT);
         // guess size, will be dynamically reallocated
         derived_state_.dxdotdx_implicit = SUNMatrixWrapper(
                     nx_solver, nx_solver, ndwdx + ndxdotdw, CSC_MAT);
-        // dynamically allocate on first call
-        derived_state_.dxdotdp_full = SUNMatrixWrapper(
-                    nx_solver, np(), 0, CSC_MAT);
-
-        for (int iytrue = 0; iytrue < nytrue; ++iytrue)
-            derived_state_.dJydy_.emplace_back(
-                SUNMatrixWrapper(nJ, ny, ndJydy.at(iytrue), CSC_MAT));
     } else {
         derived_state_.dwdx_ = SUNMatrixWrapper(nw, nx_solver, ndwdx, CSC_MAT);
+    }
+}
+
+void Model::allocateDwdp() {
+    if (derived_state_.dwdp_.get())
+        return;
+
+    if (pythonGenerated) {
+        // size dynamically adapted
+        derived_state_.dwdp_ = SUNMatrixWrapper(nw, np(), 0, CSC_MAT);
+        for (int irec = 0; irec <= definition_->w_recursion_depth; ++irec) {
+            /* for the first element we know the exact size, while for all others we
+               guess the size*/
+            derived_state_.dwdp_hierarchical_.emplace_back(
+                SUNMatrixWrapper(nw, np(), irec * ndwdw + ndwdp, CSC_MAT));
+        }
+    } else {
         derived_state_.dwdp_ = SUNMatrixWrapper(nw, np(), ndwdp, CSC_MAT);
-        derived_state_.dJydy_matlab_ = std::vector<realtype>(
-                    nJ * nytrue * ny, 0.0);
     }
-    requireSensitivitiesForAllParameters();
+}
+
+void Model::allocateDxdotdp() {
+    if (pythonGenerated) {
+        if (derived_state_.dxdotdp_full.get())
+            return;
+        derived_state_.dxdotdp_explicit = SUNMatrixWrapper(
+                    nx_solver, np(), definition_->ndxdotdp_explicit, CSC_MAT);
+        // guess size, will be dynamically reallocated
+        derived_state_.dxdotdp_implicit = SUNMatrixWrapper(
+                    nx_solver, np(), ndwdp + ndxdotdw, CSC_MAT);
+        // dynamically allocate on first call
+        derived_state_.dxdotdp_full = SUNMatrixWrapper(
+                    nx_solver, np(), 0, CSC_MAT);
+    } else if (derived_state_.dxdotdp.getLength() != nplist()) {
+        derived_state_.dxdotdp = AmiVectorArray(nx_solver, nplist());
+    }
+}
+
+void Model::allocateJB() {
+    if (!derived_state_.JB_.get())
+        derived_state_.JB_ =
+            SUNMatrixWrapper(nx_solver, nx_solver, nnz, CSC_MAT);
 }
 
 bool operator==(const Model &a, const Model &b) {
@@ -177,7 +222,8 @@ bool operator==(const Model &a, const Model &b) {
     return (static_cast<ModelDimensions const&>(a)
             == static_cast<ModelDimensions const&>(b))
             && (a.o2mode == b.o2mode) &&
-           (a.z2event_ == b.z2event_) && (a.idlist == b.idlist) &&
+           (a.definition_->z2event == b.definition_->z2event) &&
+           (a.getIdList() == b.getIdList()) &&
            (a.state_.h == b.state_.h) &&
            (a.state_.unscaledParameters == b.state_.unscaledParameters) &&
            (a.simulation_parameters_ == b.simulation_parameters_) &&
@@ -884,16 +930,15 @@ void Model::addObservableObjective(realtype &Jy, const int it,
     fsigmay(it, &edata);
 
     std::vector<realtype> nllh(nJ, 0.0);
-    for (int iyt = 0; iyt < nytrue; iyt++) {
-        if (edata.isSetObservedData(it, iyt)) {
-            std::fill(nllh.begin(), nllh.end(), 0.0);
-            fJy(nllh.data(), iyt, state_.unscaledParameters.data(),
-                state_.fixedParameters.data(),
-                derived_state_.y_.data(),
-                derived_state_.sigmay_.data(),
-                edata.getObservedDataPtr(it));
-            Jy -= nllh.at(0);
-        }
+    auto my = edata.getObservedDataPtr(it, derived_state_.my_);
+    for (auto iyt : edata.getObservedDataIndices(it)) {
+        std::fill(nllh.begin(), nllh.end(), 0.0);
+        fJy(nllh.data(), iyt, state_.unscaledParameters.data(),
+            state_.fixedParameters.data(),
+            derived_state_.y_.data(),
+            derived_state_.sigmay_.data(),
+            my);
+        Jy -= nllh.at(0);
     }
 }
 
@@ -964,7 +1009,7 @@ void Model::getUnobservedEventSensitivity(gsl::span<realtype> sz,
     checkBufferSize(sz, nz * nplist());
 
     for (int iz = 0; iz < nz; ++iz)
-        if (z2event_.at(iz) - 1 == ie)
+        if (definition_->z2event.at(iz) - 1 == ie)
             for (int ip = 0; ip < nplist(); ++ip)
                 sz[ip * nz + iz] = 0.0;
 }
@@ -1100,6 +1145,7 @@ void Model::getEventTimeSensitivity(std::vector<realtype> &stau,
                                     const realtype t, const int ie,
                                     const AmiVector &x,
                                     const AmiVectorArray &sx) {
+    AMICI_PROFILE_SCOPE(fstau);
 
     std::fill(stau.begin(), stau.end(), 0.0);
 
@@ -1114,6 +1160,7 @@ void Model::getEventTimeSensitivity(std::vector<realtype> &stau,
 void Model::addStateEventUpdate(AmiVector &x, const int ie, const realtype t,
                                 const AmiVector &xdot,
                                 const AmiVector &xdot_old) {
+    AMICI_PROFILE_SCOPE(fdeltax);
 
     derived_state_.deltax_.assign(nx_solver, 0.0);
 
@@ -1139,6 +1186,7 @@ void Model::addStateSensitivityEventUpdate(AmiVectorArray &sx, const int ie,
                                            const AmiVector &xdot,
                                            const AmiVector &xdot_old,
                                            const std::vector<realtype> &stau) {
+    AMICI_PROFILE_SCOPE(fdeltasx);
     fw(t, x_old.data());
 
     for (int ip = 0; ip < nplist(); ip++) {
@@ -1166,6 +1214,7 @@ void Model::addAdjointStateEventUpdate(AmiVector &xB, const int ie,
                                        const realtype t, const AmiVector &x,
                                        const AmiVector &xdot,
                                        const AmiVector &xdot_old) {
+    AMICI_PROFILE_SCOPE(fdeltaxB);
 
     derived_state_.deltaxB_.assign(nx_solver, 0.0);
 
@@ -1189,6 +1238,7 @@ void Model::addAdjointStateEventUpdate(AmiVector &xB, const int ie,
 void Model::addAdjointQuadratureEventUpdate(
     AmiVector xQB, const int ie, const realtype t, const AmiVector &x,
     const AmiVector &xB, const AmiVector &xdot, const AmiVector &xdot_old) {
+    AMICI_PROFILE_SCOPE(fdeltaqB);
     for (int ip = 0; ip < nplist(); ip++) {
         derived_state_.deltaqB_.assign(nJ, 0.0);
 
@@ -1239,6 +1289,7 @@ void Model::setAlwaysCheckFinite(bool alwaysCheck) {
 bool Model::getAlwaysCheckFinite() const { return always_check_finite_; }
 
 void Model::fx0(AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fx0);
     std::fill(derived_state_.x_rdata_.begin(), derived_state_.x_rdata_.end(), 0.0);
     /* this function  also computes initial total abundances */
     fx0(derived_state_.x_rdata_.data(), simulation_parameters_.tstart_,
@@ -1280,6 +1331,7 @@ void Model::fx0_fixedParameters(AmiVector &x) {
 }
 
 void Model::fsx0(AmiVectorArray &sx, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fsx0);
     /* this function  also computes initial total abundance sensitivities */
     realtype *stcl = nullptr;
     for (int ip = 0; ip < nplist(); ip++) {
@@ -1352,9 +1404,9 @@ void Model::fsx_rdata(AmiVectorArray &sx_rdata, const AmiVectorArray &sx,
 void Model::writeSliceEvent(gsl::span<const realtype> slice,
                             gsl::span<realtype> buffer, const int ie) {
     checkBufferSize(buffer, slice.size());
-    checkBufferSize(buffer, z2event_.size());
-    for (unsigned izt = 0; izt < z2event_.size(); ++izt)
-        if (z2event_.at(izt) - 1 == ie)
+    checkBufferSize(buffer, definition_->z2event.size());
+    for (unsigned izt = 0; izt < definition_->z2event.size(); ++izt)
+        if (definition_->z2event.at(izt) - 1 == ie)
             buffer[izt] = slice[izt];
 }
 
@@ -1362,10 +1414,10 @@ void Model::writeSensitivitySliceEvent(gsl::span<const realtype> slice,
                                        gsl::span<realtype> buffer,
                                        const int ie) {
     checkBufferSize(buffer, slice.size());
-    checkBufferSize(buffer, z2event_.size() * nplist());
+    checkBufferSize(buffer, definition_->z2event.size() * nplist());
     for (int ip = 0; ip < nplist(); ++ip)
-        for (unsigned izt = 0; izt < z2event_.size(); ++izt)
-            if (z2event_.at(izt) - 1 == ie)
+        for (unsigned izt = 0; izt < definition_->z2event.size(); ++izt)
+            if (definition_->z2event.at(izt) - 1 == ie)
                 buffer[ip * nztrue + izt] = slice[ip * nztrue + izt];
 }
 
@@ -1393,11 +1445,10 @@ void Model::checkLLHBufferSize(std::vector<realtype> const &sllh,
 
 void Model::initializeVectors() {
     sx0data_.clear();
-    if (!pythonGenerated)
-        derived_state_.dxdotdp = AmiVectorArray(nx_solver, nplist());
 }
 
 void Model::fy(const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fy);
     if (!ny)
         return;
 
@@ -1416,6 +1467,7 @@ void Model::fy(const realtype t, const AmiVector &x) {
 }
 
 void Model::fdydp(const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fdydp);
     if (!ny)
         return;
 
@@ -1446,6 +1498,7 @@ void Model::fdydp(const realtype t, const AmiVector &x) {
 }
 
 void Model::fdydx(const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fdydx);
     if (!ny)
         return;
 
@@ -1466,6 +1519,7 @@ void Model::fdydx(const realtype t, const AmiVector &x) {
 }
 
 void Model::fsigmay(const int it, const ExpData *edata) {
+    AMICI_PROFILE_SCOPE(fsigmay);
     if (!ny)
         return;
 
@@ -1482,7 +1536,7 @@ void Model::fsigmay(const int it, const ExpData *edata) {
         /* extract the value for the standard deviation from ExpData,
          * if the data value is NaN, use the parameter value */
         for (int iytrue = 0; iytrue < nytrue; iytrue++) {
-            if (edata->isSetObservedDataStdDev(it, iytrue))
+            if (sigmay_edata && !isNaN(sigmay_edata[iytrue]))
                 derived_state_.sigmay_.at(iytrue) = sigmay_edata[iytrue];
 
             /* TODO: when moving second order code to cpp, verify
@@ -1490,14 +1544,22 @@ void Model::fsigmay(const int it, const ExpData *edata) {
              */
             for (int iJ = 1; iJ < nJ; iJ++)
                 derived_state_.sigmay_.at(iytrue + iJ*nytrue) = 0;
-
-            if (edata->isSetObservedData(it, iytrue))
-                checkSigmaPositivity(derived_state_.sigmay_.at(iytrue), "sigmay");
         }
+
+        // sparse ExpData only stores standard deviations of set data points
+        auto indices = edata->getObservedDataIndices(it);
+        auto sigmay_sparse = edata->getObservedDataStdDevValues(it);
+        for (std::size_t i = 0; i < sigmay_sparse.size(); ++i)
+            if (!isNaN(sigmay_sparse[i]))
+                derived_state_.sigmay_.at(indices[i]) = sigmay_sparse[i];
+
+        for (auto iytrue : indices)
+            checkSigmaPositivity(derived_state_.sigmay_.at(iytrue), "sigmay");
     }
 }
 
 void Model::fdsigmaydp(const int it, const ExpData *edata) {
+    AMICI_PROFILE_SCOPE(fdsigmaydp);
     if (!ny)
         return;
 
@@ -1559,32 +1621,40 @@ void Model::fdsigmaydy(const int it, const ExpData *edata) {
 
 
 void Model::fdJydy(const int it, const AmiVector &x, const ExpData &edata) {
+    AMICI_PROFILE_SCOPE(fdJydy);
     if (!ny)
         return;
 
     fy(edata.getTimepoint(it), x);
     fsigmay(it, &edata);
+    auto my = edata.getObservedDataPtr(it, derived_state_.my_);
 
     if (pythonGenerated) {
         fdJydsigma(it, x, edata);
         fdsigmaydy(it, &edata);
         SUNMatrixWrapper tmp_dense(nJ, ny);
+        if (derived_state_.dJydy_.empty()) {
+            for (int iytrue = 0; iytrue < nytrue; ++iytrue)
+                derived_state_.dJydy_.emplace_back(
+                    SUNMatrixWrapper(nJ, ny, ndJydy.at(iytrue), CSC_MAT));
+        }
 
-        for (int iyt = 0; iyt < nytrue; iyt++) {
+        // slices of unmeasured observables are zero
+        for (auto &dJydy : derived_state_.dJydy_)
+            if (dJydy.capacity())
+                dJydy.zero();
+
+        for (auto iyt : edata.getObservedDataIndices(it)) {
             if (!derived_state_.dJydy_.at(iyt).capacity())
                 continue;
-            derived_state_.dJydy_.at(iyt).zero();
             fdJydy_colptrs(derived_state_.dJydy_.at(iyt), iyt);
             fdJydy_rowvals(derived_state_.dJydy_.at(iyt), iyt);
 
-            if (!edata.isSetObservedData(it, iyt))
-                continue;
-
             // get dJydy slice (ny) for current timepoint and observable
             fdJydy(derived_state_.dJydy_.at(iyt).data(), iyt, state_.unscaledParameters.data(),
                    state_.fixedParameters.data(), derived_state_.y_.data(),
                    derived_state_.sigmay_.data(),
-                   edata.getObservedDataPtr(it));
+                   my);
 
             // dJydy += dJydsigma * dsigmaydy
             // C(nJ,ny)  A(nJ,ny)  * B(ny,ny)
@@ -1612,16 +1682,13 @@ void Model::fdJydy(const int it, const AmiVector &x, const ExpData &edata) {
             }
         }
     } else {
-        std::fill(derived_state_.dJydy_matlab_.begin(),
-                  derived_state_.dJydy_matlab_.end(), 0.0);
-        for (int iyt = 0; iyt < nytrue; iyt++) {
-            if (!edata.isSetObservedData(it, iyt))
-                continue;
+        derived_state_.dJydy_matlab_.assign(nJ * nytrue * ny, 0.0);
+        for (auto iyt : edata.getObservedDataIndices(it)) {
             fdJydy(&derived_state_.dJydy_matlab_.at(iyt * ny * nJ), iyt,
                    state_.unscaledParameters.data(),
                    state_.fixedParameters.data(), derived_state_.y_.data(),
                    derived_state_.sigmay_.data(),
-                   edata.getObservedDataPtr(it));
+                   my);
         }
         if (always_check_finite_) {
             // get dJydy slice (ny) for current timepoint and observable
@@ -1631,22 +1698,23 @@ void Model::fdJydy(const int it, const AmiVector &x, const ExpData &edata) {
 }
 
 void Model::fdJydsigma(const int it, const AmiVector &x, const ExpData &edata) {
+    AMICI_PROFILE_SCOPE(fdJydsigma);
     if (!ny)
         return;
 
+    // slices of unmeasured observables are zero
     derived_state_.dJydsigma_.assign(nytrue * ny * nJ, 0.0);
 
     fy(edata.getTimepoint(it), x);
     fsigmay(it, &edata);
+    auto my = edata.getObservedDataPtr(it, derived_state_.my_);
 
-    for (int iyt = 0; iyt < nytrue; iyt++) {
-        if (edata.isSetObservedData(it, iyt))
-            // get dJydsigma slice (ny) for current timepoint and observable
-            fdJydsigma(&derived_state_.dJydsigma_.at(iyt * ny * nJ), iyt,
-                       state_.unscaledParameters.data(),
-                       state_.fixedParameters.data(), derived_state_.y_.data(),
-                       derived_state_.sigmay_.data(),
-                       edata.getObservedDataPtr(it));
+    for (auto iyt : edata.getObservedDataIndices(it)) {
+        // get dJydsigma slice (ny) for current timepoint and observable
+        fdJydsigma(&derived_state_.dJydsigma_.at(iyt * ny * nJ), iyt, state_.unscaledParameters.data(),
+                   state_.fixedParameters.data(), derived_state_.y_.data(),
+                   derived_state_.sigmay_.data(),
+                   my);
     }
 
     if (always_check_finite_) {
@@ -1669,10 +1737,7 @@ void Model::fdJydp(const int it, const AmiVector &x, const ExpData &edata) {
     fdJydsigma(it, x, edata);
     fdsigmaydp(it, &edata);
 
-    for (int iyt = 0; iyt < nytrue; ++iyt) {
-        if (!edata.isSetObservedData(it, iyt))
-            continue;
-
+    for (auto iyt : edata.getObservedDataIndices(it)) {
         if (pythonGenerated) {
             // dJydp = 1.0 * dJydp +  1.0 * dJydy * dydp
             for (int iplist = 0; iplist < nplist(); ++iplist) {
@@ -1708,9 +1773,7 @@ void Model::fdJydx(const int it, const AmiVector &x, const ExpData &edata) {
     // dJydy: nJ, ny x nytrue
     // dydx :     ny x nx_solver
     // dJydx:     nJ x nx_solver x nt
-    for (int iyt = 0; iyt < nytrue; ++iyt) {
-        if (!edata.isSetObservedData(it, iyt))
-            continue;
+    for (auto iyt : edata.getObservedDataIndices(it)) {
         // dJydy A[nyt,nJ,ny] * dydx B[ny,nx_solver] = dJydx C[it,nJ,nx_solver]
         //         slice                                       slice
         //          M  K            K  N                       M  N
@@ -1737,6 +1800,7 @@ void Model::fdJydx(const int it, const AmiVector &x, const ExpData &edata) {
 }
 
 void Model::fz(const int ie, const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fz);
 
     derived_state_.z_.assign(nz, 0.0);
 
@@ -1746,6 +1810,7 @@ void Model::fz(const int ie, const realtype t, const AmiVector &x) {
 }
 
 void Model::fdzdp(const int ie, const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fdzdp);
     if (!nz)
         return;
 
@@ -1763,6 +1828,7 @@ void Model::fdzdp(const int ie, const realtype t, const AmiVector &x) {
 }
 
 void Model::fdzdx(const int ie, const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(fdzdx);
     if (!nz)
         return;
 
@@ -1778,6 +1844,7 @@ void Model::fdzdx(const int ie, const realtype t, const AmiVector &x) {
 }
 
 void Model::frz(const int ie, const realtype t, const AmiVector &x) {
+    AMICI_PROFILE_SCOPE(frz);
 
     derived_state_.rz_.assign(nz, 0.0);
 
@@ -1820,6 +1887,7 @@ void Model::fdrzdx(const int ie, const realtype t, const AmiVector &x) {
 
 void Model::fsigmaz(const int ie, const int nroots, const realtype t,
                     const ExpData *edata) {
+    AMICI_PROFILE_SCOPE(fsigmaz);
     if (!nz)
         return;
 
@@ -1829,7 +1897,7 @@ void Model::fsigmaz(const int ie, const int nroots, const realtype t,
 
     if (edata) {
         for (int iztrue = 0; iztrue < nztrue; iztrue++) {
-            if (z2event_.at(iztrue) - 1 == ie) {
+            if (definition_->z2event.at(iztrue) - 1 == ie) {
                 if (edata->isSetObservedEventsStdDev(nroots, iztrue)) {
                     auto sigmaz_edata =
                         edata->getObservedEventsStdDevPtr(nroots);
@@ -1867,7 +1935,7 @@ void Model::fdsigmazdp(const int ie, const int nroots, const realtype t,
     // to zero
     if (edata) {
         for (int iz = 0; iz < nztrue; iz++) {
-            if (z2event_.at(iz) - 1 == ie &&
+            if (definition_->z2event.at(iz) - 1 == ie &&
                 !edata->isSetObservedEventsStdDev(nroots, iz)) {
                 for (int ip = 0; ip < nplist(); ip++)
                     derived_state_.dsigmazdp_.at(iz + nz * ip) = 0;
@@ -1882,6 +1950,7 @@ void Model::fdsigmazdp(const int ie, const int nroots, const realtype t,
 
 void Model::fdJzdz(const int ie, const int nroots, const realtype t,
                    const AmiVector &x, const ExpData &edata) {
+    AMICI_PROFILE_SCOPE(fdJzdz);
     if (!nz)
         return;
 
@@ -2024,6 +2093,7 @@ void Model::fdJzdx(const int ie, const int nroots, const realtype t,
 
 void Model::fdJrzdz(const int ie, const int nroots, const realtype t,
                     const AmiVector &x, const ExpData &edata) {
+    AMICI_PROFILE_SCOPE(fdJrzdz);
     if (!nz)
         return;
 
@@ -2071,6 +2141,7 @@ void Model::fdJrzdsigma(const int ie, const int nroots, const realtype t,
 }
 
 void Model::fw(const realtype t, const realtype *x) {
+    AMICI_PROFILE_SCOPE(fw);
     std::fill(derived_state_.w_.begin(), derived_state_.w_.end(), 0.0);
     fw(derived_state_.w_.data(), t, x, state_.unscaledParameters.data(),
        state_.fixedParameters.data(), state_.h.data(), state_.total_cl.data());
@@ -2081,29 +2152,33 @@ void Model::fw(const realtype t, const realtype *x) {
 }
 
 void Model::fdwdp(const realtype t, const realtype *x) {
+    AMICI_PROFILE_SCOPE(fdwdp);
+    allocateDwdp();
     if (!nw)
         return;
 
     fw(t, x);
     derived_state_.dwdp_.zero();
     if (pythonGenerated) {
-        if (!dwdp_hierarchical_.at(0).capacity())
+        if (!derived_state_.dwdp_hierarchical_.at(0).capacity())
             return;
         fdwdw(t,x);
-        dwdp_hierarchical_.at(0).zero();
-        fdwdp_colptrs(dwdp_hierarchical_.at(0));
-        fdwdp_rowvals(dwdp_hierarchical_.at(0));
-        fdwdp(dwdp_hierarchical_.at(0).data(), t, x,
+        derived_state_.dwdp_hierarchical_.at(0).zero();
+        fdwdp_colptrs(derived_state_.dwdp_hierarchical_.at(0));
+        fdwdp_rowvals(derived_state_.dwdp_hierarchical_.at(0));
+        fdwdp(derived_state_.dwdp_hierarchical_.at(0).data(), t, x,
               state_.unscaledParameters.data(), state_.fixedParameters.data(),
               state_.h.data(), derived_state_.w_.data(), state_.total_cl.data(),
               state_.stotal_cl.data());
 
-        for (int irecursion = 1; irecursion <= w_recursion_depth_;
+        auto &dwdp_hierarchical = derived_state_.dwdp_hierarchical_;
+        for (int irecursion = 1; irecursion <= definition_->w_recursion_depth;
              irecursion++) {
-            dwdw_.sparse_multiply(dwdp_hierarchical_.at(irecursion),
-                                  dwdp_hierarchical_.at(irecursion - 1));
+            derived_state_.dwdw_.sparse_multiply(
+                dwdp_hierarchical.at(irecursion),
+                dwdp_hierarchical.at(irecursion - 1));
         }
-        derived_state_.dwdp_.sparse_sum(dwdp_hierarchical_);
+        derived_state_.dwdp_.sparse_sum(derived_state_.dwdp_hierarchical_);
 
     } else {
         if (!derived_state_.dwdp_.capacity())
@@ -2121,6 +2196,7 @@ void Model::fdwdp(const realtype t, const realtype *x) {
 }
 
 void Model::fdwdx(const realtype t, const realtype *x) {
+    AMICI_PROFILE_SCOPE(fdwdx);
     if (!nw)
         return;
 
@@ -2128,22 +2204,24 @@ void Model::fdwdx(const realtype t, const realtype *x) {
 
     derived_state_.dwdx_.zero();
     if (pythonGenerated) {
-        if (!dwdx_hierarchical_.at(0).capacity())
+        if (!derived_state_.dwdx_hierarchical_.at(0).capacity())
                 return;
         fdwdw(t,x);
-        dwdx_hierarchical_.at(0).zero();
-        fdwdx_colptrs(dwdx_hierarchical_.at(0));
-        fdwdx_rowvals(dwdx_hierarchical_.at(0));
-        fdwdx(dwdx_hierarchical_.at(0).data(), t, x,
+        derived_state_.dwdx_hierarchical_.at(0).zero();
+        fdwdx_colptrs(derived_state_.dwdx_hierarchical_.at(0));
+        fdwdx_rowvals(derived_state_.dwdx_hierarchical_.at(0));
+        fdwdx(derived_state_.dwdx_hierarchical_.at(0).data(), t, x,
               state_.unscaledParameters.data(), state_.fixedParameters.data(),
               state_.h.data(), derived_state_.w_.data(), state_.total_cl.data());
 
-        for (int irecursion = 1; irecursion <= w_recursion_depth_;
+        auto &dwdx_hierarchical = derived_state_.dwdx_hierarchical_;
+        for (int irecursion = 1; irecursion <= definition_->w_recursion_depth;
              irecursion++) {
-            dwdw_.sparse_multiply(dwdx_hierarchical_.at(irecursion),
-                                  dwdx_hierarchical_.at(irecursion - 1));
+            derived_state_.dwdw_.sparse_multiply(
+                dwdx_hierarchical.at(irecursion),
+                dwdx_hierarchical.at(irecursion - 1));
         }
-        derived_state_.dwdx_.sparse_sum(dwdx_hierarchical_);
+        derived_state_.dwdx_.sparse_sum(derived_state_.dwdx_hierarchical_);
 
     } else {
         if (!derived_state_.dwdx_.capacity())
@@ -2162,17 +2240,17 @@ void Model::fdwdx(const realtype t, const realtype *x) {
 }
 
 void Model::fdwdw(const realtype t, const realtype *x) {
-    if (!nw || !dwdw_.capacity())
+    if (!nw || !derived_state_.dwdw_.capacity())
         return;
-    dwdw_.zero();
-    fdwdw_colptrs(dwdw_);
-    fdwdw_rowvals(dwdw_);
-    fdwdw(dwdw_.data(), t, x, state_.unscaledParameters.data(),
+    derived_state_.dwdw_.zero();
+    fdwdw_colptrs(derived_state_.dwdw_);
+    fdwdw_rowvals(derived_state_.dwdw_);
+    fdwdw(derived_state_.dwdw_.data(), t, x, state_.unscaledParameters.data(),
           state_.fixedParameters.data(), state_.h.data(),
           derived_state_.w_.data(), state_.total_cl.data());
 
     if (always_check_finite_) {
-        app->checkFinite(gsl::make_span(dwdw_.get()), "dwdw");
+        app->checkFinite(gsl::make_span(derived_state_.dwdw_.get()), "dwdw");
     }
 }
 
@@ -2209,6 +2287,9 @@ void Model::fsx_rdata(realtype *sx_rdata, const realtype *sx_solver,
 
     // 2) sx_rdata(nx_rdata, 1) +=
     //          dx_rdata/dx_solver(nx_rdata,nx_solver) * sx_solver(nx_solver, 1)
+    if (!derived_state_.dx_rdatadx_solver.get())
+        derived_state_.dx_rdatadx_solver = SUNMatrixWrapper(
+            nx_rdata, nx_solver, ndxrdatadxsolver, CSC_MAT);
     derived_state_.dx_rdatadx_solver.zero();
     fdx_rdatadx_solver(derived_state_.dx_rdatadx_solver.data(),
                        x_solver, tcl, p, k);
@@ -2218,6 +2299,9 @@ void Model::fsx_rdata(realtype *sx_rdata, const realtype *sx_solver,
                                               gsl::make_span(sx_solver, nx_solver));
 
     // 3) sx_rdata(nx_rdata, 1) += dx_rdata/d_tcl(nx_rdata,ntcl) * stcl
+    if (!derived_state_.dx_rdatadtcl.get())
+        derived_state_.dx_rdatadtcl = SUNMatrixWrapper(
+            nx_rdata, nx_rdata - nx_solver, ndxrdatadtcl, CSC_MAT);
     derived_state_.dx_rdatadtcl.zero();
     fdx_rdatadtcl(derived_state_.dx_rdatadtcl.data(), x_solver, tcl, p, k);
     fdx_rdatadtcl_colptrs(derived_state_.dx_rdatadtcl);
@@ -2266,6 +2350,9 @@ void Model::fstotal_cl(realtype *stotal_cl, const realtype *sx_rdata,
 
 
     // 2) stotal_cl += dtotal_cl/dx_rdata(ncl,nx_rdata) * sx_rdata(nx_rdata,1)
+    if (!derived_state_.dtotal_cldx_rdata.get())
+        derived_state_.dtotal_cldx_rdata = SUNMatrixWrapper(
+            nx_rdata - nx_solver, nx_rdata, ndtotal_cldx_rdata, CSC_MAT);
     derived_state_.dtotal_cldx_rdata.zero();
     fdtotal_cldx_rdata(derived_state_.dtotal_cldx_rdata.data(),
                        x_rdata, tcl, p, k);
@@ -2315,12 +2402,20 @@ const std::vector<int> &Model::getReinitializationStateIdxs() const
 
 const AmiVectorArray &Model::get_dxdotdp() const{
     assert(!pythonGenerated);
+    if (derived_state_.dxdotdp.getLength() != nplist())
+        throw AmiException("dxdotdp is not allocated, call fdxdotdp first.");
     return derived_state_.dxdotdp;
 }
 
 const SUNMatrixWrapper &Model::get_dxdotdp_full() const{
     assert(pythonGenerated);
+    if (!derived_state_.dxdotdp_full.get())
+        throw AmiException("dxdotdp is not allocated, call fdxdotdp first.");
     return derived_state_.dxdotdp_full;
 }
 
+std::size_t Model::getWorkspaceMemoryUsage() const {
+    return derived_state_.getMemoryUsage();
+}
+
 } // namespace amici
@@ -1,4 +1,5 @@
 #include "amici/model_dae.h"
+#include "amici/profiling.h"
 #include "amici/solver_idas.h"
 
 namespace amici {
@@ -10,6 +11,7 @@ void Model_DAE::fJ(const realtype t, const realtype cj, const AmiVector &x,
 
 void Model_DAE::fJ(realtype t, realtype cj, const_N_Vector x, const_N_Vector dx,
                    const_N_Vector /*xdot*/, SUNMatrix J) {
+    AMICI_PROFILE_SCOPE(fJ);
     fJSparse(t, cj, x, dx, derived_state_.J_.get());
     derived_state_.J_.refresh();
     auto JDense = SUNMatrixWrapper(J);
@@ -24,6 +26,7 @@ void Model_DAE::fJSparse(const realtype t, const realtype cj,
 
 void Model_DAE::fJSparse(realtype t, realtype cj, const_N_Vector x,
                          const_N_Vector dx, SUNMatrix J) {
+    AMICI_PROFILE_SCOPE(fJSparse);
     auto x_pos = computeX_pos(x);
     fdwdx(t, N_VGetArrayPointerConst(x_pos));
     SUNMatZero(J);
@@ -44,6 +47,7 @@ void Model_DAE::fJv(const realtype t, const AmiVector &x, const AmiVector &dx,
 
 void Model_DAE::fJv(realtype t, const_N_Vector x, const_N_Vector dx,
                     const_N_Vector v, N_Vector Jv, realtype cj) {
+    AMICI_PROFILE_SCOPE(fJv);
     N_VConst(0.0, Jv);
     fJSparse(t, cj, x, dx, derived_state_.J_.get());
     derived_state_.J_.refresh();
@@ -57,6 +61,7 @@ void Model_DAE::froot(const realtype t, const AmiVector &x, const AmiVector &dx,
 
 void Model_DAE::froot(realtype t, const_N_Vector x, const_N_Vector dx,
                       gsl::span<realtype> root) {
+    AMICI_PROFILE_SCOPE(froot);
     std::fill(root.begin(), root.end(), 0.0);
     auto x_pos = computeX_pos(x);
     froot(root.data(), t, N_VGetArrayPointerConst(x_pos),
@@ -71,6 +76,7 @@ void Model_DAE::fxdot(const realtype t, const AmiVector &x, const AmiVector &dx,
 
 void Model_DAE::fxdot(realtype t, const_N_Vector x, const_N_Vector dx,
                       N_Vector xdot) {
+    AMICI_PROFILE_SCOPE(fxdot);
     auto x_pos = computeX_pos(x);
     fw(t, N_VGetArrayPointerConst(x));
     N_VConst(0.0, xdot);
@@ -84,6 +90,7 @@ void Model_DAE::fxdot(realtype t, const_N_Vector x, const_N_Vector dx,
 void Model_DAE::fJDiag(const realtype t, AmiVector &JDiag,
                        const realtype /*cj*/, const AmiVector &x,
                        const AmiVector &dx) {
+    AMICI_PROFILE_SCOPE(fJDiag);
     fJSparse(t, 0.0, x.getNVector(), dx.getNVector(), derived_state_.J_.get());
     derived_state_.J_.refresh();
     derived_state_.J_.to_diag(JDiag.getNVector());
@@ -93,6 +100,8 @@ void Model_DAE::fJDiag(const realtype t, AmiVector &JDiag,
 
 void Model_DAE::fdxdotdp(const realtype t, const const_N_Vector x,
                          const const_N_Vector dx) {
+    AMICI_PROFILE_SCOPE(fdxdotdp);
+    allocateDxdotdp();
     auto x_pos = computeX_pos(x);
 
     if (pythonGenerated) {
@@ -115,6 +124,8 @@ void Model_DAE::fdxdotdp(const realtype t, const const_N_Vector x,
 }
 
 void Model_DAE::fM(realtype t, const_N_Vector x) {
+    if (!derived_state_.M_.get())
+        derived_state_.M_ = SUNMatrixWrapper(nx_solver, nx_solver);
     derived_state_.M_.zero();
     auto x_pos = computeX_pos(x);
     fM(derived_state_.M_.data(), t, N_VGetArrayPointerConst(x_pos),
@@ -159,6 +170,7 @@ void Model_DAE::fJB(const realtype t, realtype cj, const AmiVector &x,
 void Model_DAE::fJB(realtype t, realtype cj, const_N_Vector x,
                     const_N_Vector dx, const_N_Vector /*xB*/,
                     const_N_Vector /*dxB*/, SUNMatrix JB) {
+    AMICI_PROFILE_SCOPE(fJB);
     fJSparse(t, cj, x, dx, derived_state_.J_.get());
     derived_state_.J_.refresh();
     auto JBDense = SUNMatrixWrapper(JB);
@@ -176,6 +188,7 @@ void Model_DAE::fJSparseB(realtype t, realtype cj, const_N_Vector x,
                           const_N_Vector dx,
                           const_N_Vector /*xB*/, const_N_Vector /*dxB*/,
                           SUNMatrix JB) {
+    AMICI_PROFILE_SCOPE(fJSparseB);
     fJSparse(t, cj, x, dx, derived_state_.J_.get());
     derived_state_.J_.refresh();
     auto JSparseB = SUNMatrixWrapper(JB);
@@ -185,7 +198,9 @@ void Model_DAE::fJSparseB(realtype t, realtype cj, const_N_Vector x,
 void Model_DAE::fJvB(realtype t, const_N_Vector x, const_N_Vector dx,
                      const_N_Vector xB, const_N_Vector dxB, const_N_Vector vB,
                      N_Vector JvB, realtype cj) {
+    AMICI_PROFILE_SCOPE(fJvB);
     N_VConst(0.0, JvB);
+    allocateJB();
     fJSparseB(t, cj, x, dx, xB, dxB, derived_state_.JB_.get());
     derived_state_.JB_.refresh();
     derived_state_.JB_.multiply(JvB, vB);
@@ -194,7 +209,9 @@ void Model_DAE::fJvB(realtype t, const_N_Vector x, const_N_Vector dx,
 void Model_DAE::fxBdot(realtype t, const_N_Vector x, const_N_Vector dx,
                        const_N_Vector xB,
                        const_N_Vector dxB, N_Vector xBdot) {
+    AMICI_PROFILE_SCOPE(fxBdot);
     N_VConst(0.0, xBdot);
+    allocateJB();
     fJSparseB(t, 1.0, x, dx, xB, dxB, derived_state_.JB_.get());
     derived_state_.JB_.refresh();
     fM(t, x);
@@ -204,6 +221,7 @@ void Model_DAE::fxBdot(realtype t, const_N_Vector x, const_N_Vector dx,
 void Model_DAE::fqBdot(realtype t, const_N_Vector x, const_N_Vector dx,
                        const_N_Vector xB, const_N_Vector /*dxB*/,
                        N_Vector qBdot) {
+    AMICI_PROFILE_SCOPE(fqBdot);
     N_VConst(0.0, qBdot);
     fdxdotdp(t, x, dx);
     for (int ip = 0; ip < nplist(); ip++) {
@@ -254,6 +272,7 @@ void Model_DAE::writeSteadystateJB(const realtype t, realtype cj,
                                    const AmiVector &xB, const AmiVector & dxB,
                                    const AmiVector &/*xBdot*/) {
     /* Get backward Jacobian */
+    allocateJB();
     fJSparseB(t, cj, x.getNVector(), dx.getNVector(), xB.getNVector(),
               dxB.getNVector(), derived_state_.JB_.get());
     derived_state_.JB_.refresh();
@@ -270,6 +289,7 @@ void Model_DAE::fsxdot(const realtype t, const AmiVector &x,
 
 void Model_DAE::fsxdot(realtype t, const_N_Vector x, const_N_Vector dx, int ip,
                        const_N_Vector sx, const_N_Vector sdx, N_Vector sxdot) {
+    AMICI_PROFILE_SCOPE(fsxdot);
     if (ip == 0) {
         // we only need to call this for the first parameter index will be
         // the same for all remaining
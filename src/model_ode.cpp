@@ -1,5 +1,6 @@
 #include <amici/sundials_matrix_wrapper.h>
 #include "amici/model_ode.h"
+#include "amici/profiling.h"
 #include "amici/solver_cvodes.h"
 
 namespace amici {
@@ -11,6 +12,7 @@ void Model_ODE::fJ(const realtype t, const realtype /*cj*/, const AmiVector &x,
 }
 
 void Model_ODE::fJ(realtype t, const_N_Vector x, const_N_Vector /*xdot*/, SUNMatrix J) {
+    AMICI_PROFILE_SCOPE(fJ);
     auto x_pos = computeX_pos(x);
     fdwdx(t, N_VGetArrayPointerConst(x_pos));
     fJSparse(t, x, derived_state_.J_.get());
@@ -26,6 +28,7 @@ void Model_ODE::fJSparse(const realtype t, const realtype /*cj*/,
 }
 
 void Model_ODE::fJSparse(realtype t, const_N_Vector x, SUNMatrix J) {
+    AMICI_PROFILE_SCOPE(fJSparse);
     auto x_pos = computeX_pos(x);
     fdwdx(t, N_VGetArrayPointerConst(x_pos));
     if (pythonGenerated) {
@@ -67,6 +70,7 @@ void Model_ODE::fJv(const realtype t, const AmiVector &x,
 }
 
 void Model_ODE::fJv(const_N_Vector v, N_Vector Jv, realtype t, const_N_Vector x) {
+    AMICI_PROFILE_SCOPE(fJv);
     N_VConst(0.0, Jv);
     fJSparse(t, x, derived_state_.J_.get());
     derived_state_.J_.refresh();
@@ -79,6 +83,7 @@ void Model_ODE::froot(const realtype t, const AmiVector &x,
 }
 
 void Model_ODE::froot(realtype t, const_N_Vector x, gsl::span<realtype> root) {
+    AMICI_PROFILE_SCOPE(froot);
     auto x_pos = computeX_pos(x);
     std::fill(root.begin(), root.end(), 0.0);
     froot(root.data(), t, N_VGetArrayPointerConst(x_pos),
@@ -92,6 +97,7 @@ void Model_ODE::fxdot(const realtype t, const AmiVector &x,
 }
 
 void Model_ODE::fxdot(realtype t, const_N_Vector x, N_Vector xdot) {
+    AMICI_PROFILE_SCOPE(fxdot);
     auto x_pos = computeX_pos(x);
     fw(t, N_VGetArrayPointerConst(x_pos));
     N_VConst(0.0, xdot);
@@ -110,6 +116,7 @@ void Model_ODE::fJDiag(const realtype t, AmiVector &JDiag,
 }
 
 void Model_ODE::fdxdotdw(const realtype t, const_N_Vector x) {
+    AMICI_PROFILE_SCOPE(fdxdotdw);
     derived_state_.dxdotdw_.zero();
     if (nw > 0 && derived_state_.dxdotdw_.capacity()) {
         auto x_pos = computeX_pos(x);
@@ -123,6 +130,8 @@ void Model_ODE::fdxdotdw(const realtype t, const_N_Vector x) {
 }
 
 void Model_ODE::fdxdotdp(const realtype t, const_N_Vector x) {
+    AMICI_PROFILE_SCOPE(fdxdotdp);
+    allocateDxdotdp();
     auto x_pos = computeX_pos(x);
     fdwdp(t, N_VGetArrayPointerConst(x_pos));
 
@@ -293,6 +302,7 @@ void Model_ODE::fJB(const realtype t, realtype /*cj*/, const AmiVector &x,
 
 void Model_ODE::fJB(realtype t, const_N_Vector x, const_N_Vector /*xB*/,
                     const_N_Vector /*xBdot*/, SUNMatrix JB) {
+    AMICI_PROFILE_SCOPE(fJB);
     fJSparse(t, x, derived_state_.J_.get());
     derived_state_.J_.refresh();
     auto JDenseB = SUNMatrixWrapper(JB);
@@ -308,6 +318,7 @@ void Model_ODE::fJSparseB(const realtype t, realtype /*cj*/, const AmiVector &x,
 
 void Model_ODE::fJSparseB(realtype t, const_N_Vector x, const_N_Vector /*xB*/,
                           const_N_Vector /*xBdot*/, SUNMatrix JB) {
+    AMICI_PROFILE_SCOPE(fJSparseB);
     fJSparse(t, x, derived_state_.J_.get());
     derived_state_.J_.refresh();
     auto JSparseB = SUNMatrixWrapper(JB);
@@ -315,6 +326,7 @@ void Model_ODE::fJSparseB(realtype t, const_N_Vector x, const_N_Vector /*xB*/,
 }
 
 void Model_ODE::fJDiag(realtype t, N_Vector JDiag, const_N_Vector x) {
+    AMICI_PROFILE_SCOPE(fJDiag);
     fJSparse(t, x, derived_state_.J_.get());
     derived_state_.J_.refresh();
     derived_state_.J_.to_diag(JDiag);
@@ -322,14 +334,18 @@ void Model_ODE::fJDiag(realtype t, N_Vector JDiag, const_N_Vector x) {
 
 void Model_ODE::fJvB(const_N_Vector vB, N_Vector JvB, realtype t, const_N_Vector x,
                      const_N_Vector xB) {
+    AMICI_PROFILE_SCOPE(fJvB);
     N_VConst(0.0, JvB);
+    allocateJB();
     fJSparseB(t, x, xB, nullptr, derived_state_.JB_.get());
     derived_state_.JB_.refresh();
     derived_state_.JB_.multiply(JvB, vB);
 }
 
 void Model_ODE::fxBdot(realtype t, N_Vector x, N_Vector xB, N_Vector xBdot) {
+    AMICI_PROFILE_SCOPE(fxBdot);
     N_VConst(0.0, xBdot);
+    allocateJB();
     fJSparseB(t, x, xB, nullptr, derived_state_.JB_.get());
     derived_state_.JB_.refresh();
     derived_state_.JB_.multiply(xBdot, xB);
@@ -337,6 +353,7 @@ void Model_ODE::fxBdot(realtype t, N_Vector x, N_Vector xB, N_Vector xBdot) {
 
 void Model_ODE::fqBdot(realtype t, const_N_Vector x, const_N_Vector xB,
                        N_Vector qBdot) {
+    AMICI_PROFILE_SCOPE(fqBdot);
     /* initialize with zeros */
     N_VConst(0.0, qBdot);
     fdxdotdp(t, x);
@@ -392,6 +409,7 @@ void Model_ODE::writeSteadystateJB(const realtype t, realtype /*cj*/,
                                    const AmiVector &xB, const AmiVector & /*dxB*/,
                                    const AmiVector &xBdot) {
     /* Get backward Jacobian */
+    allocateJB();
     fJSparseB(t, x.getNVector(), xB.getNVector(), xBdot.getNVector(),
               derived_state_.JB_.get());
     derived_state_.JB_.refresh();
@@ -408,6 +426,7 @@ void Model_ODE::fsxdot(const realtype t, const AmiVector &x,
 
 void Model_ODE::fsxdot(realtype t, const_N_Vector x, int ip, const_N_Vector sx,
                        N_Vector sxdot) {
+    AMICI_PROFILE_SCOPE(fsxdot);
 
     /* sxdot is just the total derivative d(xdot)dp,
      so we just call dxdotdp and copy the stuff over */
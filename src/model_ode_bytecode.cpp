@@ -0,0 +1,1372 @@
+#include "amici/model_ode_bytecode.h"
+
+#include "amici/exception.h"
+#include "amici/symbolic_functions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+namespace amici {
+
+namespace bytecode {
+
+void Program::evaluate(Arguments const &args, realtype *r) const {
+    auto const reinitialized = [&args](int index) {
+        return std::find(args.reinitialization_state_idxs.begin(),
+                         args.reinitialization_state_idxs.end(),
+                         index) != args.reinitialization_state_idxs.end();
+    };
+
+    for (auto const &ins : instructions) {
+        auto const a = ins.a;
+        auto const b = ins.b;
+        switch (ins.op) {
+        case Opcode::constant:
+            r[ins.dst] = constants[a];
+            break;
+        case Opcode::load:
+            r[ins.dst] = args.arrays[a][b];
+            break;
+        case Opcode::store:
+            args.out[a] = r[b];
+            break;
+        case Opcode::store_reinit:
+            if (reinitialized(a))
+                args.out[a] = r[b];
+            break;
+        case Opcode::zero_reinit:
+            if (reinitialized(a))
+                args.out[a] = 0.0;
+            break;
+        case Opcode::add:
+            r[ins.dst] = r[a] + r[b];
+            break;
+        case Opcode::sub:
+            r[ins.dst] = r[a] - r[b];
+            break;
+        case Opcode::mul:
+            r[ins.dst] = r[a] * r[b];
+            break;
+        case Opcode::div:
+            r[ins.dst] = r[a] / r[b];
+            break;
+        case Opcode::pow:
+            r[ins.dst] = std::pow(r[a], r[b]);
+            break;
+        case Opcode::pos_pow:
+            r[ins.dst] = amici::pos_pow(r[a], r[b]);
+            break;
+        case Opcode::max:
+            r[ins.dst] = std::max(r[a], r[b]);
+            break;
+        case Opcode::min:
+            r[ins.dst] = std::min(r[a], r[b]);
+            break;
+        case Opcode::fmod:
+            r[ins.dst] = std::fmod(r[a], r[b]);
+            break;
+        case Opcode::atan2:
+            r[ins.dst] = std::atan2(r[a], r[b]);
+            break;
+        case Opcode::heaviside:
+            r[ins.dst] = amici::heaviside(r[a], r[b]);
+            break;
+        case Opcode::lt:
+            r[ins.dst] = r[a] < r[b];
+            break;
+        case Opcode::le:
+            r[ins.dst] = r[a] <= r[b];
+            break;
+        case Opcode::gt:
+            r[ins.dst] = r[a] > r[b];
+            break;
+        case Opcode::ge:
+            r[ins.dst] = r[a] >= r[b];
+            break;
+        case Opcode::eq:
+            r[ins.dst] = r[a] == r[b];
+            break;
+        case Opcode::ne:
+            r[ins.dst] = r[a] != r[b];
+            break;
+        case Opcode::logical_and:
+            r[ins.dst] = r[a] != 0.0 && r[b] != 0.0;
+            break;
+        case Opcode::logical_or:
+            r[ins.dst] = r[a] != 0.0 || r[b] != 0.0;
+            break;
+        case Opcode::neg:
+            r[ins.dst] = -r[a];
+            break;
+        case Opcode::sqrt:
+            r[ins.dst] = std::sqrt(r[a]);
+            break;
+        case Opcode::cbrt:
+            r[ins.dst] = std::cbrt(r[a]);
+            break;
+        case Opcode::exp:
+            r[ins.dst] = std::exp(r[a]);
+            break;
+        case Opcode::log:
+            r[ins.dst] = std::log(r[a]);
+            break;
+        case Opcode::sin:
+            r[ins.dst] = std::sin(r[a]);
+            break;
+        case Opcode::cos:
+            r[ins.dst] = std::cos(r[a]);
+            break;
+        case Opcode::tan:
+            r[ins.dst] = std::tan(r[a]);
+            break;
+        case Opcode::asin:
+            r[ins.dst] = std::asin(r[a]);
+            break;
+        case Opcode::acos:
+            r[ins.dst] = std::acos(r[a]);
+            break;
+        case Opcode::atan:
+            r[ins.dst] = std::atan(r[a]);
+            break;
+        case Opcode::sinh:
+            r[ins.dst] = std::sinh(r[a]);
+            break;
+        case Opcode::cosh:
+            r[ins.dst] = std::cosh(r[a]);
+            break;
+        case Opcode::tanh:
+            r[ins.dst] = std::tanh(r[a]);
+            break;
+        case Opcode::asinh:
+            r[ins.dst] = std::asinh(r[a]);
+            break;
+        case Opcode::acosh:
+            r[ins.dst] = std::acosh(r[a]);
+            break;
+        case Opcode::atanh:
+            r[ins.dst] = std::atanh(r[a]);
+            break;
+        case Opcode::fabs:
+            r[ins.dst] = std::fabs(r[a]);
+            break;
+        case Opcode::floor:
+            r[ins.dst] = std::floor(r[a]);
+            break;
+        case Opcode::ceil:
+            r[ins.dst] = std::ceil(r[a]);
+            break;
+        case Opcode::erf:
+            r[ins.dst] = std::erf(r[a]);
+            break;
+        case Opcode::sign:
+            r[ins.dst] = amici::sign(r[a]);
+            break;
+        case Opcode::dirac:
+            r[ins.dst] = amici::dirac(r[a]);
+            break;
+        case Opcode::logical_not:
+            r[ins.dst] = r[a] == 0.0;
+            break;
+        case Opcode::select:
+            r[ins.dst] = r[a] != 0.0 ? r[b] : r[ins.c];
+            break;
+        }
+    }
+}
+
+namespace {
+
+/** Operand layout of an opcode */
+enum class Operands { constant, load, store, index, unary, binary, ternary };
+
+struct OpcodeInfo {
+    char const *mnemonic;
+    Opcode op;
+    Operands operands;
+};
+
+constexpr std::array<OpcodeInfo, 49> opcodes{{
+    {"const", Opcode::constant, Operands::constant},
+    {"load", Opcode::load, Operands::load},
+    {"store", Opcode::store, Operands::store},
+    {"store_reinit", Opcode::store_reinit, Operands::store},
+    {"zero_reinit", Opcode::zero_reinit, Operands::index},
+    {"add", Opcode::add, Operands::binary},
+    {"sub", Opcode::sub, Operands::binary},
+    {"mul", Opcode::mul, Operands::binary},
+    {"div", Opcode::div, Operands::binary},
+    {"pow", Opcode::pow, Operands::binary},
+    {"pos_pow", Opcode::pos_pow, Operands::binary},
+    {"max", Opcode::max, Operands::binary},
+    {"min", Opcode::min, Operands::binary},
+    {"fmod", Opcode::fmod, Operands::binary},
+    {"atan2", Opcode::atan2, Operands::binary},
+    {"heaviside", Opcode::heaviside, Operands::binary},
+    {"lt", Opcode::lt, Operands::binary},
+    {"le", Opcode::le, Operands::binary},
+    {"gt", Opcode::gt, Operands::binary},
+    {"ge", Opcode::ge, Operands::binary},
+    {"eq", Opcode::eq, Operands::binary},
+    {"ne", Opcode::ne, Operands::binary},
+    {"and", Opcode::logical_and, Operands::binary},
+    {"or", Opcode::logical_or, Operands::binary},
+    {"neg", Opcode::neg, Operands::unary},
+    {"sqrt", Opcode::sqrt, Operands::unary},
+    {"cbrt", Opcode::cbrt, Operands::unary},
+    {"exp", Opcode::exp, Operands::unary},
+    {"log", Opcode::log, Operands::unary},
+    {"sin", Opcode::sin, Operands::unary},
+    {"cos", Opcode::cos, Operands::unary},
+    {"tan", Opcode::tan, Operands::unary},
+    {"asin", Opcode::asin, Operands::unary},
+    {"acos", Opcode::acos, Operands::unary},
+    {"atan", Opcode::atan, Operands::unary},
+    {"sinh", Opcode::sinh, Operands::unary},
+    {"cosh", Opcode::cosh, Operands::unary},
+    {"tanh", Opcode::tanh, Operands::unary},
+    {"asinh", Opcode::asinh, Operands::unary},
+    {"acosh", Opcode::acosh, Operands::unary},
+    {"atanh", Opcode::atanh, Operands::unary},
+    {"fabs", Opcode::fabs, Operands::unary},
+    {"floor", Opcode::floor, Operands::unary},
+    {"ceil", Opcode::ceil, Operands::unary},
+    {"erf", Opcode::erf, Operands::unary},
+    {"sign", Opcode::sign, Operands::unary},
+    {"dirac", Opcode::dirac, Operands::unary},
+    {"not", Opcode::logical_not, Operands::unary},
+    {"select", Opcode::select, Operands::ternary},
+}};
+
+constexpr std::array<char const *, num_slots> slot_names{{
+    "out", "t", "x", "p", "k", "h", "w", "tcl", "dtcldp", "dwdx", "y",
+    "sigmay", "my", "sx", "stau", "xdot", "xdot_old", "x0", "x_rdata",
+}};
+
+/** Which indices a function is evaluated for */
+enum class Cases { single, ip, iy, ie, ie_ip };
+
+struct FunctionInfo {
+    char const *name;
+    Cases cases;
+    bool sparse;
+    std::initializer_list<Slot> inputs;
+};
+
+// must match the function signatures in amici.ode_export
+std::array<FunctionInfo, num_functions> const function_info{{
+    {"Jy", Cases::iy, false, {Slot::p, Slot::k, Slot::y, Slot::sigmay,
+                              Slot::my}},
+    {"dJydsigma", Cases::iy, false, {Slot::p, Slot::k, Slot::y, Slot::sigmay,
+                                     Slot::my}},
+    {"dJydy", Cases::iy, true, {Slot::p, Slot::k, Slot::y, Slot::sigmay,
+                                Slot::my}},
+    {"root", Cases::single, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                    Slot::h, Slot::tcl}},
+    {"dwdp", Cases::single, true, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                   Slot::h, Slot::w, Slot::tcl,
+                                   Slot::dtcldp}},
+    {"dwdx", Cases::single, true, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                   Slot::h, Slot::w, Slot::tcl}},
+    {"dwdw", Cases::single, true, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                   Slot::h, Slot::w, Slot::tcl}},
+    {"dxdotdw", Cases::single, true, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                      Slot::h, Slot::w}},
+    {"dxdotdx_explicit", Cases::single, true, {Slot::t, Slot::x, Slot::p,
+                                               Slot::k, Slot::h, Slot::w}},
+    {"dxdotdp_explicit", Cases::single, true, {Slot::t, Slot::x, Slot::p,
+                                               Slot::k, Slot::h, Slot::w}},
+    {"dydx", Cases::single, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                    Slot::h, Slot::w, Slot::dwdx}},
+    {"dydp", Cases::ip, false, {Slot::t, Slot::x, Slot::p, Slot::k, Slot::h,
+                                Slot::w, Slot::tcl, Slot::dtcldp}},
+    {"dsigmaydy", Cases::single, false, {Slot::t, Slot::p, Slot::k,
+                                         Slot::y}},
+    {"dsigmaydp", Cases::ip, false, {Slot::t, Slot::p, Slot::k, Slot::y}},
+    {"sigmay", Cases::single, false, {Slot::t, Slot::p, Slot::k, Slot::y}},
+    {"stau", Cases::ie_ip, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                   Slot::h, Slot::tcl, Slot::sx}},
+    {"deltax", Cases::ie, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                  Slot::h, Slot::xdot, Slot::xdot_old}},
+    {"deltasx", Cases::ie_ip, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                      Slot::h, Slot::w, Slot::xdot,
+                                      Slot::xdot_old, Slot::sx, Slot::stau,
+                                      Slot::tcl}},
+    {"w", Cases::single, false, {Slot::t, Slot::x, Slot::p, Slot::k, Slot::h,
+                                 Slot::tcl}},
+    {"x0", Cases::single, false, {Slot::t, Slot::p, Slot::k}},
+    {"x0_fixedParameters", Cases::single, false, {Slot::t, Slot::p,
+                                                  Slot::k}},
+    {"sx0", Cases::ip, false, {Slot::t, Slot::x, Slot::p, Slot::k}},
+    {"sx0_fixedParameters", Cases::ip, false, {Slot::t, Slot::x0, Slot::p,
+                                               Slot::k}},
+    {"xdot", Cases::single, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                    Slot::h, Slot::w}},
+    {"y", Cases::single, false, {Slot::t, Slot::x, Slot::p, Slot::k,
+                                 Slot::h, Slot::w}},
+    {"x_rdata", Cases::single, false, {Slot::x, Slot::tcl, Slot::p,
+                                       Slot::k}},
+    {"x_solver", Cases::single, false, {Slot::x_rdata}},
+    {"total_cl", Cases::single, false, {Slot::x_rdata, Slot::p, Slot::k}},
+    {"dtotal_cldp", Cases::ip, false, {Slot::x_rdata, Slot::p, Slot::k}},
+    {"dtotal_cldx_rdata", Cases::single, true, {Slot::x_rdata, Slot::p,
+                                                Slot::k, Slot::tcl}},
+    {"dx_rdatadx_solver", Cases::single, true, {Slot::x, Slot::tcl, Slot::p,
+                                                Slot::k}},
+    {"dx_rdatadp", Cases::ip, false, {Slot::x, Slot::tcl, Slot::p, Slot::k}},
+    {"dx_rdatadtcl", Cases::single, true, {Slot::x, Slot::tcl, Slot::p,
+                                           Slot::k}},
+}};
+
+/** Number of cases a function is evaluated for */
+int numCases(Cases cases, ModelDimensions const &dim) {
+    switch (cases) {
+    case Cases::ip:
+        return dim.np;
+    case Cases::iy:
+        return dim.ny;
+    case Cases::ie:
+        return dim.ne;
+    case Cases::ie_ip:
+        return dim.ne * dim.np;
+    default:
+        return 1;
+    }
+}
+
+/** Length of the output array of a function for the given case */
+int outputSize(Function function, int index,
+               BytecodeModelDefinition const &def) {
+    auto const &dim = def.dimensions;
+    auto const ncl = dim.nx_rdata - dim.nx_solver;
+    switch (function) {
+    case Function::Jy:
+        return dim.nJ;
+    case Function::dJydsigma:
+    case Function::dydp:
+    case Function::dsigmaydp:
+    case Function::sigmay:
+    case Function::y:
+        return dim.ny;
+    case Function::dJydy:
+        return dim.ndJydy.at(index);
+    case Function::root:
+        return dim.ne;
+    case Function::dwdp:
+        return dim.ndwdp;
+    case Function::dwdx:
+        return dim.ndwdx;
+    case Function::dwdw:
+        return dim.ndwdw;
+    case Function::dxdotdw:
+        return dim.ndxdotdw;
+    case Function::dxdotdx_explicit:
+        return def.ndxdotdx_explicit;
+    case Function::dxdotdp_explicit:
+        return def.ndxdotdp_explicit;
+    case Function::dydx:
+        return dim.ny * dim.nx_solver;
+    case Function::dsigmaydy:
+        return dim.ny * dim.ny;
+    case Function::stau:
+        return 1;
+    case Function::w:
+        return dim.nw;
+    case Function::total_cl:
+    case Function::dtotal_cldp:
+        return ncl;
+    case Function::dtotal_cldx_rdata:
+        return dim.ndtotal_cldx_rdata;
+    case Function::dx_rdatadx_solver:
+        return dim.ndxrdatadxsolver;
+    case Function::dx_rdatadtcl:
+        return dim.ndxrdatadtcl;
+    case Function::deltax:
+    case Function::deltasx:
+    case Function::xdot:
+    case Function::x_solver:
+        return dim.nx_solver;
+    default:
+        return dim.nx_rdata;
+    }
+}
+
+/** Number of rows and columns of the matrix computed by a sparse function */
+std::pair<int, int> matrixShape(Function function,
+                                BytecodeModelDefinition const &def) {
+    auto const &dim = def.dimensions;
+    auto const ncl = dim.nx_rdata - dim.nx_solver;
+    switch (function) {
+    case Function::dJydy:
+        return {dim.nJ, dim.ny};
+    case Function::dwdp:
+        return {dim.nw, dim.np};
+    case Function::dwdx:
+        return {dim.nw, dim.nx_solver};
+    case Function::dwdw:
+        return {dim.nw, dim.nw};
+    case Function::dxdotdw:
+        return {dim.nx_solver, dim.nw};
+    case Function::dxdotdx_explicit:
+        return {dim.nx_solver, dim.nx_solver};
+    case Function::dxdotdp_explicit:
+        return {dim.nx_solver, dim.np};
+    case Function::dtotal_cldx_rdata:
+        return {ncl, dim.nx_rdata};
+    case Function::dx_rdatadx_solver:
+        return {dim.nx_rdata, dim.nx_solver};
+    case Function::dx_rdatadtcl:
+        return {dim.nx_rdata, ncl};
+    default:
+        throw AmiException("Function %s is not sparse.",
+                           function_info[static_cast<int>(function)].name);
+    }
+}
+
+/** Check that a sparsity pattern is a valid CSC pattern of the output */
+void checkSparsity(SparsityPattern const &pattern, Function function,
+                   int index, BytecodeModelDefinition const &def) {
+    auto const &info = function_info[static_cast<int>(function)];
+    auto const shape = matrixShape(function, def);
+    auto const nnz = outputSize(function, index, def);
+    // model import writes empty column pointers for matrices without nonzeros
+    if (nnz == 0 && pattern.colptrs.empty() && pattern.rowvals.empty())
+        return;
+    if (static_cast<int>(pattern.colptrs.size()) != shape.second + 1
+        || static_cast<int>(pattern.rowvals.size()) != nnz)
+        throw AmiException("Invalid sparsity of function %s in bytecode "
+                           "model file: got %d column pointers and %d row "
+                           "indices, expected %d and %d.", info.name,
+                           static_cast<int>(pattern.colptrs.size()),
+                           static_cast<int>(pattern.rowvals.size()),
+                           shape.second + 1, nnz);
+    if (pattern.colptrs.front() != 0 || pattern.colptrs.back() != nnz
+        || !std::is_sorted(pattern.colptrs.begin(), pattern.colptrs.end()))
+        throw AmiException("Invalid sparsity of function %s in bytecode "
+                           "model file: column pointers are not "
+                           "non-decreasing from 0 to %d.", info.name, nnz);
+    for (auto row : pattern.rowvals)
+        if (row >= shape.first)
+            throw AmiException("Invalid sparsity of function %s in bytecode "
+                               "model file: row index %d out of range.",
+                               info.name, static_cast<int>(row));
+}
+
+/** Length of an input array */
+int inputSize(Slot slot, ModelDimensions const &dim) {
+    auto const ncl = dim.nx_rdata - dim.nx_solver;
+    switch (slot) {
+    case Slot::t:
+        return 1;
+    case Slot::p:
+        return dim.np;
+    case Slot::k:
+        return dim.nk;
+    case Slot::h:
+    case Slot::stau:
+        return dim.ne;
+    case Slot::w:
+        return dim.nw;
+    case Slot::tcl:
+        return ncl;
+    case Slot::dtcldp:
+        return ncl * dim.np;
+    case Slot::dwdx:
+        return dim.ndwdx;
+    case Slot::y:
+    case Slot::sigmay:
+    case Slot::my:
+        return dim.ny;
+    case Slot::x0:
+    case Slot::x_rdata:
+        return dim.nx_rdata;
+    default:
+        return dim.nx_solver;
+    }
+}
+
+/** Tokenizer for the bytecode file format */
+class Reader {
+  public:
+    explicit Reader(std::istream &stream) : stream_(stream) {}
+
+    std::string token() {
+        std::string result;
+        if (!(stream_ >> result))
+            throw AmiException("Unexpected end of bytecode model file.");
+        return result;
+    }
+
+    void expect(std::string const &expected) {
+        auto const found = token();
+        if (found != expected)
+            throw AmiException("Invalid bytecode model file: expected "
+                               "\"%s\", found \"%s\".",
+                               expected.c_str(), found.c_str());
+    }
+
+    int integer() {
+        auto const str = token();
+        char *end = nullptr;
+        auto const value = std::strtol(str.c_str(), &end, 10);
+        if (*end != '\0' || value < std::numeric_limits<int>::min() ||
+            value > std::numeric_limits<int>::max())
+            throw AmiException("Invalid integer \"%s\" in bytecode model "
+                               "file.", str.c_str());
+        return static_cast<int>(value);
+    }
+
+    int count() {
+        auto const value = integer();
+        if (value < 0)
+            throw AmiException("Invalid count %d in bytecode model file.",
+                               value);
+        return value;
+    }
+
+    realtype real() {
+        auto const str = token();
+        char *end = nullptr;
+        auto const value = std::strtod(str.c_str(), &end);
+        if (*end != '\0')
+            throw AmiException("Invalid number \"%s\" in bytecode model "
+                               "file.", str.c_str());
+        return value;
+    }
+
+    template <class T> std::vector<T> vector(T (Reader::*read)()) {
+        std::vector<T> result(count());
+        for (auto &value : result)
+            value = (this->*read)();
+        return result;
+    }
+
+    /** `<key> <count>` followed by one string per line */
+    std::vector<std::string> lines(std::string const &key) {
+        expect(key);
+        std::vector<std::string> result(count());
+        std::string rest;
+        std::getline(stream_, rest);
+        for (auto &line : result) {
+            if (!std::getline(stream_, line))
+                throw AmiException("Unexpected end of bytecode model file.");
+        }
+        return result;
+    }
+
+  private:
+    std::istream &stream_;
+};
+
+Function functionByName(std::string const &name) {
+    for (int i = 0; i < num_functions; ++i) {
+        if (name == function_info[i].name)
+            return static_cast<Function>(i);
+    }
+    throw AmiException("Unknown function \"%s\" in bytecode model file.",
+                       name.c_str());
+}
+
+Slot slotByName(std::string const &name) {
+    for (int i = 0; i < num_slots; ++i) {
+        if (name == slot_names[i])
+            return static_cast<Slot>(i);
+    }
+    throw AmiException("Unknown input \"%s\" in bytecode model file.",
+                       name.c_str());
+}
+
+ObservableScaling scalingByName(std::string const &name) {
+    if (name == "lin")
+        return ObservableScaling::lin;
+    if (name == "log")
+        return ObservableScaling::log;
+    if (name == "log10")
+        return ObservableScaling::log10;
+    throw AmiException("Unknown observable scaling \"%s\" in bytecode model "
+                       "file.", name.c_str());
+}
+
+/** Check that the case index is valid and return the number of cases */
+int checkCase(Function function, int index,
+              BytecodeModelDefinition const &def) {
+    auto const &info = function_info[static_cast<int>(function)];
+    auto const n = numCases(info.cases, def.dimensions);
+    if (index < 0 || index >= n)
+        throw AmiException("Invalid case %d of function %s in bytecode model "
+                           "file.", index, info.name);
+    return n;
+}
+
+Program readProgram(Reader &reader, Function function, int index,
+                    BytecodeModelDefinition const &def) {
+    auto const &info = function_info[static_cast<int>(function)];
+    auto const n_instructions = reader.count();
+    Program program;
+    program.n_registers = reader.count();
+    reader.expect("constants");
+    program.constants = reader.vector(&Reader::real);
+    program.instructions.reserve(n_instructions);
+
+    auto const n_out = outputSize(function, index, def);
+    auto const n_const = static_cast<int>(program.constants.size());
+    auto const check = [&info](bool valid, char const *what, int value) {
+        if (!valid)
+            throw AmiException("Invalid %s %d in function %s of bytecode "
+                               "model file.", what, value, info.name);
+    };
+    auto const reg = [&](int r) {
+        check(r >= 0 && r < program.n_registers, "register", r);
+        return r;
+    };
+
+    for (int i = 0; i < n_instructions; ++i) {
+        auto const mnemonic = reader.token();
+        auto const op_info = std::find_if(
+            opcodes.begin(), opcodes.end(), [&mnemonic](OpcodeInfo const &o) {
+                return mnemonic == o.mnemonic;
+            });
+        if (op_info == opcodes.end())
+            throw AmiException("Unknown instruction \"%s\" in bytecode model "
+                               "file.", mnemonic.c_str());
+
+        Instruction ins{op_info->op, 0, 0, 0, 0};
+        switch (op_info->operands) {
+        case Operands::constant:
+            ins.dst = reg(reader.integer());
+            ins.a = reader.integer();
+            check(ins.a >= 0 && ins.a < n_const, "constant", ins.a);
+            break;
+        case Operands::load: {
+            ins.dst = reg(reader.integer());
+            auto const slot = slotByName(reader.token());
+            ins.a = static_cast<int>(slot);
+            ins.b = reader.integer();
+            if (slot != Slot::out &&
+                std::find(info.inputs.begin(), info.inputs.end(), slot) ==
+                    info.inputs.end())
+                throw AmiException("Function %s of bytecode model file reads "
+                                   "%s, which is not one of its inputs.",
+                                   info.name, slot_names[ins.a]);
+            check(ins.b >= 0 &&
+                      ins.b < (slot == Slot::out
+                                   ? n_out
+                                   : inputSize(slot, def.dimensions)),
+                  "input index", ins.b);
+            break;
+        }
+        case Operands::store:
+            ins.a = reader.integer();
+            check(ins.a >= 0 && ins.a < n_out, "output index", ins.a);
+            ins.b = reg(reader.integer());
+            break;
+        case Operands::index:
+            ins.a = reader.integer();
+            check(ins.a >= 0 && ins.a < n_out, "output index", ins.a);
+            break;
+        case Operands::unary:
+            ins.dst = reg(reader.integer());
+            ins.a = reg(reader.integer());
+            break;
+        case Operands::binary:
+            ins.dst = reg(reader.integer());
+            ins.a = reg(reader.integer());
+            ins.b = reg(reader.integer());
+            break;
+        case Operands::ternary:
+            ins.dst = reg(reader.integer());
+            ins.a = reg(reader.integer());
+            ins.b = reg(reader.integer());
+            ins.c = reg(reader.integer());
+            break;
+        }
+        program.instructions.push_back(ins);
+    }
+    return program;
+}
+
+} // namespace
+
+} // namespace bytecode
+
+using bytecode::Function;
+using bytecode::Slot;
+
+std::shared_ptr<const BytecodeModelDefinition>
+readBytecodeModel(std::istream &stream) {
+    bytecode::Reader reader(stream);
+    reader.expect("AMICI_BYTECODE");
+    auto const format_version = reader.integer();
+    if (format_version != 1)
+        throw AmiException("Unsupported bytecode model format version %d.",
+                           format_version);
+
+    auto def = std::make_shared<BytecodeModelDefinition>();
+    reader.expect("name");
+    def->name = reader.token();
+    reader.expect("amici_version");
+    def->amici_version = reader.token();
+    reader.expect("amici_commit");
+    def->amici_commit = reader.token();
+
+    reader.expect("dimensions");
+    std::array<int, 24> dims{};
+    for (auto &dim : dims)
+        dim = reader.count();
+    reader.expect("ndJydy");
+    auto ndJydy = reader.vector(&bytecode::Reader::count);
+    def->dimensions = ModelDimensions(
+        dims[0], dims[1], dims[2], dims[3], dims[4], dims[5], dims[6],
+        dims[7], dims[8], dims[9], dims[10], dims[11], dims[12], dims[13],
+        dims[14], dims[15], dims[16], dims[17], std::move(ndJydy), dims[18],
+        dims[19], dims[20], dims[21], dims[22], dims[23]);
+    auto const &dim = def->dimensions;
+    if (static_cast<int>(dim.ndJydy.size()) != dim.nytrue)
+        throw AmiException("Invalid bytecode model file: ndJydy has %d "
+                           "entries, expected %d.",
+                           static_cast<int>(dim.ndJydy.size()), dim.nytrue);
+
+    reader.expect("ndxdotdp_explicit");
+    def->ndxdotdp_explicit = reader.count();
+    reader.expect("ndxdotdx_explicit");
+    def->ndxdotdx_explicit = reader.count();
+    reader.expect("w_recursion_depth");
+    def->w_recursion_depth = reader.count();
+    reader.expect("reinit_fixpar_initcond");
+    def->reinit_fixpar_initcond = reader.integer() != 0;
+    reader.expect("quadratic_llh");
+    def->quadratic_llh = reader.integer() != 0;
+
+    auto const check_size = [](std::size_t size, int expected,
+                               char const *what) {
+        if (static_cast<int>(size) != expected)
+            throw AmiException("Invalid bytecode model file: %s has %d "
+                               "entries, expected %d.",
+                               what, static_cast<int>(size), expected);
+    };
+    reader.expect("parameters");
+    def->parameters = reader.vector(&bytecode::Reader::real);
+    check_size(def->parameters.size(), dim.np, "parameters");
+    reader.expect("fixed_parameters");
+    def->fixed_parameters = reader.vector(&bytecode::Reader::real);
+    check_size(def->fixed_parameters.size(), dim.nk, "fixed_parameters");
+
+    def->parameter_names = reader.lines("parameter_names");
+    def->fixed_parameter_names = reader.lines("fixed_parameter_names");
+    def->state_names = reader.lines("state_names");
+    def->observable_names = reader.lines("observable_names");
+    def->expression_names = reader.lines("expression_names");
+    def->parameter_ids = reader.lines("parameter_ids");
+    def->fixed_parameter_ids = reader.lines("fixed_parameter_ids");
+    def->state_ids = reader.lines("state_ids");
+    def->observable_ids = reader.lines("observable_ids");
+    def->expression_ids = reader.lines("expression_ids");
+    check_size(def->state_ids.size(), dim.nx_rdata, "state_ids");
+
+    reader.expect("state_idxs_solver");
+    def->state_idxs_solver = reader.vector(&bytecode::Reader::count);
+    check_size(def->state_idxs_solver.size(), dim.nx_solver,
+               "state_idxs_solver");
+    for (auto idx : def->state_idxs_solver)
+        if (idx >= dim.nx_rdata)
+            throw AmiException("Invalid bytecode model file: invalid state "
+                               "index %d.", idx);
+
+    reader.expect("observable_scalings");
+    auto const n_scalings = reader.count();
+    check_size(n_scalings, dim.ny, "observable_scalings");
+    for (int iy = 0; iy < n_scalings; ++iy)
+        def->observable_scalings.push_back(
+            bytecode::scalingByName(reader.token()));
+
+    for (auto record = reader.token(); record != "end";
+         record = reader.token()) {
+        if (record != "function" && record != "sparsity")
+            throw AmiException("Invalid bytecode model file: unexpected "
+                               "\"%s\".", record.c_str());
+        auto const function = bytecode::functionByName(reader.token());
+        auto const ifun = static_cast<int>(function);
+        auto const index = reader.integer();
+        auto const n_cases = bytecode::checkCase(function, index, *def);
+
+        if (record == "function") {
+            auto &programs = def->programs[ifun];
+            programs.resize(n_cases);
+            programs[index] =
+                bytecode::readProgram(reader, function, index, *def);
+            def->n_registers =
+                std::max(def->n_registers, programs[index].n_registers);
+            continue;
+        }
+
+        if (!bytecode::function_info[ifun].sparse)
+            throw AmiException("Invalid bytecode model file: %s is not "
+                               "sparse.", bytecode::function_info[ifun].name);
+        auto &patterns = def->sparsity[ifun];
+        patterns.resize(n_cases);
+        auto &pattern = patterns[index];
+        reader.expect("colptrs");
+        for (auto value : reader.vector(&bytecode::Reader::count))
+            pattern.colptrs.push_back(value);
+        reader.expect("rowvals");
+        for (auto value : reader.vector(&bytecode::Reader::count))
+            pattern.rowvals.push_back(value);
+        bytecode::checkSparsity(pattern, function, index, *def);
+    }
+
+    return def;
+}
+
+std::unique_ptr<Model> loadBytecodeModel(std::string const &filename) {
+    std::ifstream stream(filename);
+    if (!stream)
+        throw AmiException("Could not open bytecode model file %s.",
+                           filename.c_str());
+    return std::make_unique<Model_ODE_Bytecode>(readBytecodeModel(stream));
+}
+
+Model_ODE_Bytecode::Model_ODE_Bytecode(
+    std::shared_ptr<const BytecodeModelDefinition> definition)
+    : Model_ODE(definition->dimensions,
+                SimulationParameters(definition->fixed_parameters,
+                                     definition->parameters),
+                SecondOrderMode::none,
+                std::vector<realtype>(definition->dimensions.nx_solver, 0.0),
+                std::vector<int>{}, true, definition->ndxdotdp_explicit,
+                definition->ndxdotdx_explicit,
+                definition->w_recursion_depth),
+      definition_(std::move(definition)),
+      registers_(definition_->n_registers, 0.0) {}
+
+void Model_ODE_Bytecode::evaluate(Function function, int index,
+                                  bytecode::Arguments const &args) {
+    auto const &programs = definition_->programs[static_cast<int>(function)];
+    if (index < 0 || index >= static_cast<int>(programs.size()))
+        return;
+    auto const &program = programs[index];
+    if (program.instructions.empty())
+        return;
+    program.evaluate(args, registers_.data());
+}
+
+void Model_ODE_Bytecode::setColptrs(Function function, int index,
+                                    SUNMatrixWrapper &matrix) const {
+    auto const &patterns = definition_->sparsity[static_cast<int>(function)];
+    if (index < static_cast<int>(patterns.size()) &&
+        !patterns[index].colptrs.empty())
+        matrix.set_indexptrs(gsl::make_span(patterns[index].colptrs));
+}
+
+void Model_ODE_Bytecode::setRowvals(Function function, int index,
+                                    SUNMatrixWrapper &matrix) const {
+    auto const &patterns = definition_->sparsity[static_cast<int>(function)];
+    if (index < static_cast<int>(patterns.size()) &&
+        !patterns[index].rowvals.empty())
+        matrix.set_indexvals(gsl::make_span(patterns[index].rowvals));
+}
+
+namespace {
+
+/**
+ * @brief Collect the arguments of a program evaluation
+ * @param out output array
+ * @param inputs input arrays
+ * @return arguments
+ */
+bytecode::Arguments
+arguments(realtype *out,
+          std::initializer_list<std::pair<Slot, const realtype *>> inputs) {
+    bytecode::Arguments args;
+    args.out = out;
+    args.arrays[static_cast<int>(Slot::out)] = out;
+    for (auto const &input : inputs)
+        args.arrays[static_cast<int>(input.first)] = input.second;
+    return args;
+}
+
+} // namespace
+
+void Model_ODE_Bytecode::fJy(realtype *Jy, const int iy, const realtype *p,
+                             const realtype *k, const realtype *y,
+                             const realtype *sigmay, const realtype *my) {
+    evaluate(Function::Jy, iy,
+             arguments(Jy, {{Slot::p, p}, {Slot::k, k}, {Slot::y, y},
+                            {Slot::sigmay, sigmay}, {Slot::my, my}}));
+}
+
+void Model_ODE_Bytecode::fdJydsigma(realtype *dJydsigma, const int iy,
+                                    const realtype *p, const realtype *k,
+                                    const realtype *y, const realtype *sigmay,
+                                    const realtype *my) {
+    evaluate(Function::dJydsigma, iy,
+             arguments(dJydsigma, {{Slot::p, p}, {Slot::k, k}, {Slot::y, y},
+                                   {Slot::sigmay, sigmay}, {Slot::my, my}}));
+}
+
+void Model_ODE_Bytecode::fdJydy(realtype *dJydy, const int iy,
+                                const realtype *p, const realtype *k,
+                                const realtype *y, const realtype *sigmay,
+                                const realtype *my) {
+    evaluate(Function::dJydy, iy,
+             arguments(dJydy, {{Slot::p, p}, {Slot::k, k}, {Slot::y, y},
+                               {Slot::sigmay, sigmay}, {Slot::my, my}}));
+}
+
+void Model_ODE_Bytecode::fdJydy_colptrs(SUNMatrixWrapper &dJydy,
+                                        int index) {
+    setColptrs(Function::dJydy, index, dJydy);
+}
+
+void Model_ODE_Bytecode::fdJydy_rowvals(SUNMatrixWrapper &dJydy,
+                                        int index) {
+    setRowvals(Function::dJydy, index, dJydy);
+}
+
+void Model_ODE_Bytecode::froot(realtype *root, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *tcl) {
+    evaluate(Function::root, 0,
+             arguments(root, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fdwdp(realtype *dwdp, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *w, const realtype *tcl,
+                               const realtype *stcl) {
+    evaluate(Function::dwdp, 0,
+             arguments(dwdp, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                              {Slot::tcl, tcl}, {Slot::dtcldp, stcl}}));
+}
+
+void Model_ODE_Bytecode::fdwdp_colptrs(SUNMatrixWrapper &dwdp) {
+    setColptrs(Function::dwdp, 0, dwdp);
+}
+
+void Model_ODE_Bytecode::fdwdp_rowvals(SUNMatrixWrapper &dwdp) {
+    setRowvals(Function::dwdp, 0, dwdp);
+}
+
+void Model_ODE_Bytecode::fdwdx(realtype *dwdx, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *w, const realtype *tcl) {
+    evaluate(Function::dwdx, 0,
+             arguments(dwdx, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                              {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fdwdx_colptrs(SUNMatrixWrapper &dwdx) {
+    setColptrs(Function::dwdx, 0, dwdx);
+}
+
+void Model_ODE_Bytecode::fdwdx_rowvals(SUNMatrixWrapper &dwdx) {
+    setRowvals(Function::dwdx, 0, dwdx);
+}
+
+void Model_ODE_Bytecode::fdwdw(realtype *dwdw, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *w, const realtype *tcl) {
+    evaluate(Function::dwdw, 0,
+             arguments(dwdw, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                              {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fdwdw_colptrs(SUNMatrixWrapper &dwdw) {
+    setColptrs(Function::dwdw, 0, dwdw);
+}
+
+void Model_ODE_Bytecode::fdwdw_rowvals(SUNMatrixWrapper &dwdw) {
+    setRowvals(Function::dwdw, 0, dwdw);
+}
+
+void Model_ODE_Bytecode::fdxdotdw(realtype *dxdotdw, const realtype t,
+                                  const realtype *x, const realtype *p,
+                                  const realtype *k, const realtype *h,
+                                  const realtype *w) {
+    evaluate(Function::dxdotdw, 0,
+             arguments(dxdotdw, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                                 {Slot::k, k}, {Slot::h, h}, {Slot::w, w}}));
+}
+
+void Model_ODE_Bytecode::fdxdotdw_colptrs(SUNMatrixWrapper &dxdotdw) {
+    setColptrs(Function::dxdotdw, 0, dxdotdw);
+}
+
+void Model_ODE_Bytecode::fdxdotdw_rowvals(SUNMatrixWrapper &dxdotdw) {
+    setRowvals(Function::dxdotdw, 0, dxdotdw);
+}
+
+void Model_ODE_Bytecode::fdxdotdx_explicit(
+    realtype *dxdotdx_explicit, const realtype t, const realtype *x,
+    const realtype *p, const realtype *k, const realtype *h,
+    const realtype *w) {
+    evaluate(Function::dxdotdx_explicit, 0,
+             arguments(dxdotdx_explicit,
+                       {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                        {Slot::k, k}, {Slot::h, h}, {Slot::w, w}}));
+}
+
+void Model_ODE_Bytecode::fdxdotdx_explicit_colptrs(SUNMatrixWrapper &dxdotdx) {
+    setColptrs(Function::dxdotdx_explicit, 0, dxdotdx);
+}
+
+void Model_ODE_Bytecode::fdxdotdx_explicit_rowvals(SUNMatrixWrapper &dxdotdx) {
+    setRowvals(Function::dxdotdx_explicit, 0, dxdotdx);
+}
+
+void Model_ODE_Bytecode::fdxdotdp_explicit(
+    realtype *dxdotdp_explicit, const realtype t, const realtype *x,
+    const realtype *p, const realtype *k, const realtype *h,
+    const realtype *w) {
+    evaluate(Function::dxdotdp_explicit, 0,
+             arguments(dxdotdp_explicit,
+                       {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                        {Slot::k, k}, {Slot::h, h}, {Slot::w, w}}));
+}
+
+void Model_ODE_Bytecode::fdxdotdp_explicit_colptrs(SUNMatrixWrapper &dxdotdp) {
+    setColptrs(Function::dxdotdp_explicit, 0, dxdotdp);
+}
+
+void Model_ODE_Bytecode::fdxdotdp_explicit_rowvals(SUNMatrixWrapper &dxdotdp) {
+    setRowvals(Function::dxdotdp_explicit, 0, dxdotdp);
+}
+
+void Model_ODE_Bytecode::fdydx(realtype *dydx, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *w, const realtype *dwdx) {
+    evaluate(Function::dydx, 0,
+             arguments(dydx, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                              {Slot::dwdx, dwdx}}));
+}
+
+void Model_ODE_Bytecode::fdydp(realtype *dydp, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const int ip, const realtype *w,
+                               const realtype *tcl, const realtype *dtcldp) {
+    evaluate(Function::dydp, ip,
+             arguments(dydp, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                              {Slot::tcl, tcl}, {Slot::dtcldp, dtcldp}}));
+}
+
+void Model_ODE_Bytecode::fdsigmaydy(realtype *dsigmaydy, const realtype t,
+                                    const realtype *p, const realtype *k,
+                                    const realtype *y) {
+    evaluate(Function::dsigmaydy, 0,
+             arguments(dsigmaydy, {{Slot::t, &t}, {Slot::p, p}, {Slot::k, k},
+                                   {Slot::y, y}}));
+}
+
+void Model_ODE_Bytecode::fdsigmaydp(realtype *dsigmaydp, const realtype t,
+                                    const realtype *p, const realtype *k,
+                                    const realtype *y, const int ip) {
+    evaluate(Function::dsigmaydp, ip,
+             arguments(dsigmaydp, {{Slot::t, &t}, {Slot::p, p}, {Slot::k, k},
+                                   {Slot::y, y}}));
+}
+
+void Model_ODE_Bytecode::fsigmay(realtype *sigmay, const realtype t,
+                                 const realtype *p, const realtype *k,
+                                 const realtype *y) {
+    evaluate(Function::sigmay, 0,
+             arguments(sigmay, {{Slot::t, &t}, {Slot::p, p}, {Slot::k, k},
+                                {Slot::y, y}}));
+}
+
+void Model_ODE_Bytecode::fstau(realtype *stau, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *tcl, const realtype *sx,
+                               const int ip, const int ie) {
+    evaluate(Function::stau, ie * np() + ip,
+             arguments(stau, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::tcl, tcl},
+                              {Slot::sx, sx}}));
+}
+
+void Model_ODE_Bytecode::fdeltax(realtype *deltax, const realtype t,
+                                 const realtype *x, const realtype *p,
+                                 const realtype *k, const realtype *h,
+                                 const int ie, const realtype *xdot,
+                                 const realtype *xdot_old) {
+    evaluate(Function::deltax, ie,
+             arguments(deltax, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                                {Slot::k, k}, {Slot::h, h},
+                                {Slot::xdot, xdot},
+                                {Slot::xdot_old, xdot_old}}));
+}
+
+void Model_ODE_Bytecode::fdeltasx(
+    realtype *deltasx, const realtype t, const realtype *x, const realtype *p,
+    const realtype *k, const realtype *h, const realtype *w, const int ip,
+    const int ie, const realtype *xdot, const realtype *xdot_old,
+    const realtype *sx, const realtype *stau, const realtype *tcl) {
+    evaluate(Function::deltasx, ie * np() + ip,
+             arguments(deltasx, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                                 {Slot::k, k}, {Slot::h, h}, {Slot::w, w},
+                                 {Slot::xdot, xdot},
+                                 {Slot::xdot_old, xdot_old}, {Slot::sx, sx},
+                                 {Slot::stau, stau}, {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fw(realtype *w, const realtype t, const realtype *x,
+                            const realtype *p, const realtype *k,
+                            const realtype *h, const realtype *tcl) {
+    evaluate(Function::w, 0,
+             arguments(w, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                           {Slot::k, k}, {Slot::h, h}, {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fx0(realtype *x0, const realtype t,
+                             const realtype *p, const realtype *k) {
+    evaluate(Function::x0, 0,
+             arguments(x0, {{Slot::t, &t}, {Slot::p, p}, {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fx0_fixedParameters(
+    realtype *x0_fixedParameters, const realtype t, const realtype *p,
+    const realtype *k, gsl::span<const int> reinitialization_state_idxs) {
+    auto args = arguments(x0_fixedParameters,
+                          {{Slot::t, &t}, {Slot::p, p}, {Slot::k, k}});
+    args.reinitialization_state_idxs = reinitialization_state_idxs;
+    evaluate(Function::x0_fixedParameters, 0, args);
+}
+
+void Model_ODE_Bytecode::fsx0(realtype *sx0, const realtype t,
+                              const realtype *x, const realtype *p,
+                              const realtype *k, const int ip) {
+    evaluate(Function::sx0, ip,
+             arguments(sx0, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                             {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fsx0_fixedParameters(
+    realtype *sx0_fixedParameters, const realtype t, const realtype *x0,
+    const realtype *p, const realtype *k, const int ip,
+    gsl::span<const int> reinitialization_state_idxs) {
+    auto args = arguments(sx0_fixedParameters, {{Slot::t, &t},
+                                                {Slot::x0, x0},
+                                                {Slot::p, p},
+                                                {Slot::k, k}});
+    args.reinitialization_state_idxs = reinitialization_state_idxs;
+    evaluate(Function::sx0_fixedParameters, ip, args);
+}
+
+void Model_ODE_Bytecode::fxdot(realtype *xdot, const realtype t,
+                               const realtype *x, const realtype *p,
+                               const realtype *k, const realtype *h,
+                               const realtype *w) {
+    evaluate(Function::xdot, 0,
+             arguments(xdot, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                              {Slot::k, k}, {Slot::h, h}, {Slot::w, w}}));
+}
+
+void Model_ODE_Bytecode::fy(realtype *y, const realtype t, const realtype *x,
+                            const realtype *p, const realtype *k,
+                            const realtype *h, const realtype *w) {
+    evaluate(Function::y, 0,
+             arguments(y, {{Slot::t, &t}, {Slot::x, x}, {Slot::p, p},
+                           {Slot::k, k}, {Slot::h, h}, {Slot::w, w}}));
+}
+
+void Model_ODE_Bytecode::fx_rdata(realtype *x_rdata, const realtype *x,
+                                  const realtype *tcl, const realtype *p,
+                                  const realtype *k) {
+    if (nx_solver == nx_rdata) {
+        Model::fx_rdata(x_rdata, x, tcl, p, k);
+        return;
+    }
+    evaluate(Function::x_rdata, 0,
+             arguments(x_rdata, {{Slot::x, x}, {Slot::tcl, tcl},
+                                 {Slot::p, p}, {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fx_solver(realtype *x_solver,
+                                   const realtype *x_rdata) {
+    if (nx_solver == nx_rdata) {
+        Model::fx_solver(x_solver, x_rdata);
+        return;
+    }
+    evaluate(Function::x_solver, 0,
+             arguments(x_solver, {{Slot::x_rdata, x_rdata}}));
+}
+
+void Model_ODE_Bytecode::ftotal_cl(realtype *total_cl,
+                                   const realtype *x_rdata,
+                                   const realtype *p, const realtype *k) {
+    evaluate(Function::total_cl, 0,
+             arguments(total_cl, {{Slot::x_rdata, x_rdata}, {Slot::p, p},
+                                  {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fdtotal_cldp(realtype *dtotal_cldp,
+                                      const realtype *x_rdata,
+                                      const realtype *p, const realtype *k,
+                                      const int ip) {
+    evaluate(Function::dtotal_cldp, ip,
+             arguments(dtotal_cldp, {{Slot::x_rdata, x_rdata}, {Slot::p, p},
+                                     {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fdtotal_cldx_rdata(realtype *dtotal_cldx_rdata,
+                                            const realtype *x_rdata,
+                                            const realtype *p,
+                                            const realtype *k,
+                                            const realtype *tcl) {
+    evaluate(Function::dtotal_cldx_rdata, 0,
+             arguments(dtotal_cldx_rdata,
+                       {{Slot::x_rdata, x_rdata}, {Slot::p, p}, {Slot::k, k},
+                        {Slot::tcl, tcl}}));
+}
+
+void Model_ODE_Bytecode::fdtotal_cldx_rdata_colptrs(
+    SUNMatrixWrapper &dtotal_cldx_rdata) {
+    setColptrs(Function::dtotal_cldx_rdata, 0, dtotal_cldx_rdata);
+}
+
+void Model_ODE_Bytecode::fdtotal_cldx_rdata_rowvals(
+    SUNMatrixWrapper &dtotal_cldx_rdata) {
+    setRowvals(Function::dtotal_cldx_rdata, 0, dtotal_cldx_rdata);
+}
+
+void Model_ODE_Bytecode::fdx_rdatadx_solver(realtype *dx_rdatadx_solver,
+                                            const realtype *x,
+                                            const realtype *tcl,
+                                            const realtype *p,
+                                            const realtype *k) {
+    evaluate(Function::dx_rdatadx_solver, 0,
+             arguments(dx_rdatadx_solver, {{Slot::x, x}, {Slot::tcl, tcl},
+                                           {Slot::p, p}, {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fdx_rdatadx_solver_colptrs(
+    SUNMatrixWrapper &dxrdatadxsolver) {
+    setColptrs(Function::dx_rdatadx_solver, 0, dxrdatadxsolver);
+}
+
+void Model_ODE_Bytecode::fdx_rdatadx_solver_rowvals(
+    SUNMatrixWrapper &dxrdatadxsolver) {
+    setRowvals(Function::dx_rdatadx_solver, 0, dxrdatadxsolver);
+}
+
+void Model_ODE_Bytecode::fdx_rdatadp(realtype *dx_rdatadp, const realtype *x,
+                                     const realtype *tcl, const realtype *p,
+                                     const realtype *k, const int ip) {
+    evaluate(Function::dx_rdatadp, ip,
+             arguments(dx_rdatadp, {{Slot::x, x}, {Slot::tcl, tcl},
+                                    {Slot::p, p}, {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fdx_rdatadtcl(realtype *dx_rdatadtcl,
+                                       const realtype *x, const realtype *tcl,
+                                       const realtype *p, const realtype *k) {
+    evaluate(Function::dx_rdatadtcl, 0,
+             arguments(dx_rdatadtcl, {{Slot::x, x}, {Slot::tcl, tcl},
+                                      {Slot::p, p}, {Slot::k, k}}));
+}
+
+void Model_ODE_Bytecode::fdx_rdatadtcl_colptrs(
+    SUNMatrixWrapper &dx_rdatadtcl) {
+    setColptrs(Function::dx_rdatadtcl, 0, dx_rdatadtcl);
+}
+
+void Model_ODE_Bytecode::fdx_rdatadtcl_rowvals(
+    SUNMatrixWrapper &dx_rdatadtcl) {
+    setRowvals(Function::dx_rdatadtcl, 0, dx_rdatadtcl);
+}
+
+std::string Model_ODE_Bytecode::getName() const { return definition_->name; }
+
+std::vector<std::string> Model_ODE_Bytecode::getParameterNames() const {
+    return definition_->parameter_names;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getStateNames() const {
+    return definition_->state_names;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getStateNamesSolver() const {
+    std::vector<std::string> result;
+    result.reserve(definition_->state_idxs_solver.size());
+    for (auto idx : definition_->state_idxs_solver)
+        result.push_back(definition_->state_names.at(idx));
+    return result;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getFixedParameterNames() const {
+    return definition_->fixed_parameter_names;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getObservableNames() const {
+    return definition_->observable_names;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getExpressionNames() const {
+    return definition_->expression_names;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getParameterIds() const {
+    return definition_->parameter_ids;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getStateIds() const {
+    return definition_->state_ids;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getStateIdsSolver() const {
+    std::vector<std::string> result;
+    result.reserve(definition_->state_idxs_solver.size());
+    for (auto idx : definition_->state_idxs_solver)
+        result.push_back(definition_->state_ids.at(idx));
+    return result;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getFixedParameterIds() const {
+    return definition_->fixed_parameter_ids;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getObservableIds() const {
+    return definition_->observable_ids;
+}
+
+std::vector<std::string> Model_ODE_Bytecode::getExpressionIds() const {
+    return definition_->expression_ids;
+}
+
+bool Model_ODE_Bytecode::isFixedParameterStateReinitializationAllowed()
+    const {
+    return definition_->reinit_fixpar_initcond;
+}
+
+std::string Model_ODE_Bytecode::getAmiciVersion() const {
+    return definition_->amici_version;
+}
+
+std::string Model_ODE_Bytecode::getAmiciCommit() const {
+    return definition_->amici_commit;
+}
+
+bool Model_ODE_Bytecode::hasQuadraticLLH() const {
+    return definition_->quadratic_llh;
+}
+
+ObservableScaling Model_ODE_Bytecode::getObservableScaling(int iy) const {
+    return definition_->observable_scalings.at(iy);
+}
+
+} // namespace amici
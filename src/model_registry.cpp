@@ -0,0 +1,217 @@
+#include "amici/model_registry.h"
+
+#include "amici/exception.h"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace amici {
+
+namespace {
+
+#if defined(_WIN32)
+void *openLibrary(std::string const &path) {
+    return static_cast<void *>(LoadLibraryA(path.c_str()));
+}
+
+void *findSymbol(void *handle, char const *symbol) {
+    return reinterpret_cast<void *>(
+        GetProcAddress(static_cast<HMODULE>(handle), symbol));
+}
+
+void closeLibrary(void *handle) { FreeLibrary(static_cast<HMODULE>(handle)); }
+
+std::string libraryError() {
+    return "error code " + std::to_string(GetLastError());
+}
+#else
+void *openLibrary(std::string const &path) {
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+void *findSymbol(void *handle, char const *symbol) {
+    return dlsym(handle, symbol);
+}
+
+void closeLibrary(void *handle) { dlclose(handle); }
+
+std::string libraryError() {
+    auto const *error = dlerror();
+    return error ? error : "unknown error";
+}
+#endif
+
+/** Names and versions become path components, so they must not be able to
+ * leave the search directory */
+void checkPathComponent(std::string const &value, char const *what,
+                        bool allow_empty) {
+    if ((value.empty() && !allow_empty) || value == "." || value == ".."
+        || value.find_first_of("/\\") != std::string::npos
+        || value.find('\0') != std::string::npos)
+        throw AmiException("Invalid model %s \"%s\".", what, value.c_str());
+}
+
+} // namespace
+
+ModelPlugin::ModelPlugin(std::string path)
+    : path_(std::move(path)) {
+    handle_ = openLibrary(path_);
+    if (!handle_)
+        throw AmiException("Failed to load model plugin %s: %s",
+                           path_.c_str(), libraryError().c_str());
+
+    auto const entry_point = reinterpret_cast<ModelPluginInfo const *(*)()>(
+        findSymbol(handle_, model_plugin_symbol));
+    if (!entry_point) {
+        closeLibrary(handle_);
+        throw AmiException("%s is not a model plugin, it does not define %s.",
+                           path_.c_str(), model_plugin_symbol);
+    }
+    info_ = entry_point();
+    if (!info_ || info_->api_version != model_plugin_api_version) {
+        closeLibrary(handle_);
+        throw AmiException("Model plugin %s was built for plugin API version "
+                           "%d, expected %d.",
+                           path_.c_str(), info_ ? info_->api_version : -1,
+                           model_plugin_api_version);
+    }
+}
+
+ModelPlugin::~ModelPlugin() { closeLibrary(handle_); }
+
+std::unique_ptr<Model> ModelPlugin::create() const {
+    auto model = std::unique_ptr<Model>(info_->create());
+    if (!model)
+        throw AmiException("Model plugin %s failed to create a model.",
+                           path_.c_str());
+    return model;
+}
+
+ModelRegistry::ModelRegistry(std::vector<std::string> search_paths)
+    : search_paths_(std::move(search_paths)) {}
+
+void ModelRegistry::addSearchPath(std::string const &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    search_paths_.push_back(path);
+}
+
+std::shared_ptr<ModelPlugin const>
+ModelRegistry::load(std::string const &name, std::string const &version) {
+    checkPathComponent(name, "name", false);
+    checkPathComponent(version, "version", true);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const key = std::make_pair(name, version);
+    auto const it = plugins_.find(key);
+    if (it != plugins_.end())
+        return it->second;
+
+    for (auto const &directory : search_paths_) {
+        auto const path = getLibraryPath(directory, name, version);
+        if (!std::ifstream(path).good())
+            continue;
+        auto plugin = std::make_shared<ModelPlugin const>(path);
+        if (plugin->getName() != name || plugin->getVersion() != version)
+            throw AmiException("Model plugin %s provides model %s version "
+                               "\"%s\", expected %s version \"%s\".",
+                               path.c_str(), plugin->getName().c_str(),
+                               plugin->getVersion().c_str(), name.c_str(),
+                               version.c_str());
+        plugins_.emplace(key, plugin);
+        return plugin;
+    }
+    throw AmiException("Model plugin %s version \"%s\" was not found in the "
+                       "search paths.",
+                       name.c_str(), version.c_str());
+}
+
+std::shared_ptr<ModelPlugin const>
+ModelRegistry::loadLibrary(std::string const &path) {
+    auto plugin = std::make_shared<ModelPlugin const>(path);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const key = std::make_pair(plugin->getName(), plugin->getVersion());
+    auto const it = plugins_.find(key);
+    if (it == plugins_.end()) {
+        plugins_.emplace(key, plugin);
+        return plugin;
+    }
+    if (it->second->getPath() != path)
+        throw AmiException("Model %s version \"%s\" is already loaded from "
+                           "%s.",
+                           key.first.c_str(), key.second.c_str(),
+                           it->second->getPath().c_str());
+    // the library was opened twice, dropping `plugin` only decrements the
+    // reference count of the library
+    return it->second;
+}
+
+std::shared_ptr<Model> ModelRegistry::createModel(std::string const &name,
+                                                  std::string const &version) {
+    auto plugin = load(name, version);
+    auto model = plugin->create();
+    // the deleter owns a reference to the plugin, which keeps the library
+    // loaded while the model exists
+    return std::shared_ptr<Model>(model.release(),
+                                  [plugin](Model *ptr) { delete ptr; });
+}
+
+bool ModelRegistry::isLoaded(std::string const &name,
+                             std::string const &version) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return plugins_.count(std::make_pair(name, version)) > 0;
+}
+
+std::vector<std::pair<std::string, std::string>>
+ModelRegistry::getLoadedModels() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, std::string>> result;
+    result.reserve(plugins_.size());
+    for (auto const &plugin : plugins_)
+        result.push_back(plugin.first);
+    return result;
+}
+
+bool ModelRegistry::unload(std::string const &name,
+                           std::string const &version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const it = plugins_.find(std::make_pair(name, version));
+    if (it == plugins_.end() || it->second.use_count() > 1)
+        return false;
+    plugins_.erase(it);
+    return true;
+}
+
+int ModelRegistry::unloadUnused() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int unloaded = 0;
+    for (auto it = plugins_.begin(); it != plugins_.end();) {
+        if (it->second.use_count() > 1) {
+            ++it;
+            continue;
+        }
+        it = plugins_.erase(it);
+        ++unloaded;
+    }
+    return unloaded;
+}
+
+std::string ModelRegistry::getLibraryPath(std::string const &directory,
+                                          std::string const &name,
+                                          std::string const &version) {
+#if defined(_WIN32)
+    auto const filename = name + ".dll";
+#else
+    auto const filename = "lib" + name + ".so";
+#endif
+    if (version.empty())
+        return directory + "/" + filename;
+    return directory + "/" + name + "/" + version + "/" + filename;
+}
+
+} // namespace amici
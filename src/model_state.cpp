@@ -4,19 +4,62 @@ namespace amici {
 
 ModelStateDerived::ModelStateDerived(const ModelDimensions &dim)
     : J_(dim.nx_solver, dim.nx_solver, dim.nnz, CSC_MAT),
-      JB_(dim.nx_solver, dim.nx_solver, dim.nnz, CSC_MAT),
       dxdotdw_(dim.nx_solver, dim.nw, dim.ndxdotdw, CSC_MAT),
-      dx_rdatadx_solver(dim.nx_rdata, dim.nx_solver, dim.ndxrdatadxsolver,
-                        CSC_MAT),
-      dx_rdatadtcl(dim.nx_rdata, dim.nx_rdata - dim.nx_solver, dim.ndxrdatadtcl,
-                   CSC_MAT),
-      dtotal_cldx_rdata(dim.nx_rdata - dim.nx_solver, dim.nx_rdata,
-                        dim.ndtotal_cldx_rdata, CSC_MAT),
       w_(dim.nw),
       x_rdata_(dim.nx_rdata, 0.0),
       sx_rdata_(dim.nx_rdata, 0.0),
       x_pos_tmp_(dim.nx_solver)
 {}
 
+/**
+ * @brief Memory allocated for a matrix
+ * @param mat matrix, may be unallocated
+ * @return Size in bytes
+ */
+static std::size_t memoryUsage(SUNMatrixWrapper const &mat) {
+    long int lenrw = 0;
+    long int leniw = 0;
+    if (!mat.get() || SUNMatSpace(mat.get(), &lenrw, &leniw) != 0)
+        return 0;
+    return lenrw * sizeof(realtype) + leniw * sizeof(sunindextype);
+}
+
+/**
+ * @brief Memory allocated for a vector
+ * @param vec vector
+ * @return Size in bytes
+ */
+template <class T>
+static std::size_t memoryUsage(std::vector<T> const &vec) {
+    return vec.capacity() * sizeof(T);
+}
+
+std::size_t ModelStateDerived::getMemoryUsage() const {
+    std::size_t size = 0;
+    for (auto const *mat :
+         {&J_, &JB_, &dxdotdw_, &dwdx_, &dwdp_, &dwdw_, &M_, &dxdotdp_full,
+          &dxdotdp_explicit, &dxdotdp_implicit, &dxdotdx_explicit,
+          &dxdotdx_implicit, &dx_rdatadx_solver, &dx_rdatadtcl,
+          &dtotal_cldx_rdata})
+        size += memoryUsage(*mat);
+    for (auto const *mats :
+         {&dwdx_hierarchical_, &dwdp_hierarchical_, &dJydy_})
+        for (auto const &mat : *mats)
+            size += memoryUsage(mat);
+
+    for (auto const *vec :
+         {&dJydy_matlab_, &dJydsigma_, &dJydx_, &dJydp_, &dJzdz_, &dJzdsigma_,
+          &dJrzdz_, &dJrzdsigma_, &dJzdx_, &dJzdp_, &dzdx_, &dzdp_, &drzdx_,
+          &drzdp_, &dydp_, &dydx_, &w_, &sx_, &x_rdata_, &sx_rdata_, &y_,
+          &sigmay_, &my_, &dsigmaydp_, &dsigmaydy_, &z_, &rz_, &sigmaz_,
+          &dsigmazdp_, &deltax_, &deltasx_, &deltaxB_, &deltaqB_})
+        size += memoryUsage(*vec);
+
+    for (int i = 0; i < dxdotdp.getLength(); ++i)
+        size += dxdotdp[i].getLength() * sizeof(realtype);
+    size += x_pos_tmp_.getLength() * sizeof(realtype);
+
+    return size;
+}
 
 } // namespace amici
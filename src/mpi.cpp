@@ -0,0 +1,190 @@
+/**
+ * Functions for distributing simulations over MPI ranks
+ */
+
+#include "amici/mpi.h"
+#include "amici/amici.h"
+#include "amici/serialization.h"
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <type_traits>
+
+namespace amici {
+namespace mpi {
+
+static_assert(std::is_same<realtype, double>::value,
+              "Reductions assume realtype to be MPI_DOUBLE");
+
+/**
+ * @brief Serialize objects and concatenate them into a single buffer
+ * @param objects objects to serialize
+ * @param buffer concatenated serialized objects
+ * @param sizes size of each serialized object in bytes
+ */
+template <typename T>
+static void serializeAll(std::vector<T const*> const& objects,
+                         std::string &buffer, std::vector<int> &sizes) {
+    buffer.clear();
+    sizes.resize(objects.size());
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        auto serialized = serializeToString(*objects[i]);
+        sizes[i] = static_cast<int>(serialized.size());
+        buffer.append(serialized);
+    }
+}
+
+/**
+ * @brief Displacements for the given counts, as required by MPI_*v
+ * @param counts counts per rank
+ * @return offsets per rank
+ */
+static std::vector<int> displacements(std::vector<int> const& counts) {
+    std::vector<int> displs(counts.size(), 0);
+    std::partial_sum(counts.begin(), counts.end() - 1, displs.begin() + 1);
+    return displs;
+}
+
+/**
+ * @brief Sum of `counts` over consecutive blocks of the given sizes
+ * @param counts values to sum
+ * @param block_sizes number of consecutive values per block
+ * @return sum per block
+ */
+static std::vector<int> blockSums(std::vector<int> const& counts,
+                                  std::vector<int> const& block_sizes) {
+    std::vector<int> sums(block_sizes.size(), 0);
+    auto it = counts.begin();
+    for (std::size_t i = 0; i < block_sizes.size(); ++i) {
+        sums[i] = std::accumulate(it, it + block_sizes[i], 0);
+        it += block_sizes[i];
+    }
+    return sums;
+}
+
+ReducedResults runAmiciSimulations(Solver const &solver,
+                                   std::vector<ExpData *> const &edatas,
+                                   Model const &model, MPI_Comm comm,
+                                   bool gather_rdatas, bool failfast,
+                                   int num_threads, int root) {
+    int rank, num_ranks;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_ranks);
+    bool const is_root = rank == root;
+
+    // contiguous blocks of conditions, sizes differ by at most one
+    int num_conditions = is_root ? static_cast<int>(edatas.size()) : 0;
+    MPI_Bcast(&num_conditions, 1, MPI_INT, root, comm);
+    std::vector<int> block_sizes(num_ranks, num_conditions / num_ranks);
+    for (int i = 0; i < num_conditions % num_ranks; ++i)
+        ++block_sizes[i];
+    auto const block_offsets = displacements(block_sizes);
+    int const num_local = block_sizes[rank];
+
+    // scatter serialized ExpData: first the size of each object, then data
+    std::string send_buffer;
+    std::vector<int> object_sizes;
+    if (is_root)
+        serializeAll(std::vector<ExpData const*>(edatas.begin(), edatas.end()),
+                     send_buffer, object_sizes);
+
+    std::vector<int> local_sizes(num_local);
+    MPI_Scatterv(object_sizes.data(), block_sizes.data(),
+                 block_offsets.data(), MPI_INT, local_sizes.data(), num_local,
+                 MPI_INT, root, comm);
+
+    std::vector<int> byte_counts;
+    if (is_root)
+        byte_counts = blockSums(object_sizes, block_sizes);
+    auto const byte_offsets = displacements(
+        is_root ? byte_counts : std::vector<int>(num_ranks, 0));
+    std::string recv_buffer(
+        std::accumulate(local_sizes.begin(), local_sizes.end(), 0), '\0');
+    MPI_Scatterv(&send_buffer[0], byte_counts.data(), byte_offsets.data(),
+                 MPI_BYTE, &recv_buffer[0],
+                 static_cast<int>(recv_buffer.size()), MPI_BYTE, root, comm);
+
+    std::vector<ExpData> local_edatas(num_local);
+    std::vector<ExpData *> local_edata_ptrs(num_local);
+    for (int i = 0, offset = 0; i < num_local; offset += local_sizes[i], ++i) {
+        deserializeFromChar(&recv_buffer[offset], local_sizes[i],
+                            local_edatas[i]);
+        local_edata_ptrs[i] = &local_edatas[i];
+    }
+
+    auto local_rdatas = amici::runAmiciSimulations(
+        solver, local_edata_ptrs, model, failfast, num_threads);
+
+    // reduce llh, chi2, sllh and FIM in a single call. Ranks without any
+    // conditions still need to know the dimensions.
+    ReducedResults results;
+    int dims[2] = {0, 0};
+    for (auto const& rdata : local_rdatas) {
+        if (rdata->status != AMICI_SUCCESS)
+            ++results.num_failed;
+        dims[0] = std::max(dims[0], static_cast<int>(rdata->sllh.size()));
+        dims[1] = std::max(dims[1], static_cast<int>(rdata->FIM.size()));
+    }
+    MPI_Allreduce(MPI_IN_PLACE, dims, 2, MPI_INT, MPI_MAX, comm);
+    std::vector<realtype> sums(2 + dims[0] + dims[1], 0.0);
+    for (auto const& rdata : local_rdatas) {
+        sums[0] += rdata->llh;
+        sums[1] += rdata->chi2;
+        for (std::size_t ip = 0; ip < rdata->sllh.size(); ++ip)
+            sums[2 + ip] += rdata->sllh[ip];
+        for (std::size_t i = 0; i < rdata->FIM.size(); ++i)
+            sums[2 + dims[0] + i] += rdata->FIM[i];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sums.data(), static_cast<int>(sums.size()),
+                  MPI_DOUBLE, MPI_SUM, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &results.num_failed, 1, MPI_INT, MPI_SUM,
+                  comm);
+    results.llh = sums[0];
+    results.chi2 = sums[1];
+    results.sllh.assign(sums.begin() + 2, sums.begin() + 2 + dims[0]);
+    results.FIM.assign(sums.begin() + 2 + dims[0], sums.end());
+
+    if (!gather_rdatas)
+        return results;
+
+    // gather serialized ReturnData, same protocol as for ExpData
+    std::vector<ReturnData const*> local_rdata_ptrs(num_local);
+    std::transform(local_rdatas.begin(), local_rdatas.end(),
+                   local_rdata_ptrs.begin(),
+                   [](std::unique_ptr<ReturnData> const& rdata) {
+                       return rdata.get();
+                   });
+    serializeAll(local_rdata_ptrs, send_buffer, local_sizes);
+    local_rdatas.clear();
+
+    object_sizes.resize(is_root ? num_conditions : 0);
+    MPI_Gatherv(local_sizes.data(), num_local, MPI_INT, object_sizes.data(),
+                block_sizes.data(), block_offsets.data(), MPI_INT, root, comm);
+
+    if (is_root) {
+        byte_counts = blockSums(object_sizes, block_sizes);
+        recv_buffer.resize(std::accumulate(byte_counts.begin(),
+                                           byte_counts.end(), 0));
+    }
+    auto const gather_offsets = displacements(
+        is_root ? byte_counts : std::vector<int>(num_ranks, 0));
+    MPI_Gatherv(&send_buffer[0], static_cast<int>(send_buffer.size()),
+                MPI_BYTE, &recv_buffer[0], byte_counts.data(),
+                gather_offsets.data(), MPI_BYTE, root, comm);
+
+    if (is_root) {
+        results.rdatas.reserve(num_conditions);
+        for (int i = 0, offset = 0; i < num_conditions;
+             offset += object_sizes[i], ++i) {
+            results.rdatas.emplace_back(std::make_unique<ReturnData>());
+            deserializeFromChar(&recv_buffer[offset], object_sizes[i],
+                                *results.rdatas.back());
+        }
+    }
+
+    return results;
+}
+
+} // namespace mpi
+} // namespace amici
@@ -1,6 +1,7 @@
 #include "amici/newton_solver.h"
 
 #include "amici/model.h"
+#include "amici/profiling.h"
 #include "amici/solver.h"
 
 #include "sunlinsol/sunlinsol_dense.h" // dense solver
@@ -106,13 +107,14 @@ NewtonSolverDense::NewtonSolverDense(const Model &model)
     auto status = SUNLinSolInitialize_Dense(linsol_);
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolInitialize_Dense");
+    instrumentLinearSolver(linsol_);
 }
 
 void NewtonSolverDense::prepareLinearSystem(Model &model,
                                             const SimulationState &state) {
     model.fJ(state.t, 0.0, state.x, state.dx, xdot_, Jtmp_.get());
     Jtmp_.refresh();
-    auto status = SUNLinSolSetup_Dense(linsol_, Jtmp_.get());
+    auto status = SUNLinSolSetup(linsol_, Jtmp_.get());
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolSetup_Dense");
 }
@@ -121,14 +123,14 @@ void NewtonSolverDense::prepareLinearSystemB(Model &model,
                                              const SimulationState &state) {
     model.fJB(state.t, 0.0, state.x, state.dx, xB_, dxB_, xdot_, Jtmp_.get());
     Jtmp_.refresh();
-    auto status = SUNLinSolSetup_Dense(linsol_, Jtmp_.get());
+    auto status = SUNLinSolSetup(linsol_, Jtmp_.get());
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolSetup_Dense");
 }
 
 void NewtonSolverDense::solveLinearSystem(AmiVector &rhs) {
-    auto status = SUNLinSolSolve_Dense(linsol_, Jtmp_.get(), rhs.getNVector(),
-                                       rhs.getNVector(), 0.0);
+    auto status = SUNLinSolSolve(linsol_, Jtmp_.get(), rhs.getNVector(),
+                                 rhs.getNVector(), 0.0);
     Jtmp_.refresh();
     // last argument is tolerance and does not have any influence on result
 
@@ -162,6 +164,7 @@ NewtonSolverSparse::NewtonSolverSparse(const Model &model)
     auto status = SUNLinSolInitialize_KLU(linsol_);
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolInitialize_KLU");
+    instrumentLinearSolver(linsol_);
 }
 
 void NewtonSolverSparse::prepareLinearSystem(Model &model,
@@ -169,7 +172,7 @@ void NewtonSolverSparse::prepareLinearSystem(Model &model,
     /* Get sparse Jacobian */
     model.fJSparse(state.t, 0.0, state.x, state.dx, xdot_, Jtmp_.get());
     Jtmp_.refresh();
-    auto status = SUNLinSolSetup_KLU(linsol_, Jtmp_.get());
+    auto status = SUNLinSolSetup(linsol_, Jtmp_.get());
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolSetup_KLU");
 }
@@ -180,15 +183,15 @@ void NewtonSolverSparse::prepareLinearSystemB(Model &model,
     model.fJSparseB(state.t, 0.0, state.x, state.dx, xB_, dxB_, xdot_,
                      Jtmp_.get());
     Jtmp_.refresh();
-    auto status = SUNLinSolSetup_KLU(linsol_, Jtmp_.get());
+    auto status = SUNLinSolSetup(linsol_, Jtmp_.get());
     if (status != SUNLS_SUCCESS)
         throw NewtonFailure(status, "SUNLinSolSetup_KLU");
 }
 
 void NewtonSolverSparse::solveLinearSystem(AmiVector &rhs) {
     /* Pass pointer to the linear solver */
-    auto status = SUNLinSolSolve_KLU(linsol_, Jtmp_.get(), rhs.getNVector(),
-                                     rhs.getNVector(), 0.0);
+    auto status = SUNLinSolSolve(linsol_, Jtmp_.get(), rhs.getNVector(),
+                                 rhs.getNVector(), 0.0);
     // last argument is tolerance and does not have any influence on result
 
     if (status != SUNLS_SUCCESS)
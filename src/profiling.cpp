@@ -0,0 +1,138 @@
+#include "amici/profiling.h"
+#include "amici/trace.h"
+
+#include <atomic>
+
+namespace amici {
+
+/** names of ProfiledFunction entries */
+static constexpr std::array<char const *,
+                            static_cast<int>(ProfiledFunction::count)>
+    profiled_function_names = {{
+        "fx0",
+        "fsx0",
+        "fxdot",
+        "fJ",
+        "fJSparse",
+        "fJv",
+        "fJDiag",
+        "fJB",
+        "fJSparseB",
+        "fJvB",
+        "froot",
+        "fw",
+        "fdwdp",
+        "fdwdx",
+        "fdxdotdw",
+        "fdxdotdp",
+        "fsxdot",
+        "fxBdot",
+        "fqBdot",
+        "fy",
+        "fdydp",
+        "fdydx",
+        "fsigmay",
+        "fdsigmaydp",
+        "fdJydy",
+        "fdJydsigma",
+        "fz",
+        "frz",
+        "fdzdp",
+        "fdzdx",
+        "fsigmaz",
+        "fdJzdz",
+        "fdJrzdz",
+        "fdeltax",
+        "fdeltasx",
+        "fdeltaxB",
+        "fdeltaqB",
+        "fstau",
+        "preequilibration",
+        "forward",
+        "postequilibration",
+        "backward",
+        "steadystateBackward",
+        "newtonsMethod",
+        "steadystateSimulation",
+        "events",
+        "dataPoints",
+        "linearSolverSetup",
+        "linearSolverSolve",
+    }};
+
+char const *getProfiledFunctionName(ProfiledFunction function) {
+    return profiled_function_names.at(static_cast<int>(function));
+}
+
+std::vector<std::string> getProfiledFunctionNames() {
+    return {profiled_function_names.begin(), profiled_function_names.end()};
+}
+
+std::vector<int> Profile::getCalls() const {
+    return {calls_.begin(), calls_.end()};
+}
+
+std::vector<double> Profile::getTime() const {
+    std::vector<double> time(n_);
+    for (int i = 0; i < n_; ++i)
+        time[i] =
+            std::chrono::duration<double, std::milli>(time_[i]).count();
+    return time;
+}
+
+static thread_local Profile *current_profile = nullptr;
+
+Profile *getCurrentProfile() { return current_profile; }
+
+ProfileContext::ProfileContext(Profile *profile)
+    : previous_(current_profile) {
+    current_profile = profile;
+}
+
+ProfileContext::~ProfileContext() { current_profile = previous_; }
+
+/** type of SUNLinearSolver setup functions */
+using linsol_setup_fn = int (*)(SUNLinearSolver, SUNMatrix);
+/** type of SUNLinearSolver solve functions */
+using linsol_solve_fn = int (*)(SUNLinearSolver, SUNMatrix, N_Vector,
+                                N_Vector, realtype);
+
+/**
+ * Original setup and solve implementations per SUNLinearSolver_ID. These
+ * are the same for all instances of a given solver type, so they can be
+ * looked up from within the instrumented versions below.
+ */
+static std::array<std::atomic<linsol_setup_fn>, SUNLINEARSOLVER_CUSTOM + 1>
+    original_setup {};
+static std::array<std::atomic<linsol_solve_fn>, SUNLINEARSOLVER_CUSTOM + 1>
+    original_solve {};
+
+static int profiledSetup(SUNLinearSolver S, SUNMatrix A) {
+    AMICI_PROFILE_SCOPE(linearSolverSetup);
+    TraceScope trace_scope("linearSolverSetup");
+    return original_setup[SUNLinSolGetID(S)](S, A);
+}
+
+static int profiledSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x,
+                         N_Vector b, realtype tol) {
+    AMICI_PROFILE_SCOPE(linearSolverSolve);
+    return original_solve[SUNLinSolGetID(S)](S, A, x, b, tol);
+}
+
+void instrumentLinearSolver(SUNLinearSolver linsol) {
+    if (!linsol || !linsol->ops || !linsol->ops->getid)
+        return;
+    auto id = SUNLinSolGetID(linsol);
+    if (id < 0 || id >= SUNLINEARSOLVER_CUSTOM)
+        return;
+    if (linsol->ops->setup && linsol->ops->setup != profiledSetup) {
+        original_setup[id] = linsol->ops->setup;
+        linsol->ops->setup = profiledSetup;
+    }
+    if (linsol->ops->solve && linsol->ops->solve != profiledSolve) {
+        original_solve[id] = linsol->ops->solve;
+        linsol->ops->solve = profiledSolve;
+    }
+}
+
+} // namespace amici
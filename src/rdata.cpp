@@ -1,6 +1,7 @@
 #include "amici/rdata.h"
 
 #include "amici/backwardproblem.h"
+#include "amici/cblas.h"
 #include "amici/edata.h"
 #include "amici/exception.h"
 #include "amici/forwardproblem.h"
@@ -12,6 +13,7 @@
 
 #include <cstring>
 #include <cmath>
+#include <numeric>
 
 namespace amici {
 
@@ -24,7 +26,9 @@ ReturnData::ReturnData(Solver const &solver, const Model &model)
                  solver.getSensitivityOrder(), solver.getSensitivityMethod(),
                  solver.getReturnDataReportingMode(), model.hasQuadraticLLH(),
                  model.getAddSigmaResiduals(),
-                 model.getMinimumSigmaResiduals()) {}
+                 model.getMinimumSigmaResiduals(),
+                 solver.getReturnDataFields(),
+                 solver.getReturnDataTrajectoryTimepoints()) {}
 
 ReturnData::ReturnData(std::vector<realtype> ts,
                        ModelDimensions const& model_dimensions,
@@ -34,15 +38,19 @@ ReturnData::ReturnData(std::vector<realtype> ts,
                        SecondOrderMode o2mode, SensitivityOrder sensi,
                        SensitivityMethod sensi_meth, RDataReporting rdrm,
                        bool quadratic_llh, bool sigma_res,
-                       realtype sigma_offset)
+                       realtype sigma_offset, int rdata_fields,
+                       std::vector<int> const &trajectory_its)
     : ModelDimensions(model_dimensions), ts(std::move(ts)), nx(nx_rdata),
       nxtrue(nxtrue_rdata), nplist(nplist),
       nmaxevent(nmaxevent), nt(nt), newton_maxsteps(newton_maxsteps),
       pscale(std::move(pscale)), o2mode(o2mode), sensi(sensi),
-      sensi_meth(sensi_meth), rdata_reporting(rdrm), sigma_res(sigma_res),
+      sensi_meth(sensi_meth), rdata_reporting(rdrm),
+      rdata_fields(rdata_fields), sigma_res(sigma_res),
       sigma_offset(sigma_offset), x_solver_(nx_solver),
       sx_solver_(nx_solver, nplist), x_rdata_(nx), sx_rdata_(nx, nplist),
       nroots_(ne) {
+    applyTrajectoryTimepoints(trajectory_its);
+
     switch (rdata_reporting) {
     case RDataReporting::full:
         initializeFullReporting(quadratic_llh);
@@ -56,6 +64,17 @@ ReturnData::ReturnData(std::vector<realtype> ts,
         initializeLikelihoodReporting(quadratic_llh);
         break;
     }
+
+    // per-timepoint buffers for observation model quantities, allocated once
+    // here to avoid allocations for every timepoint
+    y_it_.resize(ny, 0.0);
+    sigmay_it_.resize(ny, 0.0);
+    if (sensi >= SensitivityOrder::first) {
+        sy_it_.resize(ny * nplist, 0.0);
+        ssigmay_it_.resize(ny * nplist, 0.0);
+    }
+    if (sres.empty() && !FIM.empty())
+        sres_it_.resize((sigma_res ? 2 : 1) * nytrue * nplist, 0.0);
 }
 
 void ReturnData::initializeLikelihoodReporting(bool enable_fim) {
@@ -68,24 +87,30 @@ void ReturnData::initializeLikelihoodReporting(bool enable_fim) {
 
         if ((sensi_meth == SensitivityMethod::forward ||
             sensi >= SensitivityOrder::second) && enable_fim)
-            FIM.resize(nplist * nplist, 0.0);
+            allocateField(RDataField::FIM, FIM, nplist * nplist, 0.0);
     }
 }
 
 void ReturnData::initializeResidualReporting(bool enable_res) {
-    y.resize(nt * ny, 0.0);
-    sigmay.resize(nt * ny, 0.0);
+    allocateField(RDataField::y, y, nt * ny, 0.0);
+    allocateField(RDataField::sigmay, sigmay, nt * ny, 0.0);
     if (enable_res)
-        res.resize((sigma_res ? 2 : 1) * nt * nytrue, 0.0);
+        allocateField(RDataField::res, res,
+                      (sigma_res ? 2 : 1) * nt * nytrue, 0.0);
 
     if ((sensi_meth == SensitivityMethod::forward &&
          sensi >= SensitivityOrder::first)
         || sensi >= SensitivityOrder::second) {
 
-        sy.resize(nt * ny * nplist, 0.0);
-        ssigmay.resize(nt * ny * nplist, 0.0);
+        allocateField(RDataField::sy, sy, nt * ny * nplist, 0.0);
+        // without forward sensitivities, ssigmay is computed from the
+        // reported sy
+        if (sensi_meth == SensitivityMethod::forward || !sy.empty())
+            allocateField(RDataField::ssigmay, ssigmay, nt * ny * nplist,
+                          0.0);
         if (enable_res)
-            sres.resize((sigma_res ? 2 : 1) * nt * nytrue * nplist, 0.0);
+            allocateField(RDataField::sres, sres,
+                          (sigma_res ? 2 : 1) * nt * nytrue * nplist, 0.0);
     }
 }
 
@@ -103,8 +128,8 @@ void ReturnData::initializeFullReporting(bool quadratic_llh) {
     sigmaz.resize(nmaxevent * nz, 0.0);
 
     rz.resize(nmaxevent * nz, 0.0);
-    x.resize(nt * nx, 0.0);
-    w.resize(nt * nw, 0.0);
+    allocateField(RDataField::x, x, ntTrajectory() * nx, 0.0);
+    allocateField(RDataField::w, w, ntTrajectory() * nw, 0.0);
 
     preeq_numsteps.resize(3, 0);
     preeq_status.resize(3, SteadyStateStatus::not_run);
@@ -137,7 +162,8 @@ void ReturnData::initializeFullReporting(bool quadratic_llh) {
         if (sensi_meth == SensitivityMethod::forward ||
             sensi >= SensitivityOrder::second) {
             // for second order we can fill in from the augmented states
-            sx.resize(nt * nx * nplist, 0.0);
+            allocateField(RDataField::sx, sx, ntTrajectory() * nx * nplist,
+                          0.0);
             sz.resize(nmaxevent * nz * nplist, 0.0);
             srz.resize(nmaxevent * nz * nplist, 0.0);
         }
@@ -149,6 +175,34 @@ void ReturnData::initializeFullReporting(bool quadratic_llh) {
     }
 }
 
+void ReturnData::allocateField(RDataField field, std::vector<realtype> &vec,
+                               std::size_t size, realtype value) {
+    if (rdata_fields & static_cast<int>(field))
+        vec.resize(size, value);
+}
+
+void ReturnData::applyTrajectoryTimepoints(
+    std::vector<int> const &trajectory_its) {
+    if (trajectory_its.empty())
+        return;
+
+    trajectory_rows_.assign(nt, -1);
+    for (auto it : trajectory_its) {
+        if (it < 0 || it >= nt)
+            throw AmiException("Trajectory timepoint index %d out of range "
+                               "[0, %d)", it, nt);
+        trajectory_rows_[it] = 0;
+    }
+
+    this->trajectory_its.clear();
+    for (int it = 0; it < nt; ++it) {
+        if (trajectory_rows_[it] < 0)
+            continue;
+        trajectory_rows_[it] = static_cast<int>(this->trajectory_its.size());
+        this->trajectory_its.push_back(it);
+    }
+}
+
 void ReturnData::processSimulationObjects(SteadystateProblem const *preeq,
                                           ForwardProblem const *fwd,
                                           BackwardProblem const *bwd,
@@ -175,6 +229,9 @@ void ReturnData::processSimulationObjects(SteadystateProblem const *preeq,
     else if (posteq)
         storeJacobianAndDerivativeInReturnData(*posteq, model);
 
+    if (!FIM.empty())
+        symmetrizeFIM();
+
     if (fwd && bwd)
         processBackwardProblem(*fwd, *bwd, preeq, model);
     else if (solver.computingASA())
@@ -199,6 +256,8 @@ void ReturnData::processPreEquilibration(SteadystateProblem const &preeq,
     /* Get cpu time for Newton solve in milliseconds */
     preeq_cpu_time = preeq.getCPUTime();
     preeq_cpu_timeB = preeq.getCPUTimeB();
+    preeq_wall_time = preeq.getWallTime();
+    preeq_wall_timeB = preeq.getWallTimeB();
     preeq_numstepsB = preeq.getNumStepsB();
     preeq_wrms = preeq.getResidualNorm();
     preeq_status = preeq.getSteadyStateStatus();
@@ -220,6 +279,8 @@ void ReturnData::processPostEquilibration(SteadystateProblem const &posteq,
     /* Get cpu time for Newton solve in milliseconds */
     posteq_cpu_time = posteq.getCPUTime();
     posteq_cpu_timeB = posteq.getCPUTimeB();
+    posteq_wall_time = posteq.getWallTime();
+    posteq_wall_timeB = posteq.getWallTimeB();
     posteq_numstepsB = posteq.getNumStepsB();
     posteq_wrms = posteq.getResidualNorm();
     posteq_status = posteq.getSteadyStateStatus();
@@ -274,16 +335,26 @@ void ReturnData::processForwardProblem(ForwardProblem const &fwd, Model &model,
 }
 
 void ReturnData::getDataOutput(int it, Model &model, ExpData const *edata) {
-    if (!x.empty()) {
+    auto const row = trajectoryRow(it);
+    if (!x.empty() && row >= 0) {
         model.fx_rdata(x_rdata_, x_solver_);
-        writeSlice(x_rdata_, slice(x, it, nx));
+        writeSlice(x_rdata_, slice(x, row, nx));
+    }
+    if (!w.empty() && row >= 0)
+        model.getExpression(slice(w, row, nw), ts[it], x_solver_);
+
+    // observables and sigmas are evaluated once per timepoint and shared
+    // between outputs and residuals
+    if (!y.empty() || !res.empty() || !sres.empty() || !FIM.empty()) {
+        model.getObservable(y_it_, ts[it], x_solver_);
+        if (!y.empty())
+            writeSlice(y_it_, slice(y, it, ny));
+    }
+    if (!sigmay.empty() || !res.empty() || !sres.empty() || !FIM.empty()) {
+        model.getObservableSigma(sigmay_it_, it, edata);
+        if (!sigmay.empty())
+            writeSlice(sigmay_it_, slice(sigmay, it, ny));
     }
-    if (!w.empty())
-        model.getExpression(slice(w, it, nw), ts[it], x_solver_);
-    if (!y.empty())
-        model.getObservable(slice(y, it, ny), ts[it], x_solver_);
-    if (!sigmay.empty())
-        model.getObservableSigma(slice(sigmay, it, ny), it, edata);
 
     if (edata) {
         if (!isNaN(llh))
@@ -296,30 +367,42 @@ void ReturnData::getDataOutput(int it, Model &model, ExpData const *edata) {
 
         if (sensi_meth == SensitivityMethod::forward) {
             getDataSensisFSA(it, model, edata);
-        } else if (edata && !sllh.empty()) {
-            model.addPartialObservableObjectiveSensitivity(
-                sllh, s2llh, it, x_solver_, *edata);
+        } else {
+            if (edata && !sllh.empty())
+                model.addPartialObservableObjectiveSensitivity(
+                    sllh, s2llh, it, x_solver_, *edata);
+
+            if (!ssigmay.empty())
+                model.getObservableSigmaSensitivity(
+                    slice(ssigmay, it, nplist * ny),
+                    slice(sy, it, nplist * ny), it, edata);
         }
-
-        if (!ssigmay.empty())
-            model.getObservableSigmaSensitivity(slice(ssigmay, it, nplist * ny),
-                                                slice(sy, it, nplist * ny),
-                                                it, edata);
     }
 }
 
 void ReturnData::getDataSensisFSA(int it, Model &model, ExpData const *edata) {
-    if (!sx.empty()) {
+    auto const row = trajectoryRow(it);
+    if (!sx.empty() && row >= 0) {
         model.fsx_rdata(sx_rdata_, sx_solver_, x_solver_);
         for (int ip = 0; ip < nplist; ip++) {
             writeSlice(sx_rdata_[ip],
-                       slice(sx, it * nplist + ip, nx));
+                       slice(sx, row * nplist + ip, nx));
         }
     }
 
-    if (!sy.empty()) {
-        model.getObservableSensitivity(slice(sy, it, nplist * ny), ts[it],
-                                       x_solver_, sx_solver_);
+    // observable and sigma sensitivities are evaluated once per timepoint
+    // and shared between outputs, residual sensitivities and FIM
+    bool const need_ssigmay =
+        !ssigmay.empty() || (edata && (!sres.empty() || !FIM.empty()));
+    if (!sy.empty() || need_ssigmay) {
+        model.getObservableSensitivity(sy_it_, ts[it], x_solver_, sx_solver_);
+        if (!sy.empty())
+            writeSlice(sy_it_, slice(sy, it, nplist * ny));
+    }
+    if (need_ssigmay) {
+        model.getObservableSigmaSensitivity(ssigmay_it_, sy_it_, it, edata);
+        if (!ssigmay.empty())
+            writeSlice(ssigmay_it_, slice(ssigmay, it, nplist * ny));
     }
 
     if (edata) {
@@ -489,6 +572,7 @@ void ReturnData::handleSx0Forward(const Model &model,
 void ReturnData::processSolver(Solver const &solver) {
 
     cpu_time = solver.getCpuTime();
+    wall_time = solver.getWallTime();
 
     const std::vector<int> *tmp;
 
@@ -520,6 +604,7 @@ void ReturnData::processSolver(Solver const &solver) {
     }
 
     cpu_timeB = solver.getCpuTimeB();
+    wall_timeB = solver.getWallTimeB();
 
     if (!numstepsB.empty()) {
         tmp = &solver.getNumStepsB();
@@ -560,15 +645,23 @@ void ReturnData::invalidate(const int it_start) {
     invalidateLLH();
     invalidateSLLH();
 
+    // first row of state trajectories at or after it_start
+    auto const row_start =
+        trajectory_its.empty()
+            ? it_start
+            : static_cast<int>(std::lower_bound(trajectory_its.begin(),
+                                                trajectory_its.end(), it_start)
+                               - trajectory_its.begin());
+
     if (!x.empty())
-        std::fill(x.begin() + nx * it_start, x.end(), getNaN());
+        std::fill(x.begin() + nx * row_start, x.end(), getNaN());
     if (!y.empty())
         std::fill(y.begin() + ny * it_start, y.end(), getNaN());
     if (!w.empty())
-        std::fill(w.begin() + nw * it_start, w.end(), getNaN());
+        std::fill(w.begin() + nw * row_start, w.end(), getNaN());
 
     if (!sx.empty())
-        std::fill(sx.begin() + nx * nplist * it_start, sx.end(), getNaN());
+        std::fill(sx.begin() + nx * nplist * row_start, sx.end(), getNaN());
     if (!sy.empty())
         std::fill(sy.begin() + ny * nplist * it_start, sy.end(), getNaN());
 }
@@ -791,24 +884,15 @@ void ReturnData::fres(const int it, Model &model, const ExpData &edata) {
     if (res.empty())
         return;
 
-    std::vector<realtype> y_it(ny, 0.0);
-    model.getObservable(y_it, ts[it], x_solver_);
-
-    std::vector<realtype> sigmay_it(ny, 0.0);
-    model.getObservableSigma(sigmay_it, it, &edata);
-
-    auto observedData = edata.getObservedDataPtr(it);
-    for (int iy = 0; iy < nytrue; ++iy) {
+    auto observedData = edata.getObservedDataPtr(it, my_it_);
+    for (auto iy : edata.getObservedDataIndices(it)) {
         int iyt = iy + it * edata.nytrue();
-        if (!edata.isSetObservedData(it, iy))
-            continue;
-
-        res.at(iyt) = amici::fres(y_it.at(iy), observedData[iy],
-                                  sigmay_it.at(iy),
+        res.at(iyt) = amici::fres(y_it_[iy], observedData[iy],
+                                  sigmay_it_[iy],
                                   model.getObservableScaling(iy));
 
         if (sigma_res)
-            res.at(iyt + nt * nytrue) = fres_error(sigmay_it.at(iy),
+            res.at(iyt + nt * nytrue) = fres_error(sigmay_it_[iy],
                                                    sigma_offset);
     }
 }
@@ -817,10 +901,11 @@ void ReturnData::fchi2(const int it, const ExpData &edata) {
     if (res.empty() || isNaN(chi2))
         return;
 
-    for (int iy = 0; iy < nytrue; ++iy) {
+    // residuals of missing data points are zero
+    for (auto iy : edata.getObservedDataIndices(it)) {
         int iyt_true = iy + it * nytrue;
         chi2 += pow(res.at(iyt_true), 2);
-        if (sigma_res && edata.isSetObservedData(it, iy))
+        if (sigma_res)
             chi2 += pow(res.at(iyt_true + nt * nytrue), 2) - sigma_offset;
     }
 }
@@ -850,54 +935,38 @@ void ReturnData::fsres(const int it, Model &model, const ExpData &edata) {
     if (sres.empty())
         return;
 
-    std::vector<realtype> y_it(ny, 0.0);
-    model.getObservable(y_it, ts[it], x_solver_);
-    std::vector<realtype> sy_it(ny * nplist, 0.0);
-    model.getObservableSensitivity(sy_it, ts[it], x_solver_, sx_solver_);
-
-    std::vector<realtype> sigmay_it(ny, 0.0);
-    model.getObservableSigma(sigmay_it, it, &edata);
-    std::vector<realtype> ssigmay_it(ny * nplist, 0.0);
-    model.getObservableSigmaSensitivity(ssigmay_it, sy_it, it, &edata);
+    auto sres_it = slice(sres, it, nytrue * nplist);
+    auto sres_error_it = sigma_res ? slice(sres, nt + it, nytrue * nplist)
+                                   : gsl::span<realtype>();
+    fsres(it, model, edata, sres_it, sres_error_it);
+}
 
-    auto observedData = edata.getObservedDataPtr(it);
-    for (int iy = 0; iy < nytrue; ++iy) {
-        if (!edata.isSetObservedData(it, iy))
-            continue;
+void ReturnData::fsres(const int it, Model &model, const ExpData &edata,
+                       gsl::span<realtype> sres_it,
+                       gsl::span<realtype> sres_error_it, bool compact) {
+    auto observedData = edata.getObservedDataPtr(it, my_it_);
+    int irow = 0;
+    for (auto iy : edata.getObservedDataIndices(it)) {
+        auto row = (compact ? irow++ : iy) * nplist;
+        auto y = y_it_[iy];
+        auto m = observedData[iy];
+        auto s = sigmay_it_[iy];
+        auto os = model.getObservableScaling(iy);
         for (int ip = 0; ip < nplist; ++ip) {
-            int idx = (iy + it * edata.nytrue()) * nplist + ip;
-
-            sres.at(idx) = amici::fsres(y_it.at(iy), sy_it.at(iy + ny * ip),
-                                        observedData[iy], sigmay_it.at(iy),
-                                        ssigmay_it.at(iy + ny * ip),
-                                        model.getObservableScaling(iy));
-
-            if (sigma_res) {
-                int idx_res =
-                    (iy + it * edata.nytrue() + edata.nytrue() * edata.nt()) *
-                        nplist + ip;
-                sres.at(idx_res) = amici::fsres_error(sigmay_it.at(iy),
-                                                      ssigmay_it.at(iy + ny * ip),
-                                                      sigma_offset);
-            }
+            auto ds = ssigmay_it_[iy + ny * ip];
+            sres_it[row + ip] =
+                amici::fsres(y, sy_it_[iy + ny * ip], m, s, ds, os);
+            if (sigma_res)
+                sres_error_it[row + ip] =
+                    amici::fsres_error(s, ds, sigma_offset);
         }
     }
 }
 
 void ReturnData::fFIM(int it, Model &model, const ExpData &edata) {
-    if (FIM.empty())
+    if (FIM.empty() || nytrue == 0)
         return;
 
-    std::vector<realtype> y_it(ny, 0.0);
-    model.getObservable(y_it, ts[it], x_solver_);
-    std::vector<realtype> sy_it(ny * nplist, 0.0);
-    model.getObservableSensitivity(sy_it, ts[it], x_solver_, sx_solver_);
-
-    std::vector<realtype> sigmay_it(ny, 0.0);
-    model.getObservableSigma(sigmay_it, it, &edata);
-    std::vector<realtype> ssigmay_it(ny * nplist, 0.0);
-    model.getObservableSigmaSensitivity(ssigmay_it, sy_it, it, &edata);
-
     /*
      * https://www.wolframalpha.com/input/?i=d%2Fdu+d%2Fdv+log%28s%28u%2Cv%29%29+%2B+0.5+*+%28r%28u%2Cv%29%2Fs%28u%2Cv%29%29%5E2
      * r = (y - m)
@@ -951,36 +1020,186 @@ void ReturnData::fFIM(int it, Model &model, const ExpData &edata) {
      * on the Boehm2014 Benchmark example.
      */
 
-    auto observedData = edata.getObservedDataPtr(it);
+    /*
+     * FIM += sres_it^T * sres_it, where sres_it is the (nytrue x nplist,
+     * row-major) block of residual sensitivities at this timepoint.
+     * Missing data points have zero rows and thus do not contribute.
+     * Row-major sres_it equals a column-major (nplist x nytrue) matrix, so we
+     * compute the upper triangle of the symmetric rank-k update in
+     * column-major layout, the lower triangle is filled in symmetrizeFIM.
+     * If sres is not requested, only the rows of measured observables are
+     * evaluated and stacked, which reduces the rank of the update to the
+     * number of data points at this timepoint.
+     */
+    realtype const *sres_it, *sres_error_it;
+    int nrows;
+    if (!sres.empty()) {
+        // already evaluated by fsres
+        sres_it = sres.data() + it * nytrue * nplist;
+        sres_error_it =
+            sigma_res ? sres.data() + (nt + it) * nytrue * nplist : nullptr;
+        nrows = nytrue;
+    } else {
+        nrows = static_cast<int>(edata.getObservedDataIndices(it).size());
+        if (nrows == 0)
+            return;
+        auto sres_it_span = gsl::make_span(sres_it_.data(), nrows * nplist);
+        auto sres_error_it_span =
+            sigma_res ? gsl::make_span(sres_it_.data() + nytrue * nplist,
+                                       nrows * nplist)
+                      : gsl::span<realtype>();
+        fsres(it, model, edata, sres_it_span, sres_error_it_span, true);
+        sres_it = sres_it_.data();
+        sres_error_it = sres_it_.data() + nytrue * nplist;
+    }
+
+    amici_dsyrk(BLASLayout::colMajor, BLASUplo::upper, BLASTranspose::noTrans,
+                nplist, nrows, 1.0, sres_it, nplist, 1.0, FIM.data(), nplist);
+    if (sigma_res)
+        amici_dsyrk(BLASLayout::colMajor, BLASUplo::upper,
+                    BLASTranspose::noTrans, nplist, nrows, 1.0, sres_error_it,
+                    nplist, 1.0, FIM.data(), nplist);
+}
 
-    for (int iy = 0; iy < nytrue; ++iy) {
-        if (!edata.isSetObservedData(it, iy))
+void ReturnData::symmetrizeFIM() {
+    for (int jp = 0; jp < nplist; ++jp)
+        for (int ip = jp + 1; ip < nplist; ++ip)
+            FIM[ip + nplist * jp] = FIM[jp + nplist * ip];
+}
+
+ReturnDataArena::ReturnDataArena(int num_simulations) {
+    reset(num_simulations);
+}
+
+void ReturnDataArena::reset(int num_simulations) {
+    if (num_simulations < 0)
+        throw AmiException("Number of simulations must not be negative.");
+    num_simulations_ = num_simulations;
+    fields_.clear();
+    if (!data_ || data_.use_count() > 1)
+        data_ = std::make_shared<std::vector<realtype>>();
+    else
+        data_->clear();
+    status_.assign(num_simulations, AMICI_ERROR);
+}
+
+void ReturnDataArena::initializeLayout(ReturnData const &rdata) {
+    auto const nt_trajectory = rdata.ntTrajectory();
+    using F = std::vector<realtype> ReturnData::*;
+    std::vector<std::pair<F, std::vector<int>>> const vectors{
+        {&ReturnData::ts, {rdata.nt}},
+        {&ReturnData::x, {nt_trajectory, rdata.nx}},
+        {&ReturnData::sx, {nt_trajectory, rdata.nplist, rdata.nx}},
+        {&ReturnData::w, {nt_trajectory, rdata.nw}},
+        {&ReturnData::x0, {rdata.nx}},
+        {&ReturnData::sx0, {rdata.nplist, rdata.nx}},
+        {&ReturnData::x_ss, {rdata.nx}},
+        {&ReturnData::sx_ss, {rdata.nplist, rdata.nx}},
+        {&ReturnData::y, {rdata.nt, rdata.ny}},
+        {&ReturnData::sigmay, {rdata.nt, rdata.ny}},
+        {&ReturnData::sy, {rdata.nt, rdata.nplist, rdata.ny}},
+        {&ReturnData::ssigmay, {rdata.nt, rdata.nplist, rdata.ny}},
+        {&ReturnData::z, {rdata.nmaxevent, rdata.nz}},
+        {&ReturnData::rz, {rdata.nmaxevent, rdata.nz}},
+        {&ReturnData::sigmaz, {rdata.nmaxevent, rdata.nz}},
+        {&ReturnData::sz, {rdata.nmaxevent, rdata.nplist, rdata.nz}},
+        {&ReturnData::srz, {rdata.nmaxevent, rdata.nplist, rdata.nz}},
+        {&ReturnData::ssigmaz, {rdata.nmaxevent, rdata.nplist, rdata.nz}},
+        {&ReturnData::res, {static_cast<int>(rdata.res.size())}},
+        {&ReturnData::sres,
+         {rdata.nplist ? static_cast<int>(rdata.sres.size()) / rdata.nplist
+                       : 0,
+          rdata.nplist}},
+        {&ReturnData::sllh, {rdata.nplist}},
+        {&ReturnData::s2llh, {rdata.nJ - 1, rdata.nplist}},
+        {&ReturnData::FIM, {rdata.nplist, rdata.nplist}},
+        {&ReturnData::J, {rdata.nx_solver, rdata.nx_solver}},
+        {&ReturnData::xdot, {rdata.nx_solver}},
+    };
+    static char const *const vector_names[] = {
+        "ts", "x", "sx", "w", "x0", "sx0", "x_ss", "sx_ss", "y", "sigmay",
+        "sy", "ssigmay", "z", "rz", "sigmaz", "sz", "srz", "ssigmaz", "res",
+        "sres", "sllh", "s2llh", "FIM", "J", "xdot"};
+
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < vectors.size(); ++i) {
+        auto const &vec = rdata.*vectors[i].first;
+        if (vec.empty())
+            continue;
+        auto shape = vectors[i].second;
+        if (static_cast<std::size_t>(std::accumulate(
+                shape.begin(), shape.end(), 1, std::multiplies<int>()))
+            != vec.size())
+            shape = {static_cast<int>(vec.size())};
+        fields_.push_back({vector_names[i], vectors[i].first, nullptr,
+                           std::move(shape), vec.size(), offset});
+        offset += vec.size() * num_simulations_;
+    }
+    for (auto const &scalar : {std::make_pair("llh", &ReturnData::llh),
+                               std::make_pair("chi2", &ReturnData::chi2)}) {
+        fields_.push_back({scalar.first, nullptr, scalar.second, {}, 1,
+                           offset});
+        offset += num_simulations_;
+    }
+
+    // does not reallocate if the previous batch was at least as large
+    data_->assign(offset, getNaN());
+}
+
+void ReturnDataArena::consume(int index, std::unique_ptr<ReturnData> rdata) {
+    if (index < 0 || index >= num_simulations_)
+        throw AmiException("Simulation index %d out of range [0, %d)", index,
+                           num_simulations_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fields_.empty())
+            initializeLayout(*rdata);
+    }
+
+    for (auto const &field : fields_) {
+        auto dest = data_->begin() + field.offset + index * field.size;
+        if (field.scalar) {
+            *dest = rdata.get()->*field.scalar;
             continue;
-        auto y = y_it.at(iy);
-        auto m = observedData[iy];
-        auto s = sigmay_it.at(iy);
-        auto os = model.getObservableScaling(iy);
-        // auto r = amici::fres(y, m, s);
-        for (int ip = 0; ip < nplist; ++ip) {
-            auto dy_i = sy_it.at(iy + ny * ip);
-            auto ds_i = ssigmay_it.at(iy + ny * ip);
-            auto sr_i = amici::fsres(y, dy_i, m, s, ds_i, os);
-            realtype sre_i = 0.0;
-            if (sigma_res)
-                sre_i = amici::fsres_error(s, ds_i, sigma_offset);
-            for (int jp = 0; jp < nplist; ++jp) {
-                auto dy_j = sy_it.at(iy + ny * jp);
-                auto ds_j = ssigmay_it.at(iy + ny * jp);
-                auto sr_j = amici::fsres(y, dy_j, m, s, ds_j, os);
-                FIM.at(ip + nplist * jp) += sr_i*sr_j;
-                if (sigma_res) {
-                    auto sre_j = amici::fsres_error(s, ds_j, sigma_offset);
-                    FIM.at(ip + nplist * jp) += sre_i * sre_j;
-                }
-                /*+ ds_i*ds_j*(2*pow(r/pow(s,2.0), 2.0) - 1/pow(s,2.0));*/
-            }
         }
+        auto const &vec = rdata.get()->*field.vector;
+        if (vec.size() != field.size)
+            throw AmiException("Size of field %s (%zu) of simulation %d does "
+                               "not match the size in the arena (%zu).",
+                               field.name.c_str(), vec.size(), index,
+                               field.size);
+        std::copy(vec.begin(), vec.end(), dest);
     }
+    status_[index] = rdata->status;
+}
+
+std::vector<std::string> ReturnDataArena::getFieldNames() const {
+    std::vector<std::string> names;
+    names.reserve(fields_.size());
+    for (auto const &field : fields_)
+        names.push_back(field.name);
+    return names;
+}
+
+int ReturnDataArena::getFieldOffset(std::string const &field) const {
+    return static_cast<int>(getField(field).offset);
+}
+
+int ReturnDataArena::getFieldSize(std::string const &field) const {
+    return static_cast<int>(getField(field).size);
+}
+
+std::vector<int> const &
+ReturnDataArena::getFieldShape(std::string const &field) const {
+    return getField(field).shape;
+}
+
+ReturnDataArena::Field const &
+ReturnDataArena::getField(std::string const &field) const {
+    for (auto const &f : fields_)
+        if (f.name == field)
+            return f;
+    throw AmiException("Unknown field %s.", field.c_str());
 }
 
 ModelContext::ModelContext(Model *model)
@@ -56,7 +56,8 @@ mxArray *initMatlabReturnFields(ReturnData const *rdata) {
         writeMatlabField2(matlabSolutionStruct, "sigmaz", rdata->sigmaz, rdata->nmaxevent, rdata->nz, perm1);
     }
     if (rdata->nx > 0) {
-        writeMatlabField2(matlabSolutionStruct, "x", rdata->x, rdata->nt, rdata->nx, perm1);
+        if (!rdata->x.empty())
+            writeMatlabField2(matlabSolutionStruct, "x", rdata->x, rdata->ntTrajectory(), rdata->nx, perm1);
         writeMatlabField2(matlabSolutionStruct, "x0",  rdata->x0, rdata->nx, 1, perm1);
     }
     if (rdata->ny > 0) {
@@ -68,7 +69,8 @@ mxArray *initMatlabReturnFields(ReturnData const *rdata) {
         writeMatlabField2(matlabSolutionStruct, "sx0",  rdata->sx0, rdata->nplist, rdata->nx, perm0);
 
         if (rdata->sensi_meth == SensitivityMethod::forward) {
-            writeMatlabField3(matlabSolutionStruct, "sx", rdata->sx, rdata->nt, rdata->nplist, rdata->nx, perm2);
+            if (!rdata->sx.empty())
+                writeMatlabField3(matlabSolutionStruct, "sx", rdata->sx, rdata->ntTrajectory(), rdata->nplist, rdata->nx, perm2);
             if (rdata->ny > 0) {
                 writeMatlabField3(matlabSolutionStruct, "sy", rdata->sy, rdata->nt, rdata->nplist, rdata->ny, perm2);
             }
@@ -101,7 +103,7 @@ mxArray *initMatlabReturnFields(ReturnData const *rdata) {
 }
 
 mxArray *initMatlabDiagnosisFields(ReturnData const *rdata) {
-    const int numFields = 25;
+    const int numFields = 29;
     const char *field_names_sol[numFields] = {"xdot",
                                               "J",
                                               "numsteps",
@@ -118,6 +120,8 @@ mxArray *initMatlabDiagnosisFields(ReturnData const *rdata) {
                                               "preeq_numstepsB",
                                               "preeq_cpu_time",
                                               "preeq_cpu_timeB",
+                                              "preeq_wall_time",
+                                              "preeq_wall_timeB",
                                               "preeq_t",
                                               "preeq_wrms",
                                               "posteq_status",
@@ -125,6 +129,8 @@ mxArray *initMatlabDiagnosisFields(ReturnData const *rdata) {
                                               "posteq_numstepsB",
                                               "posteq_cpu_time",
                                               "posteq_cpu_timeB",
+                                              "posteq_wall_time",
+                                              "posteq_wall_timeB",
                                               "posteq_t",
                                               "posteq_wrms"};
 
@@ -169,6 +175,8 @@ mxArray *initMatlabDiagnosisFields(ReturnData const *rdata) {
         writeMatlabField0(matlabDiagnosisStruct, "preeq_numstepsB", rdata->preeq_numstepsB);
         writeMatlabField0(matlabDiagnosisStruct, "preeq_cpu_time", rdata->preeq_cpu_time);
         writeMatlabField0(matlabDiagnosisStruct, "preeq_cpu_timeB", rdata->preeq_cpu_timeB);
+        writeMatlabField0(matlabDiagnosisStruct, "preeq_wall_time", rdata->preeq_wall_time);
+        writeMatlabField0(matlabDiagnosisStruct, "preeq_wall_timeB", rdata->preeq_wall_timeB);
         writeMatlabField0(matlabDiagnosisStruct, "preeq_t", rdata->preeq_t);
         writeMatlabField0(matlabDiagnosisStruct, "preeq_wrms", rdata->preeq_wrms);
 
@@ -177,6 +185,8 @@ mxArray *initMatlabDiagnosisFields(ReturnData const *rdata) {
         writeMatlabField0(matlabDiagnosisStruct, "posteq_numstepsB", rdata->posteq_numstepsB);
         writeMatlabField0(matlabDiagnosisStruct, "posteq_cpu_time", rdata->posteq_cpu_time);
         writeMatlabField0(matlabDiagnosisStruct, "posteq_cpu_timeB", rdata->posteq_cpu_timeB);
+        writeMatlabField0(matlabDiagnosisStruct, "posteq_wall_time", rdata->posteq_wall_time);
+        writeMatlabField0(matlabDiagnosisStruct, "posteq_wall_timeB", rdata->posteq_wall_timeB);
         writeMatlabField0(matlabDiagnosisStruct, "posteq_t", rdata->posteq_t);
         writeMatlabField0(matlabDiagnosisStruct, "posteq_wrms", rdata->posteq_wrms);
     }
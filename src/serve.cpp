@@ -0,0 +1,665 @@
+/**
+ * Simulation server and client communicating via Unix domain sockets
+ */
+
+#include "amici/serve.h"
+#include "amici/amici.h"
+#include "amici/model_registry.h"
+#include "amici/serialization.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <list>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace amici {
+namespace serve {
+
+namespace {
+
+/** Upper bound for frame sizes, to reject garbage before allocating */
+constexpr std::uint32_t max_frame_size = 1u << 30u;
+
+#if defined(MSG_NOSIGNAL)
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+std::string errnoMessage() { return std::strerror(errno); }
+
+/**
+ * @brief Create a socket that does not raise SIGPIPE when writing to a
+ * closed connection
+ * @return file descriptor
+ */
+int createSocket() {
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw AmiException("Failed to create socket: %s",
+                           errnoMessage().c_str());
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+    int const on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    return fd;
+}
+
+sockaddr_un socketAddress(std::string const &path) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+        throw AmiException("Invalid socket path \"%s\", must be non-empty and "
+                           "shorter than %zu characters.",
+                           path.c_str(), sizeof(address.sun_path));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+bool connectSocket(int fd, sockaddr_un const &address) {
+    int result;
+    do {
+        result = connect(fd, reinterpret_cast<sockaddr const *>(&address),
+                         sizeof(address));
+    } while (result < 0 && errno == EINTR);
+    return result == 0;
+}
+
+void writeAll(int fd, char const *data, std::size_t size) {
+    while (size > 0) {
+        auto const written = send(fd, data, size, send_flags);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            throw AmiException("Failed to write to socket: %s",
+                               errnoMessage().c_str());
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+/**
+ * @brief Read exactly `size` bytes
+ * @return false if the connection was closed before the first byte
+ */
+bool readAll(int fd, char *data, std::size_t size) {
+    auto const total = size;
+    while (size > 0) {
+        auto const received = recv(fd, data, size, 0);
+        if (received < 0) {
+            if (errno == EINTR)
+                continue;
+            throw AmiException("Failed to read from socket: %s",
+                               errnoMessage().c_str());
+        }
+        if (received == 0) {
+            if (size == total)
+                return false;
+            throw AmiException("Connection closed in the middle of a message.");
+        }
+        data += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+/** Appends little-endian encoded values to a payload */
+class Encoder {
+  public:
+    void u8(std::uint8_t value) { data_.push_back(static_cast<char>(value)); }
+
+    void u32(std::uint32_t value) {
+        for (int i = 0; i < 4; ++i)
+            u8(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+
+    void f64(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i)
+            u8(static_cast<std::uint8_t>(bits >> (8 * i)));
+    }
+
+    void str(std::string const &value) {
+        u32(static_cast<std::uint32_t>(value.size()));
+        data_.append(value);
+    }
+
+    void f64s(std::vector<realtype> const &values) {
+        u32(static_cast<std::uint32_t>(values.size()));
+        for (auto const value : values)
+            f64(value);
+    }
+
+    std::string &data() { return data_; }
+
+  private:
+    std::string data_;
+};
+
+/** Reads little-endian encoded values from a payload */
+class Decoder {
+  public:
+    explicit Decoder(std::string const &data) : data_(data) {}
+
+    std::uint8_t u8() {
+        require(1);
+        return static_cast<std::uint8_t>(data_[pos_++]);
+    }
+
+    std::uint32_t u32() {
+        require(4);
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<std::uint32_t>(
+                         static_cast<std::uint8_t>(data_[pos_++]))
+                     << (8 * i);
+        return value;
+    }
+
+    double f64() {
+        require(8);
+        std::uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i)
+            bits |= static_cast<std::uint64_t>(
+                        static_cast<std::uint8_t>(data_[pos_++]))
+                    << (8 * i);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string str() {
+        auto const size = u32();
+        require(size);
+        auto value = data_.substr(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    void f64s(std::vector<realtype> &values) {
+        auto const size = u32();
+        require(static_cast<std::size_t>(size) * 8);
+        values.resize(size);
+        for (auto &value : values)
+            value = f64();
+    }
+
+  private:
+    void require(std::size_t size) const {
+        if (data_.size() - pos_ < size)
+            throw AmiException("Truncated message.");
+    }
+
+    std::string const &data_;
+    std::size_t pos_{0};
+};
+
+void writeFrame(int fd, std::string const &payload) {
+    Encoder header;
+    header.u32(static_cast<std::uint32_t>(payload.size()));
+    writeAll(fd, header.data().data(), header.data().size());
+    writeAll(fd, payload.data(), payload.size());
+}
+
+/**
+ * @brief Read a frame into `payload`
+ * @return false if the connection was closed
+ */
+bool readFrame(int fd, std::string &payload) {
+    std::string header(4, '\0');
+    if (!readAll(fd, &header[0], header.size()))
+        return false;
+    auto const size = Decoder(header).u32();
+    if (size > max_frame_size)
+        throw AmiException("Message of %u bytes exceeds the maximum size.",
+                           size);
+    payload.resize(size);
+    if (size > 0 && !readAll(fd, &payload[0], size))
+        throw AmiException("Connection closed in the middle of a message.");
+    return true;
+}
+
+/**
+ * @brief Check that the data of a condition matches the model, which
+ * ConditionContext and ReturnData rely on
+ */
+void checkDimensions(ExpData const &edata, Model const &model) {
+    if (edata.nytrue() != model.nytrue || edata.nztrue() != model.nztrue
+        || edata.nmaxevent() != model.nMaxEvent())
+        throw AmiException("Dimensions of ExpData (nytrue %d, nztrue %d, "
+                           "nmaxevent %d) do not match the model (%d, %d, %d).",
+                           edata.nytrue(), edata.nztrue(), edata.nmaxevent(),
+                           model.nytrue, model.nztrue, model.nMaxEvent());
+    // the data arrays were checked against these dimensions during
+    // deserialization
+}
+
+/**
+ * @brief Resident model instance and the objects reused across requests
+ * for it.
+ */
+struct Workspace {
+    /** model name */
+    std::string name;
+
+    /** model version */
+    std::string version;
+
+    /** model, declared first to be destroyed after the solver */
+    std::shared_ptr<Model> model;
+
+    /** parameters of the model as created */
+    std::vector<realtype> default_parameters;
+
+    /** parameter scales of the model as created */
+    std::vector<ParameterScaling> default_pscale;
+
+    /** solver for the settings in `solver_settings` */
+    std::unique_ptr<Solver> solver;
+
+    /** serialized settings of `solver`, empty for the model defaults */
+    std::string solver_settings;
+
+    /** conditions of the current request */
+    std::vector<ExpData> edatas;
+};
+
+/**
+ * @brief Workspaces of a worker, ordered by last use
+ */
+class WorkspaceCache {
+  public:
+    WorkspaceCache(ModelFactory const &factory, ServerOptions const &options)
+        : factory_(factory), options_(options) {}
+
+    ~WorkspaceCache() {
+        if (workspaces_.empty())
+            return;
+        workspaces_.clear();
+        released();
+    }
+
+    /**
+     * @brief Get the workspace of a model, creating the model if necessary
+     */
+    Workspace &get(std::string const &name, std::string const &version) {
+        auto it = std::find_if(workspaces_.begin(), workspaces_.end(),
+                               [&](Workspace const &workspace) {
+                                   return workspace.name == name
+                                          && workspace.version == version;
+                               });
+        if (it != workspaces_.end()) {
+            workspaces_.splice(workspaces_.begin(), workspaces_, it);
+            return workspaces_.front();
+        }
+
+        Workspace workspace;
+        workspace.name = name;
+        workspace.version = version;
+        workspace.model = factory_(name, version);
+        if (!workspace.model)
+            throw AmiException("Unknown model %s version \"%s\".",
+                               name.c_str(), version.c_str());
+        workspace.default_parameters = workspace.model->getParameters();
+        workspace.default_pscale = workspace.model->getParameterScale();
+        workspace.solver = workspace.model->getSolver();
+        workspaces_.push_front(std::move(workspace));
+
+        auto const max_size = static_cast<std::size_t>(
+            std::max(options_.max_models_per_thread, 1));
+        if (workspaces_.size() > max_size) {
+            workspaces_.resize(max_size);
+            released();
+        }
+        return workspaces_.front();
+    }
+
+  private:
+    void released() const {
+        if (options_.on_models_released)
+            options_.on_models_released();
+    }
+
+    ModelFactory const &factory_;
+
+    ServerOptions const &options_;
+
+    /** most recently used first */
+    std::list<Workspace> workspaces_;
+};
+
+void writeError(int fd, std::string const &message) {
+    Encoder response;
+    response.u8(static_cast<std::uint8_t>(ResponseType::error));
+    response.str(message);
+    writeFrame(fd, response.data());
+}
+
+/**
+ * @brief Simulate all conditions of a request, sending each result as soon
+ * as it is available
+ */
+void handleRequest(int fd, std::string const &payload, WorkspaceCache &cache,
+                   std::vector<std::string> &edata_blobs) {
+    Decoder request(payload);
+    auto const version = request.u32();
+    if (version != protocol_version)
+        throw AmiException("Unsupported protocol version %u, expected %u.",
+                           version, protocol_version);
+    auto const model_name = request.str();
+    auto const model_version = request.str();
+    auto solver_settings = request.str();
+    std::vector<realtype> parameters;
+    request.f64s(parameters);
+    auto const num_conditions = request.u32();
+    if (num_conditions > payload.size())
+        throw AmiException("Truncated message.");
+    edata_blobs.resize(num_conditions);
+    for (auto &blob : edata_blobs)
+        blob = request.str();
+
+    auto &workspace = cache.get(model_name, model_version);
+    auto &model = *workspace.model;
+
+    if (solver_settings != workspace.solver_settings) {
+        // solver memory depends on the settings, so start from a new
+        // instance rather than changing the settings of the existing one
+        auto solver = model.getSolver();
+        if (!solver_settings.empty())
+            deserializeFromString(solver_settings, *solver);
+        workspace.solver = std::move(solver);
+        workspace.solver_settings = std::move(solver_settings);
+    }
+
+    model.setParameterScale(workspace.default_pscale);
+    model.setParameters(parameters.empty() ? workspace.default_parameters
+                                           : parameters);
+
+    workspace.edatas.resize(edata_blobs.size());
+    for (std::size_t i = 0; i < edata_blobs.size(); ++i) {
+        deserializeFromString(edata_blobs[i], workspace.edatas[i]);
+        checkDimensions(workspace.edatas[i], model);
+    }
+
+    auto const num_simulations = std::max<std::size_t>(num_conditions, 1);
+    for (std::size_t i = 0; i < num_simulations; ++i) {
+        auto const rdata = runAmiciSimulation(
+            *workspace.solver,
+            workspace.edatas.empty() ? nullptr : &workspace.edatas[i], model);
+        Encoder response;
+        response.u8(static_cast<std::uint8_t>(ResponseType::result));
+        response.u32(static_cast<std::uint32_t>(i));
+        response.str(serializeToString(*rdata));
+        writeFrame(fd, response.data());
+    }
+}
+
+/**
+ * @brief Handle requests of a connection until it is closed
+ */
+void serveConnection(int fd, WorkspaceCache &cache) {
+    std::string payload;
+    std::vector<std::string> edata_blobs;
+    try {
+        while (readFrame(fd, payload)) {
+            try {
+                handleRequest(fd, payload, cache, edata_blobs);
+            } catch (std::exception const &e) {
+                // the request was invalid or could not be simulated, the
+                // connection can still be used for further requests
+                writeError(fd, e.what());
+                continue;
+            }
+            Encoder response;
+            response.u8(static_cast<std::uint8_t>(ResponseType::end));
+            writeFrame(fd, response.data());
+        }
+    } catch (AmiException const &e) {
+        // broken connection or framing, nothing left to respond to
+        try {
+            writeError(fd, e.what());
+        } catch (AmiException const &) {
+        }
+    }
+}
+
+} // namespace
+
+std::string encodeRequest(Request const &request) {
+    Encoder payload;
+    payload.u32(protocol_version);
+    payload.str(request.model_name);
+    payload.str(request.model_version);
+    payload.str(request.solver ? serializeToString(*request.solver)
+                               : std::string());
+    payload.f64s(request.parameters);
+    payload.u32(static_cast<std::uint32_t>(request.edatas.size()));
+    for (auto const *edata : request.edatas)
+        payload.str(serializeToString(*edata));
+    return std::move(payload.data());
+}
+
+Server::Server(std::string socket_path, ModelFactory model_factory,
+               ServerOptions options)
+    : socket_path_(std::move(socket_path)),
+      model_factory_(std::move(model_factory)), options_(std::move(options)) {
+    auto const address = socketAddress(socket_path_);
+
+    listen_fd_ = createSocket();
+    if (bind(listen_fd_, reinterpret_cast<sockaddr const *>(&address),
+             sizeof(address))
+        < 0) {
+        auto const error = errno;
+        auto const probe = createSocket();
+        auto const in_use = error == EADDRINUSE && connectSocket(probe, address);
+        close(probe);
+        // a socket file without a server is left over from a previous run
+        if (error != EADDRINUSE || in_use
+            || unlink(socket_path_.c_str()) < 0
+            || bind(listen_fd_, reinterpret_cast<sockaddr const *>(&address),
+                    sizeof(address))
+                   < 0) {
+            close(listen_fd_);
+            throw AmiException("Failed to bind to %s: %s", socket_path_.c_str(),
+                               in_use ? "another server is listening"
+                                      : std::strerror(error));
+        }
+    }
+    // only the owner may connect, before anybody can connect at all
+    if (chmod(socket_path_.c_str(), S_IRUSR | S_IWUSR) < 0
+        || listen(listen_fd_, SOMAXCONN) < 0 || pipe(wake_fds_) < 0) {
+        auto const message = errnoMessage();
+        close(listen_fd_);
+        unlink(socket_path_.c_str());
+        throw AmiException("Failed to listen on %s: %s", socket_path_.c_str(),
+                           message.c_str());
+    }
+    for (auto const fd : wake_fds_)
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+Server::Server(std::string socket_path, ModelRegistry &registry,
+               ServerOptions options)
+    : Server(std::move(socket_path),
+             [&registry](std::string const &name, std::string const &version) {
+                 return registry.createModel(name, version);
+             },
+             std::move(options)) {
+    if (!options_.on_models_released)
+        options_.on_models_released = [&registry]() {
+            registry.unloadUnused();
+        };
+}
+
+Server::~Server() {
+    stop();
+    {
+        // run() still uses the sockets and members until it returns
+        std::unique_lock<std::mutex> lock(mutex_);
+        run_cv_.wait(lock, [this]() { return !running_; });
+    }
+    close(listen_fd_);
+    close(wake_fds_[0]);
+    close(wake_fds_[1]);
+    unlink(socket_path_.c_str());
+}
+
+void Server::run() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+    }
+    stopping_ = false;
+    for (int i = 0; i < std::max(options_.num_threads, 1); ++i)
+        workers_.emplace_back(&Server::work, this);
+
+    pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}};
+    while (!stopping_) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break;
+        if (!(fds[0].revents & POLLIN))
+            continue;
+        auto const fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+        int const on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.push_back(fd);
+        cv_.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto const fd : connections_)
+            close(fd);
+        connections_.clear();
+        // workers finish their current request and then see the end of
+        // the connection
+        for (auto const fd : active_connections_)
+            shutdown(fd, SHUT_RD);
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_)
+        worker.join();
+    workers_.clear();
+
+    // consume wake-ups, so that the server can be run again
+    char buffer[16];
+    while (poll(&fds[1], 1, 0) > 0
+           && read(wake_fds_[0], buffer, sizeof(buffer)) > 0) {
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    run_cv_.notify_all();
+}
+
+void Server::stop() {
+    stopping_ = true;
+    char const byte = 0;
+    // only async-signal-safe calls here
+    auto const result = write(wake_fds_[1], &byte, 1);
+    static_cast<void>(result);
+}
+
+void Server::work() {
+    WorkspaceCache cache(model_factory_, options_);
+    while (true) {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock,
+                     [this]() { return stopping_ || !connections_.empty(); });
+            if (stopping_)
+                return;
+            fd = connections_.front();
+            connections_.pop_front();
+            active_connections_.push_back(fd);
+        }
+
+        serveConnection(fd, cache);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_connections_.erase(std::find(active_connections_.begin(),
+                                                active_connections_.end(),
+                                                fd));
+        }
+        close(fd);
+    }
+}
+
+Client::Client(std::string const &socket_path) {
+    auto const address = socketAddress(socket_path);
+    fd_ = createSocket();
+    if (!connectSocket(fd_, address)) {
+        auto const message = errnoMessage();
+        close(fd_);
+        throw AmiException("Failed to connect to %s: %s", socket_path.c_str(),
+                           message.c_str());
+    }
+}
+
+Client::~Client() { close(fd_); }
+
+std::vector<std::unique_ptr<ReturnData>>
+Client::simulate(Request const &request) {
+    std::vector<std::unique_ptr<ReturnData>> results(
+        std::max<std::size_t>(request.edatas.size(), 1));
+    simulate(request, [&results](int index, std::unique_ptr<ReturnData> rdata) {
+        results.at(index) = std::move(rdata);
+    });
+    return results;
+}
+
+void Client::simulate(
+    Request const &request,
+    std::function<void(int, std::unique_ptr<ReturnData>)> const &consumer) {
+    writeFrame(fd_, encodeRequest(request));
+
+    std::string payload;
+    while (true) {
+        if (!readFrame(fd_, payload))
+            throw AmiException("Connection closed by the server.");
+        Decoder response(payload);
+        switch (static_cast<ResponseType>(response.u8())) {
+        case ResponseType::result: {
+            auto const index = static_cast<int>(response.u32());
+            auto rdata = std::make_unique<ReturnData>();
+            deserializeFromString(response.str(), *rdata);
+            consumer(index, std::move(rdata));
+            break;
+        }
+        case ResponseType::end:
+            return;
+        case ResponseType::error:
+            throw AmiException("Simulation server: %s",
+                               response.str().c_str());
+        default:
+            throw AmiException("Invalid response from simulation server.");
+        }
+    }
+}
+
+} // namespace serve
+} // namespace amici
@@ -3,8 +3,10 @@
 #include "amici/exception.h"
 #include "amici/misc.h"
 #include "amici/model.h"
+#include "amici/profiling.h"
 #include "amici/rdata.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
@@ -21,6 +23,8 @@ Solver::Solver(const Solver &other)
     : ism_(other.ism_), lmm_(other.lmm_), iter_(other.iter_),
       interp_type_(other.interp_type_), maxsteps_(other.maxsteps_),
       maxtime_(other.maxtime_), starttime_(other.starttime_),
+      profiling_(other.profiling_),
+      cancellation_token_(other.cancellation_token_),
       sensi_meth_(other.sensi_meth_), sensi_meth_preeq_(other.sensi_meth_preeq_),
       stldet_(other.stldet_), ordering_(other.ordering_),
       newton_maxsteps_(other.newton_maxsteps_),
@@ -34,6 +38,8 @@ Solver::Solver(const Solver &other)
       ss_tol_sensi_factor_(other.ss_tol_sensi_factor_),
       ss_atol_sensi_(other.ss_atol_sensi_),
       ss_rtol_sensi_(other.ss_rtol_sensi_), rdata_mode_(other.rdata_mode_),
+      rdata_fields_(other.rdata_fields_),
+      rdata_trajectory_its_(other.rdata_trajectory_its_),
       newton_step_steadystate_conv_(other.newton_step_steadystate_conv_),
       check_sensi_steadystate_conv_(other.check_sensi_steadystate_conv_),
       maxstepsB_(other.maxstepsB_), sensi_(other.sensi_)
@@ -65,9 +71,46 @@ void Solver::apply_max_num_steps_B() const {
     }
 }
 
+bool Solver::pollInterrupt() const {
+    long int steps = 0;
+    if (solver_memory_) {
+        long int cursteps;
+        getNumSteps(solver_memory_.get(), &cursteps);
+        // counter is reset on reinitialization
+        if (cursteps < steps_at_poll_)
+            steps_at_poll_ = 0;
+        steps = cursteps - steps_at_poll_;
+        steps_at_poll_ = cursteps;
+    }
+    auto rhs_evaluations = rhs_evaluations_since_poll_;
+    rhs_evaluations_since_poll_ = 0;
+
+    if (cancellation_token_
+        && cancellation_token_->charge(rhs_evaluations, steps))
+        return true;
+    return timeExceeded();
+}
+
+void Solver::checkInterrupt(bool backward) const {
+    if (!pollInterrupt())
+        return;
+    if (backward)
+        throw IntegrationFailureB(getInterruptStatus(), t_);
+    throw IntegrationFailure(getInterruptStatus(), t_);
+}
+
+int Solver::getInterruptStatus() const {
+    if (cancellation_token_ && cancellation_token_->isCancelled())
+        return cancellation_token_->getStatus();
+    if (timeExceeded())
+        return AMICI_MAX_TIME_EXCEEDED;
+    return AMICI_SUCCESS;
+}
+
 int Solver::run(const realtype tout) const {
+    checkInterrupt(false);
     setStopTime(tout);
-    clock_t starttime = clock();
+    CpuTimer timer;
     int status = AMICI_SUCCESS;
 
     apply_max_num_steps();
@@ -80,11 +123,13 @@ int Solver::run(const realtype tout) const {
     } else {
         t_ = tout;
     }
-    cpu_time_ += (realtype)((clock() - starttime) * 1000) / CLOCKS_PER_SEC;
+    cpu_time_ += timer.elapsedMilliseconds();
+    wall_time_ += timer.elapsedWallMilliseconds();
     return status;
 }
 
 int Solver::step(const realtype tout) const {
+    checkInterrupt(false);
     int status = AMICI_SUCCESS;
 
     apply_max_num_steps();
@@ -101,13 +146,15 @@ int Solver::step(const realtype tout) const {
 }
 
 void Solver::runB(const realtype tout) const {
-    clock_t starttime = clock();
+    checkInterrupt(true);
+    CpuTimer timer;
 
     apply_max_num_steps_B();
     if (nx() > 0) {
         solveB(tout, AMICI_NORMAL);
     }
-    cpu_timeB_ += (realtype)((clock() - starttime) * 1000) / CLOCKS_PER_SEC;
+    cpu_timeB_ += timer.elapsedMilliseconds();
+    wall_timeB_ += timer.elapsedWallMilliseconds();
     t_ = tout;
 }
 
@@ -379,6 +426,9 @@ void Solver::initializeLinearSolver(const Model *model) const {
         throw AmiException("Invalid choice of solver: %d",
                            static_cast<int>(linsol_));
     }
+
+    if (linear_solver_)
+        instrumentLinearSolver(linear_solver_->get());
 }
 
 void Solver::initializeNonLinearSolver() const {
@@ -468,6 +518,9 @@ void Solver::initializeLinearSolverB(const Model *model,
         throw AmiException("Invalid choice of solver: %d",
                            static_cast<int>(linsol_));
     }
+
+    if (linear_solver_B_)
+        instrumentLinearSolver(linear_solver_B_->get());
 }
 
 void Solver::initializeNonLinearSolverB(const int which) const {
@@ -503,6 +556,7 @@ bool operator==(const Solver &a, const Solver &b) {
            (a.maxsteps_ == b.maxsteps_) && (a.maxstepsB_ == b.maxstepsB_) &&
            (a.quad_atol_ == b.quad_atol_) && (a.quad_rtol_ == b.quad_rtol_) &&
            (a.maxtime_ == b.maxtime_) &&
+           (a.profiling_ == b.profiling_) &&
            (a.getAbsoluteToleranceSteadyState() ==
             b.getAbsoluteToleranceSteadyState()) &&
            (a.getRelativeToleranceSteadyState() ==
@@ -520,7 +574,9 @@ bool operator==(const Solver &a, const Solver &b) {
            (a.sensi_ == b.sensi_) && (a.sensi_meth_ == b.sensi_meth_) &&
            (a.newton_step_steadystate_conv_ == b.newton_step_steadystate_conv_) &&
            (a.check_sensi_steadystate_conv_ == b.check_sensi_steadystate_conv_) &&
-           (a.rdata_mode_ == b.rdata_mode_);
+           (a.rdata_mode_ == b.rdata_mode_) &&
+           (a.rdata_fields_ == b.rdata_fields_) &&
+           (a.rdata_trajectory_its_ == b.rdata_trajectory_its_);
 }
 
 void Solver::applyTolerances() const {
@@ -864,12 +920,36 @@ void Solver::setMaxTime(double maxtime)
 
 void Solver::startTimer() const
 {
-    starttime_ = std::chrono::system_clock::now();
+    starttime_ = std::chrono::steady_clock::now();
+    cpu_time_ = 0.0;
+    cpu_timeB_ = 0.0;
+    wall_time_ = 0.0;
+    wall_timeB_ = 0.0;
 }
 
 bool Solver::timeExceeded() const
 {
-    return std::chrono::system_clock::now() - starttime_ > maxtime_;
+    return std::chrono::steady_clock::now() - starttime_ > maxtime_;
+}
+
+void Solver::setProfiling(bool profiling)
+{
+    profiling_ = profiling;
+}
+
+bool Solver::getProfiling() const
+{
+    return profiling_;
+}
+
+void Solver::setCancellationToken(CancellationToken *token)
+{
+    cancellation_token_ = token;
+}
+
+CancellationToken *Solver::getCancellationToken() const
+{
+    return cancellation_token_;
 }
 
 void Solver::setMaxSteps(const long int maxsteps) {
@@ -980,6 +1060,26 @@ void Solver::setReturnDataReportingMode(RDataReporting rdrm) {
     rdata_mode_ = rdrm;
 }
 
+int Solver::getReturnDataFields() const {
+    return rdata_fields_;
+}
+
+void Solver::setReturnDataFields(int fields) {
+    if (fields & ~static_cast<int>(RDataField::all))
+        throw AmiException("Invalid ReturnData field mask %d", fields);
+    rdata_fields_ = fields;
+}
+
+std::vector<int> const &Solver::getReturnDataTrajectoryTimepoints() const {
+    return rdata_trajectory_its_;
+}
+
+void Solver::setReturnDataTrajectoryTimepoints(std::vector<int> const &its) {
+    if (std::any_of(its.begin(), its.end(), [](int it) { return it < 0; }))
+        throw AmiException("Timepoint indices must be non-negative");
+    rdata_trajectory_its_ = its;
+}
+
 void Solver::initializeNonLinearSolverSens(const Model *model) const {
     switch (iter_) {
     case NonlinearSolverIteration::newton:
@@ -1078,6 +1178,14 @@ realtype Solver::getCpuTimeB() const {
     return cpu_timeB_;
 }
 
+realtype Solver::getWallTime() const {
+    return wall_time_;
+}
+
+realtype Solver::getWallTimeB() const {
+    return wall_timeB_;
+}
+
 void Solver::resetMutableMemory(const int nx, const int nplist,
                                 const int nquad) const {
     solver_memory_ = nullptr;
@@ -1257,6 +1365,10 @@ void wrapErrHandlerFn(int error_code, const char *module,
         throw std::runtime_error("eh_data unset");
     }
     auto solver = static_cast<Solver const*>(eh_data);
+    // failure was caused by the user cancelling the simulation
+    if (solver->getCancellationToken()
+        && solver->getCancellationToken()->isCancelled())
+        return;
     solver->app->warning(buffid, buffer);
 }
 
@@ -311,8 +311,8 @@ void IDASolver::setStabLimDetB(const int /*which*/,
 
 void IDASolver::setId(const Model *model) const {
 
-    N_Vector id = N_VMake_Serial(model->nx_solver,
-                                 const_cast<realtype *>(model->idlist.data()));
+    N_Vector id = N_VMake_Serial(
+        model->nx_solver, const_cast<realtype *>(model->getIdList().data()));
 
     int status = IDASetId(solver_memory_.get(), id);
     if (status != IDA_SUCCESS)
@@ -1051,7 +1051,7 @@ int fxdot(realtype t, N_Vector x, N_Vector dx, N_Vector xdot,
     auto solver = dynamic_cast<IDASolver const*>(typed_udata->second);
     Expects(model);
 
-    if(solver->timeExceeded()) {
+    if(solver->interrupted()) {
         return AMICI_MAX_TIME_EXCEEDED;
     }
 
@@ -1087,7 +1087,7 @@ int fxBdot(realtype t, N_Vector x, N_Vector dx, N_Vector xB,
     auto solver = dynamic_cast<IDASolver const*>(typed_udata->second);
     Expects(model);
 
-    if(solver->timeExceeded()) {
+    if(solver->interrupted()) {
         return AMICI_MAX_TIME_EXCEEDED;
     }
 
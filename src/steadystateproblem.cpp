@@ -6,6 +6,8 @@
 #include "amici/misc.h"
 #include "amici/model.h"
 #include "amici/newton_solver.h"
+#include "amici/profiling.h"
+#include "amici/trace.h"
 #include "amici/solver.h"
 #include "amici/solver_cvodes.h"
 
@@ -60,9 +62,10 @@ void SteadystateProblem::workSteadyStateProblem(const Solver &solver,
     initializeForwardProblem(it, solver, model);
 
     /* Compute steady state, track computation time */
-    clock_t starttime = clock();
+    CpuTimer timer;
     findSteadyState(solver, model, it);
-    cpu_time_ = (double)((clock() - starttime) * 1000) / CLOCKS_PER_SEC;
+    cpu_time_ = timer.elapsedMilliseconds();
+    wall_time_ = timer.elapsedWallMilliseconds();
 
     /* Check whether state sensis still need to be computed */
     if (getSensitivityFlag(model, solver, it,
@@ -81,14 +84,17 @@ void SteadystateProblem::workSteadyStateProblem(const Solver &solver,
 
 void SteadystateProblem::workSteadyStateBackwardProblem(
     const Solver &solver, Model &model, const BackwardProblem *bwd) {
+    AMICI_PROFILE_SCOPE(steadystateBackward);
+    TraceScope trace_scope("steadystateBackward");
 
     if (!initializeBackwardProblem(solver, model, bwd))
         return;
 
     /* compute quadratures, track computation time */
-    clock_t starttime = clock();
+    CpuTimer timer;
     computeSteadyStateQuadrature(solver, model);
-    cpu_timeB_ = (double)((clock() - starttime) * 1000) / CLOCKS_PER_SEC;
+    cpu_timeB_ = timer.elapsedMilliseconds();
+    wall_timeB_ = timer.elapsedWallMilliseconds();
 }
 
 void SteadystateProblem::findSteadyState(const Solver &solver, Model &model,
@@ -119,6 +125,9 @@ void SteadystateProblem::findSteadyState(const Solver &solver, Model &model,
 
 void SteadystateProblem::findSteadyStateByNewtonsMethod(Model &model,
                                                         bool newton_retry) {
+    AMICI_PROFILE_SCOPE(newtonsMethod);
+    TraceScope trace_scope(newton_retry ? "newtonsMethodRetry"
+                                        : "newtonsMethod");
     int ind = newton_retry ? 2 : 0;
     try {
         applyNewtonsMethod(model, newton_retry);
@@ -148,6 +157,8 @@ void SteadystateProblem::findSteadyStateByNewtonsMethod(Model &model,
 
 void SteadystateProblem::findSteadyStateBySimulation(const Solver &solver,
                                                      Model &model, int it) {
+    AMICI_PROFILE_SCOPE(steadystateSimulation);
+    TraceScope trace_scope("steadystateSimulation");
     try {
         if (it < 0) {
             /* Preequilibration? -> Create a new solver instance for sim */
@@ -176,6 +187,9 @@ void SteadystateProblem::findSteadyStateBySimulation(const Solver &solver,
             steady_state_status_[1] = SteadyStateStatus::failed;
         }
     } catch (AmiException const &ex) {
+        // no point in retrying if the simulation was interrupted
+        if (solver.getInterruptStatus() != AMICI_SUCCESS)
+            throw;
         model.app->warningF("AMICI:equilibration",
                              "AMICI equilibration failed: %s\n", ex.what());
         steady_state_status_[1] = SteadyStateStatus::failed;
@@ -745,11 +759,11 @@ void SteadystateProblem::computeQBfromQ(Model &model, const AmiVector &yQ,
 
     /* set to zero first, as multiplication adds to existing value */
     yQB.zero();
+    /* fill dxdotdp with current values, allocates it on first use */
+    model.fdxdotdp(state_.t, state_.x, state_.dx);
     /* multiply */
     if (model.pythonGenerated) {
-        /* fill dxdotdp with current values */
         const auto &plist = model.getParameterList();
-        model.fdxdotdp(state_.t, state_.x, state_.dx);
         model.get_dxdotdp_full().multiply(yQB.getNVector(), yQ.getNVector(),
                                            plist, true);
     } else {
@@ -0,0 +1,201 @@
+#include "amici/trace.h"
+
+#include "amici/exception.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace amici {
+
+std::atomic<TraceRecorder *> active_trace_recorder {nullptr};
+
+/** source of TraceRecorder ids */
+static std::atomic<std::uint64_t> next_trace_recorder_id {1};
+
+/**
+ * @brief Events of a single thread. Only the owning thread writes, readers
+ * must make sure that no events are being recorded.
+ */
+struct TraceRecorder::ThreadBuffer {
+    ThreadBuffer(std::size_t capacity, int thread)
+        : events(capacity), thread(thread) {}
+
+    /** ring buffer */
+    std::vector<TraceEvent> events;
+    /** total number of events recorded */
+    std::atomic<std::size_t> count {0};
+    /** thread index */
+    int thread;
+};
+
+/** buffer of the current thread for the recorder with the given id */
+struct ThreadBufferCache {
+    std::uint64_t recorder_id {0};
+    void *buffer {nullptr};
+};
+
+static thread_local ThreadBufferCache thread_buffer_cache;
+
+TraceRecorder::TraceRecorder(std::size_t capacity)
+    : id_(next_trace_recorder_id++),
+      capacity_(std::max<std::size_t>(capacity, 1)),
+      epoch_(std::chrono::steady_clock::now()) {}
+
+TraceRecorder::~TraceRecorder() {
+    auto self = this;
+    active_trace_recorder.compare_exchange_strong(self, nullptr);
+}
+
+TraceRecorder::ThreadBuffer &TraceRecorder::getThreadBuffer() {
+    auto &cache = thread_buffer_cache;
+    if (cache.recorder_id != id_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.emplace_back(std::make_unique<ThreadBuffer>(
+            capacity_, static_cast<int>(buffers_.size())));
+        cache.recorder_id = id_;
+        cache.buffer = buffers_.back().get();
+    }
+    return *static_cast<ThreadBuffer *>(cache.buffer);
+}
+
+void TraceRecorder::record(char const *name,
+                           std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end,
+                           std::string const &arg) {
+    auto &buffer = getThreadBuffer();
+    auto count = buffer.count.load(std::memory_order_relaxed);
+    auto &event = buffer.events[count % capacity_];
+    event.name = name;
+    event.arg = arg;
+    event.start =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch_)
+            .count();
+    event.duration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count();
+    event.thread = buffer.thread;
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+std::vector<TraceEvent> TraceRecorder::getEvents() const {
+    std::vector<TraceEvent> events;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const &buffer : buffers_) {
+        auto count = buffer->count.load(std::memory_order_acquire);
+        auto n = std::min(count, capacity_);
+        for (auto i = count - n; i < count; ++i)
+            events.push_back(buffer->events[i % capacity_]);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](TraceEvent const &a, TraceEvent const &b) {
+                         return a.start < b.start;
+                     });
+    return events;
+}
+
+std::size_t TraceRecorder::getNumDropped() const {
+    std::size_t dropped = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const &buffer : buffers_) {
+        auto count = buffer->count.load(std::memory_order_acquire);
+        if (count > capacity_)
+            dropped += count - capacity_;
+    }
+    return dropped;
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const &buffer : buffers_)
+        buffer->count = 0;
+}
+
+/**
+ * @brief Write a string as JSON string literal
+ * @param os output stream
+ * @param str string
+ */
+static void writeJSONString(std::ostream &os, std::string const &str) {
+    os << '"';
+    for (auto c : str) {
+        switch (c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        case '\t':
+            os << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << static_cast<int>(c) << std::dec << std::setfill(' ');
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+void TraceRecorder::writeChromeTrace(std::ostream &os) const {
+    auto events = getEvents();
+    int num_threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_threads = static_cast<int>(buffers_.size());
+    }
+
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    os << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+          "\"args\": {\"name\": \"AMICI\"}}";
+    for (int thread = 0; thread < num_threads; ++thread) {
+        os << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+              "\"tid\": "
+           << thread << ", \"args\": {\"name\": \"thread " << thread
+           << "\"}}";
+    }
+    // timestamps and durations in microseconds
+    for (auto const &event : events) {
+        os << ",\n{\"name\": ";
+        writeJSONString(os, event.name);
+        os << ", \"cat\": \"amici\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+           << event.thread << ", \"ts\": " << event.start / 1000.0
+           << ", \"dur\": " << event.duration / 1000.0;
+        if (!event.arg.empty()) {
+            os << ", \"args\": {\"id\": ";
+            writeJSONString(os, event.arg);
+            os << "}";
+        }
+        os << "}";
+    }
+    os << "\n]}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void TraceRecorder::writeChromeTrace(std::string const &filename) const {
+    std::ofstream file(filename);
+    if (!file)
+        throw AmiException("Failed to open %s for writing.", filename.c_str());
+    writeChromeTrace(file);
+    if (!file)
+        throw AmiException("Failed to write trace to %s.", filename.c_str());
+}
+
+void setTraceRecorder(TraceRecorder *recorder) {
+    active_trace_recorder = recorder;
+}
+
+TraceRecorder *getTraceRecorder() { return active_trace_recorder; }
+
+} // namespace amici
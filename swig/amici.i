@@ -92,6 +92,7 @@ import_array();
 static_assert (sizeof(double) == sizeof (npy_double), "Numpy double size mismatch");
 static_assert (sizeof(int) == sizeof (npy_int), "Numpy integer size mismatch");
 
+#include "amici/rdata.h"
 #include "../swig/stdvec2numpy.h"
 using namespace amici;
 %}
@@ -137,12 +138,17 @@ wrap_unique_ptr(ExpDataPtr, amici::ExpData)
 %include model.i
 %include model_ode.i
 %include model_dae.i
+%include model_ode_bytecode.i
 %include rdata.i
 
 #ifndef AMICI_SWIG_WITHOUT_HDF5
 %include hdf5.i
 #endif
 
+#ifndef AMICI_SWIG_WITHOUT_BOOST_SERIALIZATION
+%include serialization.i
+#endif
+
 // Return Python list of raw pointers instead of std::vector<std::unique_ptr> which is a huge pain
 %typemap(out) std::vector<std::unique_ptr<amici::ReturnData>> %{
     $result = PyList_New($1.size());
@@ -165,9 +171,108 @@ using namespace amici;
 %ignore std::vector<std::unique_ptr<amici::ReturnData>>;
 %template(ReturnDataPtrVector) std::vector<std::unique_ptr<amici::ReturnData>>;
 
+// std::future can't be wrapped, see SimulationHandle below
+%ignore amici::SimulationWorkerPool;
+%ignore amici::defaultSimulationWorkerPool;
+%ignore amici::submitSimulation;
+%ignore amici::submitSimulations;
+
 // Process symbols in header
 %include "amici/amici.h"
 
+// Handle for asynchronous simulations, wrapped as concurrent.futures.Future
+// in amici.swig_wrappers.submitSimulation(s). All functions are called with
+// the GIL released (-threads). Completed simulations are reported by handle
+// id via _nextCompletedSimulation, in the order they complete.
+%{
+#include <atomic>
+
+namespace amici {
+class SimulationHandle {
+  public:
+    SimulationHandle(long id,
+                     std::future<std::unique_ptr<ReturnData>> future)
+        : id_(id), future_(std::move(future)) {}
+
+    long id() const { return id_; }
+
+    bool ready() const {
+        return future_.wait_for(std::chrono::seconds(0))
+               == std::future_status::ready;
+    }
+
+    bool wait(double timeout) const {
+        return future_.wait_for(std::chrono::duration<double>(timeout))
+               == std::future_status::ready;
+    }
+
+    std::unique_ptr<ReturnData> get() { return future_.get(); }
+
+  private:
+    long id_;
+    std::future<std::unique_ptr<ReturnData>> future_;
+};
+
+namespace {
+/** ids of completed simulations, not yet taken by _nextCompletedSimulation */
+std::deque<long> completed_simulations;
+std::mutex completed_simulations_mutex;
+std::condition_variable completed_simulations_cv;
+} // namespace
+
+SimulationHandle *_submitSimulation(Solver const &solver,
+                                    ExpData const *edata,
+                                    Model const &model) {
+    static std::atomic<long> next_id{0};
+    auto const id = next_id++;
+    auto future = defaultSimulationWorkerPool().submit(
+        solver, edata, model, [id]() {
+            {
+                std::lock_guard<std::mutex> lock(completed_simulations_mutex);
+                completed_simulations.push_back(id);
+            }
+            completed_simulations_cv.notify_one();
+        });
+    return new SimulationHandle(id, std::move(future));
+}
+
+long _nextCompletedSimulation() {
+    std::unique_lock<std::mutex> lock(completed_simulations_mutex);
+    completed_simulations_cv.wait(
+        lock, []() { return !completed_simulations.empty(); });
+    auto const id = completed_simulations.front();
+    completed_simulations.pop_front();
+    return id;
+}
+} // namespace amici
+%}
+
+namespace amici {
+%feature("docstring") SimulationHandle
+"Handle of a simulation running on the AMICI worker pool. Use
+:func:`amici.swig_wrappers.submitSimulation` instead of creating it
+directly.";
+class SimulationHandle {
+  public:
+    long id() const;
+    bool ready() const;
+    bool wait(double timeout) const;
+    std::unique_ptr<ReturnData> get();
+  private:
+    SimulationHandle();
+};
+
+%newobject _submitSimulation;
+SimulationHandle *_submitSimulation(Solver const &solver,
+                                    ExpData const *edata,
+                                    Model const &model);
+
+%feature("docstring") _nextCompletedSimulation
+"Block until a simulation submitted via _submitSimulation completed or was
+cancelled, and return the id of its handle.";
+long _nextCompletedSimulation();
+} // namespace amici
+
 // Expose vectors
 %template(ExpDataPtrVector) std::vector<amici::ExpData*>;
 
@@ -247,6 +352,7 @@ SteadyStateStatus = enum('SteadyStateStatus')
 NewtonDampingFactorMode = enum('NewtonDampingFactorMode')
 FixedParameterContext = enum('FixedParameterContext')
 RDataReporting = enum('RDataReporting')
+RDataField = enum('RDataField')
 %}
 
 %template(SteadyStateStatusVector) std::vector<amici::SteadyStateStatus>;
@@ -7,6 +7,10 @@ using namespace amici;
 %}
 
 %ignore ConditionContext;
+%ignore amici::ExpData::getObservedDataIndices(int) const;
+%ignore amici::ExpData::getObservedDataValues;
+%ignore amici::ExpData::getObservedDataStdDevValues;
+%ignore amici::ExpData::getObservedDataPtr(int, std::vector<realtype> &) const;
 
 // Process symbols in header
 %include "amici/edata.h"
@@ -3,10 +3,17 @@
 %rename("$ignore", regextarget=1, fullname=1) "amici::hdf5::.*$";
 %rename("%s") amici::hdf5::readModelDataFromHDF5;
 %rename("%s") amici::hdf5::readSimulationExpData;
+%rename("%s") amici::hdf5::readSimulationExpDatas;
 %rename("%s") amici::hdf5::readSolverSettingsFromHDF5;
 %rename("%s") amici::hdf5::writeReturnData;
 %rename("%s") amici::hdf5::writeSimulationExpData;
+%rename("%s") amici::hdf5::writeSimulationExpDatas;
 %rename("%s") amici::hdf5::writeSolverSettingsToHDF5;
+%rename("%s") amici::hdf5::ReturnDataBatchWriter;
+%rename("%s") amici::hdf5::ReturnDataBatchWriter::ReturnDataBatchWriter;
+%rename("%s") amici::hdf5::ReturnDataBatchWriter::~ReturnDataBatchWriter;
+%rename("%s") amici::hdf5::ReturnDataBatchWriter::append;
+%rename("%s") amici::hdf5::ReturnDataBatchWriter::close;
 
 // Add necessary symbols to generated header
 %{
@@ -16,5 +23,14 @@ using namespace amici;
 #endif
 %}
 
+// Return Python list of owning ExpData instead of std::vector<std::unique_ptr>
+%typemap(out) std::vector<std::unique_ptr<amici::ExpData>> %{
+    $result = PyList_New($1.size());
+    for (int i = 0; i < (int) $1.size(); i++) {
+        PyObject *o = SWIG_NewPointerObj($1.at(i).release(), $descriptor(amici::ExpData*), SWIG_POINTER_OWN);
+        PyList_SetItem($result, i, o);
+    }
+%}
+
 // Process symbols in header
 %include "amici/hdf5.h"
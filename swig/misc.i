@@ -13,3 +13,18 @@ using namespace amici;
 
 // Process symbols in header
 %include "amici/misc.h"
+
+%{
+#include "amici/trace.h"
+%}
+
+%ignore amici::active_trace_recorder;
+%ignore amici::TraceScope;
+%ignore amici::TraceRecorder::record;
+%ignore amici::TraceRecorder::writeChromeTrace(std::ostream &) const;
+%feature("docstring") amici::setTraceRecorder
+"Activate a recorder for all simulations in this process, or disable tracing
+by passing None. The recorder is not owned, keep a reference as long as it is
+active.";
+%include "amici/trace.h"
+%template(TraceEventVector) std::vector<amici::TraceEvent>;
@@ -38,6 +38,7 @@ using namespace amici;
 %ignore initializeStateSensitivities;
 %ignore initializeStates;
 %ignore ModelState;
+%ignore ModelDefinition;
 %ignore getModelState;
 %ignore setModelState;
 %ignore fx0;
@@ -0,0 +1,18 @@
+%module model_ode_bytecode
+
+// Add necessary symbols to generated header
+%{
+#include "amici/model_ode_bytecode.h"
+using namespace amici;
+%}
+
+// Only expose the loader, models are used through the Model interface
+%feature("docstring") amici::loadBytecodeModel
+"Load a model from bytecode written by :mod:`amici.bytecode`.
+
+:param filename: bytecode file, usually ``<model_name>.amici_bytecode``
+:returns: model instance";
+
+namespace amici {
+std::unique_ptr<Model> loadBytecodeModel(std::string const &filename);
+} // namespace amici
@@ -3,11 +3,23 @@
 // Add necessary symbols to generated header
 %{
 #include "amici/rdata.h"
+#include "amici/profiling.h"
 using namespace amici;
 %}
 
 %ignore processSimulationObjects;
 %ignore ModelContext;
+%ignore amici::ReturnDataConsumer::consume;
+%ignore amici::ReturnDataArena::consume;
+%ignore amici::ReturnDataArena::getStorage;
+%feature("notabstract") amici::ReturnDataArena;
+
+%ignore amici::Profile;
+%ignore amici::ProfileContext;
+%ignore amici::ProfileScope;
+%ignore amici::getCurrentProfile;
+%ignore amici::instrumentLinearSolver;
 
 // Process symbols in header
+%include "amici/profiling.h"
 %include "amici/rdata.h"
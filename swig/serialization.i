@@ -0,0 +1,70 @@
+%module serialization
+
+// Add necessary symbols to generated header
+%{
+#ifndef AMICI_SWIG_WITHOUT_BOOST_SERIALIZATION
+#include "amici/serialization.h"
+using namespace amici;
+#endif
+%}
+
+// These create Python objects and must hold the GIL
+%feature("nothread") amici::serializeToBytes;
+%feature("nothread") amici::deserializeFromBytes;
+%newobject amici::deserializeFromBytes;
+
+%inline %{
+namespace amici {
+
+/**
+ * @brief Serialize object to Python bytes (see amici::serializeToString)
+ * @param data input object
+ * @return New reference to a bytes object
+ */
+template <typename T>
+PyObject *serializeToBytes(T const& data) {
+    auto serialized = serializeToString(data);
+    return PyBytes_FromStringAndSize(serialized.data(), serialized.size());
+}
+
+/**
+ * @brief Deserialize object that has been serialized using
+ * amici::serializeToBytes
+ * @param bytes bytes object
+ * @return The deserialized object
+ */
+template <typename T>
+T *deserializeFromBytes(PyObject *bytes) {
+    char *buffer;
+    Py_ssize_t size;
+    if (PyBytes_AsStringAndSize(bytes, &buffer, &size) == -1) {
+        PyErr_Clear();
+        throw AmiException("Expected bytes");
+    }
+    auto data = std::make_unique<T>();
+    deserializeFromChar(buffer, static_cast<int>(size), *data);
+    return data.release();
+}
+
+} // namespace amici
+%}
+
+%template(_expDataToBytes) amici::serializeToBytes<amici::ExpData>;
+%template(_expDataFromBytes) amici::deserializeFromBytes<amici::ExpData>;
+%template(_returnDataToBytes) amici::serializeToBytes<amici::ReturnData>;
+%template(_returnDataFromBytes) amici::deserializeFromBytes<amici::ReturnData>;
+
+// Pickle through the boost binary archive instead of element-wise copies
+%extend amici::ExpData {
+%pythoncode %{
+def __reduce__(self):
+    return _expDataFromBytes, (_expDataToBytes(self),)
+%}
+};
+
+%extend amici::ReturnData {
+%pythoncode %{
+def __reduce__(self):
+    return _returnDataFromBytes, (_returnDataToBytes(self),)
+%}
+};
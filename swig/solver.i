@@ -6,6 +6,12 @@
 using namespace amici;
 %}
 
+%feature("docstring") amici::Solver::setCancellationToken
+"Set the token for cooperative cancellation of simulations using this solver
+or any of its clones. The token is not owned by the solver, keep a reference
+as long as it is in use.";
+%include "amici/cancellation.h"
+
 %rename(equals) operator==;
 
 // remove functions that use AmiVector(Array) since that class anyways cannot
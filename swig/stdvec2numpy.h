@@ -125,4 +125,111 @@ PyObject* stdVec2ndarray(std::vector<int>& vec, int dim1, int dim2, int dim3, in
     return array;
 }
 
+#ifndef SWIG
+/**
+ * @brief Create a read-only ndarray that shares memory with vec and keeps
+ * owner alive
+ * @param vec data
+ * @param dims array dimensions (row-major)
+ * @param typenum numpy type of the vector elements
+ * @param owner Python object that keeps vec alive
+ * @return ndarray
+ */
+template <typename T>
+PyObject* stdVec2ndarrayViewImpl(std::vector<T>& vec,
+                                 std::vector<int> const& dims,
+                                 int typenum, PyObject* owner) {
+    std::vector<npy_intp> npdims(dims.begin(), dims.end());
+    npy_intp size = 1;
+    for (auto dim: npdims)
+        size *= dim;
+    if (vec.size() != static_cast<std::size_t>(size))
+        throw std::runtime_error("Size mismatch in stdVec2ndarrayView");
+    PyObject * array = PyArray_SimpleNewFromData(
+        static_cast<int>(npdims.size()), npdims.data(), typenum, vec.data());
+    if (!array)
+        throw std::runtime_error("Unknown failure in stdVec2ndarrayView");
+    PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(array),
+                       NPY_ARRAY_WRITEABLE);
+    // the array steals this reference
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(array),
+                              owner) < 0) {
+        Py_DECREF(array);
+        throw std::runtime_error("Failed to set base in stdVec2ndarrayView");
+    }
+    return array;
+}
+#endif
+
+/**
+ * @brief Convert row-major flattened array to read-only numpy ndarray that
+ * shares memory with the vector without copying. The array holds a reference to
+ * owner, which has to keep the vector alive.
+ * @param vec data
+ * @param dims array dimensions
+ * @param owner Python object that keeps vec alive, e.g. the wrapper of the
+ * object that has vec as member
+ * @return ndarray
+ */
+PyObject* stdVec2ndarrayView(std::vector<double>& vec,
+                             std::vector<int> const& dims, PyObject* owner) {
+    return stdVec2ndarrayViewImpl(vec, dims, NPY_DOUBLE, owner);
+}
+
+/**
+ * @brief Convert row-major flattened array to read-only numpy ndarray that
+ * shares memory with the vector without copying. The array holds a reference to
+ * owner, which has to keep the vector alive.
+ * @param vec data
+ * @param dims array dimensions
+ * @param owner Python object that keeps vec alive, e.g. the wrapper of the
+ * object that has vec as member
+ * @return ndarray
+ */
+PyObject* stdVec2ndarrayView(std::vector<int>& vec,
+                             std::vector<int> const& dims, PyObject* owner) {
+    return stdVec2ndarrayViewImpl(vec, dims, NPY_INT, owner);
+}
+
+#ifndef SWIG
+/**
+ * @brief Releases the storage reference held by a PyCapsule
+ * @param capsule capsule created by returnDataArenaStorageView
+ */
+inline void releaseArenaStorage(PyObject* capsule) {
+    delete static_cast<std::shared_ptr<std::vector<double>>*>(
+        PyCapsule_GetPointer(capsule, nullptr));
+}
+#endif
+
+/**
+ * @brief Convert the storage of a ReturnDataArena to a read-only 1D numpy
+ * ndarray without copying. The array shares ownership of the storage, so it
+ * stays valid after the arena was reset or destroyed.
+ * @param arena arena holding the results
+ * @return ndarray
+ */
+PyObject* returnDataArenaStorageView(ReturnDataArena const& arena) {
+    auto storage =
+        new std::shared_ptr<std::vector<double>>(arena.getStorage());
+    PyObject* owner = PyCapsule_New(storage, nullptr, releaseArenaStorage);
+    if (!owner) {
+        delete storage;
+        throw std::runtime_error("Failed to create storage owner");
+    }
+    PyObject* array = nullptr;
+    try {
+        array = stdVec2ndarrayViewImpl(
+            **storage, {static_cast<int>((*storage)->size())}, NPY_DOUBLE,
+            owner);
+    } catch (...) {
+        Py_DECREF(owner);
+        throw;
+    }
+    // the array holds its own reference
+    Py_DECREF(owner);
+    return array;
+}
+
 }
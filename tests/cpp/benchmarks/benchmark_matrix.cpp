@@ -0,0 +1,84 @@
+/**
+ * Micro-benchmarks of SUNMatrixWrapper operations used in the Jacobian and
+ * sensitivity computations. Arguments are matrix dimension and the number of
+ * nonzeros per column.
+ */
+#include <amici/sundials_matrix_wrapper.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace {
+
+/**
+ * @brief Create a random sparse square matrix with a fixed number of nonzeros
+ * per column, including the diagonal
+ * @param n dimension
+ * @param nnz_col nonzeros per column
+ * @param seed random seed
+ * @return CSC matrix
+ */
+amici::SUNMatrixWrapper randomSparse(int n, int nnz_col, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> row(0, n - 1);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+
+    amici::SUNMatrixWrapper dense(n, n);
+    dense.zero();
+    for (int icol = 0; icol < n; ++icol) {
+        dense.set_data(icol, icol, value(rng));
+        for (int i = 1; i < nnz_col; ++i)
+            dense.set_data(row(rng), icol, value(rng));
+    }
+    return amici::SUNMatrixWrapper(dense, 0.0, CSC_MAT);
+}
+
+void BM_multiply(benchmark::State &state) {
+    auto const n = static_cast<int>(state.range(0));
+    auto A = randomSparse(n, static_cast<int>(state.range(1)), 0);
+    std::vector<realtype> b(n, 1.0), c(n, 0.0);
+    for (auto _ : state) {
+        A.multiply(c, b);
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.counters["nnz"] = static_cast<double>(A.num_nonzeros());
+}
+
+void BM_sparse_multiply(benchmark::State &state) {
+    auto const n = static_cast<int>(state.range(0));
+    auto const nnz_col = static_cast<int>(state.range(1));
+    auto A = randomSparse(n, nnz_col, 0);
+    auto B = randomSparse(n, nnz_col, 1);
+    // upper bound for the number of nonzeros of the product
+    amici::SUNMatrixWrapper C(
+        n, n, std::min<sunindextype>(n * n, A.num_nonzeros() * nnz_col),
+        CSC_MAT);
+    for (auto _ : state) {
+        A.sparse_multiply(C, B);
+        benchmark::DoNotOptimize(C.data());
+    }
+    state.counters["nnz"] = static_cast<double>(A.num_nonzeros());
+}
+
+void BM_transpose(benchmark::State &state) {
+    auto const n = static_cast<int>(state.range(0));
+    auto A = randomSparse(n, static_cast<int>(state.range(1)), 0);
+    amici::SUNMatrixWrapper C(n, n, A.num_nonzeros(), CSC_MAT);
+    for (auto _ : state) {
+        A.transpose(C, 1.0, n);
+        benchmark::DoNotOptimize(C.data());
+    }
+    state.counters["nnz"] = static_cast<double>(A.num_nonzeros());
+}
+
+} // namespace
+
+BENCHMARK(BM_multiply)->Args({100, 5})->Args({1000, 5})->Args({1000, 50});
+BENCHMARK(BM_sparse_multiply)
+    ->Args({100, 5})
+    ->Args({1000, 5})
+    ->Args({1000, 20});
+BENCHMARK(BM_transpose)->Args({100, 5})->Args({1000, 5})->Args({1000, 50});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+/**
+ * Benchmarks of complete simulations and of the Newton solvers for one of the
+ * test models. Compiled once per model, see CMakeLists.txt.
+ *
+ * Every simulation case corresponds to a test case in testOptions.h5, e.g.
+ * `nosensi`, `sensiforward` or `sensiadjoint`, and is registered as
+ * `<model>/simulate/<case>`. Newton steps are only benchmarked for models with
+ * a non-singular Jacobian at t0 (BENCHMARK_NEWTON).
+ */
+#include "wrapfunctions.h"
+
+#include <amici/amici.h>
+#include <amici/forwardproblem.h>
+#include <amici/exception.h>
+#include <amici/hdf5.h>
+#include <amici/newton_solver.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+/** Load model and solver settings and data of a test case */
+struct TestCase {
+    explicit TestCase(std::string const &path)
+        : model(amici::generic_model::getModel()),
+          solver(model->getSolver()) {
+        amici::hdf5::readModelDataFromHDF5(NEW_OPTION_FILE, *model,
+                                           path + "/options");
+        amici::hdf5::readSolverSettingsFromHDF5(NEW_OPTION_FILE, *solver,
+                                                path + "/options");
+        if (amici::hdf5::locationExists(NEW_OPTION_FILE, path + "/data"))
+            edata = amici::hdf5::readSimulationExpData(NEW_OPTION_FILE,
+                                                       path + "/data", *model);
+    }
+
+    std::unique_ptr<amici::Model> model;
+    std::unique_ptr<amici::Solver> solver;
+    std::unique_ptr<amici::ExpData> edata;
+};
+
+void simulate(benchmark::State &state, std::string const &path) {
+    TestCase test_case(path);
+    long int rhs_evals = 0;
+    for (auto _ : state) {
+        auto rdata = amici::runAmiciSimulation(
+            *test_case.solver, test_case.edata.get(), *test_case.model);
+        if (rdata->status != amici::AMICI_SUCCESS) {
+            state.SkipWithError("simulation failed");
+            break;
+        }
+        // cumulative counts per time point
+        if (!rdata->numrhsevals.empty())
+            rhs_evals += *std::max_element(rdata->numrhsevals.begin(),
+                                           rdata->numrhsevals.end());
+        if (!rdata->numrhsevalsB.empty())
+            rhs_evals += *std::max_element(rdata->numrhsevalsB.begin(),
+                                           rdata->numrhsevalsB.end());
+        benchmark::DoNotOptimize(rdata->llh);
+    }
+    state.counters["rhs_evals"] =
+        benchmark::Counter(static_cast<double>(rhs_evals),
+                           benchmark::Counter::kAvgIterations);
+}
+
+#ifdef BENCHMARK_NEWTON
+/** One Newton step (Jacobian evaluation, factorization and solve) at t0 */
+void newtonStep(benchmark::State &state, std::string const &path,
+                amici::LinearSolver linear_solver) {
+    TestCase test_case(path);
+    auto &model = *test_case.model;
+    test_case.solver->setLinearSolver(linear_solver);
+    auto newton_solver = amici::NewtonSolver::getSolver(*test_case.solver,
+                                                        model);
+
+    amici::SimulationState sim_state;
+    sim_state.t = model.t0();
+    sim_state.x = amici::AmiVector(model.nx_solver);
+    sim_state.dx = amici::AmiVector(model.nx_solver);
+    sim_state.sx = amici::AmiVectorArray(model.nx_solver, model.nplist());
+    amici::AmiVectorArray sdx(model.nx_solver, model.nplist());
+    model.initialize(sim_state.x, sim_state.dx, sim_state.sx, sdx, false);
+    sim_state.state = model.getModelState();
+
+    amici::AmiVector delta(model.nx_solver);
+    try {
+        newton_solver->getStep(delta, model, sim_state);
+    } catch (amici::NewtonFailure const &) {
+        state.SkipWithError("Jacobian is singular at t0");
+        return;
+    }
+    for (auto _ : state) {
+        model.fxdot(sim_state.t, sim_state.x, sim_state.dx, delta);
+        newton_solver->getStep(delta, model, sim_state);
+        benchmark::DoNotOptimize(delta.data());
+    }
+}
+#endif
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string const model_path = std::string("/") + BENCHMARK_MODEL + "/";
+
+    std::istringstream cases(BENCHMARK_CASES);
+    for (std::string test_case; std::getline(cases, test_case, ',');) {
+        benchmark::RegisterBenchmark(
+            (std::string(BENCHMARK_MODEL) + "/simulate/" + test_case).c_str(),
+            simulate, model_path + test_case)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+#ifdef BENCHMARK_NEWTON
+    std::string const newton_case = model_path + "nosensi";
+    benchmark::RegisterBenchmark(
+        (std::string(BENCHMARK_MODEL) + "/newton/dense").c_str(), newtonStep,
+        newton_case, amici::LinearSolver::dense)
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(
+        (std::string(BENCHMARK_MODEL) + "/newton/KLU").c_str(), newtonStep,
+        newton_case, amici::LinearSolver::KLU)
+        ->Unit(benchmark::kMicrosecond);
+#endif
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
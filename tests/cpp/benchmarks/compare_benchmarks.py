@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Compare Google Benchmark JSON results to stored baselines.
+
+For every ``<name>.json`` in the results directory, the median (or, without
+repetitions, the single) real time of each benchmark is compared to the
+baseline in ``<baseline_dir>/<name>.json``. A benchmark regresses if it is
+slower than its baseline by more than the relative tolerance, which defaults
+to ``--tolerance`` and can be overridden per benchmark by a ``tolerance``
+entry in the baseline file.
+
+Exits with status 1 if any benchmark regressed. Run with ``--update`` to
+replace the baselines by the current results.
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Dict
+
+# conversion of time units to nanoseconds
+_TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('baseline_dir', type=Path,
+                        help='Directory with baseline JSON files')
+    parser.add_argument('results_dir', type=Path,
+                        help='Directory with Google Benchmark JSON output')
+    parser.add_argument('--tolerance', type=float, default=0.25,
+                        help='Default relative tolerance (default: 0.25)')
+    parser.add_argument('--update', action='store_true',
+                        help='Write the current results as new baselines')
+    return parser.parse_args()
+
+
+def read_results(filename: Path) -> Dict[str, dict]:
+    """
+    Read median real times from Google Benchmark JSON output.
+
+    :param filename: JSON file written via ``--benchmark_out``
+    :return: ``{benchmark name: {'real_time': ..., 'time_unit': ...}}``
+    """
+    with open(filename) as f:
+        benchmarks = json.load(f)['benchmarks']
+
+    results = {}
+    for benchmark in benchmarks:
+        if benchmark.get('error_occurred'):
+            continue
+        name = benchmark.get('run_name', benchmark['name'])
+        if benchmark.get('run_type') == 'aggregate':
+            if benchmark.get('aggregate_name') != 'median':
+                continue
+        elif name in results:
+            # repetitions without aggregates, keep the first one
+            continue
+        results[name] = {
+            'real_time': benchmark['real_time'],
+            'time_unit': benchmark.get('time_unit', 'ns'),
+        }
+    return results
+
+
+def read_baseline(filename: Path) -> Dict[str, dict]:
+    """
+    Read a baseline file.
+
+    :param filename: baseline JSON file
+    :return: ``{benchmark name: {'real_time': ..., 'time_unit': ..., ...}}``
+    """
+    if not filename.exists():
+        return {}
+    with open(filename) as f:
+        return {b['name']: b for b in json.load(f)['benchmarks']}
+
+
+def write_baseline(filename: Path, results: Dict[str, dict],
+                   previous: Dict[str, dict]) -> None:
+    """
+    Write results as baseline, keeping per-benchmark tolerances.
+
+    :param filename: baseline JSON file
+    :param results: current results
+    :param previous: previous baseline
+    """
+    benchmarks = []
+    for name, result in results.items():
+        entry = {'name': name, **result}
+        if 'tolerance' in previous.get(name, {}):
+            entry['tolerance'] = previous[name]['tolerance']
+        benchmarks.append(entry)
+    filename.parent.mkdir(parents=True, exist_ok=True)
+    with open(filename, 'w') as f:
+        json.dump({'benchmarks': benchmarks}, f, indent=2)
+        f.write('\n')
+
+
+def compare(results: Dict[str, dict], baseline: Dict[str, dict],
+            default_tolerance: float) -> int:
+    """
+    Print comparison of results and baseline.
+
+    :param results: current results
+    :param baseline: baseline
+    :param default_tolerance: relative tolerance if not set in the baseline
+    :return: number of regressions
+    """
+    regressions = 0
+    for name, result in results.items():
+        if name not in baseline:
+            print(f'  {name}: no baseline')
+            continue
+        reference = baseline[name]
+        time = result['real_time'] * _TIME_UNITS[result['time_unit']]
+        reference_time = \
+            reference['real_time'] * _TIME_UNITS[reference['time_unit']]
+        tolerance = reference.get('tolerance', default_tolerance)
+        change = time / reference_time - 1.0
+        if change > tolerance:
+            status = 'REGRESSION'
+            regressions += 1
+        elif change < -tolerance:
+            status = 'improved'
+        else:
+            status = 'ok'
+        print(f'  {name}: {change:+.1%} (tolerance {tolerance:.0%}) {status}')
+    return regressions
+
+
+def main():
+    args = parse_args()
+
+    result_files = sorted(args.results_dir.glob('*.json'))
+    if not result_files:
+        print(f'No results found in {args.results_dir}', file=sys.stderr)
+        sys.exit(1)
+
+    regressions = 0
+    for result_file in result_files:
+        results = read_results(result_file)
+        baseline_file = args.baseline_dir / result_file.name
+        baseline = read_baseline(baseline_file)
+        if args.update:
+            write_baseline(baseline_file, results, baseline)
+            print(f'Updated {baseline_file}')
+            continue
+        print(f'{result_file.stem}:')
+        regressions += compare(results, baseline, args.tolerance)
+
+    if regressions:
+        print(f'{regressions} benchmark(s) regressed.', file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
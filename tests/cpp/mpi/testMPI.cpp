@@ -0,0 +1,125 @@
+#include "testfunctions.h"
+
+#include "wrapfunctions.h"
+#include <amici/mpi.h>
+
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cmath>
+
+class MPITest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+        model = amici::generic_model::getModel();
+        model->setTimepoints({1.0, 10.0, 100.0});
+        solver = model->getSolver();
+        solver->setSensitivityOrder(amici::SensitivityOrder::first);
+        solver->setSensitivityMethod(amici::SensitivityMethod::forward);
+
+        if (rank != 0)
+            return;
+
+        // distinct conditions, more than ranks and not divisible by them
+        auto rdata = amici::runAmiciSimulation(*solver, nullptr, *model);
+        auto k = model->getFixedParameters();
+        for (int i = 0; i < 11; ++i) {
+            edatas.emplace_back(*rdata, 1.0, 0.0);
+            edatas.back().id = std::to_string(i);
+            edatas.back().fixedParameters = k;
+            edatas.back().fixedParameters[0] *= 1.0 + 0.1 * i;
+        }
+        for (auto& edata : edatas)
+            edata_ptrs.push_back(&edata);
+    }
+
+    int rank {0};
+    std::unique_ptr<amici::Model> model;
+    std::unique_ptr<amici::Solver> solver;
+    std::vector<amici::ExpData> edatas;
+    std::vector<amici::ExpData*> edata_ptrs;
+};
+
+TEST_F(MPITest, MatchesLocalSimulation)
+{
+    auto results = amici::mpi::runAmiciSimulations(
+        *solver, edata_ptrs, *model, MPI_COMM_WORLD, true);
+
+    // reference on root, reduced values are broadcast for comparison on all
+    // ranks
+    std::vector<amici::realtype> expected(1 + model->nplist(), 0.0);
+    int expected_failed = 0;
+    // no early returns before the collective calls below
+    if (rank == 0) {
+        auto rdatas = amici::runAmiciSimulations(*solver, edata_ptrs, *model,
+                                                 false, 1);
+        EXPECT_EQ(rdatas.size(), results.rdatas.size());
+        for (int i = 0; i < static_cast<int>(std::min(
+                            rdatas.size(), results.rdatas.size())); ++i) {
+            EXPECT_EQ(rdatas[i]->id, results.rdatas[i]->id);
+            EXPECT_EQ(rdatas[i]->status, results.rdatas[i]->status);
+            EXPECT_EQ(rdatas[i]->llh, results.rdatas[i]->llh);
+            amici::checkEqualArray(rdatas[i]->sllh, results.rdatas[i]->sllh,
+                                   0.0, 0.0, "sllh");
+            amici::checkEqualArray(rdatas[i]->y, results.rdatas[i]->y,
+                                   0.0, 0.0, "y");
+            expected[0] += rdatas[i]->llh;
+            for (int ip = 0; ip < model->nplist(); ++ip)
+                expected[1 + ip] += rdatas[i]->sllh[ip];
+            if (rdatas[i]->status != amici::AMICI_SUCCESS)
+                ++expected_failed;
+        }
+    } else {
+        EXPECT_TRUE(results.rdatas.empty());
+    }
+    MPI_Bcast(expected.data(), static_cast<int>(expected.size()), MPI_DOUBLE,
+              0, MPI_COMM_WORLD);
+    MPI_Bcast(&expected_failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    ASSERT_EQ(0, expected_failed);
+    ASSERT_EQ(expected_failed, results.num_failed);
+    ASSERT_TRUE(std::isfinite(results.llh));
+    EXPECT_NEAR(expected[0], results.llh, 1e-10 * std::abs(expected[0]));
+    ASSERT_EQ(model->nplist(), static_cast<int>(results.sllh.size()));
+    amici::checkEqualArray(
+        std::vector<amici::realtype>(expected.begin() + 1, expected.end()),
+        results.sllh, 1e-10, 1e-10, "sllh");
+    ASSERT_EQ(model->nplist() * model->nplist(),
+              static_cast<int>(results.FIM.size()));
+}
+
+TEST_F(MPITest, FewerConditionsThanRanks)
+{
+    if (rank == 0)
+        edata_ptrs.resize(1);
+
+    auto results = amici::mpi::runAmiciSimulations(
+        *solver, edata_ptrs, *model, MPI_COMM_WORLD);
+
+    ASSERT_TRUE(results.rdatas.empty());
+    ASSERT_EQ(0, results.num_failed);
+    ASSERT_EQ(model->nplist(), static_cast<int>(results.sllh.size()));
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // only report from one rank
+    if (rank != 0) {
+        auto &listeners = ::testing::UnitTest::GetInstance()->listeners();
+        delete listeners.Release(listeners.default_result_printer());
+    }
+
+    int result = RUN_ALL_TESTS();
+    // fail the job if any rank failed
+    MPI_Allreduce(MPI_IN_PLACE, &result, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return result;
+}
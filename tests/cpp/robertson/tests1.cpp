@@ -26,3 +26,21 @@ TEST(ExampleRobertson, SensitivityForwardSPBCG)
     amici::simulateVerifyWrite(
       "/model_robertson/sensiforwardSPBCG/", 1e7 * TEST_ATOL, 1e2 * TEST_RTOL);
 }
+
+TEST(ExampleRobertson, SimulateClonedModel)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+    amici::hdf5::readModelDataFromHDF5(
+      NEW_OPTION_FILE, *model, "/model_robertson/sensiforward/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+      NEW_OPTION_FILE, *solver, "/model_robertson/sensiforward/options");
+    auto clone = std::unique_ptr<amici::Model>(model->clone());
+
+    auto rdata = amici::runAmiciSimulation(*solver, nullptr, *model);
+    auto rdata_clone = amici::runAmiciSimulation(*solver, nullptr, *clone);
+
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata_clone->status);
+    ASSERT_EQ(rdata->x, rdata_clone->x);
+    ASSERT_EQ(rdata->sx, rdata_clone->sx);
+}
@@ -2,6 +2,8 @@
 
 #include "wrapfunctions.h"
 #include <cstring>
+#include <map>
+#include <set>
 
 #include <gtest/gtest.h>
 
@@ -49,6 +51,52 @@ TEST(ExampleSteadystate, CopyModel)
     ASSERT_EQ(*modelA, *modelB);
 }
 
+TEST(ExampleSteadystate, SimulateClonedModel)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+    amici::hdf5::readModelDataFromHDF5(
+      NEW_OPTION_FILE, *model, "/model_steadystate/sensiforward/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+      NEW_OPTION_FILE, *solver, "/model_steadystate/sensiforward/options");
+    auto clone = std::unique_ptr<amici::Model>(model->clone());
+
+    auto rdata = amici::runAmiciSimulation(*solver, nullptr, *model);
+    auto rdata_clone = amici::runAmiciSimulation(*solver, nullptr, *clone);
+
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata_clone->status);
+    ASSERT_EQ(rdata->x, rdata_clone->x);
+    ASSERT_EQ(rdata->sx, rdata_clone->sx);
+}
+
+TEST(ExampleSteadystate, WorkspaceAllocatedOnDemand)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+    amici::hdf5::readModelDataFromHDF5(
+      NEW_OPTION_FILE, *model, "/model_steadystate/sensiforward/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+      NEW_OPTION_FILE, *solver, "/model_steadystate/sensiforward/options");
+
+    auto initial = model->getWorkspaceMemoryUsage();
+    ASSERT_GT(initial, 0U);
+
+    solver->setSensitivityOrder(amici::SensitivityOrder::none);
+    auto rdata = amici::runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata->status);
+    auto nosensi = model->getWorkspaceMemoryUsage();
+    ASSERT_EQ(static_cast<long long>(nosensi), rdata->model_workspace_bytes);
+
+    solver->setSensitivityOrder(amici::SensitivityOrder::first);
+    rdata = amici::runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata->status);
+    ASSERT_GT(model->getWorkspaceMemoryUsage(), nosensi);
+
+    // clones start with an empty workspace
+    auto clone = std::unique_ptr<amici::Model>(model->clone());
+    ASSERT_EQ(initial, clone->getWorkspaceMemoryUsage());
+}
+
 TEST(ExampleSteadystate, CloneModel)
 {
     auto modelA = amici::generic_model::getModel();
@@ -131,6 +179,120 @@ TEST(ExampleSteadystate, Maxtime)
     ASSERT_EQ(amici::AMICI_MAX_TIME_EXCEEDED, rdata->status);
 }
 
+TEST(ExampleSteadystate, Cancellation)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+
+    amici::hdf5::readModelDataFromHDF5(
+        NEW_OPTION_FILE, *model, "/model_steadystate/nosensi/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+        NEW_OPTION_FILE, *solver, "/model_steadystate/nosensi/options");
+
+    amici::CancellationToken token;
+    solver->setCancellationToken(&token);
+    auto rdata = runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata->status);
+    ASSERT_GT(token.getNumRHSEvaluations(), 0);
+    ASSERT_GT(token.getNumSteps(), 0);
+
+    // budget is shared by all conditions of a batch
+    auto edata = amici::ExpData(*rdata, 0.1, 0.1);
+    std::vector<amici::ExpData *> edatas(4, &edata);
+    token.reset();
+    token.setMaxSteps(token.getNumSteps() + 1);
+    auto rdatas = runAmiciSimulations(*solver, edatas, *model, false, 1);
+    ASSERT_EQ(amici::CancellationToken::Reason::steps, token.getReason());
+    for (auto const &rd: rdatas)
+        ASSERT_EQ(amici::AMICI_CANCELLED, rd->status);
+
+    token.reset();
+    token.setMaxSteps(-1);
+    token.setTimeout(0.0);
+    rdata = runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_EQ(amici::AMICI_MAX_TIME_EXCEEDED, rdata->status);
+
+    // remaining conditions are skipped after cancellation
+    token.reset();
+    token.setTimeout(1e300);
+    token.cancel();
+    edata.id = "skipped";
+    rdatas = runAmiciSimulations(*solver, edatas, *model, false, 1);
+    for (auto const &rd: rdatas) {
+        ASSERT_EQ(amici::AMICI_CANCELLED, rd->status);
+        ASSERT_EQ("skipped", rd->id);
+    }
+}
+
+TEST(ExampleSteadystate, Profiling)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+
+    amici::hdf5::readModelDataFromHDF5(
+        NEW_OPTION_FILE, *model, "/model_steadystate/nosensi/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+        NEW_OPTION_FILE, *solver, "/model_steadystate/nosensi/options");
+
+    auto rdata = runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_TRUE(rdata->profile_calls.empty());
+
+    solver->setProfiling(true);
+    rdata = runAmiciSimulation(*solver, nullptr, *model);
+    ASSERT_EQ(amici::AMICI_SUCCESS, rdata->status);
+    if (rdata->profile_calls.empty())
+        GTEST_SKIP() << "AMICI was built without ENABLE_PROFILING";
+
+    auto calls = [&rdata](amici::ProfiledFunction function) {
+        return rdata->profile_calls.at(static_cast<int>(function));
+    };
+    ASSERT_EQ(1, calls(amici::ProfiledFunction::forward));
+    ASSERT_EQ(1, calls(amici::ProfiledFunction::fx0));
+    ASSERT_GT(calls(amici::ProfiledFunction::fxdot), 0);
+    // no data point handling for t = inf
+    ASSERT_EQ(model->nt() - 1, calls(amici::ProfiledFunction::dataPoints));
+    ASSERT_GT(calls(amici::ProfiledFunction::linearSolverSetup), 0);
+    ASSERT_GT(rdata->profile_time.at(
+                  static_cast<int>(amici::ProfiledFunction::forward)), 0.0);
+}
+
+TEST(ExampleSteadystate, Tracing)
+{
+    auto model = amici::generic_model::getModel();
+    auto solver = model->getSolver();
+
+    amici::hdf5::readModelDataFromHDF5(
+        NEW_OPTION_FILE, *model, "/model_steadystate/nosensi/options");
+    amici::hdf5::readSolverSettingsFromHDF5(
+        NEW_OPTION_FILE, *solver, "/model_steadystate/nosensi/options");
+
+    auto rdata = runAmiciSimulation(*solver, nullptr, *model);
+    std::vector<amici::ExpData> edatas(4, amici::ExpData(*rdata, 0.1, 0.1));
+    std::vector<amici::ExpData *> edata_ptrs;
+    for (int i = 0; i < static_cast<int>(edatas.size()); ++i) {
+        edatas[i].id = std::to_string(i);
+        edata_ptrs.push_back(&edatas[i]);
+    }
+
+    amici::TraceRecorder recorder;
+    amici::setTraceRecorder(&recorder);
+    auto rdatas = runAmiciSimulations(*solver, edata_ptrs, *model, false, 2);
+    amici::setTraceRecorder(nullptr);
+
+    std::set<std::string> ids;
+    std::map<std::string, int> counts;
+    for (auto const &event : recorder.getEvents()) {
+        ++counts[event.name];
+        if (std::string(event.name) == "simulation")
+            ids.insert(event.arg);
+    }
+    ASSERT_EQ(4, counts["simulation"]);
+    ASSERT_EQ(4, counts["forward"]);
+    ASSERT_EQ(4, counts["postequilibration"]);
+    ASSERT_GT(counts["linearSolverSetup"], 0);
+    ASSERT_EQ((std::set<std::string>{"0", "1", "2", "3"}), ids);
+}
+
 TEST(ExampleSteadystate, InitialStatesNonEmpty)
 {
     auto model = amici::generic_model::getModel();
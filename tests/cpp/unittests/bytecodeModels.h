@@ -0,0 +1,104 @@
+#ifndef AMICI_TEST_BYTECODE_MODELS_H
+#define AMICI_TEST_BYTECODE_MODELS_H
+
+namespace amici {
+
+/** Bytecode of dx/dt = -p * x, y = x with a gaussian noise model */
+char const *const decay_bytecode = R"(AMICI_BYTECODE 1
+name decay
+amici_version 0.0.0
+amici_commit unknown
+dimensions 1 1 1 1 0 1 0 1 1 0 0 0 1 0 0 0 0 0 0 0 0 0 1 1
+ndJydy 1 1
+ndxdotdp_explicit 1
+ndxdotdx_explicit 1
+w_recursion_depth 0
+reinit_fixpar_initcond 1
+quadratic_llh 1
+parameters 1 0.5
+fixed_parameters 0
+parameter_names 1
+decay rate
+fixed_parameter_names 0
+state_names 1
+x
+observable_names 1
+y
+expression_names 0
+parameter_ids 1
+p
+fixed_parameter_ids 0
+state_ids 1
+x
+observable_ids 1
+y
+expression_ids 0
+state_idxs_solver 1 0
+observable_scalings 1 lin
+function x0 0 2 1
+constants 1 1.0
+const 0 0
+store 0 0
+function xdot 0 5 2
+constants 0
+load 0 p 0
+load 1 x 0
+mul 0 0 1
+neg 0 0
+store 0 0
+function dxdotdx_explicit 0 3 1
+constants 0
+load 0 p 0
+neg 0 0
+store 0 0
+function dxdotdp_explicit 0 3 1
+constants 0
+load 0 x 0
+neg 0 0
+store 0 0
+function y 0 2 1
+constants 0
+load 0 x 0
+store 0 0
+function dydx 0 2 1
+constants 1 1.0
+const 0 0
+store 0 0
+function sigmay 0 2 1
+constants 1 1.0
+const 0 0
+store 0 0
+function Jy 0 14 5
+constants 2 0.5 6.283185307179586
+const 0 0
+const 1 1
+load 2 sigmay 0
+mul 3 2 2
+mul 3 1 3
+log 3 3
+load 1 y 0
+load 4 my 0
+sub 1 1 4
+div 1 1 2
+mul 1 1 1
+add 3 3 1
+mul 3 0 3
+store 0 3
+function dJydy 0 7 4
+constants 0
+load 0 y 0
+load 1 my 0
+sub 0 0 1
+load 2 sigmay 0
+mul 3 2 2
+div 0 0 3
+store 0 0
+sparsity dJydy 0 colptrs 2 0 1 rowvals 1 0
+sparsity dxdotdx_explicit 0 colptrs 2 0 1 rowvals 1 0
+sparsity dxdotdp_explicit 0 colptrs 2 0 1 rowvals 1 0
+end
+)";
+
+} // namespace amici
+
+#endif // AMICI_TEST_BYTECODE_MODELS_H
@@ -1,6 +1,7 @@
 #include "testfunctions.h"
 
 #include <amici/amici.h>
+#include <amici/hdf5.h>
 #include <amici/model_ode.h>
 #include <amici/symbolic_functions.h>
 
@@ -328,4 +329,119 @@ TEST_F(ExpDataTest, SettersGetters)
                     "ObservedEventsStdDev");
 }
 
+TEST_F(ExpDataTest, SparseObservedData)
+{
+    ExpData edata(testModel);
+    ASSERT_EQ(edata.nObservedData(), 0);
+    ASSERT_EQ(edata.getObservedDataIndptr().size(), timepoints.size() + 1);
+
+    edata.setObservedDataSparse({0, 2, 2}, {1, 0, 1}, {1.0, 2.0, 3.0},
+                                {0.1, 0.2, 0.3});
+    ASSERT_EQ(edata.nObservedData(), 3);
+    ASSERT_EQ(edata.getObservedDataIndptr(),
+              std::vector<int>({0, 1, 1, 3, 3}));
+    ASSERT_EQ(edata.getObservedDataIndices(), std::vector<int>({1, 0, 1}));
+    ASSERT_EQ(edata.getObservedDataIndices(1).size(), 0);
+    ASSERT_EQ(edata.getObservedDataIndices(2).size(), 2);
+
+    ASSERT_FALSE(edata.isSetObservedData(0, 0));
+    ASSERT_TRUE(edata.isSetObservedData(0, 1));
+    ASSERT_TRUE(edata.isSetObservedDataStdDev(2, 0));
+
+    // no dense storage is used
+    ASSERT_TRUE(edata.isObservedDataSparse());
+    ASSERT_FALSE(edata.getObservedDataPtr(2));
+    ASSERT_FALSE(edata.getObservedDataStdDevPtr(2));
+    std::vector<realtype> buffer;
+    ASSERT_EQ(edata.getObservedDataPtr(2, buffer)[1], 3.0);
+    ASSERT_TRUE(isNaN(edata.getObservedDataPtr(1, buffer)[1]));
+    ASSERT_EQ(edata.getObservedDataValues(2).size(), 2);
+    ASSERT_EQ(edata.getObservedDataStdDevValues(2)[0], 0.2);
+    ASSERT_THROW(edata.getObservedData(), AmiException);
+    auto dense = edata.getObservedDataDense();
+    ASSERT_EQ(dense.size(), edata.nt() * ny);
+    ASSERT_EQ(dense.at(2 * ny + 1), 3.0);
+    ASSERT_TRUE(isNaN(dense.at(0)));
+    ASSERT_EQ(edata.getObservedDataStdDevDense().at(2 * ny), 0.2);
+
+    // index follows dense updates
+    std::vector<realtype> single_y(edata.nt(), getNaN());
+    single_y[3] = 4.0;
+    edata.setObservedData(single_y, 1);
+    ASSERT_EQ(edata.getObservedDataIndptr(),
+              std::vector<int>({0, 0, 0, 1, 2}));
+    ASSERT_EQ(edata.getObservedDataIndices(), std::vector<int>({0, 1}));
+    ASSERT_FALSE(edata.isObservedDataSparse());
+    ASSERT_EQ(edata.getObservedDataPtr(3)[1], 4.0);
+    ASSERT_EQ(edata.getObservedDataStdDevPtr(2)[0], 0.2);
+
+    ASSERT_THROW(edata.setObservedDataSparse({0}, {ny}, {1.0}, {}),
+                 AmiException);
+    ASSERT_THROW(edata.setObservedDataSparse({-1}, {0}, {1.0}, {}),
+                 AmiException);
+    ASSERT_THROW(edata.setObservedDataSparse({0, 1}, {0}, {1.0}, {}),
+                 AmiException);
+    ASSERT_THROW(edata.setObservedDataSparse({0}, {0}, {1.0}, {-1.0}),
+                 AmiException);
+    // invalid input leaves data and index unchanged
+    ASSERT_THROW(edata.setObservedDataSparse({0, 1}, {0, ny}, {1.0, 2.0}, {}),
+                 AmiException);
+    ASSERT_EQ(edata.getObservedDataIndices(), std::vector<int>({0, 1}));
+    ASSERT_EQ(edata.getObservedDataPtr(3)[1], 4.0);
+    ASSERT_EQ(edata.getObservedDataStdDevPtr(2)[0], 0.2);
+}
+
+TEST_F(ExpDataTest, StackedHDF5RoundTrip)
+{
+    std::vector<std::unique_ptr<ExpData>> edatas;
+    std::vector<ExpData *> edata_ptrs;
+    for (int icond = 0; icond < 3; ++icond) {
+        edatas.push_back(std::make_unique<ExpData>(testModel));
+        auto &edata = *edatas.back();
+        std::vector<realtype> y(ny * timepoints.size(), icond);
+        y[1] = getNaN();
+        edata.setObservedData(y);
+        edata.setObservedDataStdDev(std::vector<realtype>(y.size(), 0.1));
+        edata.setObservedEvents(std::vector<realtype>(nz * nmaxevent, icond));
+        if (icond == 1)
+            edata.fixedParametersPreequilibration = {1.0, 2.0, 3.0};
+        edata.t_presim = icond;
+        edata.id = "condition" + std::to_string(icond);
+        edata.reinitializeFixedParameterInitialStates = icond == 2;
+        if (icond == 0)
+            edata.reinitialization_state_idxs_sim = {0};
+        edata_ptrs.push_back(&edata);
+    }
+
+    std::string filename = "amici_stacked_edata_test.h5";
+    {
+        H5::H5File file(filename.c_str(), H5F_ACC_TRUNC);
+        hdf5::writeSimulationExpDatas(edata_ptrs, file, "/edatas");
+    }
+    auto read = hdf5::readSimulationExpDatas(filename, "/edatas", testModel);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(read.size(), edatas.size());
+    for (int icond = 0; icond < 3; ++icond) {
+        auto const &expected = *edatas[icond];
+        auto const &actual = *read[icond];
+        ASSERT_EQ(actual.getTimepoints(), expected.getTimepoints());
+        ASSERT_EQ(actual.nObservedData(), expected.nObservedData());
+        ASSERT_EQ(actual.getObservedDataIndices(),
+                  expected.getObservedDataIndices());
+        ASSERT_EQ(actual.getObservedDataPtr(1)[0], icond);
+        ASSERT_EQ(actual.getObservedDataStdDevPtr(1)[0], 0.1);
+        ASSERT_EQ(actual.getObservedEventsPtr(0)[0], icond);
+        ASSERT_EQ(actual.fixedParameters, expected.fixedParameters);
+        ASSERT_EQ(actual.fixedParametersPreequilibration,
+                  expected.fixedParametersPreequilibration);
+        ASSERT_EQ(actual.t_presim, expected.t_presim);
+        ASSERT_EQ(actual.id, expected.id);
+        ASSERT_EQ(actual.reinitializeFixedParameterInitialStates,
+                  expected.reinitializeFixedParameterInitialStates);
+        ASSERT_EQ(actual.reinitialization_state_idxs_sim,
+                  expected.reinitialization_state_idxs_sim);
+    }
+}
+
 } // namespace
@@ -1,15 +1,28 @@
 #include "testfunctions.h"
+#include "bytecodeModels.h"
 
 #include <amici/amici.h>
 #include <amici/forwardproblem.h>
+#include <amici/hdf5.h>
 #include <amici/model_ode.h>
+#include <amici/model_ode_bytecode.h>
+#include <amici/model_registry.h>
+#include <amici/profiling.h>
 #include <amici/solver_cvodes.h>
 #include <amici/solver_idas.h>
 #include <amici/symbolic_functions.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <exception>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -122,6 +135,19 @@ TEST_F(ModelTest, ParameterScaleTooLong)
     ASSERT_THROW(model.setParameterScale(pscale), AmiException);
 }
 
+TEST_F(ModelTest, CloneSharesDefinition)
+{
+    model.setParameters(std::vector<realtype>{ 2.0 });
+    std::unique_ptr<Model> clone(model.clone());
+
+    ASSERT_EQ(model, *clone);
+    ASSERT_EQ(&model.getIdList(), &clone->getIdList());
+    ASSERT_EQ(idlist, clone->getIdList());
+
+    clone->setParameters(std::vector<realtype>{ 3.0 });
+    ASSERT_EQ(2.0, model.getParameters()[0]);
+}
+
 TEST_F(ModelTest, UnsortedTimepointsThrow){
     ASSERT_THROW(model.setTimepoints(std::vector<realtype>{ 0.0, 1.0, 0.5 }),
                  AmiException);
@@ -177,6 +203,135 @@ TEST_F(ModelTest, ReinitializeFixedParameterInitialStates)
     AmiVectorArray sx(model.np(), nx);
 }
 
+TEST_F(ModelTest, SimulationWorkerPool)
+{
+    model.setTimepoints({1.0});
+    CVodeSolver solver;
+    std::vector<ExpData> edatas(5, ExpData(model));
+    std::vector<ExpData *> edata_ptrs;
+    for (int i = 0; i < static_cast<int>(edatas.size()); ++i) {
+        edatas[i].id = std::to_string(i);
+        edata_ptrs.push_back(&edatas[i]);
+    }
+
+    std::vector<std::future<std::unique_ptr<ReturnData>>> results;
+    {
+        SimulationWorkerPool pool(2);
+        ASSERT_EQ(pool.numThreads(), 2);
+        results = pool.submit(solver, edata_ptrs, model);
+        // inputs are copied on submission
+        edatas.clear();
+        results.push_back(pool.submit(solver, nullptr, model));
+        // destruction cancels the simulations that were not started yet
+    }
+
+    ASSERT_EQ(results.size(), 6);
+    for (auto &result : results) {
+        ASSERT_EQ(result.wait_for(std::chrono::seconds(0)),
+                  std::future_status::ready);
+        // Model_Test does not implement any model functions, the exception
+        // is passed on to the caller
+        try {
+            result.get();
+            FAIL() << "Expected an exception";
+        } catch (AmiException const &) {
+        } catch (std::future_error const &e) {
+            ASSERT_EQ(e.code(), std::future_errc::broken_promise);
+        }
+    }
+}
+
+namespace {
+
+/** Decay model that blocks in fx0 until `gate` is ready, if set */
+class BlockingModel : public Model_ODE_Bytecode {
+  public:
+    using Model_ODE_Bytecode::Model_ODE_Bytecode;
+
+    Model *clone() const override { return new BlockingModel(*this); }
+
+    void fx0(realtype *x0, realtype t, const realtype *p,
+             const realtype *k) override {
+        if (gate.valid()) {
+            ++*started;
+            gate.wait();
+        }
+        Model_ODE_Bytecode::fx0(x0, t, p, k);
+    }
+
+    std::shared_future<void> gate;
+
+    /** number of simulations that reached the gate */
+    std::shared_ptr<std::atomic<int>> started{
+        std::make_shared<std::atomic<int>>(0)};
+};
+
+template <typename Condition> void waitUntil(Condition condition) {
+    while (!condition())
+        std::this_thread::yield();
+}
+
+} // namespace
+
+TEST(SimulationWorkerPoolTest, OutOfOrderCompletion)
+{
+    std::istringstream stream(decay_bytecode);
+    BlockingModel model(readBytecodeModel(stream));
+    model.setTimepoints({1.0});
+    auto solver = model.getSolver();
+
+    std::promise<void> release;
+    auto blocking = model;
+    blocking.gate = release.get_future().share();
+
+    std::mutex mutex;
+    std::vector<int> completed;
+    auto on_completion = [&](int index) {
+        return [&, index]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(index);
+        };
+    };
+    auto num_completed = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return completed.size();
+    };
+
+    std::future<std::unique_ptr<ReturnData>> slow, fast, busy, cancelled;
+    {
+        SimulationWorkerPool pool(2);
+        slow = pool.submit(*solver, nullptr, blocking, on_completion(0));
+        fast = pool.submit(*solver, nullptr, model, on_completion(1));
+        // a later simulation completes while an earlier one is running
+        ASSERT_EQ(fast.get()->status, AMICI_SUCCESS);
+        waitUntil([&]() { return num_completed() == 1; });
+        ASSERT_EQ(slow.wait_for(std::chrono::seconds(0)),
+                  std::future_status::timeout);
+
+        // occupy both workers, so the next one stays queued
+        busy = pool.submit(*solver, nullptr, blocking, on_completion(2));
+        waitUntil([&]() { return *blocking.started == 2; });
+        cancelled = pool.submit(*solver, nullptr, model, [&]() {
+            on_completion(3)();
+            // the queued simulation was cancelled, let the others finish
+            release.set_value();
+        });
+    }
+
+    ASSERT_EQ(busy.get()->status, AMICI_SUCCESS);
+
+    ASSERT_EQ(slow.get()->status, AMICI_SUCCESS);
+    try {
+        cancelled.get();
+        FAIL() << "Expected cancellation";
+    } catch (std::future_error const &e) {
+        ASSERT_EQ(e.code(), std::future_errc::broken_promise);
+    }
+    ASSERT_EQ(completed.size(), 4U);
+    ASSERT_EQ(completed[0], 1);
+    ASSERT_EQ(completed[1], 3);
+}
+
 TEST(SymbolicFunctionsTest, Sign)
 {
     ASSERT_EQ(-1, sign(-2));
@@ -253,6 +408,342 @@ TEST(SolverTestBasic, Clone)
     ASSERT_FALSE(*i2 == *c2);
 }
 
+TEST(SolverTestBasic, CancellationToken)
+{
+    CancellationToken token;
+    ASSERT_FALSE(token.isCancelled());
+    ASSERT_EQ(AMICI_SUCCESS, token.getStatus());
+
+    token.setMaxRHSEvaluations(10);
+    ASSERT_FALSE(token.charge(10, 1));
+    ASSERT_TRUE(token.charge(1, 0));
+    ASSERT_EQ(CancellationToken::Reason::rhsEvaluations, token.getReason());
+    ASSERT_EQ(AMICI_CANCELLED, token.getStatus());
+
+    // first reason is kept
+    token.cancel();
+    ASSERT_EQ(CancellationToken::Reason::rhsEvaluations, token.getReason());
+
+    token.reset();
+    token.setMaxRHSEvaluations(-1);
+    ASSERT_FALSE(token.charge(100, 0));
+    ASSERT_EQ(100, token.getNumRHSEvaluations());
+    token.setTimeout(0.0);
+    ASSERT_TRUE(token.charge(0, 0));
+    ASSERT_EQ(AMICI_MAX_TIME_EXCEEDED, token.getStatus());
+
+    // shared by clones, can be cancelled from any thread
+    token.reset();
+    token.setTimeout(std::numeric_limits<double>::max());
+    CVodeSolver solver;
+    solver.setCancellationToken(&token);
+    std::unique_ptr<Solver> clone(solver.clone());
+    ASSERT_EQ(&token, clone->getCancellationToken());
+    ASSERT_FALSE(clone->interrupted());
+    std::thread([&token]() { token.cancel(); }).join();
+    ASSERT_TRUE(clone->interrupted());
+    ASSERT_EQ(AMICI_CANCELLED, clone->getInterruptStatus());
+}
+
+TEST(SolverTestBasic, Profile)
+{
+    ASSERT_EQ(static_cast<int>(ProfiledFunction::count),
+              static_cast<int>(getProfiledFunctionNames().size()));
+    ASSERT_STREQ("fxdot", getProfiledFunctionName(ProfiledFunction::fxdot));
+
+    Profile profile;
+    ASSERT_EQ(nullptr, getCurrentProfile());
+    {
+        ProfileContext context(&profile);
+        ASSERT_EQ(&profile, getCurrentProfile());
+        ProfileScope outer(ProfiledFunction::forward);
+        for (int i = 0; i < 3; ++i)
+            ProfileScope inner(ProfiledFunction::fxdot);
+        {
+            // nested contexts, e.g. disabled profiling for a sub-simulation
+            ProfileContext disabled(nullptr);
+            ProfileScope ignored(ProfiledFunction::fxdot);
+        }
+        profile.add(ProfiledFunction::fJ, std::chrono::milliseconds(2));
+    }
+    ASSERT_EQ(nullptr, getCurrentProfile());
+
+    auto calls = profile.getCalls();
+    auto time = profile.getTime();
+    ASSERT_EQ(3, calls[static_cast<int>(ProfiledFunction::fxdot)]);
+    ASSERT_EQ(1, calls[static_cast<int>(ProfiledFunction::forward)]);
+    ASSERT_EQ(0, calls[static_cast<int>(ProfiledFunction::fw)]);
+    ASSERT_DOUBLE_EQ(2.0, time[static_cast<int>(ProfiledFunction::fJ)]);
+    // times are inclusive
+    ASSERT_GE(time[static_cast<int>(ProfiledFunction::forward)],
+              time[static_cast<int>(ProfiledFunction::fxdot)]);
+
+    CVodeSolver solver;
+    ASSERT_FALSE(solver.getProfiling());
+    solver.setProfiling(true);
+    std::unique_ptr<Solver> clone(solver.clone());
+    ASSERT_TRUE(clone->getProfiling());
+}
+
+TEST(SolverTestBasic, TraceRecorder)
+{
+    {
+        // no recorder active, nothing recorded
+        TraceScope scope("ignored");
+    }
+    TraceRecorder recorder(4);
+    setTraceRecorder(&recorder);
+    ASSERT_EQ(&recorder, getTraceRecorder());
+    {
+        TraceScope outer("simulation", "condition \"1\"");
+        TraceScope inner("forward");
+    }
+    std::thread([]() {
+        for (int i = 0; i < 6; ++i)
+            TraceScope scope("events");
+    }).join();
+    setTraceRecorder(nullptr);
+    {
+        TraceScope scope("ignored");
+    }
+
+    auto events = recorder.getEvents();
+    // the second thread's buffer only keeps its last 4 events
+    ASSERT_EQ(6, static_cast<int>(events.size()));
+    ASSERT_EQ(2, static_cast<int>(recorder.getNumDropped()));
+    ASSERT_STREQ("simulation", events[0].name);
+    ASSERT_EQ("condition \"1\"", events[0].arg);
+    ASSERT_STREQ("forward", events[1].name);
+    ASSERT_EQ(0, events[1].thread);
+    ASSERT_GE(events[0].duration, events[1].duration);
+    for (int i = 2; i < 6; ++i) {
+        ASSERT_STREQ("events", events[i].name);
+        ASSERT_EQ(1, events[i].thread);
+    }
+
+    std::ostringstream os;
+    recorder.writeChromeTrace(os);
+    auto json = os.str();
+    ASSERT_NE(std::string::npos, json.find("\"traceEvents\""));
+    ASSERT_NE(std::string::npos, json.find("\"id\": \"condition \\\"1\\\"\""));
+    ASSERT_EQ(std::string::npos, json.find("ignored"));
+
+    recorder.clear();
+    ASSERT_TRUE(recorder.getEvents().empty());
+}
+
+TEST(SolverTestBasic, CpuTimer)
+{
+    CpuTimer timer;
+    // sleeping or other busy threads don't count towards this thread's CPU
+    // time
+    std::thread([]() {
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start
+               < std::chrono::milliseconds(50)) {
+        }
+    }).join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_GE(timer.elapsedWallMilliseconds(), 100.0);
+    ASSERT_LT(timer.elapsedMilliseconds(), 50.0);
+    ASSERT_GE(timer.elapsedMilliseconds(), 0.0);
+
+    timer.reset();
+    ASSERT_LT(timer.elapsedWallMilliseconds(), 100.0);
+}
+
+TEST(ReturnDataTest, FieldSelection)
+{
+    int nx = 2, ny = 3, nt = 4, nplist = 2;
+    ModelDimensions dims(nx, nx, nx, nx, 0, nplist, 0, ny, ny, 0, 0, 0, 1, 1,
+                         0, 0, 0, 0, {}, 0, 0, 0, 0, 0, 0);
+    std::vector<realtype> ts{0.0, 1.0, 2.0, 3.0};
+    auto makeReturnData = [&](int fields, std::vector<int> const &its) {
+        return ReturnData(ts, dims, nplist, 0, nt, 0,
+                          std::vector<ParameterScaling>(
+                              nplist, ParameterScaling::none),
+                          SecondOrderMode::none, SensitivityOrder::first,
+                          SensitivityMethod::forward, RDataReporting::full,
+                          true, false, 0.0, fields, its);
+    };
+
+    auto full = makeReturnData(static_cast<int>(RDataField::all), {});
+    ASSERT_EQ(full.x.size(), nt * nx);
+    ASSERT_EQ(full.sx.size(), nt * nx * nplist);
+    ASSERT_EQ(full.sy.size(), nt * ny * nplist);
+    ASSERT_EQ(full.FIM.size(), nplist * nplist);
+
+    auto rdata = makeReturnData(RDataField::x | RDataField::y, {3, 1});
+    ASSERT_EQ(rdata.rdata_fields, RDataField::x | RDataField::y);
+    ASSERT_EQ(rdata.trajectory_its, std::vector<int>({1, 3}));
+    ASSERT_EQ(rdata.ntTrajectory(), 2);
+    ASSERT_EQ(rdata.x.size(), 2 * nx);
+    ASSERT_EQ(rdata.y.size(), nt * ny);
+    ASSERT_TRUE(rdata.sx.empty());
+    ASSERT_TRUE(rdata.sy.empty());
+    ASSERT_TRUE(rdata.ssigmay.empty());
+    ASSERT_TRUE(rdata.sres.empty());
+    ASSERT_TRUE(rdata.FIM.empty());
+    ASSERT_TRUE(rdata.sllh.size() == static_cast<unsigned>(nplist));
+
+    auto sensis = makeReturnData(static_cast<int>(RDataField::all), {2});
+    ASSERT_EQ(sensis.x.size(), nx);
+    ASSERT_EQ(sensis.sx.size(), nx * nplist);
+    ASSERT_EQ(sensis.sy.size(), nt * ny * nplist);
+
+    ASSERT_THROW(makeReturnData(static_cast<int>(RDataField::all), {nt}),
+                 AmiException);
+
+    CVodeSolver solver;
+    ASSERT_EQ(solver.getReturnDataFields(), static_cast<int>(RDataField::all));
+    solver.setReturnDataFields(RDataField::y | RDataField::sy);
+    ASSERT_EQ(solver.getReturnDataFields(), RDataField::y | RDataField::sy);
+    ASSERT_THROW(solver.setReturnDataFields(
+                     static_cast<int>(RDataField::all) + 1), AmiException);
+    solver.setReturnDataTrajectoryTimepoints({0, 2});
+    ASSERT_EQ(solver.getReturnDataTrajectoryTimepoints(),
+              std::vector<int>({0, 2}));
+    ASSERT_THROW(solver.setReturnDataTrajectoryTimepoints({-1}), AmiException);
+}
+
+TEST(ReturnDataTest, Arena)
+{
+    int nx = 2, ny = 3, nt = 4, nplist = 1, nsim = 3;
+    ModelDimensions dims(nx, nx, nx, nx, 0, nplist, 0, ny, ny, 0, 0, 0, 1, 1,
+                         0, 0, 0, 0, {}, 0, 0, 0, 0, 0, 0);
+    auto makeReturnData = [&](int isim) {
+        auto rdata = std::make_unique<ReturnData>(
+            std::vector<realtype>{0.0, 1.0, 2.0, 3.0}, dims, nplist, 0, nt, 0,
+            std::vector<ParameterScaling>{ParameterScaling::none},
+            SecondOrderMode::none, SensitivityOrder::none,
+            SensitivityMethod::none, RDataReporting::residuals, true, false,
+            0.0);
+        std::fill(rdata->y.begin(), rdata->y.end(), 10.0 * isim);
+        rdata->llh = isim;
+        rdata->status = -isim;
+        return rdata;
+    };
+
+    ReturnDataArena arena(nsim);
+    for (int isim : {2, 0, 1})
+        arena.consume(isim, makeReturnData(isim));
+
+    auto const names = arena.getFieldNames();
+    ASSERT_NE(std::find(names.begin(), names.end(), "y"), names.end());
+    ASSERT_EQ(std::find(names.begin(), names.end(), "x"), names.end());
+    ASSERT_EQ(arena.getFieldShape("y"), std::vector<int>({nt, ny}));
+    ASSERT_EQ(arena.getFieldSize("y"), nt * ny);
+    ASSERT_TRUE(arena.getFieldShape("llh").empty());
+    ASSERT_THROW(arena.getFieldSize("x"), AmiException);
+
+    auto const &data = arena.getData();
+    auto y = data.begin() + arena.getFieldOffset("y");
+    ASSERT_EQ(y[0], 0.0);
+    ASSERT_EQ(y[nt * ny], 10.0);
+    ASSERT_EQ(y[2 * nt * ny + nt * ny - 1], 20.0);
+    ASSERT_EQ(data.at(arena.getFieldOffset("llh") + 2), 2.0);
+    ASSERT_EQ(arena.getStatus(), std::vector<int>({0, -1, -2}));
+
+    // storage is reused for further batches of the same or smaller size
+    auto const *storage = data.data();
+    arena.reset(nsim - 1);
+    ASSERT_TRUE(arena.getFieldNames().empty());
+    arena.consume(1, makeReturnData(1));
+    ASSERT_EQ(storage, arena.getData().data());
+    ASSERT_EQ(arena.getStatus(), std::vector<int>({AMICI_ERROR, -1}));
+    ASSERT_THROW(arena.consume(nsim - 1, makeReturnData(0)), AmiException);
+
+    // shared storage is left to its other owners
+    auto shared = arena.getStorage();
+    arena.reset(nsim);
+    arena.consume(0, makeReturnData(2));
+    ASSERT_NE(shared.get(), &arena.getData());
+    ASSERT_EQ(shared->at(arena.getFieldOffset("y") + nt * ny), 10.0);
+}
+
+TEST(ReturnDataTest, BatchWriter)
+{
+    int nx = 2, ny = 3, nt = 4, nplist = 1, nsim = 5;
+    ModelDimensions dims(nx, nx, nx, nx, 0, nplist, 0, ny, ny, 0, 0, 0, 1, 1,
+                         0, 0, 0, 0, {}, 0, 0, 0, 0, 0, 0);
+    ReturnData rdata(std::vector<realtype>{0.0, 1.0, 2.0, 3.0}, dims, nplist,
+                     0, nt, 0, {ParameterScaling::none},
+                     SecondOrderMode::none, SensitivityOrder::none,
+                     SensitivityMethod::none, RDataReporting::residuals, true,
+                     false, 0.0);
+
+    std::string filename = "amici_batch_writer_test.h5";
+    {
+        hdf5::ReturnDataBatchWriter writer(filename, "/results", 4, true, 2,
+                                           2);
+        // written out of order, leaving index 3 empty
+        for (int isim : {4, 0, 2, 1}) {
+            rdata.llh = isim;
+            std::fill(rdata.y.begin(), rdata.y.end(), 10.0 * isim);
+            writer.append(isim, rdata);
+        }
+        writer.close();
+        ASSERT_THROW(writer.append(0, rdata), AmiException);
+    }
+
+    H5::H5File file(filename.c_str(), H5F_ACC_RDONLY);
+    auto y = file.openDataSet("/results/y");
+    hsize_t extent[3];
+    ASSERT_EQ(y.getSpace().getSimpleExtentDims(extent), 3);
+    ASSERT_EQ(extent[0], nsim);
+    ASSERT_EQ(extent[1], nt);
+    ASSERT_EQ(extent[2], ny);
+    std::vector<double> ybuf(nsim * nt * ny);
+    y.read(ybuf.data(), H5::PredType::NATIVE_DOUBLE);
+    ASSERT_EQ(ybuf[2 * nt * ny], 20.0);
+    ASSERT_TRUE(std::isnan(ybuf[3 * nt * ny]));
+
+    auto llh = hdf5::getDoubleDataset1D(file, "/results/llh");
+    ASSERT_EQ(llh.size(), nsim);
+    ASSERT_EQ(llh[4], 4.0);
+    ASSERT_TRUE(std::isnan(llh[3]));
+    auto status = hdf5::getIntDataset1D(file, "/results/status");
+    ASSERT_EQ(status[0], AMICI_SUCCESS);
+    ASSERT_EQ(status[3], AMICI_ERROR);
+    ASSERT_FALSE(hdf5::locationExists(file, "/results/x"));
+    file.close();
+    std::remove(filename.c_str());
+
+    // invalid options are rejected before the file is created
+    ASSERT_THROW(hdf5::ReturnDataBatchWriter(filename, "/results", 10),
+                 AmiException);
+    ASSERT_THROW(hdf5::ReturnDataBatchWriter(filename, "/results", 0, false,
+                                             0),
+                 AmiException);
+    ASSERT_FALSE(std::ifstream(filename).good());
+
+    // chunks are limited in size regardless of the number of simulations
+    {
+        hdf5::ReturnDataBatchWriter writer(filename, "/results", 0, false,
+                                           1 << 20);
+        writer.append(0, rdata);
+        writer.close();
+        H5::H5File file(filename.c_str(), H5F_ACC_RDONLY);
+        hsize_t chunk[3];
+        ASSERT_EQ(file.openDataSet("/results/y").getCreatePlist().getChunk(
+                      3, chunk),
+                  3);
+        ASSERT_LE(chunk[0] * chunk[1] * chunk[2] * sizeof(double),
+                  1024 * 1024);
+        ASSERT_EQ(chunk[1], nt);
+    }
+    std::remove(filename.c_str());
+
+    // fields that do not match their dimensions are not written
+    {
+        hdf5::ReturnDataBatchWriter writer(filename, "/results");
+        rdata.y.resize(1);
+        writer.append(0, rdata);
+        ASSERT_THROW(writer.close(), AmiException);
+    }
+    std::remove(filename.c_str());
+}
+
 TEST(SolverIdasTest, DefaultConstructableAndNotLeaky)
 {
     IDASolver solver;
@@ -646,4 +1137,179 @@ TEST_F(SunMatrixWrapperTest, BlockTranspose)
                   SM_INDEXPTRS_S(B_sparse.get())[icol]);
 }
 
+TEST(BytecodeModelTest, SimulateDecay)
+{
+    std::istringstream stream(decay_bytecode);
+    Model_ODE_Bytecode model(readBytecodeModel(stream));
+    ASSERT_EQ(model.getName(), "decay");
+    ASSERT_EQ(model.getParameterNames(),
+              std::vector<std::string>{"decay rate"});
+    ASSERT_EQ(model.getStateIdsSolver(), std::vector<std::string>{"x"});
+
+    std::vector<realtype> const ts{0.0, 1.0, 2.0, 5.0};
+    model.setTimepoints(ts);
+    std::unique_ptr<Model> clone(model.clone());
+    auto const p = 0.5;
+
+    ExpData edata(*clone);
+    edata.setObservedData(std::vector<realtype>(ts.size(), 0.5));
+    edata.setObservedDataStdDev(std::vector<realtype>(ts.size(), 1.0));
+
+    auto solver = clone->getSolver();
+    solver->setSensitivityOrder(SensitivityOrder::first);
+    solver->setSensitivityMethod(SensitivityMethod::forward);
+    solver->setRelativeTolerance(1e-12);
+    solver->setAbsoluteTolerance(1e-12);
+    auto rdata = runAmiciSimulation(*solver, &edata, *clone);
+    ASSERT_EQ(rdata->status, AMICI_SUCCESS);
+
+    realtype llh = 0.0, sllh = 0.0;
+    for (std::size_t it = 0; it < ts.size(); ++it) {
+        auto const x = std::exp(-p * ts[it]);
+        auto const sx = -ts[it] * x;
+        EXPECT_NEAR(rdata->x[it], x, 1e-8);
+        EXPECT_NEAR(rdata->y[it], x, 1e-8);
+        EXPECT_NEAR(rdata->sx[it], sx, 1e-8);
+        llh -= 0.5 * std::log(2 * pi) + 0.5 * std::pow(x - 0.5, 2);
+        sllh -= (x - 0.5) * sx;
+    }
+    EXPECT_NEAR(rdata->llh, llh, 1e-8);
+    EXPECT_NEAR(rdata->sllh[0], sllh, 1e-8);
+}
+
+TEST(BytecodeModelTest, ConsumerErrorsReportedAfterLoop)
+{
+    std::istringstream stream(decay_bytecode);
+    Model_ODE_Bytecode model(readBytecodeModel(stream));
+    model.setTimepoints({0.0, 1.0});
+    auto solver = model.getSolver();
+
+    class FailingConsumer : public ReturnDataConsumer {
+      public:
+        void consume(int index, std::unique_ptr<ReturnData>) override {
+            if (index == 1)
+                throw AmiException("consumer failed");
+            ++consumed;
+        }
+        std::atomic<int> consumed{0};
+    } consumer;
+
+    std::vector<ExpData *> edatas(3, nullptr);
+    try {
+        runAmiciSimulations(*solver, edatas, model, consumer, false, 2);
+        FAIL() << "Expected AmiException";
+    } catch (AmiException const &ex) {
+        ASSERT_NE(std::string(ex.what()).find("consumer failed"),
+                  std::string::npos);
+    }
+    // the other simulations were not interrupted
+    ASSERT_EQ(consumer.consumed, 2);
+}
+
+TEST(BytecodeModelTest, DxdotdpAllocatedOnFirstUse)
+{
+    std::istringstream stream(decay_bytecode);
+    Model_ODE_Bytecode model(readBytecodeModel(stream));
+    ASSERT_TRUE(model.pythonGenerated);
+    ASSERT_THROW(model.get_dxdotdp_full(), AmiException);
+
+    AmiVector x(std::vector<realtype>{2.0});
+    model.setParameters({0.5});
+    Model &base = model;
+    base.fdxdotdp(0.0, x, x);
+    // dxdot/dp = -x
+    ASSERT_EQ(base.get_dxdotdp_full().get_data(0), -2.0);
+}
+
+TEST(BytecodeModelTest, InvalidBytecode)
+{
+    std::string bytecode(decay_bytecode);
+    // reading an array that is not an argument of the function
+    auto const pos = bytecode.find("load 0 p 0\nneg");
+    auto invalid = bytecode;
+    invalid.replace(pos, 10, "load 0 y 0");
+    std::istringstream stream(invalid);
+    ASSERT_THROW(readBytecodeModel(stream), AmiException);
+
+    // out of bounds input index
+    invalid = bytecode;
+    invalid.replace(pos, 10, "load 0 p 1");
+    stream = std::istringstream(invalid);
+    ASSERT_THROW(readBytecodeModel(stream), AmiException);
+
+    // invalid sparsity patterns of the 1x1 matrix dxdotdx_explicit
+    std::string const sparsity = "dxdotdx_explicit 0 colptrs 2 0 1 rowvals 1 0";
+    auto const sparsity_pos = bytecode.find(sparsity);
+    ASSERT_NE(sparsity_pos, std::string::npos);
+    for (auto const &pattern :
+         {"colptrs 3 0 1 1 rowvals 1 0", "colptrs 2 0 1 rowvals 2 0 0",
+          "colptrs 2 1 1 rowvals 1 0", "colptrs 2 0 0 rowvals 1 0",
+          "colptrs 2 0 1 rowvals 1 1"}) {
+        invalid = bytecode;
+        invalid.replace(sparsity_pos, sparsity.size(),
+                        std::string("dxdotdx_explicit 0 ") + pattern);
+        stream = std::istringstream(invalid);
+        ASSERT_THROW(readBytecodeModel(stream), AmiException) << pattern;
+    }
+
+    stream = std::istringstream(bytecode.substr(0, bytecode.size() / 2));
+    ASSERT_THROW(readBytecodeModel(stream), AmiException);
+
+    ASSERT_THROW(loadBytecodeModel("does_not_exist.amici_bytecode"),
+                 AmiException);
+}
+
+TEST(ModelRegistryTest, LoadAndUnload)
+{
+    ModelRegistry registry({"does_not_exist", MODEL_PLUGIN_DIR});
+
+    auto model = registry.createModel("test_model", "1");
+    ASSERT_EQ(model->np(), 1);
+    ASSERT_EQ(model->getParameters()[0], 1.0);
+    ASSERT_TRUE(registry.isLoaded("test_model", "1"));
+
+    // several versions can be loaded at the same time
+    auto model2 = registry.createModel("test_model", "2");
+    ASSERT_EQ(model2->getParameters()[0], 2.0);
+    auto other = registry.createModel("test_model", "1");
+    ASSERT_EQ(registry.getLoadedModels(),
+              (std::vector<std::pair<std::string, std::string>>{
+                  {"test_model", "1"}, {"test_model", "2"}}));
+
+    // plugins stay loaded while models exist
+    ASSERT_FALSE(registry.unload("test_model", "1"));
+    model2.reset();
+    ASSERT_EQ(registry.unloadUnused(), 1);
+    ASSERT_FALSE(registry.isLoaded("test_model", "2"));
+    model.reset();
+    other.reset();
+    ASSERT_TRUE(registry.unload("test_model", "1"));
+    ASSERT_TRUE(registry.getLoadedModels().empty());
+
+    // reload after unloading
+    model = registry.createModel("test_model", "1");
+    ASSERT_EQ(model->getParameters()[0], 1.0);
+}
+
+TEST(ModelRegistryTest, Errors)
+{
+    ModelRegistry registry({MODEL_PLUGIN_DIR});
+    // not found
+    ASSERT_THROW(registry.load("test_model", "3"), AmiException);
+    ASSERT_THROW(registry.load("test_model"), AmiException);
+    // no paths outside of the search directories
+    ASSERT_THROW(registry.load("../model_plugins/test_model", "1"),
+                 AmiException);
+    ASSERT_THROW(registry.load("test_model", ".."), AmiException);
+
+    auto const path =
+        ModelRegistry::getLibraryPath(MODEL_PLUGIN_DIR, "test_model", "2");
+    auto plugin = registry.loadLibrary(path);
+    ASSERT_EQ(plugin->getName(), "test_model");
+    ASSERT_EQ(plugin->getVersion(), "2");
+    ASSERT_EQ(registry.load("test_model", "2"), plugin);
+
+    ASSERT_THROW(ModelPlugin("does_not_exist.so"), AmiException);
+}
+
 } // namespace
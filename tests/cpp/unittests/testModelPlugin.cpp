@@ -0,0 +1,50 @@
+/**
+ * Model plugin for the ModelRegistry tests. Built once per version, see
+ * CMakeLists.txt, the only parameter of the model is set to the version.
+ */
+#include "testfunctions.h"
+
+#include <amici/model_registry.h>
+
+namespace {
+
+std::unique_ptr<amici::Model> getPluginModel() {
+    using amici::realtype;
+    return std::make_unique<amici::Model_Test>(
+        amici::ModelDimensions(
+            1,  // nx_rdata
+            1,  // nxtrue_rdata
+            1,  // nx_solver
+            1,  // nxtrue_solver
+            0,  // nx_solver_reinit
+            1,  // np
+            0,  // nk
+            0,  // ny
+            0,  // nytrue
+            0,  // nz
+            0,  // nztrue
+            0,  // ne
+            0,  // nJ
+            0,  // nw
+            0,  // ndwdx
+            0,  // ndwdp
+            0,  // dwdw
+            0,  // ndxdotdw
+            {}, // ndJydy
+            0,  // ndxrdatadxsolver
+            0,  // ndxrdatadtcl
+            0,  // ndtotal_cldx_rdata
+            0,  // nnz
+            0,  // ubw
+            0   // lbw
+            ),
+        amici::SimulationParameters(std::vector<realtype>{},
+                                    std::vector<realtype>{std::stod(
+                                        TEST_MODEL_VERSION)}),
+        amici::SecondOrderMode::none, std::vector<realtype>{1.0},
+        std::vector<int>{});
+}
+
+} // namespace
+
+AMICI_MODEL_PLUGIN("test_model", TEST_MODEL_VERSION, getPluginModel)
@@ -51,6 +51,14 @@ checkReturnDataEqual(amici::ReturnData const& r, amici::ReturnData const& s)
     checkEqualArray(r.sigmay, s.sigmay, 1e-16, 1e-16, "sigmay");
     checkEqualArray(r.sy, s.sy, 1e-16, 1e-16, "sy");
     checkEqualArray(r.ssigmay, s.ssigmay, 1e-16, 1e-16, "ssigmay");
+    checkEqualArray(r.res, s.res, 1e-16, 1e-16, "res");
+    checkEqualArray(r.sres, s.sres, 1e-16, 1e-16, "sres");
+    checkEqualArray(r.FIM, s.FIM, 1e-16, 1e-16, "FIM");
+    checkEqualArray(r.x_ss, s.x_ss, 1e-16, 1e-16, "x_ss");
+    checkEqualArray(r.sx_ss, s.sx_ss, 1e-16, 1e-16, "sx_ss");
+    ASSERT_EQ(static_cast<int>(r.rdata_reporting),
+              static_cast<int>(s.rdata_reporting));
+    ASSERT_EQ(r.rdata_fields, s.rdata_fields);
 
     ASSERT_EQ(r.numsteps, s.numsteps);
     ASSERT_EQ(r.numstepsB, s.numstepsB);
@@ -258,3 +266,47 @@ TEST_F(SolverSerializationTest, ToStdVec)
 
     ASSERT_EQ(solver, v);
 }
+
+TEST(ExpDataSerializationTest, ToStringAndIntoExisting)
+{
+    amici::ExpData edata(2, 1, 1, {0.0, 1.0, 2.0});
+    edata.id = "condition";
+    edata.fixedParameters = {1.0, 2.0};
+    edata.reinitialization_state_idxs_sim = {0};
+    edata.t_presim = 3.0;
+    edata.setObservedDataSparse({0, 2}, {1, 0}, {4.0, 5.0}, {0.5, 0.6});
+    edata.setObservedEvents({7.0});
+
+    auto serialized = amici::serializeToString(edata);
+    auto e = amici::deserializeFromString<amici::ExpData>(serialized);
+
+    ASSERT_EQ(edata.id, e.id);
+    ASSERT_EQ(static_cast<amici::SimulationParameters const&>(edata),
+              static_cast<amici::SimulationParameters const&>(e));
+    ASSERT_EQ(edata.nytrue(), e.nytrue());
+    ASSERT_EQ(edata.nztrue(), e.nztrue());
+    ASSERT_EQ(edata.nmaxevent(), e.nmaxevent());
+    ASSERT_EQ(edata.getObservedDataIndptr(), e.getObservedDataIndptr());
+    ASSERT_EQ(edata.getObservedDataIndices(), e.getObservedDataIndices());
+    amici::checkEqualArray(edata.getObservedDataDense(),
+                           e.getObservedDataDense(), 0.0, 0.0, "Y");
+    amici::checkEqualArray(edata.getObservedDataStdDevDense(),
+                           e.getObservedDataStdDevDense(), 0.0, 0.0,
+                           "Sigma_Y");
+    amici::checkEqualArray(edata.getObservedEvents(), e.getObservedEvents(),
+                           0.0, 0.0, "Z");
+
+    ASSERT_TRUE(e.isObservedDataSparse());
+
+    // reading into an instance of the same shape reuses its storage
+    e.setObservedData(e.getObservedDataDense());
+    ASSERT_FALSE(e.isObservedDataSparse());
+    serialized = amici::serializeToString(e);
+    edata.setObservedData({1.0, 1.0, 1.0, 1.0, 1.0, 1.0});
+    auto const* data_ptr = edata.getObservedDataPtr(0);
+    amici::deserializeFromString(serialized, edata);
+    ASSERT_EQ(data_ptr, edata.getObservedDataPtr(0));
+    ASSERT_EQ(e.getObservedDataIndices(), edata.getObservedDataIndices());
+    amici::checkEqualArray(e.getObservedData(), edata.getObservedData(),
+                           0.0, 0.0, "Y");
+}
@@ -0,0 +1,166 @@
+#include "testfunctions.h"
+#include "bytecodeModels.h"
+
+#include <amici/amici.h>
+#include <amici/model_ode_bytecode.h>
+#include <amici/serve.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace amici;
+
+namespace {
+
+std::string socketPath() {
+    return "/tmp/amici_serve_test_" + std::to_string(getpid()) + ".sock";
+}
+
+/** Serves the decay model in a separate thread */
+class ServeTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        std::istringstream stream(decay_bytecode);
+        definition_ = readBytecodeModel(stream);
+        serve::ServerOptions options;
+        options.num_threads = 2;
+        options.on_models_released = [this]() { ++released_; };
+        server_ = std::make_unique<serve::Server>(
+            socketPath(),
+            [this](std::string const &name, std::string const &version) {
+                ++created_;
+                if (name != "decay" || !version.empty())
+                    throw AmiException("Unknown model %s.", name.c_str());
+                return std::make_shared<Model_ODE_Bytecode>(definition_);
+            },
+            options);
+        thread_ = std::thread([this]() { server_->run(); });
+    }
+
+    void TearDown() override {
+        if (server_)
+            server_->stop();
+        thread_.join();
+        server_.reset();
+        ASSERT_EQ(access(socketPath().c_str(), F_OK), -1);
+    }
+
+    std::shared_ptr<const BytecodeModelDefinition> definition_;
+    std::unique_ptr<serve::Server> server_;
+    std::thread thread_;
+    std::atomic<int> created_{0};
+    std::atomic<int> released_{0};
+};
+
+} // namespace
+
+TEST_F(ServeTest, SimulateConditions)
+{
+    Model_ODE_Bytecode model(definition_);
+    auto solver = model.getSolver();
+    solver->setSensitivityOrder(SensitivityOrder::first);
+    solver->setSensitivityMethod(SensitivityMethod::forward);
+
+    std::vector<ExpData> edatas;
+    for (int i = 0; i < 3; ++i) {
+        ExpData edata(model);
+        edata.setTimepoints({0.0, 1.0 + i, 4.0});
+        edata.setObservedData({1.0, 0.5 * i, 0.1});
+        edata.setObservedDataStdDev({1.0, 1.0, 1.0});
+        edatas.push_back(edata);
+    }
+
+    serve::Request request;
+    request.model_name = "decay";
+    request.solver = solver.get();
+    request.parameters = {0.3};
+    for (auto const &edata : edatas)
+        request.edatas.push_back(&edata);
+
+    serve::Client client(socketPath());
+    std::vector<int> received;
+    std::vector<std::unique_ptr<ReturnData>> results(edatas.size());
+    client.simulate(request, [&](int index, std::unique_ptr<ReturnData> rdata) {
+        received.push_back(index);
+        results.at(index) = std::move(rdata);
+    });
+    ASSERT_EQ(received, std::vector<int>({0, 1, 2}));
+
+    model.setParameters(request.parameters);
+    for (std::size_t i = 0; i < edatas.size(); ++i) {
+        auto const expected = runAmiciSimulation(*solver, &edatas[i], model);
+        ASSERT_EQ(results[i]->status, AMICI_SUCCESS);
+        checkEqualArray(results[i]->ts, expected->ts, 0.0, 0.0, "ts");
+        checkEqualArray(results[i]->x, expected->x, 0.0, 0.0, "x");
+        checkEqualArray(results[i]->sllh, expected->sllh, 0.0, 0.0, "sllh");
+        ASSERT_EQ(results[i]->llh, expected->llh);
+    }
+
+    // default solver settings and parameters, without data
+    serve::Request defaults;
+    defaults.model_name = "decay";
+    auto const rdatas = client.simulate(defaults);
+    ASSERT_EQ(rdatas.size(), 1U);
+    Model_ODE_Bytecode default_model(definition_);
+    auto const expected = runAmiciSimulation(*default_model.getSolver(),
+                                             nullptr, default_model);
+    checkEqualArray(rdatas[0]->x, expected->x, 0.0, 0.0, "x");
+    ASSERT_TRUE(rdatas[0]->sllh.empty());
+
+    // the model stays resident across requests
+    ASSERT_EQ(created_, 1);
+    ASSERT_EQ(released_, 0);
+}
+
+TEST_F(ServeTest, Errors)
+{
+    serve::Client client(socketPath());
+    serve::Request request;
+    request.model_name = "unknown";
+    ASSERT_THROW(client.simulate(request), AmiException);
+
+    request.model_name = "decay";
+    request.parameters = {1.0, 2.0};
+    ASSERT_THROW(client.simulate(request), AmiException);
+
+    request.parameters.clear();
+    ExpData edata(2, 0, 0, {1.0});
+    request.edatas.push_back(&edata);
+    ASSERT_THROW(client.simulate(request), AmiException);
+
+    // the connection can still be used after failed requests
+    request.edatas.clear();
+    ASSERT_EQ(client.simulate(request).at(0)->status, AMICI_SUCCESS);
+
+    ASSERT_THROW(serve::Server(socketPath(), serve::ModelFactory()),
+                 AmiException);
+    ASSERT_THROW(serve::Client("/tmp/amici_serve_test_does_not_exist.sock"),
+                 AmiException);
+}
+
+TEST_F(ServeTest, SocketPermissions)
+{
+    struct stat status {};
+    ASSERT_EQ(stat(socketPath().c_str(), &status), 0);
+    ASSERT_TRUE(S_ISSOCK(status.st_mode));
+    ASSERT_EQ(status.st_mode & 0777, 0600);
+}
+
+TEST_F(ServeTest, DestroyWhileRunning)
+{
+    // run() has started once a request was served
+    serve::Client client(socketPath());
+    serve::Request request;
+    request.model_name = "decay";
+    ASSERT_EQ(client.simulate(request).at(0)->status, AMICI_SUCCESS);
+
+    // the destructor stops the server and waits for run() to return
+    server_.reset();
+    ASSERT_EQ(access(socketPath().c_str(), F_OK), -1);
+}
@@ -8,14 +8,18 @@ import os
 import re
 import shutil
 
+from amici.pgo import compile_model_pgo
 from amici.petab_import import import_model
 
 
 def parse_args():
     arg = sys.argv[1]
-    if '_' in arg and re.match(r'O[0-2]', arg.split("_")[-1]):
+    if '_' in arg and re.match(r'O[0-2]|LTO|PGO', arg.split("_")[-1]):
         optim = arg.split("_")[-1]
-        os.environ['AMICI_CXXFLAGS'] = f'-{optim}'
+        if optim == 'LTO':
+            os.environ['ENABLE_AMICI_LTO'] = 'TRUE'
+        elif optim != 'PGO':
+            os.environ['AMICI_CXXFLAGS'] = f'-{optim}'
         suffix = f'_{optim}'
         arg = '_'.join(arg.split("_")[:-1])
     else:
@@ -30,7 +34,10 @@ def check_results(rdata):
                    'numnonlinsolvconvfails', 'numnonlinsolvconvfailsB',
                    'preeq_cpu_time', 'preeq_cpu_timeB',
                    'cpu_time', 'cpu_timeB',
-                   'posteq_cpu_time', 'posteq_cpu_timeB']
+                   'posteq_cpu_time', 'posteq_cpu_timeB',
+                   'preeq_wall_time', 'preeq_wall_timeB',
+                   'wall_time', 'wall_timeB',
+                   'posteq_wall_time', 'posteq_wall_timeB']
     for d in diagnostics:
         print(d, rdata[d])
     assert rdata['status'] == amici.AMICI_SUCCESS
@@ -121,6 +128,12 @@ def main():
         return
     elif arg == 'compile':
         compile_model(model_name, model_dir)
+        if suffix == '_PGO':
+            # train with forward sensitivities, reports the speedup
+            compile_model_pgo(
+                model_name, model_dir,
+                training_command=[sys.executable, os.path.abspath(__file__),
+                                  f'forward_sensitivities{suffix}'])
         return
     else:
         model_module = amici.import_model_module(model_name, model_dir)